@@ -31,6 +31,8 @@
 
 /*=========================================================  INCLUDE FILES  ==*/
 
+#include <asm/system.h>
+
 #include "arch/compiler.h"
 #include "dbg/dbg.h"
 
@@ -53,6 +55,7 @@ struct circBuff {
     uint32_t   			tail;
     uint32_t            size;
     uint32_t            free;
+    bool_T              isMirrored;                                             /**<@brief Storage is mapped twice, back to back            */
 #if (1 == CFG_DBG_API_VALIDATION)
     uint32_t            signature;
 #endif
@@ -74,6 +77,17 @@ void circInit(
     void *              mem,
     size_t              size);
 
+/**@brief       Initialize a buffer over mirrored storage
+ * @details     The @c size bytes at @c mem must be mapped again right after
+ *              the first mapping. Every occupied and free region is then
+ *              contiguous, so circRemainingOccGet() and circRemainingFreeGet()
+ *              return all occupied and all free bytes.
+ */
+void circInitMirrored(
+    circBuff_T *        buff,
+    void *              mem,
+    size_t              size);
+
 static inline void circItemPut(
     circBuff_T *        buff,
     uint8_t             item) {
@@ -88,7 +102,7 @@ static inline void circItemPut(
     }
 }
 
-static inline u8 circItemGet(
+static inline uint8_t circItemGet(
     circBuff_T *        buff) {
 
     uint8_t             tmp;
@@ -112,6 +126,13 @@ size_t circRemainingFreeGet(
 size_t circRemainingOccGet(
     const circBuff_T *  buff);
 
+/**@brief       Occupied bytes from the tail up to the end of the storage
+ * @details     Same as circRemainingOccGet() for a plain buffer. Used by
+ *              transfers which do not see the mirror, like DMA.
+ */
+size_t circStorageOccGet(
+    const circBuff_T *  buff);
+
 size_t circFreeGet(
     const circBuff_T *  buff);
 
@@ -137,6 +158,14 @@ void circPosHeadSet(
     circBuff_T *        buff,
     int32_t             position);
 
+/**@brief       Remove the most recently written items
+ * @details     Used to drop partially received data which has not been
+ *              handed to the consumer yet.
+ */
+void circPosHeadRewind(
+    circBuff_T *        buff,
+    uint32_t            size);
+
 uint32_t circPosTailGet(
     const circBuff_T *  buff);
 
@@ -0,0 +1,128 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author  	Nenad Radulovic
+ * @brief       Table driven CRC-16 and CRC-32 interface
+ *********************************************************************//** @{ */
+
+#if !defined(CRC_H_)
+#define CRC_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include "arch/compiler.h"
+
+/*===============================================================  MACRO's  ==*/
+
+/**@brief       Maximum size of a CRC value in bytes
+ */
+#define CRC_SIZE_MAX                    4U
+
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+
+/*------------------------------------------------------------------------*//**
+ * @name        CRC data types
+ * @{ *//*--------------------------------------------------------------------*/
+
+/**@brief       Supported CRC algorithms
+ */
+enum crcType {
+    CRC_NONE,
+    CRC_16_CCITT,                                                               /**<@brief CRC-16/CCITT-FALSE, poly 0x1021, init 0xFFFF     */
+    CRC_16_MODBUS,                                                              /**<@brief CRC-16/MODBUS, poly 0x8005 reflected, init 0xFFFF*/
+    CRC_32                                                                      /**<@brief CRC-32 (IEEE 802.3)                              */
+};
+
+/**@brief       Running CRC state
+ */
+struct crc {
+    enum crcType        type;
+    uint32_t            value;                                                  /**<@brief Register value, without final XOR                */
+};
+
+/** @} *//*-------------------------------------------------------------------*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/*------------------------------------------------------------------------*//**
+ * @name        CRC computation
+ * @{ *//*--------------------------------------------------------------------*/
+
+/**@brief       Build the slice-by-8 lookup tables
+ * @details     Must be called once before any other function of this module.
+ */
+void crcModuleInit(
+    void);
+
+/**@brief       Reset the running CRC and select algorithm
+ */
+void crcInit(
+    struct crc *        crc,
+    enum crcType        type);
+
+/**@brief       Fold a block of bytes into the running CRC
+ * @details     Eight bytes are processed per table lookup round, the
+ *              remainder is processed byte by byte.
+ */
+void crcUpdate(
+    struct crc *        crc,
+    const uint8_t *     data,
+    size_t              size);
+
+/**@brief       Return the CRC of all bytes folded since crcInit()
+ */
+uint32_t crcValueGet(
+    const struct crc *  crc);
+
+/**@brief       Return the size of the CRC value in bytes
+ */
+size_t crcSizeGet(
+    const struct crc *  crc);
+
+/**@brief       Write the CRC value in on-the-wire byte order
+ * @details     CRC-16/CCITT is sent most significant byte first, CRC-16/MODBUS
+ *              and CRC-32 least significant byte first. After folding the
+ *              appended bytes on the receiving side crcValueGet() returns
+ *              zero for both CRC-16 variants and 0x2144DF1C for CRC-32.
+ * @return      Number of bytes written
+ */
+size_t crcSerialize(
+    const struct crc *  crc,
+    uint8_t *           dst);
+
+/** @} *//*-----------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of crc.h
+ ******************************************************************************/
+#endif /* CRC_H_ */
@@ -31,11 +31,14 @@
 
 /*=========================================================  INCLUDE FILES  ==*/
 
+#include <linux/dma-mapping.h>
 #include <rtdm/rtdm_driver.h>
 #include <native/heap.h>
 
 #include "drv/x-16c750_ioctl.h"
 #include "drv/x-16c750_cfg.h"
+#include "drv/x-16c750_frame.h"
+#include "crc/crc.h"
 #include "circbuff/circbuff.h"
 #include "arch/compiler.h"
 
@@ -55,55 +58,162 @@ enum ctxState {
     CTX_STATE_TX_BUFF,
     CTX_STATE_TX_BUFF_INIT,
     CTX_STATE_RX_BUFF,
-    CTX_STATE_RX_BUFF_INIT
+    CTX_STATE_RX_BUFF_INIT,
+    CTX_STATE_IRQ
 };
 
 enum uartStatus {
-    UART_STATUS_NORMAL,
-    UART_STATUS_SOFT_OVERFLOW,
-    UART_STATUS_TIMEOUT,
-    UART_STATUS_FAULT_USAGE,
-    UART_STATUS_BUSY,
-    UART_STATUS_BAD_FILE_NUMBER,
-    UART_STATUS_UNHANDLED_INTERRUPT
+    UART_STATUS_NORMAL              = XUART_STATUS_NORMAL,
+    UART_STATUS_SOFT_OVERFLOW       = XUART_STATUS_SOFT_OVERFLOW,
+    UART_STATUS_TIMEOUT             = XUART_STATUS_TIMEOUT,
+    UART_STATUS_FAULT_USAGE         = XUART_STATUS_FAULT_USAGE,
+    UART_STATUS_BUSY                = XUART_STATUS_BUSY,
+    UART_STATUS_BAD_FILE_NUMBER     = XUART_STATUS_BAD_FILE_NUMBER,
+    UART_STATUS_UNHANDLED_INTERRUPT = XUART_STATUS_UNHANDLED_INTERRUPT
 };
 
+/**@brief       Receive completion conditions in driver form
+ */
+struct rxWake {
+    uint32_t            map[256U / 32U];                                        /**<@brief Bitmap of delimiter bytes                        */
+    bool_T              isDelim;
+    size_t              count;
+    nanosecs_rel_t      idle;
+};
+
+struct xferEngine;
+
 /**@brief       UART channel context structure
  */
 struct uartCtx {
-    rtdm_lock_t         lock;                                                   /**<@brief Lock to protect this structure                   */
     rtdm_irq_t          irqHandle;                                              /**<@brief IRQ routine handler structure                    */
     struct unit {
+        rtdm_lock_t         lock;                                               /**<@brief Lock to protect this unit                        */
         rtdm_event_t        opr;                                                /**<@brief Operational event                                */
         nanosecs_rel_t      oprTimeout;
         rtdm_sem_t          acc;                                                /**<@brief Access mutex                                     */
         nanosecs_rel_t      accTimeout;
         rtdm_user_info_t *  user;
+        nanosecs_abs_t      stamp;                                              /**<@brief Time of the last transferred byte                */
+        rtdm_event_t        rdy;                                                /**<@brief Readiness event bound to select()                */
+        size_t              rdyLevel;                                           /**<@brief Buffer level at which the unit becomes ready     */
+        bool_T              isRdy;                                              /**<@brief Current readiness state                          */
+        bool_T              isPersistent;                                       /**<@brief Unit stays enabled between calls                 */
+        bool_T              isCrcAppend;                                        /**<@brief Append CRC to transmitted data                   */
+        struct crc          crc;                                                /**<@brief CRC of the data moved by the current call        */
+        uint32_t            crcLast;                                            /**<@brief CRC of the data moved by the last call           */
         struct buff {
             circBuff_T          handle;                                         /**<@brief Buffer handle                                    */
 #if (0 == CFG_DMA_MODE)
             RT_HEAP             storage;                                        /**<@brief Heap for internal buffers                        */
-#elif (1 == CFG_DMA_MODE)
-            volatile uint8_t *  phy;
-#elif (2 == CFG_DMA_MODE)
-            volatile uint8_t *  phy;
+#elif (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
+            volatile uint8_t *  phy;                                            /**<@brief Streaming DMA address, NULL when not mapped      */
+            enum dma_data_direction dir;                                        /**<@brief Direction of the mapping                         */
 #endif
             size_t              pend;
-#if (1 == CFG_DMA_MODE)
-            size_t              chunk;
-#elif (2 == CFG_DMA_MODE)
+#if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
             size_t              chunk;
 #endif
         }                   buff;
         enum uartStatus     status;
+        enum uartStatus     statusLatch;                                        /**<@brief First error since the last call, kept for it     */
+        enum uartStatus     statusLast;                                         /**<@brief Status of the last call                          */
     }                   tx, rx;                                                 /**<@brief TX and RX channel                                */
     struct cache {
+        rtdm_lock_t         lock;                                               /**<@brief Lock to protect IER shadow register              */
         volatile uint8_t *  io;
         struct devData *    devData;
         uint32_t            IER;
     }                   cache;
+    struct frame {
+        enum xUartFraming   type;
+        struct frameDec     dec;                                                /**<@brief RX decoder, protected by RX lock                 */
+        struct frameQueue   queue;                                              /**<@brief Lengths of complete RX frames                    */
+        size_t              uncommitted;                                        /**<@brief Decoded bytes of the frame being received        */
+        struct frameEnc     enc;                                                /**<@brief TX encoder, protected by TX lock                 */
+        struct frameRtu {
+            rtdm_timer_t        timer;                                          /**<@brief Inter-character silence timer                    */
+            nanosecs_rel_t      tChar;                                          /**<@brief Duration of one character on the line            */
+            nanosecs_rel_t      t15;                                            /**<@brief Maximum gap between characters of a frame        */
+            nanosecs_rel_t      t35;                                            /**<@brief Minimum gap between frames                       */
+            bool_T              isGap;                                          /**<@brief t1.5 elapsed since the last received character   */
+            bool_T              isBad;                                          /**<@brief Drop received data until the next t3.5 silence   */
+        }                   rtu;
+        struct frameMux {
+            bool_T              isEnabled;
+            bool_T              isIdPending;                                    /**<@brief Next decoded byte is a channel number            */
+            uint8_t             id;                                             /**<@brief Channel of the frame being received              */
+        }                   mux;
+    }                   frame;
+    struct poll {
+        rtdm_timer_t        timer;                                              /**<@brief Cycle and response timeout timer                 */
+        rtdm_event_t        done;                                               /**<@brief Signalled at the end of every cycle              */
+        enum pollState {
+            POLL_STATE_IDLE,
+            POLL_STATE_CYCLE,                                                   /**<@brief Waiting for the next cycle                       */
+            POLL_STATE_RSP                                                      /**<@brief Waiting for the response of entry @c idx         */
+        }                   state;
+        bool_T              isActive;
+        uint32_t            idx;
+        uint32_t            cycle;
+        uint32_t            overruns;
+        uint32_t            pub;                                                /**<@brief Index of the published result buffer             */
+        nanosecs_abs_t      start;                                              /**<@brief Scheduled start of the current cycle             */
+        struct xUartPollTable table;
+        struct xUartPollResult result[2];
+    }                   poll;
+    struct filter {
+        struct xUartFilter  cfg;
+        nanosecs_abs_t      last;                                               /**<@brief Time of the last received burst                  */
+        bool_T              isGap;                                              /**<@brief Next received byte is an address byte            */
+        bool_T              isMatch;                                            /**<@brief Current frame is addressed to this node          */
+    }                   filter;
+    struct wake {
+        struct xUartWake    cfg;
+        struct rxWake       cond;                                               /**<@brief Conditions used by read()                        */
+        const struct rxWake * cur;                                              /**<@brief Conditions of the receive in progress, or NULL   */
+        bool_T              isEnabled;
+        bool_T              isHit;                                              /**<@brief ISR received a delimiter                         */
+    }                   wake;
+    struct tap {
+        struct uartCtx *    owner;                                              /**<@brief Hardware owner, NULL when orphaned               */
+        struct uartCtx *    next;                                               /**<@brief Owner: first tap, tap: next tap                  */
+        enum xUartTapPolicy policy;
+        uint32_t            lost;
+        uint32_t            channel;                                            /**<@brief Bound virtual channel, 0 for a plain tap         */
+        bool_T              isTap;
+        bool_T              isCopying;                                          /**<@brief Reader is copying out of the buffer              */
+    }                   tap;
+    struct engine {
+        const struct xferEngine * ops;                                          /**<@brief Transfer engine selected by XUART_ENGINE_SET     */
+        rtdm_timer_t        timer;                                              /**<@brief Service timer of the polled engine               */
+        nanosecs_abs_t      rxLast;                                             /**<@brief Time the polled engine last found RX data        */
+        bool_T              isRxOn;                                             /**<@brief Receiver is started, protected by RX lock        */
+        bool_T              isTxOn;                                             /**<@brief Transmitter is started, protected by TX lock     */
+        bool_T              isRxIdle;                                           /**<@brief Polled engine reported the RX silence            */
+        struct hybrid {
+            size_t              threshold;                                      /**<@brief Bytes above which TX data is sent by DMA         */
+            uint32_t            dmaSetup;                                       /**<@brief Measured CPU time of a DMA cycle in ns           */
+            uint32_t            pioByte;                                        /**<@brief Measured THR write time per byte in ns           */
+            uint32_t            dmaBursts;
+            uint32_t            pioBursts;
+            uint32_t            dmaTime;                                        /**<@brief CPU time of the timed DMA cycles in ns           */
+            uint32_t            dmaSamples;
+            uint32_t            pioTime;                                        /**<@brief Duration of the timed THR bursts in ns           */
+            size_t              pioBytes;
+            uint32_t            pioSamples;
+            bool_T              isCalibrated;                                   /**<@brief Threshold measured or fixed, kept over opens     */
+        }                   hybrid;
+    }                   engine;
+    struct selfTest {
+        nanosecs_rel_t      isrTime;                                            /**<@brief Accumulated ISR execution time                   */
+        uint32_t            irqs;
+        bool_T              isActive;
+    }                   selfTest;
     struct xUartProto   proto;
+    bool_T              isLoopback;                                             /**<@brief Internal loopback set by XUART_LOOPBACK_SET      */
     enum ctxState       state;
+    bool_T              isOpen;                                                 /**<@brief Context is used by an open file                  */
     uint32_t            signature;
 };
 
@@ -54,8 +54,46 @@
  */
 #define CFG_DRV_BUFF_SIZE               4096U
 
+/**@brief       Map the storage of internal buffers twice, back to back
+ * @details     Copies into and out of a mirrored buffer never wrap, so every
+ *              read(), write() and scan moves one contiguous span. Needs
+ *              CFG_DRV_BUFF_SIZE to be a multiple of the page size.
+ */
+#if !defined(CFG_BUFF_MIRROR)
+# define CFG_BUFF_MIRROR                0
+#endif
+
 #define CFG_TIMEOUT_MS                  2000
 
+/**@brief       Maximum number of I/O vector segments accepted by sendmsg() and
+ *              recvmsg()
+ * @details     The segment array is copied onto the stack of the calling
+ *              task, so keep this value small.
+ */
+#define CFG_DRV_IOV_MAX                 16
+
+/**@brief       Maximum number of complete frames buffered by the receiver
+ * @details     Used only when framing is enabled. Frames received while the
+ *              queue is full are dropped.
+ */
+#define CFG_FRAME_QUEUE_SIZE            32
+
+/**@brief       Number of tap contexts created when the module is loaded
+ * @details     Each tap owns a receive buffer of CFG_DRV_BUFF_SIZE bytes.
+ *              Opens beyond this number fail with -EBUSY.
+ */
+#define CFG_TAP_MAX                     2
+
+/**@brief       Default number of bytes pumped by XUART_SELFTEST
+ */
+#define CFG_SELFTEST_SIZE               16384U
+
+/**@brief       Size of the self test transfer chunk
+ * @details     The chunk buffers are allocated on the stack of the calling
+ *              task. Must be smaller than half of CFG_DRV_BUFF_SIZE.
+ */
+#define CFG_SELFTEST_CHUNK              256U
+
 /**@brief       Trigger level of UART FIFO
  * @details     Lower value:    + less generated interrupts
  *                              - may cause pauses in data flow
@@ -68,13 +106,64 @@
 
 /**@brief       DMA mode
  * @details     0 - DMA mode not enabled
- *              1 - Software triggered DMA mode
- *              2 - Hardware triggered DMA mode
+ *              1 - Software triggered DMA mode, adds the soft DMA and hybrid
+ *                  engines
+ *              2 - Hardware triggered DMA mode, adds the hardware DMA engine
  */
 #define CFG_DMA_MODE                    0
 
+/**@brief       Transfer engine used after open, see enum xUartEngine
+ * @details     Defaults to the engine matching CFG_DMA_MODE. Every open file
+ *              can change it with XUART_ENGINE_SET.
+ */
+#if !defined(CFG_ENGINE_DEFAULT)
+# define CFG_ENGINE_DEFAULT             CFG_DMA_MODE
+#endif
+
+/**@brief       Service period of the polled engine in us
+ * @details     Must be shorter than the time needed to fill the RX FIFO at
+ *              the highest baud rate used with the polled engine (about
+ *              700us at 921600 baud).
+ */
+#define CFG_ENGINE_POLL_US              200
+
+/**@brief       Bytes above which the hybrid engine sends by DMA
+ * @details     Zero calibrates the threshold once, from the first THR bursts
+ *              and DMA cycles the engine times after the module is loaded.
+ */
+#if !defined(CFG_HYBRID_THRESHOLD)
+# define CFG_HYBRID_THRESHOLD           0
+#endif
+
 #define CFG_CRITICAL_INT_ENABLE         0
 
+/** @} *//*---------------------------------------------------------------*//**
+ * @name        Virtual null-modem devices
+ * @{ *//*--------------------------------------------------------------------*/
+
+/**@brief       Number of virtual null-modem device pairs
+ * @details     Each pair registers the devices CFG_DRV_NAME "-vnm<n>a" and
+ *              CFG_DRV_NAME "-vnm<n>b" which are connected back to back,
+ *              see struct xUartVnm. 0 disables the virtual devices.
+ */
+#if !defined(CFG_VNM_PAIRS)
+# define CFG_VNM_PAIRS                  0
+#endif
+
+/**@brief       Build only the virtual devices as a module of their own
+ * @details     The standalone module does not touch the UART hardware, so it
+ *              loads on any Xenomai machine. It is built with: make vnm
+ */
+#if !defined(CFG_VNM_STANDALONE)
+# define CFG_VNM_STANDALONE             0
+#endif
+
+/**@brief       Delivery timer granularity of the virtual devices in us
+ * @details     Bytes which are due within one tick are delivered together,
+ *              the average rate still follows the configured baud rate.
+ */
+#define CFG_VNM_TICK_US                 100
+
 /** @} *//*-------------------------------------------------------------------*/
 /*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
 /** @endcond *//** @} *//******************************************************
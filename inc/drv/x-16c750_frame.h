@@ -0,0 +1,201 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author  	Nenad Radulovic
+ * @brief       Frame encoder and decoder (SLIP, COBS, HDLC-like)
+ *********************************************************************//** @{ */
+
+#if !defined(X_16C750_FRAME_H_)
+#define X_16C750_FRAME_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include "arch/compiler.h"
+#include "circbuff/circbuff.h"
+#include "drv/x-16c750_cfg.h"
+#include "drv/x-16c750_ioctl.h"
+
+/*===============================================================  MACRO's  ==*/
+
+/**@brief       Maximum number of data bytes in one COBS block
+ */
+#define FRAME_COBS_BLOCK_SIZE           254U
+
+/**@brief       Maximum number of bytes written by frameEncAbort()
+ */
+#define FRAME_ABORT_SIZE                2U
+
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+
+/*------------------------------------------------------------------------*//**
+ * @name        Frame data types
+ * @{ *//*--------------------------------------------------------------------*/
+
+/**@brief       Result of feeding one byte to the decoder
+ */
+enum frameEvent {
+    FRAME_EV_NONE,                                                              /**<@brief Byte consumed, nothing to store                  */
+    FRAME_EV_DATA,                                                              /**<@brief Decoded data byte is available                   */
+    FRAME_EV_END,                                                               /**<@brief Current frame is complete                        */
+    FRAME_EV_ERROR                                                              /**<@brief Current frame is malformed and must be dropped   */
+};
+
+/**@brief       Streaming frame decoder
+ */
+struct frameDec {
+    enum xUartFraming   type;
+    size_t              len;                                                    /**<@brief Decoded bytes of the current frame               */
+    uint8_t             code;                                                   /**<@brief COBS: code of the current block                  */
+    uint8_t             rem;                                                    /**<@brief COBS: data bytes left in the current block       */
+    bool_T              isEsc;                                                  /**<@brief SLIP/HDLC: escape byte received                  */
+    bool_T              isBad;                                                  /**<@brief Discard data until the next delimiter            */
+};
+
+/**@brief       Streaming frame encoder
+ */
+struct frameEnc {
+    enum xUartFraming   type;
+    size_t              blockLen;                                               /**<@brief COBS: bytes waiting in the block staging area    */
+    uint8_t             block[FRAME_COBS_BLOCK_SIZE];                           /**<@brief COBS: block staging area                         */
+};
+
+/**@brief       Queue of complete frame lengths
+ */
+struct frameQueue {
+    size_t              len[CFG_FRAME_QUEUE_SIZE];
+    uint32_t            head;
+    uint32_t            tail;
+    uint32_t            occ;
+};
+
+/** @} *//*-------------------------------------------------------------------*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/*------------------------------------------------------------------------*//**
+ * @name        Decoder
+ * @{ *//*--------------------------------------------------------------------*/
+
+void frameDecInit(
+    struct frameDec *   dec,
+    enum xUartFraming   type);
+
+/**@brief       Feed one received byte to the decoder
+ * @param       dec
+ *              Decoder state
+ * @param       item
+ *              Received (encoded) byte
+ * @param       out
+ *              Decoded byte, valid only when FRAME_EV_DATA is returned
+ * @return      Decoder event
+ */
+enum frameEvent frameDecPut(
+    struct frameDec *   dec,
+    uint8_t             item,
+    uint8_t *           out);
+
+/**@brief       Drop the current frame and resynchronize on next delimiter
+ */
+void frameDecDiscard(
+    struct frameDec *   dec);
+
+/** @} *//*-------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//**
+ * @name        Encoder
+ * @details     Encoded bytes are written directly into the circular buffer.
+ *              The caller must ensure that at least frameEncBound() bytes
+ *              are free before calling frameEncPut() or frameEncEnd().
+ * @{ *//*--------------------------------------------------------------------*/
+
+void frameEncInit(
+    struct frameEnc *   enc,
+    enum xUartFraming   type);
+
+/**@brief       Worst case number of encoded bytes for given payload size,
+ *              including frame termination
+ */
+size_t frameEncBound(
+    const struct frameEnc * enc,
+    size_t              size);
+
+void frameEncBegin(
+    struct frameEnc *   enc,
+    circBuff_T *        dst);
+
+void frameEncPut(
+    struct frameEnc *   enc,
+    circBuff_T *        dst,
+    const uint8_t *     src,
+    size_t              size);
+
+void frameEncEnd(
+    struct frameEnc *   enc,
+    circBuff_T *        dst);
+
+/**@brief       Terminate the current frame so that the receiver drops it
+ * @details     Used when the payload can not be completed. Staged data is
+ *              discarded and at most FRAME_ABORT_SIZE bytes are written.
+ *              Framing without delimiters writes nothing, the receiver has
+ *              to rely on the frame CRC.
+ */
+void frameEncAbort(
+    struct frameEnc *   enc,
+    circBuff_T *        dst);
+
+/** @} *//*-------------------------------------------------------------------*/
+/*------------------------------------------------------------------------*//**
+ * @name        Frame length queue
+ * @{ *//*--------------------------------------------------------------------*/
+
+void frameQueueFlush(
+    struct frameQueue * queue);
+
+bool_T frameQueuePut(
+    struct frameQueue * queue,
+    size_t              len);
+
+size_t frameQueueGet(
+    struct frameQueue * queue);
+
+static inline uint32_t frameQueueOccGet(
+    const struct frameQueue * queue) {
+
+    return (queue->occ);
+}
+
+/** @} *//*-----------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x-16c750_frame.h
+ ******************************************************************************/
+#endif /* X_16C750_FRAME_H_ */
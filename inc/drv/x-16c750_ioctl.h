@@ -34,6 +34,12 @@
 #include <linux/ioctl.h>
 #include <rtdm/rtdm.h>
 
+#if defined(__KERNEL__)
+#include <linux/types.h>
+#else
+#include <stdint.h>
+#endif
+
 /*===============================================================  MACRO's  ==*/
 
 /*------------------------------------------------------------------------*//**
@@ -43,6 +49,23 @@
 
 #define XUART_IOCTL_VERSION             1
 
+/**@brief       Maximum number of entries in a poll table
+ */
+#define XUART_POLL_ENTRIES_MAX          16
+
+/**@brief       Maximum size of a poll request and of a poll response
+ */
+#define XUART_POLL_REQ_MAX              256
+#define XUART_POLL_RSP_MAX              256
+
+/**@brief       Highest virtual channel number
+ */
+#define XUART_CHANNEL_MAX               255
+
+/**@brief       Maximum number of wakeup delimiters
+ */
+#define XUART_WAKE_DELIM_MAX            8
+
 #define XUART_IOCTL_TYPE                RTDM_CLASS_SERIAL
 
 #define XUART_PROTOCOL_GET                                                      \
@@ -51,6 +74,113 @@
 #define XUART_PROTOCOL_SET                                                      \
     _IOW(XUART_IOCTL_TYPE, 0x01,struct xUartProto)
 
+#define XUART_RDY_LEVEL_SET                                                     \
+    _IOW(XUART_IOCTL_TYPE, 0x02,struct xUartRdyLevel)
+
+/**@brief       Keep the receiver running between reads until the device is
+ *              closed
+ * @details     This is the receive mode select() binding switches to. Bytes
+ *              which arrive between calls are kept and returned first by the
+ *              next read(). Without it every read() starts with an empty
+ *              buffer and bytes received between calls are lost.
+ */
+#define XUART_RX_PERSIST                                                        \
+    _IO(XUART_IOCTL_TYPE, 0x03)
+
+#define XUART_FRAMING_GET                                                       \
+    _IOR(XUART_IOCTL_TYPE, 0x04,enum xUartFraming)
+
+#define XUART_FRAMING_SET                                                       \
+    _IOW(XUART_IOCTL_TYPE, 0x05,enum xUartFraming)
+
+#define XUART_CRC_GET                                                           \
+    _IOR(XUART_IOCTL_TYPE, 0x06,struct xUartCrcState)
+
+#define XUART_CRC_SET                                                           \
+    _IOW(XUART_IOCTL_TYPE, 0x07,struct xUartCrcCfg)
+
+#define XUART_TRANSACT                                                          \
+    _IOW(XUART_IOCTL_TYPE, 0x08,struct xUartTransact)
+
+#define XUART_POLL_SET                                                          \
+    _IOW(XUART_IOCTL_TYPE, 0x09,struct xUartPollTable)
+
+#define XUART_POLL_START                                                        \
+    _IO(XUART_IOCTL_TYPE, 0x0a)
+
+#define XUART_POLL_STOP                                                         \
+    _IO(XUART_IOCTL_TYPE, 0x0b)
+
+#define XUART_POLL_WAIT                                                         \
+    _IOR(XUART_IOCTL_TYPE, 0x0c,struct xUartPollResult)
+
+#define XUART_FILTER_GET                                                        \
+    _IOR(XUART_IOCTL_TYPE, 0x0d,struct xUartFilter)
+
+#define XUART_FILTER_SET                                                        \
+    _IOW(XUART_IOCTL_TYPE, 0x0e,struct xUartFilter)
+
+#define XUART_WAKE_GET                                                          \
+    _IOR(XUART_IOCTL_TYPE, 0x0f,struct xUartWake)
+
+#define XUART_WAKE_SET                                                          \
+    _IOW(XUART_IOCTL_TYPE, 0x10,struct xUartWake)
+
+#define XUART_TAP_GET                                                           \
+    _IOR(XUART_IOCTL_TYPE, 0x11,struct xUartTap)
+
+#define XUART_TAP_SET                                                           \
+    _IOW(XUART_IOCTL_TYPE, 0x12,struct xUartTap)
+
+#define XUART_MUX_SET                                                           \
+    _IOW(XUART_IOCTL_TYPE, 0x13,uint32_t)
+
+#define XUART_CHANNEL_SET                                                       \
+    _IOW(XUART_IOCTL_TYPE, 0x14,uint32_t)
+
+#define XUART_SELFTEST                                                          \
+    _IOWR(XUART_IOCTL_TYPE, 0x15,struct xUartSelfTest)
+
+/**@brief       Enable (1) or disable (0) internal loopback for regular traffic
+ * @details     While enabled the transmitter is wired to the receiver inside
+ *              the UART and the line stays idle. It is disabled on close.
+ */
+#define XUART_LOOPBACK_SET                                                      \
+    _IOW(XUART_IOCTL_TYPE, 0x16,uint32_t)
+
+/**@brief       Line model of a virtual null-modem device, see struct xUartVnm
+ */
+#define XUART_VNM_GET                                                           \
+    _IOR(XUART_IOCTL_TYPE, 0x17,struct xUartVnm)
+
+#define XUART_VNM_SET                                                           \
+    _IOW(XUART_IOCTL_TYPE, 0x18,struct xUartVnm)
+
+/**@brief       Transfer engine of this open file, see enum xUartEngine
+ * @details     The engine is reset to the build default on open. Changing it
+ *              fails with -EBUSY while polling, framing, the self test or a
+ *              transfer is in progress, and with -ENOTSUPP when the engine is
+ *              not available in this build.
+ */
+#define XUART_ENGINE_GET                                                        \
+    _IOR(XUART_IOCTL_TYPE, 0x19,uint32_t)
+
+#define XUART_ENGINE_SET                                                        \
+    _IOW(XUART_IOCTL_TYPE, 0x1a,uint32_t)
+
+/**@brief       Threshold and statistics of the hybrid engine, see struct
+ *              xUartHybrid
+ * @details     Fails with -ENOTSUPP when the hybrid engine is not available in
+ *              this build. XUART_HYBRID_SET with a zero threshold starts the
+ *              calibration again and fails with -EBUSY while a DMA transfer
+ *              is running.
+ */
+#define XUART_HYBRID_GET                                                        \
+    _IOR(XUART_IOCTL_TYPE, 0x1b,struct xUartHybrid)
+
+#define XUART_HYBRID_SET                                                        \
+    _IOW(XUART_IOCTL_TYPE, 0x1c,struct xUartHybrid)
+
 /** @} *//*-------------------------------------------------------------------*/
 /*------------------------------------------------------  C++ extern begin  --*/
 #ifdef __cplusplus
@@ -67,7 +197,9 @@ extern "C" {
 enum xUartParity {
     XUART_PARITY_NONE,
     XUART_PARITY_EVEN,
-    XUART_PARITY_ODD
+    XUART_PARITY_ODD,
+    XUART_PARITY_MARK,                                                          /**<@brief Parity bit is always 1                           */
+    XUART_PARITY_SPACE                                                          /**<@brief Parity bit is always 0                           */
 };
 
 enum xUartDataBits {
@@ -81,13 +213,331 @@ enum xUartStopBits {
     XUART_STOP_2
 };
 
+/**@brief       Framing mode
+ * @details     When framing is enabled every write() sends one encoded frame
+ *              and every read() returns exactly one decoded frame. A frame
+ *              longer than the read buffer is truncated.
+ *
+ *              In Modbus RTU mode a frame ends after 3.5 character times of
+ *              silence and frames with a gap longer than 1.5 character times
+ *              are dropped. Before a frame is transmitted the line is kept
+ *              idle for at least 3.5 character times. Above 19200 baud the
+ *              fixed values of 750us and 1750us are used.
+ */
+enum xUartFraming {
+    XUART_FRAMING_NONE,                                                         /**<@brief Raw byte stream                                  */
+    XUART_FRAMING_SLIP,                                                         /**<@brief RFC 1055 SLIP                                    */
+    XUART_FRAMING_COBS,                                                         /**<@brief Consistent Overhead Byte Stuffing, 0x00 delimited*/
+    XUART_FRAMING_HDLC,                                                         /**<@brief HDLC-like 0x7E flag, 0x7D escape                 */
+    XUART_FRAMING_RTU                                                           /**<@brief Modbus RTU, frames delimited by t3.5 silence     */
+};
+
+/**@brief       CRC algorithm computed while data is transferred
+ */
+enum xUartCrc {
+    XUART_CRC_NONE,
+    XUART_CRC_16_CCITT,                                                         /**<@brief CRC-16/CCITT-FALSE                               */
+    XUART_CRC_16_MODBUS,                                                        /**<@brief CRC-16/MODBUS                                    */
+    XUART_CRC_32                                                                /**<@brief CRC-32 (IEEE 802.3)                              */
+};
+
+/**@brief       Status of the last RX or TX operation
+ */
+enum xUartStatus {
+    XUART_STATUS_NORMAL,
+    XUART_STATUS_SOFT_OVERFLOW,
+    XUART_STATUS_TIMEOUT,
+    XUART_STATUS_FAULT_USAGE,
+    XUART_STATUS_BUSY,
+    XUART_STATUS_BAD_FILE_NUMBER,
+    XUART_STATUS_UNHANDLED_INTERRUPT
+};
+
 struct xUartProto {
-    u32                 baud;
+    uint32_t            baud;
     enum xUartParity    parity;
     enum xUartDataBits  dataBits;
     enum xUartStopBits  stopBits;
 };
 
+/**@brief       Readiness levels reported by select()
+ * @details     The device is readable while at least @c rx bytes are waiting
+ *              in the receive buffer and writable while at least @c tx bytes
+ *              are free in the transmit buffer. Both levels must be between 1
+ *              and the internal buffer size.
+ */
+struct xUartRdyLevel {
+    uint32_t            rx;
+    uint32_t            tx;
+};
+
+/**@brief       CRC configuration
+ * @details     When @c isAppend is set the CRC of every write() is appended to
+ *              the transmitted data: CRC-16/CCITT most significant byte first,
+ *              CRC-16/MODBUS and CRC-32 least significant byte first. With
+ *              framing enabled the CRC is appended inside the frame.
+ */
+struct xUartCrcCfg {
+    uint32_t            type;                                                   /**<@brief See enum xUartCrc                                */
+    uint32_t            isAppend;
+};
+
+/**@brief       CRC of the data moved by the last read() and write() call
+ * @details     With framing enabled a read() covers exactly one frame.
+ */
+struct xUartCrcState {
+    uint32_t            rx;
+    uint32_t            tx;
+};
+
+/**@brief       Request/response transaction
+ * @details     The receiver is flushed and armed before the request is
+ *              transmitted, then the call waits for the response. The
+ *              response is complete when @c rxSize bytes are received, when
+ *              the byte @c term is received or, with framing enabled, when one
+ *              frame is received. The ioctl returns the number of response
+ *              bytes, or -ETIMEDOUT when nothing was received in time.
+ */
+struct xUartTransact {
+    const void *        tx;                                                     /**<@brief Request buffer                                   */
+    void *              rx;                                                     /**<@brief Response buffer                                  */
+    uint32_t            txSize;
+    uint32_t            rxSize;                                                 /**<@brief Response buffer size and expected length         */
+    int32_t             term;                                                   /**<@brief Terminator byte, or -1 when not used             */
+    uint32_t            timeout;                                                /**<@brief Response timeout in us, 0 for the default        */
+};
+
+/**@brief       Receive address filter mode
+ */
+enum xUartFilterType {
+    XUART_FILTER_NONE,
+    XUART_FILTER_MARK,                                                          /**<@brief 9-bit addressing, see struct xUartFilter         */
+    XUART_FILTER_ADDR                                                           /**<@brief First byte after t3.5 silence is the address     */
+};
+
+/**@brief       Receive address filter for multi-drop buses
+ * @details     A received address byte matches when it equals @c addr in all
+ *              bits set in @c mask, or when it equals @c broadcast. Bytes of
+ *              frames which are not addressed to this node are dropped in the
+ *              interrupt handler and never wake the reader. The address byte
+ *              itself is delivered with the frame.
+ *
+ *              With XUART_FILTER_MARK the line must use XUART_PARITY_SPACE:
+ *              address bytes are sent with mark parity and are recognized by
+ *              their parity error. With XUART_FILTER_ADDR frame boundaries
+ *              are detected by t3.5 silence or by the receive timeout.
+ *              Filtering is available with XUART_FRAMING_NONE and
+ *              XUART_FRAMING_RTU only.
+ */
+struct xUartFilter {
+    uint32_t            type;                                                   /**<@brief See enum xUartFilterType                         */
+    uint32_t            addr;
+    uint32_t            mask;
+    int32_t             broadcast;                                              /**<@brief Broadcast address, or -1 when not used           */
+};
+
+/**@brief       Wake conditions for read() without framing
+ * @details     When any condition is set, read() returns as soon as one of
+ *              them is met instead of waiting for the full buffer: a
+ *              delimiter byte was received (it is returned as the last byte),
+ *              @c count bytes were read, or the line was idle for @c idle us
+ *              after at least one byte was read. All fields set to zero
+ *              restore the default behaviour.
+ */
+struct xUartWake {
+    uint32_t            count;                                                  /**<@brief Minimum bytes to return, 0 when not used         */
+    uint32_t            idle;                                                   /**<@brief Idle time in us, 0 when not used                 */
+    uint32_t            delimCount;                                             /**<@brief Number of valid bytes in @c delim                */
+    uint8_t             delim[XUART_WAKE_DELIM_MAX];
+};
+
+/**@brief       What a tap does when its buffer is full
+ */
+enum xUartTapPolicy {
+    XUART_TAP_DROP_NEW,                                                         /**<@brief Keep buffered data, drop newly received bytes    */
+    XUART_TAP_DROP_OLD                                                          /**<@brief Make room by dropping the oldest buffered bytes  */
+};
+
+/**@brief       Tap (passive reader) state
+ * @details     The first open of the device owns the hardware. Every further
+ *              open creates a read-only tap which receives a copy of all
+ *              bytes accepted by the owner, before framing is decoded, into
+ *              its own buffer. A slow tap never blocks or drops data for the
+ *              owner. While a tap is attached the owner's receiver runs
+ *              continuously. read() on a tap returns as soon as any data is
+ *              available, and fails with -EBADF after the owner is closed.
+ *              Only XUART_TAP_GET, XUART_TAP_SET and XUART_CHANNEL_SET are
+ *              accepted by a tap.
+ *
+ *              Virtual channels: when the owner enables XUART_MUX_SET with
+ *              SLIP, COBS or HDLC framing, the first byte of every frame is a
+ *              channel number. Frames of channel 0 belong to the owner. A tap
+ *              bound to channel 1 to XUART_CHANNEL_MAX with XUART_CHANNEL_SET
+ *              receives only the frames of its channel, one frame per read(),
+ *              and its write() sends one frame on its channel. Writers of all
+ *              channels are served frame by frame in priority order.
+ */
+struct xUartTap {
+    uint32_t            policy;                                                 /**<@brief See enum xUartTapPolicy                          */
+    uint32_t            lost;                                                   /**<@brief Bytes dropped by this tap, read only             */
+};
+
+/**@brief       Status of one poll entry in a cycle
+ */
+enum xUartPollStatus {
+    XUART_POLL_OK,                                                              /**<@brief Response received                                */
+    XUART_POLL_TIMEOUT,                                                         /**<@brief No complete response, partial data is returned   */
+    XUART_POLL_SKIPPED,                                                         /**<@brief Entry was not due in this cycle                  */
+    XUART_POLL_OVERFLOW                                                         /**<@brief Receive overflow, the cycle was aborted          */
+};
+
+/**@brief       One request of the poll table
+ * @details     The response is complete when @c rspSize bytes are received
+ *              or, in Modbus RTU framing mode, when one frame is received.
+ *              The response timeout runs from the end of the request.
+ */
+struct xUartPollEntry {
+    uint32_t            reqSize;
+    uint32_t            rspSize;                                                /**<@brief Expected response size                           */
+    uint32_t            timeout;                                                /**<@brief Response timeout in us                           */
+    uint32_t            every;                                                  /**<@brief Poll in every n-th cycle, 0 is the same as 1     */
+    uint8_t             req[XUART_POLL_REQ_MAX];
+};
+
+/**@brief       Poll table executed by the driver on every cycle
+ */
+struct xUartPollTable {
+    uint32_t            period;                                                 /**<@brief Cycle period in us                               */
+    uint32_t            count;                                                  /**<@brief Number of valid entries                          */
+    struct xUartPollEntry entry[XUART_POLL_ENTRIES_MAX];
+};
+
+/**@brief       Response slot of one poll entry
+ */
+struct xUartPollSlot {
+    uint64_t            timestamp;                                              /**<@brief Time of the last received byte in ns             */
+    uint32_t            status;                                                 /**<@brief See enum xUartPollStatus                         */
+    uint32_t            size;
+    uint8_t             rsp[XUART_POLL_RSP_MAX];
+};
+
+/**@brief       Results of one complete poll cycle
+ * @details     Results are double buffered, so they must be collected within
+ *              one cycle period after XUART_POLL_WAIT returns.
+ */
+struct xUartPollResult {
+    uint32_t            cycle;                                                  /**<@brief Cycle sequence number                            */
+    uint32_t            errors;                                                 /**<@brief Entries which did not complete in this cycle     */
+    uint32_t            overruns;                                               /**<@brief Cycles started late since XUART_POLL_START       */
+    uint32_t            count;
+    struct xUartPollSlot slot[XUART_POLL_ENTRIES_MAX];
+};
+
+/**@brief       Sideband data returned by recvmsg() through msg_control
+ * @details     When msg_controllen is smaller than this structure no sideband
+ *              data is returned and msg_controllen is set to zero.
+ */
+struct xUartRxInfo {
+    uint64_t            timestamp;                                              /**<@brief Time of the last received byte in ns             */
+    uint32_t            status;                                                 /**<@brief Receiver status, see enum xUartStatus            */
+    uint32_t            size;                                                   /**<@brief Number of bytes returned by this call            */
+    uint32_t            crc;                                                    /**<@brief CRC of the bytes returned by this call           */
+};
+
+/**@brief       Data pattern used by the self test
+ */
+enum xUartSelfTestPattern {
+    XUART_SELFTEST_LINEAR,                                                      /**<@brief Byte value equals offset modulo 256              */
+    XUART_SELFTEST_ZERO,                                                        /**<@brief All bytes are 0x00                               */
+    XUART_SELFTEST_ONE,                                                         /**<@brief All bytes are 0xff                               */
+    XUART_SELFTEST_RANDOM                                                       /**<@brief Pseudo random sequence                           */
+};
+
+/**@brief       Internal loopback self test
+ * @details     The UART is switched to internal loopback (MCR) and @c size
+ *              bytes of the pattern are pumped through the regular write,
+ *              interrupt and read paths using the current protocol settings.
+ *              The line is not driven during the test. Fails with -EBUSY when
+ *              polling or framing is active. A received byte is compared with
+ *              the pattern at its position in the stream, so after a lost byte
+ *              every following byte is counted as an error, as are the bytes
+ *              not received in time.
+ */
+struct xUartSelfTest {
+    uint64_t            duration;                                               /**<@brief Output: test duration in ns                      */
+    uint64_t            isrTime;                                                /**<@brief Output: time spent in the ISR in ns              */
+    uint32_t            size;                                                   /**<@brief Number of bytes, 0 for the default               */
+    uint32_t            pattern;                                                /**<@brief Data pattern, see enum xUartSelfTestPattern      */
+    uint32_t            bytesPerSec;                                            /**<@brief Output: measured throughput                      */
+    uint32_t            irqs;                                                   /**<@brief Output: number of handled interrupts             */
+    uint32_t            irqsPerKiB;                                             /**<@brief Output: interrupts per 1024 bytes                */
+    uint32_t            errors;                                                 /**<@brief Output: wrong or missing bytes                   */
+};
+
+/**@brief       Transfer engines
+ * @details     Values up to XUART_ENGINE_DMA match CFG_DMA_MODE. The interrupt
+ *              and polled engines are available in every build, the soft DMA
+ *              and hybrid engines need CFG_DMA_MODE 1 and the hardware DMA
+ *              engine needs CFG_DMA_MODE 2.
+ */
+enum xUartEngine {
+    XUART_ENGINE_IRQ,                                                           /**<@brief FIFO serviced from the interrupt handler         */
+    XUART_ENGINE_SOFT_DMA,                                                      /**<@brief TX FIFO fed by DMA started from the interrupt    */
+    XUART_ENGINE_DMA,                                                           /**<@brief TX FIFO fed by DMA paced by UART DMA requests    */
+    XUART_ENGINE_POLL,                                                          /**<@brief FIFO serviced from a periodic timer, no IRQs     */
+    XUART_ENGINE_HYBRID                                                         /**<@brief Short bursts written to THR, long ones by DMA    */
+};
+
+/**@brief       Hybrid engine tuning
+ * @details     Every time the TX FIFO asks for data the hybrid engine compares
+ *              the buffered bytes with @c threshold. Up to the threshold the
+ *              bytes are written to THR, above it the contiguous part of the
+ *              TX buffer is handed to DMA. The engine times its first THR
+ *              bursts and DMA cycles, averages eight of each and sets the
+ *              threshold to the number of bytes written to THR in the CPU
+ *              time of one DMA cycle. Until then the threshold is the FIFO
+ *              size. The result is kept across opens. A fixed threshold is
+ *              set with CFG_HYBRID_THRESHOLD or XUART_HYBRID_SET.
+ *
+ *              XUART_HYBRID_SET uses only @c threshold, the other members are
+ *              reported by XUART_HYBRID_GET.
+ */
+struct xUartHybrid {
+    uint32_t            threshold;                                              /**<@brief Bytes, 0 to calibrate                            */
+    uint32_t            dmaSetup;                                               /**<@brief Output: CPU time of a DMA cycle in ns            */
+    uint32_t            pioByte;                                                /**<@brief Output: THR write time per byte in ns            */
+    uint32_t            dmaBursts;                                              /**<@brief Output: bursts sent by DMA                       */
+    uint32_t            pioBursts;                                              /**<@brief Output: bursts written to THR                    */
+};
+
+/**@brief       Line model of a virtual null-modem device
+ * @details     Virtual devices are registered in pairs connected back to back
+ *              when the module is built with CFG_VNM_PAIRS. Every byte written
+ *              to one device of the pair arrives at the other one after a
+ *              full character time of the configured protocol, so a pair
+ *              behaves like two UARTs connected with a null-modem cable. Bytes
+ *              sent while the protocols of both ends differ are counted as
+ *              mismatched and lost, like on a real line.
+ *
+ *              XUART_VNM_SET changes only @c jitter, @c corruptRate and
+ *              @c dropRate of the transmitting side, the other fields are
+ *              read only. All fields are reset when the device is opened.
+ *              Only XUART_PROTOCOL_GET, XUART_PROTOCOL_SET, XUART_RX_PERSIST,
+ *              XUART_LOOPBACK_SET and these two requests are accepted by a
+ *              virtual device.
+ */
+struct xUartVnm {
+    uint64_t            sent;                                                   /**<@brief Output: bytes put on the line                    */
+    uint64_t            received;                                               /**<@brief Output: bytes stored in the receive buffer       */
+    uint32_t            jitter;                                                 /**<@brief Maximum extra delivery delay in ns, up to 1s     */
+    uint32_t            corruptRate;                                            /**<@brief Bytes with one bit flipped, in ppm               */
+    uint32_t            dropRate;                                               /**<@brief Bytes lost on the line, in ppm                   */
+    uint32_t            corrupted;                                              /**<@brief Output: bytes corrupted on the line              */
+    uint32_t            dropped;                                                /**<@brief Output: bytes dropped on the line                */
+    uint32_t            mismatched;                                             /**<@brief Output: bytes received with a different protocol */
+    uint32_t            overflows;                                              /**<@brief Output: bytes lost to a full receive buffer      */
+};
+
 /** @} *//*-------------------------------------------------------------------*/
 /*======================================================  GLOBAL VARIABLES  ==*/
 
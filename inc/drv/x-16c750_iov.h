@@ -0,0 +1,102 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Scatter/gather copy between I/O vectors and driver buffers
+ *********************************************************************//** @{ */
+
+#if !defined(X_16C750_IOV_H_)
+#define X_16C750_IOV_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <rtdm/rtdm_driver.h>
+
+#include "arch/compiler.h"
+#include "drv/x-16c750_cfg.h"
+
+/*===============================================================  MACRO's  ==*/
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+
+enum ioDir {
+    IO_DIR_RX,
+    IO_DIR_TX
+};
+
+/**@brief       Cursor over I/O vector segments
+ * @details     Each copy advances the cursor, so a single pass over the
+ *              internal buffer fills or drains all segments in order.
+ */
+struct ioCursor {
+    struct iovec *      iov;
+    size_t              iovlen;
+};
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+void ioCursorInit(
+    struct ioCursor *   cur,
+    struct iovec *      iov,
+    size_t              iovlen);
+
+/**@brief       Fetch the segment array of a message and validate every segment
+ * @param       iov
+ *              Storage for at least CFG_DRV_IOV_MAX segments
+ * @return      Total size of all segments, or a negative error code
+ */
+ssize_t ioCursorFromMsg(
+    struct ioCursor *   cur,
+    struct iovec *      iov,
+    rtdm_user_info_t *  user,
+    const struct msghdr * msg,
+    enum ioDir          dir);
+
+int ioCursorCopyTo(
+    struct ioCursor *   cur,
+    rtdm_user_info_t *  user,
+    const uint8_t *     src,
+    size_t              size);
+
+int ioCursorCopyFrom(
+    struct ioCursor *   cur,
+    rtdm_user_info_t *  user,
+    uint8_t *           dst,
+    size_t              size);
+
+/*--------------------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x-16c750_iov.h
+ ******************************************************************************/
+#endif /* X_16C750_IOV_H_ */
@@ -109,6 +109,10 @@ enum hwReg {
 #define rbTLR                           rbXOFF2
 #define wbTLR                           wbXOFF2
 
+/**@brief       Size of RX and TX hardware FIFO in bytes
+ */
+#define DEF_FIFO_SIZE                   64U
+
 /** @} *//*---------------------------------------------------------------*//**
  * @name        Register bit definitions
  * @{ *//*--------------------------------------------------------------------*/
@@ -126,6 +130,7 @@ enum hwReg {
 
 /* MCR register bits                                                          */
 #define MCR_TCRTLR                      (1U << 6)
+#define MCR_LOOPBACKEN                  (1U << 4)
 
 /* FCR register bits                                                          */
 #define FCR_RX_FIFO_TRIG_Mask           (0x3u << 6)
@@ -239,6 +244,13 @@ enum hwReg {
 #define SSR_TXFIFOFULL                  (0x01U << 0)
 
 /* Line Status Register (LSR) : register bits                                 */
+#define LSR_RXFIFOSTS                   (0x01U << 7)
+#define LSR_TXSRE                       (0x01U << 6)
+#define LSR_TXFIFOE                     (0x01U << 5)
+#define LSR_RXBI                        (0x01U << 4)
+#define LSR_RXFE                        (0x01U << 3)
+#define LSR_RXPE                        (0x01U << 2)
+#define LSR_RXOE                        (0x01U << 1)
 #define LSR_RXFIFOE                     (0x01U << 0)
 
 /* Tx DMA Threshold Register (TXDMA) : register bits                          */
@@ -444,6 +456,17 @@ void lldEnhanced(
     volatile uint8_t *  io,
     enum lldState       state);
 
+/**@brief       Enable/disable internal loopback
+ * @param       io
+ *              Pointer to IO mapped memory
+ * @param       state
+ *  @arg        LLD_ENABLE
+ *  @arg        LLD_DISABLE
+ */
+void lldLoopbackSet(
+    volatile uint8_t *  io,
+    enum lldState       state);
+
 /**@} *//*----------------------------------------------------------------*//**
  * @name        Interrupt actions
  * @{ *//*--------------------------------------------------------------------*/
@@ -119,6 +119,25 @@ volatile uint8_t * portIORemapGet(
 bool_T portIsOnline(
     uint32_t            id);
 
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Buffer functions
+ * @{ *//*--------------------------------------------------------------------*/
+
+/**@brief       Allocate memory whose pages are mapped twice, back to back
+ * @param       size
+ *              Size in bytes, a multiple of the page size
+ * @return      Start of the first mapping or NULL. Byte @c size of the
+ *              returned memory is byte 0 again.
+ */
+void * portMirrorAlloc(
+    size_t              size);
+
+/**@brief       Release memory returned by portMirrorAlloc()
+ */
+void portMirrorFree(
+    void *              mem,
+    size_t              size);
+
 /**@} *//*----------------------------------------------------------------*//**
  * @name        DMA functions
  * @{ *//*--------------------------------------------------------------------*/
@@ -184,6 +203,9 @@ void portDMARxStopI(
  *              virtual address to that buffer
  * @param       devData
  *              Device data structure
+ * @return      Operation status
+ *  @retval     0 - success
+ *              negative errno - no DMA channel could be allocated
  */
 int32_t portDMATxInit(
     struct devData *    devData,
@@ -118,6 +118,7 @@ typedef enum boolType {
 #include <linux/types.h>
 typedef uint32_t uint_fast8_t;
 #else
+#include <stddef.h>
 #include <stdint.h>
 #endif
 
@@ -30,6 +30,9 @@
 
 #include <linux/kernel.h>
 #include <linux/ioport.h>
+#include <linux/mm.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
 
 #include <omap_hwmod.h>
 #include <omap_device.h>
@@ -117,7 +120,6 @@ struct devData {
 
 #if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
     struct dma {
-        struct hwAddr       addr;
         struct dmaPerUnit{
             struct edmacc_param param;
             size_t              chunk;
@@ -126,12 +128,27 @@ struct devData {
             void (* callback)(void *);
             void *              arg;
         }                   rx, tx;
-        rtdm_irq_t          irqHandle;
     }                   dma;
 #endif
     uint32_t            signature;
 };
 
+#if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
+/**@brief       EDMA completion dispatcher shared by all UART instances
+ * @details     The first initialized instance maps the TPCC and requests the
+ *              completion interrupt, the last terminated one releases them.
+ *              Channels register their transfer completion code in @c tcc and
+ *              the interrupt handler calls only the registered ones.
+ */
+struct edmaCtrl {
+    struct hwAddr       addr;
+    rtdm_irq_t          irqHandle;
+    rtdm_lock_t         lock;                                                   /**<@brief Protects the TCC table                           */
+    uint32_t            users;                                                  /**<@brief Number of initialized UART instances             */
+    struct dmaPerUnit * tcc[EDMA_TCC_NUM];                                      /**<@brief Channels indexed by transfer completion code     */
+};
+#endif
+
 /*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
 
 static int32_t baudRateCfgFindIndex(
@@ -173,6 +190,14 @@ static void edmaIntrClear(
 static int edmaHandleIrq(
     rtdm_irq_t *        handle);
 
+/**@brief       Route completions of the channel to its callback
+ */
+static void edmaTccAttach(
+    struct dmaPerUnit * unit);
+
+static void edmaTccDetach(
+    struct dmaPerUnit * unit);
+
 static int32_t edmaInit(
     struct devData *    devData);
 
@@ -202,6 +227,10 @@ static const uint32_t DIVdata[] = {
     BAUD_RATE_CFG_TABLE(BAUD_RATE_CFG_EXPAND_AS_DIV_DATA)
 };
 
+#if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
+static struct edmaCtrl  Edma;
+#endif
+
 /*======================================================  GLOBAL VARIABLES  ==*/
 
 const uint32_t PortIOmap[] = {
@@ -349,56 +378,77 @@ static void edmaIntrClear(
 static int edmaHandleIrq(
     rtdm_irq_t *        handle) {
 
-    struct devData *    devData;
-    volatile uint8_t *  io;
+    struct edmaCtrl *   ctrl;
     uint64_t            ipr;
+    uint32_t            tcc;
+    int                 retval;
 
     LOG_DBG("ISR DMA");
-    devData = rtdm_irq_get_arg(handle, struct devData);
-
-    io = devData->dma.addr.remap;
-    ipr = ((uint64_t)edmaShRd(io, EDMA_IPRH) << 32u) | (uint64_t)edmaShRd(io, EDMA_IPR);
-
-    if ((uint64_t)0ul != (ipr & ((uint64_t)0x1ul << devData->dma.rx.chn))) {
-        edmaShWr(
-            io,
-            EDMA_ICR,
-            (uint32_t)(0xffffu & ipr));
-        edmaShWr(
-            io,
-            EDMA_ICRH,
-            (uint32_t)(0xffffu & (ipr >> 32)));
-        ipr &= ~((uint64_t)0x1ul << devData->dma.rx.chn);
-        devData->dma.rx.isRunning = FALSE;
-
-        if (NULL != devData->dma.rx.callback) {
-            devData->dma.rx.callback(devData->dma.rx.arg);
+    ctrl   = rtdm_irq_get_arg(handle, struct edmaCtrl);
+    retval = RTDM_IRQ_NONE;
+    ipr    = ((uint64_t)edmaShRd(ctrl->addr.remap, EDMA_IPRH) << 32u) | (uint64_t)edmaShRd(ctrl->addr.remap, EDMA_IPR);
+    rtdm_lock_get(
+        &ctrl->lock);
+
+    for (tcc = 0u; (uint64_t)0u != ipr; tcc++, ipr >>= 1u) {
+        struct dmaPerUnit * unit;
+
+        unit = ctrl->tcc[tcc];
+
+        if (((uint64_t)0u == (ipr & (uint64_t)0x1u)) || (NULL == unit)) {
+
+            continue;                                                           /* Pending bits of other EDMA users are left alone          */
         }
-    }
+        edmaIntrClear(
+            ctrl->addr.remap,
+            tcc);
+        unit->isRunning = FALSE;
 
-    if ((uint64_t)0ul != (ipr & ((uint64_t)0x1ul << devData->dma.tx.chn))) {
-        edmaShWr(
-            io,
-            EDMA_ICR,
-            (uint32_t)(0xffffu & ipr));
-        edmaShWr(
-            io,
-            EDMA_ICRH,
-            (uint32_t)(0xffffu & (ipr >> 32)));
-        devData->dma.tx.isRunning = FALSE;
-        ipr &= ~((uint64_t)0x1ul << devData->dma.tx.chn);
-
-        if (NULL != devData->dma.tx.callback) {
-            devData->dma.tx.callback(devData->dma.tx.arg);
+        if (NULL != unit->callback) {
+            unit->callback(unit->arg);
         }
+        retval = RTDM_IRQ_HANDLED;
     }
+    rtdm_lock_put(
+        &ctrl->lock);
 
-    if ((uint64_t)0ul == ipr) {
+    return (retval);
+}
 
-        return (RTDM_IRQ_HANDLED);
-    }
+static void edmaTccAttach(
+    struct dmaPerUnit * unit) {
+
+    rtdm_lockctx_t      lockCtx;
+    uint32_t            tcc;
+
+    tcc = EDMA_CHAN_SLOT(unit->chn);                                            /* Begin functions set TCC to the channel number            */
+    ES_DBG_API_REQUIRE(ES_DBG_OUT_OF_RANGE, EDMA_TCC_NUM > tcc);
+    rtdm_lock_get_irqsave(
+        &Edma.lock,
+        lockCtx);
+    Edma.tcc[tcc] = unit;
+    rtdm_lock_put_irqrestore(
+        &Edma.lock,
+        lockCtx);
+}
+
+static void edmaTccDetach(
+    struct dmaPerUnit * unit) {
+
+    rtdm_lockctx_t      lockCtx;
+    uint32_t            tcc;
+
+    tcc = EDMA_CHAN_SLOT(unit->chn);
+    rtdm_lock_get_irqsave(
+        &Edma.lock,
+        lockCtx);
 
-    return (RTDM_IRQ_NONE);
+    if ((EDMA_TCC_NUM > tcc) && (unit == Edma.tcc[tcc])) {
+        Edma.tcc[tcc] = NULL;
+    }
+    rtdm_lock_put_irqrestore(
+        &Edma.lock,
+        lockCtx);
 }
 
 static int32_t edmaInit(
@@ -410,15 +460,27 @@ static int32_t edmaInit(
     struct resource *   res;
 #endif /* (0 == DEF_SUPPRESS_MEM_REQ_WARNING) */
 
-    devData->dma.addr.phy = (volatile uint8_t *)EDMA_TPCC_BASE;
-    devData->dma.addr.size = (size_t)EDMA_TPCC_SIZE;
-    LOG_DBG("EDMA mem start: %p", devData->dma.addr.phy);
-    LOG_DBG("EDMA mem size : %x", devData->dma.addr.size);
+    /*
+     * NOTE: Since DMA stop functions are called within module deinitialization
+     *       we must initialize these at this time.
+     */
+    devData->dma.rx.chn = EDMA_CHANNEL_ANY;
+    devData->dma.tx.chn = EDMA_CHANNEL_ANY;
+
+    if (0u != Edma.users) {                                                     /* Instances are initialized one at a time by module init   */
+        Edma.users++;
+
+        return (0);
+    }
+    Edma.addr.phy = (volatile uint8_t *)EDMA_TPCC_BASE;
+    Edma.addr.size = (size_t)EDMA_TPCC_SIZE;
+    LOG_DBG("EDMA mem start: %p", Edma.addr.phy);
+    LOG_DBG("EDMA mem size : %x", Edma.addr.size);
 
 #if (0 == DEF_SUPPRESS_MEM_REQ_WARNING)
     res = request_mem_region(
-        (resource_size_t)devData->dma.addr.phy,
-        (resource_size_t)devData->dma.addr.size,
+        (resource_size_t)Edma.addr.phy,
+        (resource_size_t)Edma.addr.size,
         CFG_DRV_NAME ".edma");
 
     if (NULL == res) {
@@ -427,48 +489,44 @@ static int32_t edmaInit(
         return (-ENOMEM);
     }
 #endif /* (0 == DEF_SUPPRESS_MEM_REQ_WARNING) */
-    devData->dma.addr.remap = ioremap(
-        (long unsigned int)devData->dma.addr.phy,
-        devData->dma.addr.size);
-    LOG_DBG("EDMA mem start (remap): %p", devData->dma.addr.remap);
+    Edma.addr.remap = ioremap(
+        (long unsigned int)Edma.addr.phy,
+        Edma.addr.size);
+    LOG_DBG("EDMA mem start (remap): %p", Edma.addr.remap);
 
-    if (NULL == devData->dma.addr.remap) {
+    if (NULL == Edma.addr.remap) {
         LOG_ERR("OMAP UART DMA: failed to remap memory, err: %d", ENOMEM);
 #if (0 == DEF_SUPPRESS_MEM_REQ_WARNING)
         release_mem_region(
-            (resource_size_t)devData->dma.addr.phy,
-            (resource_size_t)devData->dma.addr.size);
+            (resource_size_t)Edma.addr.phy,
+            (resource_size_t)Edma.addr.size);
 #endif /* (0 == DEF_SUPPRESS_MEM_REQ_WARNING) */
 
         return (-ENOMEM);
     }
+    rtdm_lock_init(
+        &Edma.lock);
     retval = (int32_t)rtdm_irq_request(
-        &devData->dma.irqHandle,
+        &Edma.irqHandle,
         EDMA_COMP_IRQ,
         edmaHandleIrq,
         RTDM_IRQTYPE_EDGE,
         CFG_DRV_NAME " DMA",
-        devData);
+        &Edma);
 
     if (0 != retval) {
         LOG_ERR("OMAP UART DMA: failed to request DMA IRQ, err: %d", -retval);
         iounmap(
-            devData->dma.addr.phy);
+            Edma.addr.remap);
 #if (0 == DEF_SUPPRESS_MEM_REQ_WARNING)
         release_mem_region(
-            (resource_size_t)devData->dma.addr.phy,
-            (resource_size_t)devData->dma.addr.size);
+            (resource_size_t)Edma.addr.phy,
+            (resource_size_t)Edma.addr.size);
 #endif /* (0 == DEF_SUPPRESS_MEM_REQ_WARNING) */
 
         return (retval);
     }
-
-    /*
-     * NOTE: Since DMA stop functions are called within module deinitialization
-     *       we must initialize these at this time.
-     */
-    devData->dma.rx.chn = EDMA_CHANNEL_ANY;
-    devData->dma.tx.chn = EDMA_CHANNEL_ANY;
+    Edma.users = 1u;
 
     return (0);
 }
@@ -481,22 +539,27 @@ static int32_t edmaTerm(
     LOG_DBG("OMAP UART DMA: terminating");
 
     retval = 0;
-    portDMATxStopI(
+    portDMATxTerm(
         devData);
-    portDMARxStopI(
+    portDMARxTerm(
         devData);
+
+    if (0u != --Edma.users) {
+
+        return (0);                                                             /* Other instances still use the dispatcher                 */
+    }
     retval = (int32_t)rtdm_irq_free(
-        &devData->dma.irqHandle);
+        &Edma.irqHandle);
 
     if (0 != retval) {
         LOG_ERR("OMAP UART DMA: failed to release IRQ, err: %d", -retval);
     }
     iounmap(
-        devData->dma.addr.remap);
+        Edma.addr.remap);
 #if (0 == DEF_SUPPRESS_MEM_REQ_WARNING)
     release_mem_region(
-        (resource_size_t)devData->dma.addr.phy,
-        (resource_size_t)devData->dma.addr.size);
+        (resource_size_t)Edma.addr.phy,
+        (resource_size_t)Edma.addr.size);
 #endif /* (0 == DEF_SUPPRESS_MEM_REQ_WARNING) */
 
     return (retval);
@@ -744,6 +807,78 @@ bool_T portIsOnline(
     return (ans);
 }
 
+void * portMirrorAlloc(
+    size_t              size) {
+
+    struct page *       page;
+    struct page **      pages;
+    void *              mem;
+    uint32_t            num;
+    uint32_t            cnt;
+
+    num = size >> PAGE_SHIFT;
+
+    if ((0u == num) || (size != ((size_t)num << PAGE_SHIFT))) {
+
+        return (NULL);
+    }
+    page = alloc_pages(                                                         /* Contiguous, so DMA sees the first mapping as one block   */
+        GFP_KERNEL,
+        get_order(size));
+
+    if (NULL == page) {
+
+        return (NULL);
+    }
+    pages = kmalloc(
+        2u * num * sizeof(struct page *),
+        GFP_KERNEL);
+
+    if (NULL == pages) {
+        __free_pages(
+            page,
+            get_order(size));
+
+        return (NULL);
+    }
+
+    for (cnt = 0u; cnt < num; cnt++) {
+        pages[cnt]       = nth_page(page, cnt);
+        pages[cnt + num] = nth_page(page, cnt);
+    }
+    mem = vmap(
+        pages,
+        2u * num,
+        VM_MAP,
+        PAGE_KERNEL);
+    kfree(
+        pages);
+
+    if (NULL == mem) {
+        __free_pages(
+            page,
+            get_order(size));
+    }
+    LOG_DBG("mirrored buffer: %p, %d bytes", mem, size);
+
+    return (mem);
+}
+
+void portMirrorFree(
+    void *              mem,
+    size_t              size) {
+
+    struct page *       page;
+
+    page = vmalloc_to_page(
+        mem);
+    vunmap(
+        mem);
+    __free_pages(
+        page,
+        get_order(size));
+}
+
 #if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
 int32_t portDMARxInit(
     struct devData *    devData,
@@ -765,10 +900,17 @@ int32_t portDMARxInit(
         edmaDummyCallback,
         NULL,
         EVENTQ_0);
+    LOG_DBG("DMA Rx: allocated channel: %d", retval);
+
+    if (0 > retval) {
+
+        return (retval);                                                        /* Channel stays EDMA_CHANNEL_ANY, Term has nothing to free */
+    }
     devData->dma.rx.chn = retval;
-    LOG_DBG("DMA Tx: allocated channel: %d", retval);
+    edmaTccAttach(
+        &devData->dma.rx);
 
-    return (retval);
+    return (0);
 }
 
 void portDMARxTerm(
@@ -778,6 +920,14 @@ void portDMARxTerm(
 
     portDMARxStopI(
         devData);
+
+    if (EDMA_CHANNEL_ANY != devData->dma.rx.chn) {
+        edmaTccDetach(
+            &devData->dma.rx);
+        edma_free_channel(
+            devData->dma.rx.chn);
+        devData->dma.rx.chn = EDMA_CHANNEL_ANY;
+    }
 }
 
 bool_T portDMARxIsRunning(
@@ -861,7 +1011,7 @@ void portDMARxStartI(
         devData->dma.rx.chn);
 #endif
     edmaIntrClear(
-        devData->dma.addr.remap,
+        Edma.addr.remap,
         devData->dma.rx.chn);
     retval = (int32_t)edma_start(
         devData->dma.rx.chn);
@@ -874,13 +1024,11 @@ void portDMARxStopI(
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, DEVDATA_SIGNATURE == devData->signature);
 
     if (EDMA_CHANNEL_ANY != devData->dma.rx.chn) {
-        LOG_DBG("DMA Rx: stop chn : %d", devData->dma.tx.chn);
+        LOG_DBG("DMA Rx: stop chn : %d", devData->dma.rx.chn);
         edma_stop(
-            devData->dma.rx.chn);
-        edma_free_channel(
-            devData->dma.rx.chn);
-        devData->dma.rx.chn = EDMA_CHANNEL_ANY;
+            devData->dma.rx.chn);                                              /* Channel is kept until Term, DMA may start again          */
     }
+    devData->dma.rx.isRunning = FALSE;
 }
 
 int32_t portDMATxInit(
@@ -905,9 +1053,16 @@ int32_t portDMATxInit(
         edmaDummyCallback,
         NULL,
         EVENTQ_1);
-    devData->dma.tx.chn = retval;
     LOG_DBG("DMA Tx: allocated channel: %d", retval);
 
+    if (0 > retval) {
+
+        return (retval);                                                        /* Channel stays EDMA_CHANNEL_ANY, Term has nothing to free */
+    }
+    devData->dma.tx.chn = retval;
+    edmaTccAttach(
+        &devData->dma.tx);
+
     return (0);
 }
 
@@ -918,6 +1073,14 @@ void portDMATxTerm(
 
     portDMATxStopI(
         devData);
+
+    if (EDMA_CHANNEL_ANY != devData->dma.tx.chn) {
+        edmaTccDetach(
+            &devData->dma.tx);
+        edma_free_channel(
+            devData->dma.tx.chn);
+        devData->dma.tx.chn = EDMA_CHANNEL_ANY;
+    }
 }
 
 bool_T portDMATxIsRunning(
@@ -1051,8 +1214,8 @@ void portDMATxStartI(
     int32_t             retval;
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, DEVDATA_SIGNATURE == devData->signature);
-    (void)edmaShRd(devData->dma.addr.remap, EDMA_ER);
-    (void)edmaShRd(devData->dma.addr.remap, EDMA_ERH);
+    (void)edmaShRd(Edma.addr.remap, EDMA_ER);
+    (void)edmaShRd(Edma.addr.remap, EDMA_ERH);
     LOG_DBG("DMA Tx: start chn %d", devData->dma.tx.chn);
 
 #if (1u == CFG_LOG_DBG_ENABLE)
@@ -1060,7 +1223,7 @@ void portDMATxStartI(
         devData->dma.tx.chn);
 #endif
     edmaIntrClear(
-        devData->dma.addr.remap,
+        Edma.addr.remap,
         devData->dma.tx.chn);
     retval = (int32_t)edma_start(
         devData->dma.tx.chn);
@@ -1075,11 +1238,9 @@ void portDMATxStopI(
     if (EDMA_CHANNEL_ANY != devData->dma.tx.chn) {
         LOG_DBG("DMA Tx: stop chn : %d", devData->dma.tx.chn);
         edma_stop(
-            devData->dma.tx.chn);
-        edma_free_channel(
-            devData->dma.tx.chn);
-        devData->dma.tx.chn = EDMA_CHANNEL_ANY;
+            devData->dma.tx.chn);                                              /* Channel is kept until Term, DMA may start again          */
     }
+    devData->dma.tx.isRunning = FALSE;
 }
 #endif
 
@@ -83,6 +83,7 @@
 #  define EDMA_CHN_RX                   (8u + 63u)
 # endif
 
+# define EDMA_TCC_NUM                   64u                                     /* Transfer completion codes of the TPCC                    */
 # define EDMA_SH_BASE                   0x2000u
 # define EDMA_SH_INCR                   0x200u                                  /* Increment to next shadow region                          */
 #endif
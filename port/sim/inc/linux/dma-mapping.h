@@ -0,0 +1,53 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Linux kernel shim for the host simulation
+ *********************************************************************//** @{ */
+
+#if !defined(SIM_LINUX_DMA_MAPPING_H_)
+#define SIM_LINUX_DMA_MAPPING_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <linux/kernel.h>
+
+/*===============================================================  MACRO's  ==*/
+/*============================================================  DATA TYPES  ==*/
+
+enum dma_data_direction {
+    DMA_BIDIRECTIONAL   = 0,
+    DMA_TO_DEVICE       = 1,
+    DMA_FROM_DEVICE     = 2,
+    DMA_NONE            = 3
+};
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of dma-mapping.h
+ ******************************************************************************/
+#endif /* SIM_LINUX_DMA_MAPPING_H_ */
@@ -0,0 +1,136 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Linux kernel shim for the host simulation
+ *********************************************************************//** @{ */
+
+#if !defined(SIM_LINUX_KERNEL_H_)
+#define SIM_LINUX_KERNEL_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+
+/*===============================================================  MACRO's  ==*/
+
+/*------------------------------------------------------------------------*//**
+ * @name        Kernel annotations
+ * @{ *//*--------------------------------------------------------------------*/
+
+#define __init
+#define __exit
+#define __user
+#define __iomem
+
+#define KERN_ERR                        "<3>"
+#define KERN_WARNING                    "<4>"
+#define KERN_INFO                       "<6>"
+
+/**@brief       Kernel internal error code, not visible to user space
+ */
+#define ENOTSUPP                        524
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Kernel helpers
+ * @{ *//*--------------------------------------------------------------------*/
+
+#define min(a, b)                                                               \
+    (((a) < (b)) ? (a) : (b))
+
+#define max(a, b)                                                               \
+    (((a) > (b)) ? (a) : (b))
+
+#define container_of(ptr, type, member)                                         \
+    ((type *)((char *)(ptr) - offsetof(type, member)))
+
+#define ARRAY_SIZE(array)                                                       \
+    (sizeof(array) / sizeof((array)[0]))
+
+#define likely(expr)                    __builtin_expect(!!(expr), 1)
+#define unlikely(expr)                  __builtin_expect(!!(expr), 0)
+
+/**@brief       The simulated machine has a single CPU, but the core thread and
+ *              the application threads run on different host CPUs
+ */
+#define smp_mb()                        __sync_synchronize()
+#define smp_rmb()                       __sync_synchronize()
+#define smp_wmb()                       __sync_synchronize()
+#define smp_read_barrier_depends()      do { } while (0)
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Module declarations
+ * @details     The simulation host calls moduleInit() and moduleTerm()
+ *              directly, see port/sim/plat_sim.h
+ * @{ *//*--------------------------------------------------------------------*/
+
+#define MODULE_LICENSE(license)         extern int simModuleUnused_
+#define MODULE_AUTHOR(author)           extern int simModuleUnused_
+#define MODULE_DESCRIPTION(desc)        extern int simModuleUnused_
+#define MODULE_SUPPORTED_DEVICE(dev)    extern int simModuleUnused_
+#define EXPORT_SYMBOL(sym)              extern int simModuleUnused_
+#define module_init(fn)                 extern int simModuleUnused_
+#define module_exit(fn)                 extern int simModuleUnused_
+
+/** @} *//*---------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/**@brief       Print a kernel message on standard error output
+ */
+int printk(
+    const char *        fmt,
+    ...) __attribute__((format(printf, 1, 2)));
+
+/**@brief       Access a register of the simulated 16C750, see plat_sim.c
+ */
+uint16_t ioread16(
+    volatile void *     addr);
+
+void iowrite16(
+    uint16_t            val,
+    volatile void *     addr);
+
+/*--------------------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of kernel.h
+ ******************************************************************************/
+#endif /* SIM_LINUX_KERNEL_H_ */
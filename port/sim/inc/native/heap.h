@@ -0,0 +1,91 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Xenomai native heap shim for the host simulation
+ *********************************************************************//** @{ */
+
+#if !defined(SIM_NATIVE_HEAP_H_)
+#define SIM_NATIVE_HEAP_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <stddef.h>
+
+/*===============================================================  MACRO's  ==*/
+
+#define H_PRIO                          0x0001
+#define H_SINGLE                        0x0004
+#define H_DMA                           0x0100
+
+#define TM_INFINITE                     0
+#define TM_NONBLOCK                     (-1)
+
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+
+/**@brief       Heap backed by the host allocator, H_SINGLE heaps hold one
+ *              block only
+ */
+typedef struct rtHeap {
+    size_t              size;
+    void *              block;
+} RT_HEAP;
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+int rt_heap_create(
+    RT_HEAP *           heap,
+    const char *        name,
+    size_t              heapsize,
+    int                 mode);
+
+int rt_heap_delete(
+    RT_HEAP *           heap);
+
+int rt_heap_alloc(
+    RT_HEAP *           heap,
+    size_t              size,
+    long long           timeout,
+    void **             blockp);
+
+int rt_heap_free(
+    RT_HEAP *           heap,
+    void *              block);
+
+/*--------------------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of heap.h
+ ******************************************************************************/
+#endif /* SIM_NATIVE_HEAP_H_ */
@@ -0,0 +1,115 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       RTDM user API shim for the host simulation
+ *********************************************************************//** @{ */
+
+#if !defined(SIM_RTDM_H_)
+#define SIM_RTDM_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+/*===============================================================  MACRO's  ==*/
+
+#define RTDM_API_VER                    8
+
+#define RTDM_CLASS_SERIAL               2
+#define RTDM_CLASS_TESTING              6
+
+/*------------------------------------------------------------------------*//**
+ * @name        Timeout values
+ * @{ *//*--------------------------------------------------------------------*/
+
+#define RTDM_TIMEOUT_INFINITE           0
+#define RTDM_TIMEOUT_NONE               (-1)
+
+/** @} *//*---------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+
+typedef uint64_t nanosecs_abs_t;
+typedef int64_t  nanosecs_rel_t;
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/*------------------------------------------------------------------------*//**
+ * @name        Device access
+ * @details     Calls are routed to the handlers of the registered device
+ *              within the calling thread. The device handlers receive a NULL
+ *              user info, the same as for calls made from kernel space.
+ * @{ *//*--------------------------------------------------------------------*/
+
+int rt_dev_open(
+    const char *        path,
+    int                 oflag,
+    ...);
+
+int rt_dev_close(
+    int                 fd);
+
+int rt_dev_ioctl(
+    int                 fd,
+    int                 request,
+    ...);
+
+ssize_t rt_dev_read(
+    int                 fd,
+    void *              buf,
+    size_t              nbyte);
+
+ssize_t rt_dev_write(
+    int                 fd,
+    const void *        buf,
+    size_t              nbyte);
+
+ssize_t rt_dev_recvmsg(
+    int                 fd,
+    struct msghdr *     msg,
+    int                 flags);
+
+ssize_t rt_dev_sendmsg(
+    int                 fd,
+    const struct msghdr * msg,
+    int                 flags);
+
+/** @} *//*-----------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of rtdm.h
+ ******************************************************************************/
+#endif /* SIM_RTDM_H_ */
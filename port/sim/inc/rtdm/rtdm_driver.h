@@ -0,0 +1,483 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       RTDM driver API shim for the host simulation
+ *********************************************************************//** @{ */
+
+#if !defined(SIM_RTDM_DRIVER_H_)
+#define SIM_RTDM_DRIVER_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <linux/kernel.h>
+#include <rtdm/rtdm.h>
+
+/*===============================================================  MACRO's  ==*/
+
+/*------------------------------------------------------------------------*//**
+ * @name        Device registration
+ * @{ *//*--------------------------------------------------------------------*/
+
+#define RTDM_EXCLUSIVE                  0x0001
+#define RTDM_NAMED_DEVICE               0x0010
+#define RTDM_PROTOCOL_DEVICE            0x0020
+
+#define RTDM_DEVICE_STRUCT_VER          5
+#define RTDM_MAX_DEVNAME_LEN            31
+
+#define RTDM_DRIVER_VER(major, minor, patch)                                    \
+    (((major & 0xFF) << 16) | ((minor & 0xFF) << 8) | (patch & 0xFF))
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Interrupt management
+ * @{ *//*--------------------------------------------------------------------*/
+
+#define RTDM_IRQTYPE_SHARED             0x0001
+#define RTDM_IRQTYPE_EDGE               0x0002
+
+#define RTDM_IRQ_NONE                   0x0001
+#define RTDM_IRQ_HANDLED                0x0002
+
+#define rtdm_irq_get_arg(irqHandle, type)                                       \
+    ((type *)(irqHandle)->arg)
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Spinlocks
+ * @details     All locks map to the simulation core lock. Holding it keeps the
+ *              core thread from dispatching interrupts and timers, the same
+ *              way a spinlock with interrupts disabled does on a single CPU.
+ * @{ *//*--------------------------------------------------------------------*/
+
+#define RTDM_LOCK_UNLOCKED              0
+
+#define rtdm_lock_init(lock)                                                    \
+    do { *(lock) = RTDM_LOCK_UNLOCKED; } while (0)
+
+#define rtdm_lock_get(lock)                                                     \
+    do { (void)(lock); simCoreLock(); } while (0)
+
+#define rtdm_lock_put(lock)                                                     \
+    do { (void)(lock); simCoreUnlock(); } while (0)
+
+#define rtdm_lock_get_irqsave(lock, context)                                    \
+    do { (void)(lock); (context) = 0; simCoreLock(); } while (0)
+
+#define rtdm_lock_put_irqrestore(lock, context)                                 \
+    do { (void)(lock); (void)(context); simCoreUnlock(); } while (0)
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Utility
+ * @{ *//*--------------------------------------------------------------------*/
+
+#define rtdm_printk                     printk
+
+#define rtdm_malloc(size)               malloc(size)
+#define rtdm_free(ptr)                  free(ptr)
+
+/** @} *//*---------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+
+struct rtdm_dev_context;
+struct rtdm_device;
+
+/**@brief       Calls made through rt_dev_*() carry no user info
+ */
+typedef struct rtdm_user_info rtdm_user_info_t;
+
+typedef int rtdm_lock_t;
+typedef unsigned long rtdm_lockctx_t;
+
+typedef nanosecs_abs_t rtdm_toseq_t;
+
+typedef struct rtdm_selector rtdm_selector_t;
+
+enum rtdm_selecttype {
+    RTDM_SELECTTYPE_READ,
+    RTDM_SELECTTYPE_WRITE,
+    RTDM_SELECTTYPE_EXCEPT
+};
+
+enum rtdm_timer_mode {
+    RTDM_TIMERMODE_RELATIVE,
+    RTDM_TIMERMODE_ABSOLUTE,
+    RTDM_TIMERMODE_REALTIME
+};
+
+/*------------------------------------------------------------------------*//**
+ * @name        Device description
+ * @{ *//*--------------------------------------------------------------------*/
+
+typedef int (* rtdm_open_handler_t)(
+    struct rtdm_dev_context * context,
+    rtdm_user_info_t *  user_info,
+    int                 oflag);
+
+typedef int (* rtdm_socket_handler_t)(
+    struct rtdm_dev_context * context,
+    rtdm_user_info_t *  user_info,
+    int                 protocol);
+
+typedef int (* rtdm_close_handler_t)(
+    struct rtdm_dev_context * context,
+    rtdm_user_info_t *  user_info);
+
+typedef int (* rtdm_ioctl_handler_t)(
+    struct rtdm_dev_context * context,
+    rtdm_user_info_t *  user_info,
+    unsigned int        request,
+    void __user *       arg);
+
+typedef int (* rtdm_select_bind_handler_t)(
+    struct rtdm_dev_context * context,
+    rtdm_selector_t *   selector,
+    enum rtdm_selecttype type,
+    unsigned            fd_index);
+
+typedef ssize_t (* rtdm_read_handler_t)(
+    struct rtdm_dev_context * context,
+    rtdm_user_info_t *  user_info,
+    void *              buf,
+    size_t              nbyte);
+
+typedef ssize_t (* rtdm_write_handler_t)(
+    struct rtdm_dev_context * context,
+    rtdm_user_info_t *  user_info,
+    const void *        buf,
+    size_t              nbyte);
+
+typedef ssize_t (* rtdm_recvmsg_handler_t)(
+    struct rtdm_dev_context * context,
+    rtdm_user_info_t *  user_info,
+    struct msghdr *     msg,
+    int                 flags);
+
+typedef ssize_t (* rtdm_sendmsg_handler_t)(
+    struct rtdm_dev_context * context,
+    rtdm_user_info_t *  user_info,
+    const struct msghdr * msg,
+    int                 flags);
+
+struct rtdm_operations {
+    rtdm_close_handler_t close_rt;
+    rtdm_close_handler_t close_nrt;
+    rtdm_ioctl_handler_t ioctl_rt;
+    rtdm_ioctl_handler_t ioctl_nrt;
+    rtdm_select_bind_handler_t select_bind;
+    rtdm_read_handler_t read_rt;
+    rtdm_read_handler_t read_nrt;
+    rtdm_write_handler_t write_rt;
+    rtdm_write_handler_t write_nrt;
+    rtdm_recvmsg_handler_t recvmsg_rt;
+    rtdm_recvmsg_handler_t recvmsg_nrt;
+    rtdm_sendmsg_handler_t sendmsg_rt;
+    rtdm_sendmsg_handler_t sendmsg_nrt;
+};
+
+struct rtdm_dev_context {
+    unsigned long       context_flags;
+    int                 fd;
+    struct rtdm_operations * ops;
+    struct rtdm_device * device;
+    char                dev_private[0] __attribute__((aligned(sizeof(void *))));
+};
+
+struct rtdm_device {
+    int                 struct_version;
+    int                 device_flags;
+    size_t              context_size;
+    char                device_name[RTDM_MAX_DEVNAME_LEN + 1];
+    int                 protocol_family;
+    int                 socket_type;
+    rtdm_open_handler_t open_rt;
+    rtdm_open_handler_t open_nrt;
+    rtdm_socket_handler_t socket_rt;
+    rtdm_socket_handler_t socket_nrt;
+    struct rtdm_operations ops;
+    int                 device_class;
+    int                 device_sub_class;
+    int                 profile_version;
+    const char *        driver_name;
+    int                 driver_version;
+    const char *        peripheral_name;
+    const char *        provider_name;
+    const char *        proc_name;
+    int                 device_id;
+    void *              device_data;
+};
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Synchronisation objects
+ * @{ *//*--------------------------------------------------------------------*/
+
+typedef struct rtdm_event {
+    pthread_mutex_t     mutex;
+    pthread_cond_t      cond;
+    uint32_t            gen;                                                    /**<@brief Incremented on every signal                      */
+    bool                isPending;
+    bool                isDestroyed;
+} rtdm_event_t;
+
+typedef struct rtdm_sem {
+    pthread_mutex_t     mutex;
+    pthread_cond_t      cond;
+    unsigned long       value;
+    bool                isDestroyed;
+} rtdm_sem_t;
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Interrupts and timers
+ * @details     Both are dispatched by the simulation core thread while it
+ *              holds the core lock.
+ * @{ *//*--------------------------------------------------------------------*/
+
+typedef struct rtdm_irq rtdm_irq_t;
+
+typedef int (* rtdm_irq_handler_t)(
+    rtdm_irq_t *        irq_handle);
+
+struct rtdm_irq {
+    rtdm_irq_handler_t  handler;
+    void *              arg;
+    unsigned int        irq;
+};
+
+typedef struct rtdm_timer rtdm_timer_t;
+
+typedef void (* rtdm_timer_handler_t)(
+    rtdm_timer_t *      timer);
+
+struct rtdm_timer {
+    rtdm_timer_handler_t handler;
+    const char *        name;
+    nanosecs_abs_t      expiry;
+    nanosecs_rel_t      interval;
+    bool                isArmed;
+    struct rtdm_timer * next;
+};
+
+/** @} *//*-------------------------------------------------------------------*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/*------------------------------------------------------------------------*//**
+ * @name        Simulation core lock
+ * @{ *//*--------------------------------------------------------------------*/
+
+void simCoreLock(
+    void);
+
+void simCoreUnlock(
+    void);
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Device registration
+ * @{ *//*--------------------------------------------------------------------*/
+
+int rtdm_dev_register(
+    struct rtdm_device * device);
+
+int rtdm_dev_unregister(
+    struct rtdm_device * device,
+    unsigned int        poll_delay);
+
+static inline void * rtdm_context_to_private(
+    struct rtdm_dev_context * context) {
+
+    return ((void *)context->dev_private);
+}
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Clock and task services
+ * @{ *//*--------------------------------------------------------------------*/
+
+nanosecs_abs_t rtdm_clock_read(
+    void);
+
+nanosecs_abs_t rtdm_clock_read_monotonic(
+    void);
+
+int rtdm_task_sleep(
+    nanosecs_rel_t      delay);
+
+int rtdm_task_sleep_abs(
+    nanosecs_abs_t      wakeup_time,
+    enum rtdm_timer_mode mode);
+
+int rtdm_in_rt_context(
+    void);
+
+void rtdm_toseq_init(
+    rtdm_toseq_t *      timeout_seq,
+    nanosecs_rel_t      timeout);
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Events and semaphores
+ * @{ *//*--------------------------------------------------------------------*/
+
+void rtdm_event_init(
+    rtdm_event_t *      event,
+    unsigned long       pending);
+
+void rtdm_event_destroy(
+    rtdm_event_t *      event);
+
+void rtdm_event_signal(
+    rtdm_event_t *      event);
+
+void rtdm_event_pulse(
+    rtdm_event_t *      event);
+
+void rtdm_event_clear(
+    rtdm_event_t *      event);
+
+int rtdm_event_wait(
+    rtdm_event_t *      event);
+
+int rtdm_event_timedwait(
+    rtdm_event_t *      event,
+    nanosecs_rel_t      timeout,
+    rtdm_toseq_t *      timeout_seq);
+
+int rtdm_event_select_bind(
+    rtdm_event_t *      event,
+    rtdm_selector_t *   selector,
+    enum rtdm_selecttype type,
+    unsigned            fd_index);
+
+void rtdm_sem_init(
+    rtdm_sem_t *        sem,
+    unsigned long       value);
+
+void rtdm_sem_destroy(
+    rtdm_sem_t *        sem);
+
+int rtdm_sem_down(
+    rtdm_sem_t *        sem);
+
+int rtdm_sem_timeddown(
+    rtdm_sem_t *        sem,
+    nanosecs_rel_t      timeout,
+    rtdm_toseq_t *      timeout_seq);
+
+void rtdm_sem_up(
+    rtdm_sem_t *        sem);
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Interrupts and timers
+ * @{ *//*--------------------------------------------------------------------*/
+
+int rtdm_irq_request(
+    rtdm_irq_t *        irq_handle,
+    unsigned int        irq_no,
+    rtdm_irq_handler_t  handler,
+    unsigned long       flags,
+    const char *        device_name,
+    void *              arg);
+
+int rtdm_irq_free(
+    rtdm_irq_t *        irq_handle);
+
+int rtdm_timer_init(
+    rtdm_timer_t *      timer,
+    rtdm_timer_handler_t handler,
+    const char *        name);
+
+void rtdm_timer_destroy(
+    rtdm_timer_t *      timer);
+
+int rtdm_timer_start(
+    rtdm_timer_t *      timer,
+    nanosecs_abs_t      expiry,
+    nanosecs_rel_t      interval,
+    enum rtdm_timer_mode mode);
+
+void rtdm_timer_stop(
+    rtdm_timer_t *      timer);
+
+int rtdm_timer_start_in_handler(
+    rtdm_timer_t *      timer,
+    nanosecs_abs_t      expiry,
+    nanosecs_rel_t      interval,
+    enum rtdm_timer_mode mode);
+
+void rtdm_timer_stop_in_handler(
+    rtdm_timer_t *      timer);
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        User space access
+ * @details     Every address is directly accessible in the simulation.
+ * @{ *//*--------------------------------------------------------------------*/
+
+int rtdm_read_user_ok(
+    rtdm_user_info_t *  user_info,
+    const void __user * ptr,
+    size_t              size);
+
+int rtdm_rw_user_ok(
+    rtdm_user_info_t *  user_info,
+    const void __user * ptr,
+    size_t              size);
+
+int rtdm_copy_from_user(
+    rtdm_user_info_t *  user_info,
+    void *              dst,
+    const void __user * src,
+    size_t              size);
+
+int rtdm_safe_copy_from_user(
+    rtdm_user_info_t *  user_info,
+    void *              dst,
+    const void __user * src,
+    size_t              size);
+
+int rtdm_copy_to_user(
+    rtdm_user_info_t *  user_info,
+    void __user *       dst,
+    const void *        src,
+    size_t              size);
+
+int rtdm_safe_copy_to_user(
+    rtdm_user_info_t *  user_info,
+    void __user *       dst,
+    const void *        src,
+    size_t              size);
+
+/** @} *//*-----------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of rtdm_driver.h
+ ******************************************************************************/
+#endif /* SIM_RTDM_DRIVER_H_ */
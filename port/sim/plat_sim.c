@@ -0,0 +1,1293 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Platform port for the host simulation
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <linux/kernel.h>
+#include <rtdm/rtdm_driver.h>
+
+#include "drv/x-16c750.h"
+#include "drv/x-16c750_cfg.h"
+#include "drv/x-16c750_lld.h"
+#include "port/port.h"
+#include "dbg/dbg.h"
+#include "plat_sim.h"
+#include "sim_core.h"
+#include "log.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+#define BAUD_RATE_CFG_EXPAND_AS_BAUD(a, b, c)                                   \
+    a,
+
+#define BAUD_RATE_CFG_EXPAND_AS_MDR_DATA(a, b, c)                               \
+    b,
+
+#define BAUD_RATE_CFG_EXPAND_AS_DIV_DATA(a, b, c)                               \
+    c,
+
+#define DEVDATA_SIGNATURE               0xDEADBEEA
+
+/**@brief       Size of the IO window of one UART
+ */
+#define DEF_IO_SIZE                     0x100U
+
+/**@brief       Silent character times which trigger the RX timeout interrupt
+ */
+#define DEF_RX_TIMEOUT_CHARS            4U
+
+/**@brief       Flags stored with a character above the data byte
+ */
+#define ITEM_DATA_Mask                  0x00FFU
+#define ITEM_PARITY                     (0x1U << 8)                             /* Value of the parity bit on the line                      */
+#define ITEM_HAS_PARITY                 (0x1U << 9)
+#define ITEM_PE                         (0x1U << 10)                            /* Parity error detected by the receiver                    */
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+
+enum uartId {
+    UART_DATA_TABLE(UART_DATA_EXPAND_AS_UART)
+    LAST_UART_ENTRY
+};
+
+/**@brief       Registers which share an address offset
+ */
+enum simReg {
+    SIM_RHR_THR,
+    SIM_DLL,
+    SIM_DLH,
+    SIM_IER,
+    SIM_IIR_FCR,
+    SIM_EFR,
+    SIM_LCR,
+    SIM_MCR,
+    SIM_LSR,
+    SIM_MSR_TCR,
+    SIM_TLR,
+    SIM_SPR,
+    SIM_XON1,
+    SIM_XON2,
+    SIM_XOFF1,
+    SIM_XOFF2,
+    SIM_PLAIN                                                                   /* Register is not banked                                   */
+};
+
+struct simFifo {
+    uint16_t            item[DEF_FIFO_SIZE];
+    uint32_t            head;
+    uint32_t            tail;
+    uint32_t            occ;
+};
+
+struct simRing {
+    uint8_t             item[PORT_SIM_REMOTE_SIZE];
+    uint32_t            head;
+    uint32_t            tail;
+    uint32_t            occ;
+};
+
+/**@brief       State of one simulated 16C750
+ * @details     The model keeps its own time and is brought up to the current
+ *              time before each register access and each time the core thread
+ *              wakes up. Characters complete at exact multiples of the
+ *              character time, so the FIFO levels seen by the driver are the
+ *              same as on the hardware running at the same baud rate.
+ */
+struct simUart {
+    uint32_t            id;
+    uint16_t            reg[DEF_IO_SIZE / 4U];                                  /* Registers which are not banked                           */
+    uint16_t            dll;
+    uint16_t            dlh;
+    uint16_t            ier;
+    uint16_t            fcr;
+    uint16_t            efr;
+    uint16_t            lcr;
+    uint16_t            mcr;
+    uint16_t            tcr;
+    uint16_t            tlr;
+    uint16_t            spr;
+    uint16_t            xon[2];
+    uint16_t            xoff[2];
+    struct simFifo      rx;
+    struct simFifo      tx;
+    bool_T              isOverrun;
+    bool_T              isShifting;
+    uint16_t            shift;                                                  /* Character in the TX shift register                       */
+    nanosecs_abs_t      shiftEnd;
+    nanosecs_abs_t      rxStamp;                                                /* Last RX FIFO activity, for the RX timeout                */
+    nanosecs_abs_t      now;
+    struct simUart *    peer;
+    struct simRing      remoteTx;                                               /* Far end to UART                                          */
+    struct simRing      remoteRx;                                               /* UART to far end                                          */
+    bool_T              isRemoteActive;
+    nanosecs_abs_t      remoteNext;
+    bool_T              isIrq;
+    struct portSimStats stats;
+};
+
+struct devData {
+    struct simUart *    uart;
+    uint32_t            signature;
+};
+
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static int32_t baudRateCfgFindIndex(
+    uint32_t            baudrate);
+
+static void fifoPut(
+    struct simFifo *    fifo,
+    uint16_t            item);
+
+static uint16_t fifoGet(
+    struct simFifo *    fifo);
+
+static void fifoFlush(
+    struct simFifo *    fifo);
+
+static bool_T ringPut(
+    struct simRing *    ring,
+    uint8_t             item);
+
+static uint8_t ringGet(
+    struct simRing *    ring);
+
+static nanosecs_rel_t uartCharTime(
+    const struct simUart * uart);
+
+static uint16_t uartParity(
+    uint16_t            lcr,
+    uint8_t             data);
+
+static uint32_t uartRxTrig(
+    const struct simUart * uart);
+
+static uint32_t uartTxTrig(
+    const struct simUart * uart);
+
+static void uartReset(
+    struct simUart *    uart);
+
+static void uartRxPut(
+    struct simUart *    uart,
+    uint16_t            item,
+    nanosecs_abs_t      when);
+
+static void uartTxDone(
+    struct simUart *    uart,
+    nanosecs_abs_t      when);
+
+static void uartStart(
+    struct simUart *    uart);
+
+static void uartAdvance(
+    struct simUart *    uart,
+    nanosecs_abs_t      now);
+
+static uint16_t uartIIR(
+    const struct simUart * uart);
+
+static uint16_t uartLSR(
+    const struct simUart * uart);
+
+static nanosecs_abs_t uartNextEvent(
+    const struct simUart * uart);
+
+static enum simReg uartDecode(
+    const struct simUart * uart,
+    uint32_t            offset);
+
+static nanosecs_abs_t simAdvanceL(
+    void *              arg,
+    nanosecs_abs_t      now);
+
+static struct simUart * simAccessBegin(
+    volatile void *     addr,
+    uint32_t *          offset);
+
+static void simAccessEnd(
+    struct simUart *    uart);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+DECL_MODULE_INFO("plat_sim", "Platform port for the host simulation", "Nenad Radulovic");
+
+static const uint32_t BaudRateData[] = {
+    BAUD_RATE_CFG_TABLE(BAUD_RATE_CFG_EXPAND_AS_BAUD)
+    0
+};
+
+static const enum lldMode ModeData[] = {
+    BAUD_RATE_CFG_TABLE(BAUD_RATE_CFG_EXPAND_AS_MDR_DATA)
+};
+
+static const uint32_t DIVdata[] = {
+    BAUD_RATE_CFG_TABLE(BAUD_RATE_CFG_EXPAND_AS_DIV_DATA)
+};
+
+/**@brief       Address space of the simulated UARTs, it is never dereferenced
+ */
+static uint8_t          IoSpace[LAST_UART_ENTRY][DEF_IO_SIZE];
+
+static struct simUart   Uart[LAST_UART_ENTRY];
+
+static struct simCoreHook SimHook = {
+    .advance            = simAdvanceL,
+    .arg                = NULL,
+    .next               = NULL
+};
+
+static uint32_t         SimUsers;
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+
+const uint32_t PortIOmap[] = {
+    UART_DATA_TABLE(UART_DATA_EXPAND_AS_MEM)
+};
+
+const uint32_t PortIRQ[] = {
+    UART_DATA_TABLE(UART_DATA_EXPAND_AS_IRQ)
+};
+
+const uint32_t PortUartNum = LAST_UART_ENTRY;
+
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+static int32_t baudRateCfgFindIndex(
+    uint32_t            baudrate) {
+
+    uint32_t            cnt;
+
+    cnt = 0U;
+
+    while ((0U != BaudRateData[cnt]) && (baudrate != BaudRateData[cnt])) {
+        cnt++;
+    }
+
+    if (0U == BaudRateData[cnt]) {
+
+        return (-ENXIO);
+    }
+
+    return (cnt);
+}
+
+static void fifoPut(
+    struct simFifo *    fifo,
+    uint16_t            item) {
+
+    fifo->item[fifo->head++] = item;
+
+    if (DEF_FIFO_SIZE == fifo->head) {
+        fifo->head = 0U;
+    }
+    fifo->occ++;
+}
+
+static uint16_t fifoGet(
+    struct simFifo *    fifo) {
+
+    uint16_t            item;
+
+    item = fifo->item[fifo->tail++];
+
+    if (DEF_FIFO_SIZE == fifo->tail) {
+        fifo->tail = 0U;
+    }
+    fifo->occ--;
+
+    return (item);
+}
+
+static void fifoFlush(
+    struct simFifo *    fifo) {
+
+    fifo->head = 0U;
+    fifo->tail = 0U;
+    fifo->occ  = 0U;
+}
+
+static bool_T ringPut(
+    struct simRing *    ring,
+    uint8_t             item) {
+
+    if (PORT_SIM_REMOTE_SIZE == ring->occ) {
+
+        return (FALSE);
+    }
+    ring->item[ring->head++] = item;
+
+    if (PORT_SIM_REMOTE_SIZE == ring->head) {
+        ring->head = 0U;
+    }
+    ring->occ++;
+
+    return (TRUE);
+}
+
+static uint8_t ringGet(
+    struct simRing *    ring) {
+
+    uint8_t             item;
+
+    item = ring->item[ring->tail++];
+
+    if (PORT_SIM_REMOTE_SIZE == ring->tail) {
+        ring->tail = 0U;
+    }
+    ring->occ--;
+
+    return (item);
+}
+
+/* Duration of one character on the line, zero when the UART is disabled      */
+static nanosecs_rel_t uartCharTime(
+    const struct simUart * uart) {
+
+    uint64_t            div;
+    uint64_t            over;
+    uint64_t            bits;
+
+    div = ((uint64_t)uart->dlh << 8) | uart->dll;
+
+    switch (uart->reg[MDR1 / 4U] & MDR1_MODESELECT_Mask) {
+        case MDR1_MODESELECT_UART16 :
+        case MDR1_MODESELECT_UART16AUTO : {
+            over = 16U;
+            break;
+        }
+        case MDR1_MODESELECT_UART13 : {
+            over = 13U;
+            break;
+        }
+        default : {
+            over = 0U;
+            break;
+        }
+    }
+
+    if ((0U == div) || (0U == over)) {
+
+        return (0);
+    }
+    bits  = 1U + 5U + (uart->lcr & LCR_CHAR_LENGTH_Mask);                      /* Start and data bits                                      */
+    bits += (0U != (uart->lcr & LCR_PARITY_EN)) ? 1U : 0U;
+    bits += (0U != (uart->lcr & LCR_NB_STOP))   ? 2U : 1U;
+
+    return ((nanosecs_rel_t)((bits * div * over * 1000000000ULL) / PORT_SIM_FCLK));
+}
+
+/* Parity bit as sent on the line, ITEM_HAS_PARITY is clear without parity     */
+static uint16_t uartParity(
+    uint16_t            lcr,
+    uint8_t             data) {
+
+    uint16_t            bit;
+
+    if (0U == (lcr & LCR_PARITY_EN)) {
+
+        return (0U);
+    }
+
+    if (0U != (lcr & LCR_PARITY_TYPE2)) {                                       /* Forced parity: mark or space                             */
+        bit = (0U != (lcr & LCR_PARITY_TYPE1)) ? 0U : 1U;
+    } else if (0U != (lcr & LCR_PARITY_TYPE1)) {                                /* Even parity                                              */
+        bit = (uint16_t)(__builtin_popcount(data) & 0x1U);
+    } else {                                                                    /* Odd parity                                               */
+        bit = (uint16_t)(~__builtin_popcount(data) & 0x1U);
+    }
+
+    return (ITEM_HAS_PARITY | ((0U != bit) ? ITEM_PARITY : 0U));
+}
+
+static uint32_t uartRxTrig(
+    const struct simUart * uart) {
+
+    static const uint32_t fcrTrig[] = {8U, 16U, 56U, 60U};
+
+    if (0U != (uart->tlr & TLR_RX_FIFO_TRIG_DMA_Mask)) {
+
+        return (((uart->tlr & TLR_RX_FIFO_TRIG_DMA_Mask) >> 4) * 4U);
+    }
+
+    return (fcrTrig[(uart->fcr & FCR_RX_FIFO_TRIG_Mask) >> 6]);
+}
+
+static uint32_t uartTxTrig(
+    const struct simUart * uart) {
+
+    static const uint32_t fcrTrig[] = {8U, 16U, 32U, 56U};
+
+    if (0U != (uart->tlr & TLR_TX_FIFO_TRIG_DMA_Mask)) {
+
+        return ((uart->tlr & TLR_TX_FIFO_TRIG_DMA_Mask) * 4U);
+    }
+
+    return (fcrTrig[(uart->fcr & FCR_TX_FIFO_TRIG_Mask) >> 4]);
+}
+
+/* Hardware reset values, the wiring and the far end are kept                 */
+static void uartReset(
+    struct simUart *    uart) {
+
+    memset(uart->reg, 0, sizeof(uart->reg));
+    uart->reg[MDR1 / 4U] = MDR1_MODESELECT_DISABLE;
+    uart->reg[SYSS / 4U] = SYSS_RESETDONE;
+    uart->reg[MVR / 4U]  = 0x0402U;
+    uart->dll            = 0U;
+    uart->dlh            = 0U;
+    uart->ier            = 0U;
+    uart->fcr            = 0U;
+    uart->efr            = 0U;
+    uart->lcr            = 0U;
+    uart->mcr            = 0U;
+    uart->tcr            = 0U;
+    uart->tlr            = 0U;
+    uart->spr            = 0U;
+    uart->isOverrun      = FALSE;
+    uart->isShifting     = FALSE;
+    fifoFlush(
+        &uart->rx);
+    fifoFlush(
+        &uart->tx);
+}
+
+static void uartRxPut(
+    struct simUart *    uart,
+    uint16_t            item,
+    nanosecs_abs_t      when) {
+
+    uint16_t            expect;
+
+    if (0 == uartCharTime(uart)) {
+
+        return;                                                                 /* Receiver is disabled                                     */
+    }
+    expect = uartParity(
+        uart->lcr,
+        (uint8_t)(item & ITEM_DATA_Mask));
+
+    if ((0U != expect) && (expect != (item & (ITEM_HAS_PARITY | ITEM_PARITY)))) {
+        item |= ITEM_PE;
+        uart->stats.parityErrors++;
+    }
+
+    if (DEF_FIFO_SIZE == uart->rx.occ) {
+        uart->isOverrun = TRUE;
+        uart->stats.overruns++;
+
+        return;
+    }
+    fifoPut(
+        &uart->rx,
+        item);
+    uart->rxStamp = when;
+    uart->stats.rxBytes++;
+}
+
+static void uartTxDone(
+    struct simUart *    uart,
+    nanosecs_abs_t      when) {
+
+    uart->stats.txBytes++;
+
+    if (0U != (uart->mcr & MCR_LOOPBACKEN)) {                                   /* Internal loopback, TX line stays idle                    */
+        uartRxPut(
+            uart,
+            uart->shift,
+            when);
+    } else if (NULL != uart->peer) {
+        uartRxPut(
+            uart->peer,
+            uart->shift,
+            when);
+    } else {
+        (void)ringPut(
+            &uart->remoteRx,
+            (uint8_t)(uart->shift & ITEM_DATA_Mask));                           /* Far end drops data it does not fetch                     */
+    }
+
+    if (0U != uart->tx.occ) {
+        uart->shift     = fifoGet(&uart->tx);
+        uart->shiftEnd  = when + uartCharTime(uart);
+    } else {
+        uart->isShifting = FALSE;
+    }
+}
+
+/* Start the transmitter and the far end when they have data to send          */
+static void uartStart(
+    struct simUart *    uart) {
+
+    nanosecs_rel_t      charTime;
+
+    charTime = uartCharTime(
+        uart);
+
+    if (0 == charTime) {
+
+        return;
+    }
+
+    if ((FALSE == uart->isShifting) && (0U != uart->tx.occ)) {
+        uart->shift      = fifoGet(&uart->tx);
+        uart->shiftEnd   = uart->now + charTime;
+        uart->isShifting = TRUE;
+    }
+
+    if ((FALSE == uart->isRemoteActive) && (0U != uart->remoteTx.occ)) {
+        uart->remoteNext     = uart->now + charTime;
+        uart->isRemoteActive = TRUE;
+    }
+}
+
+static void uartAdvance(
+    struct simUart *    uart,
+    nanosecs_abs_t      now) {
+
+    nanosecs_rel_t      charTime;
+
+    if (now < uart->now) {
+        now = uart->now;
+    }
+    charTime = uartCharTime(
+        uart);
+
+    for (;;) {
+        bool_T          isShiftFirst;
+        nanosecs_abs_t  event;
+
+        event        = SIM_TIME_NEVER;
+        isShiftFirst = FALSE;
+
+        if (TRUE == uart->isShifting) {
+            event        = uart->shiftEnd;
+            isShiftFirst = TRUE;
+        }
+
+        if ((TRUE == uart->isRemoteActive) && (uart->remoteNext < event)) {
+            event        = uart->remoteNext;
+            isShiftFirst = FALSE;
+        }
+
+        if (event > now) {
+            break;
+        }
+
+        if (TRUE == isShiftFirst) {
+            uartTxDone(
+                uart,
+                event);
+        } else {
+            uint8_t     data;
+
+            data = ringGet(
+                &uart->remoteTx);
+            uartRxPut(
+                uart,
+                data | uartParity(uart->lcr, data),
+                event);
+
+            if ((0U != uart->remoteTx.occ) && (0 != charTime)) {
+                uart->remoteNext += charTime;
+            } else {
+                uart->isRemoteActive = FALSE;
+            }
+        }
+    }
+    uart->now = now;
+}
+
+/* Interrupt identification, highest priority source first                    */
+static uint16_t uartIIR(
+    const struct simUart * uart) {
+
+    nanosecs_rel_t      charTime;
+
+    if ((0U != (uart->ier & IER_LINESTSIT)) &&
+        ((TRUE == uart->isOverrun) || ((0U != uart->rx.occ) && (0U != (uart->rx.item[uart->rx.tail] & ITEM_PE))))) {
+
+        return (IIR_IT_TYPE_LINEST);
+    }
+
+    if ((0U != (uart->ier & IER_RHRIT)) && (0U != uart->rx.occ)) {
+
+        if (uartRxTrig(uart) <= uart->rx.occ) {
+
+            return (IIR_IT_TYPE_RHR);
+        }
+        charTime = uartCharTime(
+            uart);
+
+        if ((0 != charTime) && (uart->now >= uart->rxStamp + DEF_RX_TIMEOUT_CHARS * (nanosecs_abs_t)charTime)) {
+
+            return (IIR_IT_TYPE_RX_TIMEOUT);
+        }
+    }
+
+    if ((0U != (uart->ier & IER_THRIT)) && (uartTxTrig(uart) <= (DEF_FIFO_SIZE - uart->tx.occ))) {
+
+        return (IIR_IT_TYPE_THR);
+    }
+
+    return (IIR_IT_TYPE_NONE);
+}
+
+static uint16_t uartLSR(
+    const struct simUart * uart) {
+
+    uint16_t            lsr;
+    uint32_t            cnt;
+
+    lsr = 0U;
+
+    if (0U != uart->rx.occ) {
+        lsr |= LSR_RXFIFOE;
+
+        if (0U != (uart->rx.item[uart->rx.tail] & ITEM_PE)) {
+            lsr |= LSR_RXPE;
+        }
+    }
+
+    if (TRUE == uart->isOverrun) {
+        lsr |= LSR_RXOE;
+    }
+
+    for (cnt = 0U; cnt < uart->rx.occ; cnt++) {
+
+        if (0U != (uart->rx.item[(uart->rx.tail + cnt) % DEF_FIFO_SIZE] & ITEM_PE)) {
+            lsr |= LSR_RXFIFOSTS;
+            break;
+        }
+    }
+
+    if (0U == uart->tx.occ) {
+        lsr |= LSR_TXFIFOE;
+
+        if (FALSE == uart->isShifting) {
+            lsr |= LSR_TXSRE;
+        }
+    }
+
+    return (lsr);
+}
+
+static nanosecs_abs_t uartNextEvent(
+    const struct simUart * uart) {
+
+    nanosecs_abs_t      next;
+    nanosecs_rel_t      charTime;
+
+    next = SIM_TIME_NEVER;
+
+    if (TRUE == uart->isShifting) {
+        next = uart->shiftEnd;
+    }
+
+    if ((TRUE == uart->isRemoteActive) && (uart->remoteNext < next)) {
+        next = uart->remoteNext;
+    }
+    charTime = uartCharTime(
+        uart);
+
+    if ((0U != (uart->ier & IER_RHRIT)) && (0U != uart->rx.occ) && (0 != charTime)) {
+        nanosecs_abs_t  timeout;
+
+        timeout = uart->rxStamp + DEF_RX_TIMEOUT_CHARS * (nanosecs_abs_t)charTime;
+
+        if ((uart->now < timeout) && (timeout < next)) {
+            next = timeout;
+        }
+    }
+
+    return (next);
+}
+
+/* Resolve banked registers using the current LCR, EFR and MCR values         */
+static enum simReg uartDecode(
+    const struct simUart * uart,
+    uint32_t            offset) {
+
+    bool_T              isModeA;
+    bool_T              isModeB;
+    bool_T              isTcrTlr;
+
+    isModeB  = (LLD_CFG_MODE_B == uart->lcr) ? TRUE : FALSE;
+    isModeA  = ((FALSE == isModeB) && (0U != (uart->lcr & LCR_DIV_EN))) ? TRUE : FALSE;
+    isTcrTlr = ((0U != (uart->efr & EFR_ENHANCEDEN)) && (0U != (uart->mcr & MCR_TCRTLR))) ? TRUE : FALSE;
+
+    switch (offset) {
+        case RHR : {
+
+            return (((TRUE == isModeA) || (TRUE == isModeB)) ? SIM_DLL : SIM_RHR_THR);
+        }
+        case IER : {
+
+            return (((TRUE == isModeA) || (TRUE == isModeB)) ? SIM_DLH : SIM_IER);
+        }
+        case IIR : {
+
+            return ((TRUE == isModeB) ? SIM_EFR : SIM_IIR_FCR);
+        }
+        case LCR : {
+
+            return (SIM_LCR);
+        }
+        case MCR : {
+
+            return ((TRUE == isModeB) ? SIM_XON1 : SIM_MCR);
+        }
+        case LSR : {
+
+            return ((TRUE == isModeB) ? SIM_XON2 : SIM_LSR);
+        }
+        case MSR : {
+
+            if (TRUE == isTcrTlr) {
+
+                return (SIM_MSR_TCR);
+            }
+
+            return ((TRUE == isModeB) ? SIM_XOFF1 : SIM_MSR_TCR);
+        }
+        case SPR : {
+
+            if (TRUE == isTcrTlr) {
+
+                return (SIM_TLR);
+            }
+
+            return ((TRUE == isModeB) ? SIM_XOFF2 : SIM_SPR);
+        }
+        default : {
+
+            return (SIM_PLAIN);
+        }
+    }
+}
+
+static nanosecs_abs_t simAdvanceL(
+    void *              arg,
+    nanosecs_abs_t      now) {
+
+    nanosecs_abs_t      next;
+    uint32_t            id;
+
+    (void)arg;
+
+    for (id = 0U; id < LAST_UART_ENTRY; id++) {
+        uartAdvance(
+            &Uart[id],
+            now);
+    }
+    next = SIM_TIME_NEVER;
+
+    for (id = 0U; id < LAST_UART_ENTRY; id++) {
+        nanosecs_abs_t  event;
+        bool_T          isIrq;
+
+        isIrq = (IIR_IT_TYPE_NONE != uartIIR(&Uart[id])) ? TRUE : FALSE;
+
+        if (isIrq != Uart[id].isIrq) {
+            Uart[id].isIrq = isIrq;
+            simIrqLineSet(
+                PortIRQ[id],
+                (TRUE == isIrq) ? true : false);
+        }
+        event = uartNextEvent(
+            &Uart[id]);
+
+        if (event < next) {
+            next = event;
+        }
+    }
+
+    return (next);
+}
+
+static struct simUart * simAccessBegin(
+    volatile void *     addr,
+    uint32_t *          offset) {
+
+    uintptr_t           pos;
+
+    pos = (uintptr_t)addr - (uintptr_t)&IoSpace[0][0];
+    ES_DBG_API_REQUIRE(ES_DBG_OUT_OF_RANGE, pos < sizeof(IoSpace));
+    *offset = (uint32_t)(pos % DEF_IO_SIZE);
+    simCoreLock();
+    (void)simAdvanceL(
+        NULL,
+        rtdm_clock_read());
+
+    return (&Uart[pos / DEF_IO_SIZE]);
+}
+
+static void simAccessEnd(
+    struct simUart *    uart) {
+
+    uartStart(
+        uart);
+    simCoreKick(
+        simAdvanceL(NULL, uart->now));
+    simCoreUnlock();
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+uint16_t ioread16(
+    volatile void *     addr) {
+
+    struct simUart *    uart;
+    uint32_t            offset;
+    uint16_t            val;
+
+    uart = simAccessBegin(
+        addr,
+        &offset);
+
+    switch (uartDecode(uart, offset)) {
+        case SIM_RHR_THR : {
+
+            if (0U != uart->rx.occ) {
+                val = fifoGet(&uart->rx) & ITEM_DATA_Mask;
+                uart->rxStamp = uart->now;                                      /* Reading restarts the RX timeout                          */
+            } else {
+                val = 0U;
+            }
+            break;
+        }
+        case SIM_DLL     : val = uart->dll;               break;
+        case SIM_DLH     : val = uart->dlh;               break;
+        case SIM_IER     : val = uart->ier;               break;
+        case SIM_IIR_FCR : val = uartIIR(uart);           break;
+        case SIM_EFR     : val = uart->efr;               break;
+        case SIM_LCR     : val = uart->lcr;               break;
+        case SIM_MCR     : val = uart->mcr;               break;
+        case SIM_LSR     : {
+            val = uartLSR(
+                uart);
+            uart->isOverrun = FALSE;
+            break;
+        }
+        case SIM_MSR_TCR : val = 0U;                      break;
+        case SIM_TLR     : val = uart->tlr;               break;
+        case SIM_SPR     : val = uart->spr;               break;
+        case SIM_XON1    : val = uart->xon[0];            break;
+        case SIM_XON2    : val = uart->xon[1];            break;
+        case SIM_XOFF1   : val = uart->xoff[0];           break;
+        case SIM_XOFF2   : val = uart->xoff[1];           break;
+        default : {
+
+            switch (offset) {
+                case RXFIFO_LVL : val = (uint16_t)uart->rx.occ; break;
+                case TXFIFO_LVL : val = (uint16_t)uart->tx.occ; break;
+                case SSR : {
+                    val = (DEF_FIFO_SIZE == uart->tx.occ) ? SSR_TXFIFOFULL : 0U;
+                    break;
+                }
+                default : {
+                    val = uart->reg[offset / 4U];
+                    break;
+                }
+            }
+            break;
+        }
+    }
+    simAccessEnd(
+        uart);
+
+    return (val);
+}
+
+void iowrite16(
+    uint16_t            val,
+    volatile void *     addr) {
+
+    struct simUart *    uart;
+    uint32_t            offset;
+
+    uart = simAccessBegin(
+        addr,
+        &offset);
+
+    switch (uartDecode(uart, offset)) {
+        case SIM_RHR_THR : {
+
+            if (DEF_FIFO_SIZE != uart->tx.occ) {                                /* Writes to a full FIFO are lost                           */
+                uint8_t data;
+
+                data = (uint8_t)(val & (0xFFU >> (3U - (uart->lcr & LCR_CHAR_LENGTH_Mask))));
+                fifoPut(
+                    &uart->tx,
+                    data | uartParity(uart->lcr, data));
+            }
+            break;
+        }
+        case SIM_DLL     : uart->dll = val & 0xFFU;       break;
+        case SIM_DLH     : uart->dlh = val & 0x3FU;       break;
+        case SIM_IER : {
+            uart->ier = (0U != (uart->efr & EFR_ENHANCEDEN)) ? (val & 0xFFU) : (val & 0x0FU);
+            break;
+        }
+        case SIM_IIR_FCR : {
+            uart->fcr = val & ~(FCR_RX_FIFO_CLEAR | FCR_TX_FIFO_CLEAR);
+
+            if (0U != (val & FCR_RX_FIFO_CLEAR)) {
+                fifoFlush(
+                    &uart->rx);
+                uart->isOverrun = FALSE;
+            }
+
+            if (0U != (val & FCR_TX_FIFO_CLEAR)) {
+                fifoFlush(
+                    &uart->tx);
+            }
+            break;
+        }
+        case SIM_EFR     : uart->efr = val & 0xFFU;       break;
+        case SIM_LCR     : uart->lcr = val & 0xFFU;       break;
+        case SIM_MCR     : uart->mcr = val & 0xFFU;       break;
+        case SIM_LSR     :                                break;
+        case SIM_MSR_TCR : uart->tcr = val & 0xFFU;       break;
+        case SIM_TLR     : uart->tlr = val & 0xFFU;       break;
+        case SIM_SPR     : uart->spr = val & 0xFFU;       break;
+        case SIM_XON1    : uart->xon[0]  = val & 0xFFU;   break;
+        case SIM_XON2    : uart->xon[1]  = val & 0xFFU;   break;
+        case SIM_XOFF1   : uart->xoff[0] = val & 0xFFU;   break;
+        case SIM_XOFF2   : uart->xoff[1] = val & 0xFFU;   break;
+        default : {
+
+            if (SYSC == offset) {
+
+                if (0U != (val & SYSC_SOFTRESET)) {
+                    uartReset(
+                        uart);
+                }
+                uart->reg[SYSC / 4U] = val & ~SYSC_SOFTRESET;
+            } else if ((SYSS != offset) && (RXFIFO_LVL != offset) && (TXFIFO_LVL != offset)) {
+                uart->reg[offset / 4U] = val;
+            }
+            break;
+        }
+    }
+    simAccessEnd(
+        uart);
+}
+
+struct devData * portInit(
+    uint32_t            id) {
+
+    struct devData *    devData;
+
+    if (LAST_UART_ENTRY <= id) {
+        LOG_ERR("SIM UART: invalid UART %d", id);
+
+        return (NULL);
+    }
+    devData = malloc(
+        sizeof(struct devData));
+
+    if (NULL == devData) {
+        LOG_ERR("SIM UART: failed to allocate device resources struct");
+
+        return (NULL);
+    }
+    simCoreLock();
+    devData->uart = &Uart[id];
+    devData->uart->id = id;
+    devData->uart->now = rtdm_clock_read();
+    uartReset(
+        devData->uart);
+    memset(&devData->uart->stats, 0, sizeof(devData->uart->stats));
+    simCoreUnlock();
+
+    if (0U == SimUsers++) {
+        simCoreHookAdd(
+            &SimHook);
+    }
+    ES_DBG_API_OBLIGATION(devData->signature = DEVDATA_SIGNATURE);
+
+    return (devData);
+}
+
+int32_t portTerm(
+    struct devData *    devData) {
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, DEVDATA_SIGNATURE == devData->signature);
+
+    if (0U == --SimUsers) {
+        simCoreHookRemove(
+            &SimHook);
+    }
+    free(devData);
+
+    return (0);
+}
+
+volatile uint8_t * portIORemapGet(
+    struct devData *    devData) {
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, DEVDATA_SIGNATURE == devData->signature);
+
+    return (&IoSpace[devData->uart->id][0]);
+}
+
+int32_t portModeGet(
+    uint32_t            baudrate) {
+
+    int32_t             indx;
+
+    indx = baudRateCfgFindIndex(baudrate);
+
+    if (0 > indx) {
+
+        return (indx);
+    }
+
+    return ((int32_t)ModeData[indx]);
+}
+
+int32_t portDIVdataGet(
+    uint32_t            baudrate) {
+
+    int32_t             indx;
+
+    indx = baudRateCfgFindIndex(baudrate);
+
+    if (0 > indx) {
+
+        return (indx);
+    }
+
+    return (DIVdata[indx]);
+}
+
+bool_T portIsOnline(
+    uint32_t            id) {
+
+    return ((LAST_UART_ENTRY > id) ? TRUE : FALSE);
+}
+
+void * portMirrorAlloc(
+    size_t              size) {
+
+    uint8_t *           mem;
+    int                 fd;
+
+    if ((0U == size) || (0U != (size % (size_t)sysconf(_SC_PAGESIZE)))) {
+
+        return (NULL);
+    }
+    fd = memfd_create(
+        "xuart-mirror",
+        0);
+
+    if (0 > fd) {
+
+        return (NULL);
+    }
+
+    if (0 != ftruncate(fd, (off_t)size)) {
+        close(
+            fd);
+
+        return (NULL);
+    }
+    mem = mmap(                                                                 /* Reserve address space for both mappings                  */
+        NULL,
+        2U * size,
+        PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+
+    if (MAP_FAILED == mem) {
+        close(
+            fd);
+
+        return (NULL);
+    }
+
+    if ((MAP_FAILED == mmap(mem, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0)) ||
+        (MAP_FAILED == mmap(mem + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0))) {
+        munmap(
+            mem,
+            2U * size);
+        mem = NULL;
+    }
+    close(
+        fd);                                                                    /* Mappings keep the memory alive                           */
+
+    return (mem);
+}
+
+void portMirrorFree(
+    void *              mem,
+    size_t              size) {
+
+    munmap(
+        mem,
+        2U * size);
+}
+
+int32_t portSimConnect(
+    uint32_t            idA,
+    uint32_t            idB) {
+
+    if ((LAST_UART_ENTRY <= idA) || (LAST_UART_ENTRY <= idB)) {
+
+        return (-EINVAL);
+    }
+    simCoreLock();
+
+    if (((NULL != Uart[idA].peer) && (&Uart[idB] != Uart[idA].peer)) ||
+        ((NULL != Uart[idB].peer) && (&Uart[idA] != Uart[idB].peer))) {
+        simCoreUnlock();
+
+        return (-EBUSY);
+    }
+    Uart[idA].peer = &Uart[idB];
+    Uart[idB].peer = &Uart[idA];
+    simCoreUnlock();
+
+    return (0);
+}
+
+int32_t portSimDisconnect(
+    uint32_t            id) {
+
+    if (LAST_UART_ENTRY <= id) {
+
+        return (-EINVAL);
+    }
+    simCoreLock();
+
+    if (NULL != Uart[id].peer) {
+        Uart[id].peer->peer = NULL;
+        Uart[id].peer       = NULL;
+    }
+    simCoreUnlock();
+
+    return (0);
+}
+
+size_t portSimRemoteWr(
+    uint32_t            id,
+    const uint8_t *     src,
+    size_t              size) {
+
+    struct simUart *    uart;
+    size_t              cnt;
+
+    if (LAST_UART_ENTRY <= id) {
+
+        return (0U);
+    }
+    uart = &Uart[id];
+    simCoreLock();
+    (void)simAdvanceL(
+        NULL,
+        rtdm_clock_read());
+
+    for (cnt = 0U; cnt < size; cnt++) {
+
+        if (FALSE == ringPut(&uart->remoteTx, src[cnt])) {
+            break;
+        }
+    }
+    simAccessEnd(
+        uart);
+
+    return (cnt);
+}
+
+size_t portSimRemoteRd(
+    uint32_t            id,
+    uint8_t *           dst,
+    size_t              size) {
+
+    struct simUart *    uart;
+    size_t              cnt;
+
+    if (LAST_UART_ENTRY <= id) {
+
+        return (0U);
+    }
+    uart = &Uart[id];
+    simCoreLock();
+    (void)simAdvanceL(
+        NULL,
+        rtdm_clock_read());
+
+    for (cnt = 0U; (cnt < size) && (0U != uart->remoteRx.occ); cnt++) {
+        dst[cnt] = ringGet(
+            &uart->remoteRx);
+    }
+    simCoreUnlock();
+
+    return (cnt);
+}
+
+int32_t portSimStatsGet(
+    uint32_t            id,
+    struct portSimStats * stats) {
+
+    if (LAST_UART_ENTRY <= id) {
+
+        return (-EINVAL);
+    }
+    simCoreLock();
+    *stats = Uart[id].stats;
+    simIrqStatsGet(
+        PortIRQ[id],
+        &stats->irqs,
+        &stats->isrTime);
+    simCoreUnlock();
+
+    return (0);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+
+#if (0 != CFG_DMA_MODE)
+# error "Host simulation supports only CFG_DMA_MODE 0 (interrupt driven transfers)"
+#endif
+
+#if (1 == CFG_CRITICAL_INT_ENABLE)
+# error "Host simulation requires CFG_CRITICAL_INT_ENABLE 0"
+#endif
+
+/** @endcond *//** @} *//******************************************************
+
+ * END of plat_sim.c
+ ******************************************************************************/
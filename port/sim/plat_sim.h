@@ -0,0 +1,162 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Platform port for the host simulation
+ *********************************************************************//** @{ */
+
+#if !defined(PLAT_SIM_H_)
+#define PLAT_SIM_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <stddef.h>
+#include <rtdm/rtdm.h>
+
+#include "arch/compiler.h"
+
+/*===============================================================  MACRO's  ==*/
+
+/**@brief       Simulated UARTs, same numbering and IRQ lines as on AM335x
+ */
+ /*
+  *       | UART #    | IOMEM                     | IRQ
+  */
+#define UART_DATA_TABLE(entry)                                                  \
+    entry(  UARTO,      0x44e09000ul,               72)                         \
+    entry(  UART1,      0x48022000ul,               73)                         \
+    entry(  UART2,      0x48024000ul,               74)                         \
+    entry(  UART3,      0x481a6000ul,               44)                         \
+    entry(  UART4,      0x481a8000ul,               45)                         \
+    entry(  UART5,      0x481aa000ul,               46)
+
+/*
+ *        | Baud-rate | UART mode                 | Divisor
+ */
+#define BAUD_RATE_CFG_TABLE(entry)                                              \
+    entry(  9600,       LLD_MODE_UART16,            313)                        \
+    entry(  19200,      LLD_MODE_UART16,            156)                        \
+    entry(  38400,      LLD_MODE_UART16,            78)                         \
+    entry(  115200,     LLD_MODE_UART16,            26)                         \
+    entry(  921600,     LLD_MODE_UART13,            4)
+
+/**@brief       Functional clock of the simulated UARTs in Hz
+ */
+#define PORT_SIM_FCLK                   48000000UL
+
+/**@brief       Size of the far end buffers of an unconnected UART
+ */
+#define PORT_SIM_REMOTE_SIZE            4096U
+
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+
+/**@brief       Counters of one simulated UART, reset by portInit()
+ */
+struct portSimStats {
+    uint64_t            irqs;                                                   /**<@brief Interrupt handler calls                          */
+    nanosecs_rel_t      isrTime;                                                /**<@brief Time spent in the interrupt handler              */
+    uint64_t            txBytes;                                                /**<@brief Characters shifted out on TX line                */
+    uint64_t            rxBytes;                                                /**<@brief Characters stored into the RX FIFO               */
+    uint64_t            overruns;                                               /**<@brief Characters lost because the RX FIFO was full     */
+    uint64_t            parityErrors;                                           /**<@brief Characters received with wrong parity            */
+};
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/*------------------------------------------------------------------------*//**
+ * @name        Driver entry points
+ * @details     The simulation host calls these instead of insmod and rmmod.
+ * @{ *//*--------------------------------------------------------------------*/
+
+int moduleInit(
+    void);
+
+void moduleTerm(
+    void);
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Wiring
+ * @details     An unconnected UART talks to a far end which is accessed with
+ *              portSimRemoteWr() and portSimRemoteRd().
+ * @{ *//*--------------------------------------------------------------------*/
+
+/**@brief       Connect two UARTs with a null-modem cable
+ * @param       idA
+ *              First UART
+ * @param       idB
+ *              Second UART, when it is the same as @c idA the TX line of the
+ *              UART is wired to its own RX line
+ */
+int32_t portSimConnect(
+    uint32_t            idA,
+    uint32_t            idB);
+
+/**@brief       Disconnect the UART and its peer, both talk to their far end
+ *              again
+ */
+int32_t portSimDisconnect(
+    uint32_t            id);
+
+/**@brief       Far end of an unconnected UART sends data
+ * @details     The data is paced at the line rate of the UART and uses its
+ *              line format.
+ * @return      Number of bytes accepted, limited by PORT_SIM_REMOTE_SIZE
+ */
+size_t portSimRemoteWr(
+    uint32_t            id,
+    const uint8_t *     src,
+    size_t              size);
+
+/**@brief       Far end of an unconnected UART fetches received data
+ * @return      Number of bytes fetched
+ */
+size_t portSimRemoteRd(
+    uint32_t            id,
+    uint8_t *           dst,
+    size_t              size);
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Statistics
+ * @{ *//*--------------------------------------------------------------------*/
+
+int32_t portSimStatsGet(
+    uint32_t            id,
+    struct portSimStats * stats);
+
+/** @} *//*-----------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of plat_sim.h
+ ******************************************************************************/
+#endif /* PLAT_SIM_H_ */
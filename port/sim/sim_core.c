@@ -0,0 +1,648 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Simulation core: interrupt and timer dispatcher
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "sim_core.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+/**@brief       Minimum sleep of the core thread when only peripheral events are
+ *              pending, in ns
+ * @details     Peripheral models compute their state from elapsed time, so
+ *              waking up for every character is not needed. Timers are not
+ *              rounded.
+ */
+#define DEF_CORE_TICK                   20000
+
+/**@brief       Maximum number of dispatch passes over the interrupt table in
+ *              one core cycle
+ */
+#define DEF_IRQ_PASS_MAX                16U
+
+/**@brief       Number of consecutive RTDM_IRQ_NONE returns for an asserted line
+ *              before it is masked
+ */
+#define DEF_IRQ_UNHANDLED_MAX           1000U
+
+/**@brief       Longest wake-up delay of the core thread charged to the
+ *              simulated machine, in ns
+ * @details     Any delay above this is caused by the host scheduler and the
+ *              simulated clock is held back by the excess. Otherwise a late
+ *              core thread would show up as FIFO overruns which the hardware
+ *              would never see.
+ */
+#define DEF_CORE_STALL_MAX              10000
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+
+struct simIrq {
+    rtdm_irq_t *        handle;
+    bool                isAsserted;
+    bool                isMasked;
+    uint32_t            unhandled;
+    uint64_t            count;
+    nanosecs_rel_t      time;
+};
+
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static void coreStartL(
+    void);
+
+static void coreTimerRemoveL(
+    rtdm_timer_t *      timer);
+
+static void coreTimerInsertL(
+    rtdm_timer_t *      timer);
+
+static nanosecs_abs_t coreHookAdvanceL(
+    nanosecs_abs_t      now);
+
+static bool coreIrqDispatchL(
+    void);
+
+static void coreTimerDispatchL(
+    nanosecs_abs_t      now);
+
+static void * coreThread(
+    void *              arg);
+
+static nanosecs_abs_t clockHostRead(
+    void);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+static pthread_mutex_t  CoreLock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static pthread_cond_t   CoreCond;
+static pthread_t        CoreThread;
+static bool             CoreIsRunning;
+static bool             CoreIsStopping;
+
+/**@brief       Time at which the waiting core thread wakes up, zero while it is
+ *              running
+ */
+static nanosecs_abs_t   CoreWake;
+
+/**@brief       Host time which was not charged to the simulated clock
+ */
+static nanosecs_abs_t   ClockOffset;
+static nanosecs_abs_t   ClockLast;
+
+static __thread bool    CoreIsSelf;
+
+static struct simCoreHook * HookList;
+static rtdm_timer_t *   TimerList;
+static struct simIrq    IrqTable[SIM_IRQ_NUM];
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+static void coreStartL(
+    void) {
+
+    pthread_condattr_t  attr;
+
+    if (true == CoreIsRunning) {
+
+        return;
+    }
+    pthread_condattr_init(
+        &attr);
+    pthread_condattr_setclock(
+        &attr,
+        CLOCK_MONOTONIC);
+    pthread_cond_init(
+        &CoreCond,
+        &attr);
+    pthread_condattr_destroy(
+        &attr);
+    CoreIsStopping = false;
+    CoreIsRunning  = true;
+    CoreWake       = 0U;
+    pthread_create(
+        &CoreThread,
+        NULL,
+        coreThread,
+        NULL);
+}
+
+static void coreTimerRemoveL(
+    rtdm_timer_t *      timer) {
+
+    rtdm_timer_t **     link;
+
+    if (false == timer->isArmed) {
+
+        return;
+    }
+
+    for (link = &TimerList; NULL != *link; link = &(*link)->next) {
+
+        if (timer == *link) {
+            *link = timer->next;
+            break;
+        }
+    }
+    timer->isArmed = false;
+}
+
+static void coreTimerInsertL(
+    rtdm_timer_t *      timer) {
+
+    rtdm_timer_t **     link;
+
+    link = &TimerList;
+
+    while ((NULL != *link) && ((*link)->expiry <= timer->expiry)) {
+        link = &(*link)->next;
+    }
+    timer->next    = *link;
+    timer->isArmed = true;
+    *link          = timer;
+}
+
+static nanosecs_abs_t coreHookAdvanceL(
+    nanosecs_abs_t      now) {
+
+    struct simCoreHook * hook;
+    nanosecs_abs_t      next;
+
+    next = SIM_TIME_NEVER;
+
+    for (hook = HookList; NULL != hook; hook = hook->next) {
+        nanosecs_abs_t  event;
+
+        event = hook->advance(
+            hook->arg,
+            now);
+
+        if (event < next) {
+            next = event;
+        }
+    }
+
+    return (next);
+}
+
+static bool coreIrqDispatchL(
+    void) {
+
+    uint32_t            pass;
+    uint32_t            irq;
+    bool                isAny;
+    bool                isCalled;
+
+    isCalled = false;
+
+    for (pass = 0U; pass < DEF_IRQ_PASS_MAX; pass++) {
+        isAny = false;
+
+        for (irq = 0U; irq < SIM_IRQ_NUM; irq++) {
+            struct simIrq * entry;
+            nanosecs_abs_t  begin;
+            int             retval;
+
+            entry = &IrqTable[irq];
+
+            if ((NULL == entry->handle) || (false == entry->isAsserted) || (true == entry->isMasked)) {
+                continue;
+            }
+            isAny    = true;
+            isCalled = true;
+            begin    = rtdm_clock_read();
+            retval = entry->handle->handler(
+                entry->handle);
+            entry->time += (nanosecs_rel_t)(rtdm_clock_read() - begin);
+            entry->count++;
+
+            if ((RTDM_IRQ_NONE == retval) && (true == entry->isAsserted)) {
+
+                if (DEF_IRQ_UNHANDLED_MAX == ++entry->unhandled) {
+                    printk(KERN_ERR "sim: nobody cared for IRQ %u, masking it\n", irq);
+                    entry->isMasked = true;
+                }
+            } else {
+                entry->unhandled = 0U;
+            }
+        }
+
+        if (false == isAny) {
+            break;
+        }
+    }
+
+    return (isCalled);
+}
+
+static void coreTimerDispatchL(
+    nanosecs_abs_t      now) {
+
+    while ((NULL != TimerList) && (TimerList->expiry <= now)) {
+        rtdm_timer_t *  timer;
+
+        timer = TimerList;
+        coreTimerRemoveL(
+            timer);
+
+        if (0 < timer->interval) {
+
+            do {
+                timer->expiry += (nanosecs_abs_t)timer->interval;           /* Overruns are skipped                                     */
+            } while (timer->expiry <= now);
+            coreTimerInsertL(
+                timer);
+        }
+        timer->handler(
+            timer);
+    }
+}
+
+static void * coreThread(
+    void *              arg) {
+
+    struct sched_param  param;
+
+    (void)arg;
+    CoreIsSelf = true;
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+    (void)pthread_setschedparam(
+        pthread_self(),
+        SCHED_FIFO,
+        &param);                                                                /* Best effort, interrupts preempt tasks when permitted     */
+    simCoreLock();
+
+    while (false == CoreIsStopping) {
+        nanosecs_abs_t  now;
+        nanosecs_abs_t  wake;
+        struct timespec abstime;
+
+        now  = rtdm_clock_read();
+        wake = coreHookAdvanceL(
+            now);
+
+        if (true == coreIrqDispatchL()) {
+            continue;                                                           /* Handlers changed the peripherals, re-evaluate them       */
+        }
+        coreTimerDispatchL(
+            now);
+
+        if (SIM_TIME_NEVER != wake) {
+            wake = max(wake, now + DEF_CORE_TICK);
+        }
+
+        if ((NULL != TimerList) && (TimerList->expiry < wake)) {
+            wake = TimerList->expiry;
+        }
+
+        if (wake <= now) {
+            continue;
+        }
+        CoreWake = wake;
+
+        if (SIM_TIME_NEVER == wake) {
+            pthread_cond_wait(
+                &CoreCond,
+                &CoreLock);
+        } else {
+            nanosecs_abs_t late;
+
+            simClockToHost(
+                wake,
+                &abstime);
+
+            if (ETIMEDOUT == pthread_cond_timedwait(&CoreCond, &CoreLock, &abstime)) {
+                late = rtdm_clock_read();
+
+                if ((wake + DEF_CORE_STALL_MAX) < late) {
+                    late -= wake;
+                    __atomic_add_fetch(&ClockOffset, late - DEF_CORE_STALL_MAX, __ATOMIC_RELEASE);
+                }
+            }
+        }
+        CoreWake = 0U;
+    }
+    simCoreUnlock();
+
+    return (NULL);
+}
+
+static nanosecs_abs_t clockHostRead(
+    void) {
+
+    struct timespec     now;
+
+    clock_gettime(
+        CLOCK_MONOTONIC,
+        &now);
+
+    return ((nanosecs_abs_t)now.tv_sec * 1000000000U + (nanosecs_abs_t)now.tv_nsec);
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+void simCoreLock(
+    void) {
+
+    pthread_mutex_lock(
+        &CoreLock);
+}
+
+void simCoreUnlock(
+    void) {
+
+    pthread_mutex_unlock(
+        &CoreLock);
+}
+
+void simCoreHookAdd(
+    struct simCoreHook * hook) {
+
+    simCoreLock();
+    hook->next = HookList;
+    HookList   = hook;
+    coreStartL();
+    simCoreKick(
+        0U);
+    simCoreUnlock();
+}
+
+void simCoreHookRemove(
+    struct simCoreHook * hook) {
+
+    struct simCoreHook ** link;
+
+    simCoreLock();
+
+    for (link = &HookList; NULL != *link; link = &(*link)->next) {
+
+        if (hook == *link) {
+            *link = hook->next;
+            break;
+        }
+    }
+    simCoreUnlock();
+}
+
+void simCoreKick(
+    nanosecs_abs_t      when) {
+
+    if ((true == CoreIsRunning) && (when < CoreWake)) {
+        CoreWake = 0U;
+        pthread_cond_signal(
+            &CoreCond);
+    }
+}
+
+bool simCoreIsSelf(
+    void) {
+
+    return (CoreIsSelf);
+}
+
+void simIrqLineSet(
+    unsigned int        irq,
+    bool                isAsserted) {
+
+    if (SIM_IRQ_NUM <= irq) {
+
+        return;
+    }
+    IrqTable[irq].isAsserted = isAsserted;
+
+    if ((true == isAsserted) && (NULL != IrqTable[irq].handle)) {
+        simCoreKick(
+            0U);
+    }
+}
+
+void simIrqStatsGet(
+    unsigned int        irq,
+    uint64_t *          count,
+    nanosecs_rel_t *    time) {
+
+    simCoreLock();
+    *count = IrqTable[irq].count;
+    *time  = IrqTable[irq].time;
+    simCoreUnlock();
+}
+
+nanosecs_abs_t simClockRead(
+    void) {
+
+    nanosecs_abs_t      now;
+    nanosecs_abs_t      last;
+
+    now  = clockHostRead() - __atomic_load_n(&ClockOffset, __ATOMIC_ACQUIRE);
+    last = __atomic_load_n(&ClockLast, __ATOMIC_RELAXED);
+
+    do {
+
+        if (now <= last) {
+
+            return (last);                                                      /* Clock stands still while a stall is being removed        */
+        }
+    } while (!__atomic_compare_exchange_n(&ClockLast, &last, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return (now);
+}
+
+void simClockToHost(
+    nanosecs_abs_t      when,
+    struct timespec *   host) {
+
+    when += __atomic_load_n(&ClockOffset, __ATOMIC_ACQUIRE);
+    host->tv_sec  = (time_t)(when / 1000000000U);
+    host->tv_nsec = (long)(when % 1000000000U);
+}
+
+nanosecs_rel_t simClockStallGet(
+    void) {
+
+    return ((nanosecs_rel_t)__atomic_load_n(&ClockOffset, __ATOMIC_ACQUIRE));
+}
+
+void simCoreStop(
+    void) {
+
+    simCoreLock();
+
+    if (false == CoreIsRunning) {
+        simCoreUnlock();
+
+        return;
+    }
+    CoreIsStopping = true;
+    pthread_cond_signal(
+        &CoreCond);
+    simCoreUnlock();
+    pthread_join(
+        CoreThread,
+        NULL);
+    simCoreLock();
+    CoreIsRunning = false;
+    pthread_cond_destroy(
+        &CoreCond);
+    simCoreUnlock();
+}
+
+int rtdm_irq_request(
+    rtdm_irq_t *        irq_handle,
+    unsigned int        irq_no,
+    rtdm_irq_handler_t  handler,
+    unsigned long       flags,
+    const char *        device_name,
+    void *              arg) {
+
+    (void)flags;
+    (void)device_name;
+
+    if (SIM_IRQ_NUM <= irq_no) {
+
+        return (-EINVAL);
+    }
+    simCoreLock();
+
+    if (NULL != IrqTable[irq_no].handle) {
+        simCoreUnlock();
+
+        return (-EBUSY);
+    }
+    irq_handle->handler = handler;
+    irq_handle->arg     = arg;
+    irq_handle->irq     = irq_no;
+    IrqTable[irq_no].handle    = irq_handle;
+    IrqTable[irq_no].isMasked  = false;
+    IrqTable[irq_no].unhandled = 0U;
+    IrqTable[irq_no].count     = 0U;
+    IrqTable[irq_no].time      = 0;
+    coreStartL();
+    simCoreKick(
+        0U);
+    simCoreUnlock();
+
+    return (0);
+}
+
+int rtdm_irq_free(
+    rtdm_irq_t *        irq_handle) {
+
+    simCoreLock();
+
+    if (irq_handle != IrqTable[irq_handle->irq].handle) {
+        simCoreUnlock();
+
+        return (-EINVAL);
+    }
+    IrqTable[irq_handle->irq].handle = NULL;
+    simCoreUnlock();
+
+    return (0);
+}
+
+int rtdm_timer_init(
+    rtdm_timer_t *      timer,
+    rtdm_timer_handler_t handler,
+    const char *        name) {
+
+    timer->handler  = handler;
+    timer->name     = name;
+    timer->expiry   = 0U;
+    timer->interval = 0;
+    timer->isArmed  = false;
+    timer->next     = NULL;
+
+    return (0);
+}
+
+void rtdm_timer_destroy(
+    rtdm_timer_t *      timer) {
+
+    rtdm_timer_stop(
+        timer);
+}
+
+int rtdm_timer_start(
+    rtdm_timer_t *      timer,
+    nanosecs_abs_t      expiry,
+    nanosecs_rel_t      interval,
+    enum rtdm_timer_mode mode) {
+
+    simCoreLock();
+    coreTimerRemoveL(
+        timer);
+
+    if (RTDM_TIMERMODE_RELATIVE == mode) {
+        expiry += rtdm_clock_read();
+    }
+    timer->expiry   = expiry;
+    timer->interval = interval;
+    coreTimerInsertL(
+        timer);
+    coreStartL();
+    simCoreKick(
+        expiry);
+    simCoreUnlock();
+
+    return (0);
+}
+
+void rtdm_timer_stop(
+    rtdm_timer_t *      timer) {
+
+    simCoreLock();
+    coreTimerRemoveL(
+        timer);
+    simCoreUnlock();
+}
+
+int rtdm_timer_start_in_handler(
+    rtdm_timer_t *      timer,
+    nanosecs_abs_t      expiry,
+    nanosecs_rel_t      interval,
+    enum rtdm_timer_mode mode) {
+
+    return (rtdm_timer_start(timer, expiry, interval, mode));
+}
+
+void rtdm_timer_stop_in_handler(
+    rtdm_timer_t *      timer) {
+
+    rtdm_timer_stop(
+        timer);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of sim_core.c
+ ******************************************************************************/
@@ -0,0 +1,136 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Simulation core: interrupt and timer dispatcher
+ *********************************************************************//** @{ */
+
+#if !defined(SIM_CORE_H_)
+#define SIM_CORE_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <time.h>
+#include <rtdm/rtdm_driver.h>
+
+/*===============================================================  MACRO's  ==*/
+
+/**@brief       Number of interrupt lines known to the simulation core
+ */
+#define SIM_IRQ_NUM                     128U
+
+/**@brief       No pending event
+ */
+#define SIM_TIME_NEVER                  UINT64_MAX
+
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+
+/**@brief       Simulated peripheral attached to the core
+ * @details     The core calls @c advance with the core lock held every time it
+ *              wakes up. The peripheral brings its model up to @c now, updates
+ *              its interrupt lines with simIrqLineSet() and returns the time of
+ *              its next internal event, or SIM_TIME_NEVER.
+ */
+struct simCoreHook {
+    nanosecs_abs_t   (* advance)(void *, nanosecs_abs_t);
+    void *              arg;
+    struct simCoreHook * next;
+};
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+void simCoreHookAdd(
+    struct simCoreHook * hook);
+
+void simCoreHookRemove(
+    struct simCoreHook * hook);
+
+/**@brief       Tell the core thread that something happens at time @c when
+ * @details     Must be called with the core lock held. The core thread is woken
+ *              up only when @c when is before its current wake-up time.
+ */
+void simCoreKick(
+    nanosecs_abs_t      when);
+
+/**@brief       Returns TRUE when called from the core thread, that is from an
+ *              interrupt or timer handler
+ */
+bool simCoreIsSelf(
+    void);
+
+/**@brief       Set the level of an interrupt line, core lock must be held
+ */
+void simIrqLineSet(
+    unsigned int        irq,
+    bool                isAsserted);
+
+/**@brief       Get the number of handler calls and the time spent in handlers
+ *              of an interrupt line since it was requested
+ */
+void simIrqStatsGet(
+    unsigned int        irq,
+    uint64_t *          count,
+    nanosecs_rel_t *    time);
+
+/**@brief       Read the simulated clock, same as rtdm_clock_read()
+ * @details     The simulated clock is the host monotonic clock minus the host
+ *              scheduler stalls of the core thread, see simClockStallGet().
+ */
+nanosecs_abs_t simClockRead(
+    void);
+
+/**@brief       Convert a simulated time to a host CLOCK_MONOTONIC time
+ * @details     A wait on the result may end early when a stall is removed in
+ *              the meantime, callers check simClockRead() again.
+ */
+void simClockToHost(
+    nanosecs_abs_t      when,
+    struct timespec *   host);
+
+/**@brief       Get the host time which was not charged to the simulated clock
+ */
+nanosecs_rel_t simClockStallGet(
+    void);
+
+/**@brief       Stop the core thread, it is restarted on next use
+ */
+void simCoreStop(
+    void);
+
+/*--------------------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of sim_core.h
+ ******************************************************************************/
+#endif /* SIM_CORE_H_ */
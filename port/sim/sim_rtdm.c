@@ -0,0 +1,967 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       RTDM and Xenomai native services for the host simulation
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <rtdm/rtdm.h>
+#include <rtdm/rtdm_driver.h>
+#include <native/heap.h>
+
+#include "sim_core.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+/**@brief       Maximum number of registered devices
+ */
+#define DEF_DEV_MAX                     8U
+
+/**@brief       Maximum number of open file descriptors
+ */
+#define DEF_FD_MAX                      32U
+
+/**@brief       Device names may be given with this prefix
+ */
+#define DEF_DEV_PREFIX                  "/dev/"
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static void condInit(
+    pthread_mutex_t *   mutex,
+    pthread_cond_t *    cond);
+
+static int deadlineGet(
+    nanosecs_rel_t      timeout,
+    rtdm_toseq_t *      timeout_seq,
+    nanosecs_abs_t *    deadline);
+
+static int condWait(
+    pthread_mutex_t *   mutex,
+    pthread_cond_t *    cond,
+    nanosecs_abs_t      deadline);
+
+static struct rtdm_dev_context * fdGet(
+    int                 fd);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+static pthread_mutex_t  DevLock = PTHREAD_MUTEX_INITIALIZER;
+static struct rtdm_device * DevTable[DEF_DEV_MAX];
+static struct rtdm_dev_context * FdTable[DEF_FD_MAX];
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+static void condInit(
+    pthread_mutex_t *   mutex,
+    pthread_cond_t *    cond) {
+
+    pthread_condattr_t  attr;
+
+    pthread_mutex_init(
+        mutex,
+        NULL);
+    pthread_condattr_init(
+        &attr);
+    pthread_condattr_setclock(
+        &attr,
+        CLOCK_MONOTONIC);
+    pthread_cond_init(
+        cond,
+        &attr);
+    pthread_condattr_destroy(
+        &attr);
+}
+
+/* Convert RTDM timeout arguments to an absolute deadline, same rules as RTDM  */
+static int deadlineGet(
+    nanosecs_rel_t      timeout,
+    rtdm_toseq_t *      timeout_seq,
+    nanosecs_abs_t *    deadline) {
+
+    if (0 > timeout) {
+
+        return (-EWOULDBLOCK);
+    }
+
+    if (0 == timeout) {
+        *deadline = SIM_TIME_NEVER;
+    } else if (NULL != timeout_seq) {
+        *deadline = *timeout_seq;
+    } else {
+        *deadline = rtdm_clock_read() + (nanosecs_abs_t)timeout;
+    }
+
+    return (0);
+}
+
+static int condWait(
+    pthread_mutex_t *   mutex,
+    pthread_cond_t *    cond,
+    nanosecs_abs_t      deadline) {
+
+    struct timespec     abstime;
+
+    if (SIM_TIME_NEVER == deadline) {
+        pthread_cond_wait(
+            cond,
+            mutex);
+
+        return (0);
+    }
+    simClockToHost(
+        deadline,
+        &abstime);
+
+    if ((ETIMEDOUT == pthread_cond_timedwait(cond, mutex, &abstime)) && (deadline <= rtdm_clock_read())) {
+
+        return (-ETIMEDOUT);
+    }
+
+    return (0);                                                                 /* Callers re-check their condition, as for a wake-up       */
+}
+
+static struct rtdm_dev_context * fdGet(
+    int                 fd) {
+
+    struct rtdm_dev_context * context;
+
+    if ((0 > fd) || (DEF_FD_MAX <= (unsigned)fd)) {
+
+        return (NULL);
+    }
+    pthread_mutex_lock(
+        &DevLock);
+    context = FdTable[fd];
+    pthread_mutex_unlock(
+        &DevLock);
+
+    return (context);
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+/*------------------------------------------------------------------------*//**
+ * @name        Kernel services
+ * @{ *//*--------------------------------------------------------------------*/
+
+int printk(
+    const char *        fmt,
+    ...) {
+
+    va_list             args;
+    int                 retval;
+
+    if (('<' == fmt[0]) && ('\0' != fmt[1]) && ('>' == fmt[2])) {
+        fmt += 3;                                                               /* Strip the log level                                      */
+    }
+    va_start(args, fmt);
+    retval = vfprintf(
+        stderr,
+        fmt,
+        args);
+    va_end(args);
+
+    return (retval);
+}
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Device registration
+ * @{ *//*--------------------------------------------------------------------*/
+
+int rtdm_dev_register(
+    struct rtdm_device * device) {
+
+    uint32_t            cnt;
+    int                 retval;
+
+    if (RTDM_DEVICE_STRUCT_VER != device->struct_version) {
+
+        return (-EINVAL);
+    }
+    retval = -ENOMEM;
+    pthread_mutex_lock(
+        &DevLock);
+
+    for (cnt = 0U; cnt < DEF_DEV_MAX; cnt++) {
+
+        if ((NULL != DevTable[cnt]) && (0 == strcmp(DevTable[cnt]->device_name, device->device_name))) {
+            retval = -EEXIST;
+            break;
+        }
+    }
+
+    for (cnt = 0U; (-ENOMEM == retval) && (cnt < DEF_DEV_MAX); cnt++) {
+
+        if (NULL == DevTable[cnt]) {
+            DevTable[cnt] = device;
+            retval = 0;
+        }
+    }
+    pthread_mutex_unlock(
+        &DevLock);
+
+    return (retval);
+}
+
+int rtdm_dev_unregister(
+    struct rtdm_device * device,
+    unsigned int        poll_delay) {
+
+    uint32_t            cnt;
+
+    (void)poll_delay;
+    pthread_mutex_lock(
+        &DevLock);
+
+    for (cnt = 0U; cnt < DEF_FD_MAX; cnt++) {
+
+        if ((NULL != FdTable[cnt]) && (device == FdTable[cnt]->device)) {
+            pthread_mutex_unlock(
+                &DevLock);
+
+            return (-EAGAIN);
+        }
+    }
+
+    for (cnt = 0U; cnt < DEF_DEV_MAX; cnt++) {
+
+        if (device == DevTable[cnt]) {
+            DevTable[cnt] = NULL;
+            pthread_mutex_unlock(
+                &DevLock);
+
+            return (0);
+        }
+    }
+    pthread_mutex_unlock(
+        &DevLock);
+
+    return (-ENODEV);
+}
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Clock and task services
+ * @{ *//*--------------------------------------------------------------------*/
+
+nanosecs_abs_t rtdm_clock_read(
+    void) {
+
+    return (simClockRead());
+}
+
+nanosecs_abs_t rtdm_clock_read_monotonic(
+    void) {
+
+    return (rtdm_clock_read());
+}
+
+int rtdm_task_sleep(
+    nanosecs_rel_t      delay) {
+
+    return (rtdm_task_sleep_abs(rtdm_clock_read() + (nanosecs_abs_t)delay, RTDM_TIMERMODE_ABSOLUTE));
+}
+
+int rtdm_task_sleep_abs(
+    nanosecs_abs_t      wakeup_time,
+    enum rtdm_timer_mode mode) {
+
+    struct timespec     abstime;
+
+    if (RTDM_TIMERMODE_RELATIVE == mode) {
+
+        return (-EINVAL);
+    }
+
+    while (wakeup_time > rtdm_clock_read()) {
+        simClockToHost(
+            wakeup_time,
+            &abstime);
+        (void)clock_nanosleep(
+            CLOCK_MONOTONIC,
+            TIMER_ABSTIME,
+            &abstime,
+            NULL);
+    }
+
+    return (0);
+}
+
+int rtdm_in_rt_context(
+    void) {
+
+    return (1);
+}
+
+void rtdm_toseq_init(
+    rtdm_toseq_t *      timeout_seq,
+    nanosecs_rel_t      timeout) {
+
+    *timeout_seq = rtdm_clock_read() + (nanosecs_abs_t)timeout;
+}
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Events and semaphores
+ * @{ *//*--------------------------------------------------------------------*/
+
+void rtdm_event_init(
+    rtdm_event_t *      event,
+    unsigned long       pending) {
+
+    condInit(
+        &event->mutex,
+        &event->cond);
+    event->gen         = 0U;
+    event->isPending   = (0U != pending) ? true : false;
+    event->isDestroyed = false;
+}
+
+void rtdm_event_destroy(
+    rtdm_event_t *      event) {
+
+    pthread_mutex_lock(
+        &event->mutex);
+    event->isDestroyed = true;
+    pthread_cond_broadcast(
+        &event->cond);
+    pthread_mutex_unlock(
+        &event->mutex);
+}
+
+void rtdm_event_signal(
+    rtdm_event_t *      event) {
+
+    pthread_mutex_lock(
+        &event->mutex);
+    event->isPending = true;
+    event->gen++;
+    pthread_cond_broadcast(
+        &event->cond);
+    pthread_mutex_unlock(
+        &event->mutex);
+}
+
+void rtdm_event_pulse(
+    rtdm_event_t *      event) {
+
+    pthread_mutex_lock(
+        &event->mutex);
+    event->gen++;
+    pthread_cond_broadcast(
+        &event->cond);
+    pthread_mutex_unlock(
+        &event->mutex);
+}
+
+void rtdm_event_clear(
+    rtdm_event_t *      event) {
+
+    pthread_mutex_lock(
+        &event->mutex);
+    event->isPending = false;
+    pthread_mutex_unlock(
+        &event->mutex);
+}
+
+int rtdm_event_wait(
+    rtdm_event_t *      event) {
+
+    return (rtdm_event_timedwait(event, 0, NULL));
+}
+
+int rtdm_event_timedwait(
+    rtdm_event_t *      event,
+    nanosecs_rel_t      timeout,
+    rtdm_toseq_t *      timeout_seq) {
+
+    nanosecs_abs_t      deadline;
+    uint32_t            gen;
+    int                 retval;
+
+    pthread_mutex_lock(
+        &event->mutex);
+
+    if (true == event->isDestroyed) {
+        retval = -EIDRM;
+    } else if (true == event->isPending) {
+        event->isPending = false;
+        retval = 0;
+    } else if (0 == (retval = deadlineGet(timeout, timeout_seq, &deadline))) {
+        gen = event->gen;
+
+        while ((gen == event->gen) && (false == event->isDestroyed) && (0 == retval)) {
+            retval = condWait(
+                &event->mutex,
+                &event->cond,
+                deadline);
+        }
+
+        if (true == event->isDestroyed) {
+            retval = -EIDRM;
+        } else if (gen != event->gen) {
+            event->isPending = false;                                           /* Woken up waiters consume the event                       */
+            retval = 0;
+        }
+    }
+    pthread_mutex_unlock(
+        &event->mutex);
+
+    return (retval);
+}
+
+int rtdm_event_select_bind(
+    rtdm_event_t *      event,
+    rtdm_selector_t *   selector,
+    enum rtdm_selecttype type,
+    unsigned            fd_index) {
+
+    (void)event;
+    (void)selector;
+    (void)type;
+    (void)fd_index;
+
+    return (-ENOSYS);
+}
+
+void rtdm_sem_init(
+    rtdm_sem_t *        sem,
+    unsigned long       value) {
+
+    condInit(
+        &sem->mutex,
+        &sem->cond);
+    sem->value       = value;
+    sem->isDestroyed = false;
+}
+
+void rtdm_sem_destroy(
+    rtdm_sem_t *        sem) {
+
+    pthread_mutex_lock(
+        &sem->mutex);
+    sem->isDestroyed = true;
+    pthread_cond_broadcast(
+        &sem->cond);
+    pthread_mutex_unlock(
+        &sem->mutex);
+}
+
+int rtdm_sem_down(
+    rtdm_sem_t *        sem) {
+
+    return (rtdm_sem_timeddown(sem, 0, NULL));
+}
+
+int rtdm_sem_timeddown(
+    rtdm_sem_t *        sem,
+    nanosecs_rel_t      timeout,
+    rtdm_toseq_t *      timeout_seq) {
+
+    nanosecs_abs_t      deadline;
+    int                 retval;
+
+    pthread_mutex_lock(
+        &sem->mutex);
+
+    if (true == sem->isDestroyed) {
+        retval = -EIDRM;
+    } else if (0U != sem->value) {
+        sem->value--;
+        retval = 0;
+    } else if (0 == (retval = deadlineGet(timeout, timeout_seq, &deadline))) {
+
+        while ((0U == sem->value) && (false == sem->isDestroyed) && (0 == retval)) {
+            retval = condWait(
+                &sem->mutex,
+                &sem->cond,
+                deadline);
+        }
+
+        if (true == sem->isDestroyed) {
+            retval = -EIDRM;
+        } else if (0U != sem->value) {
+            sem->value--;
+            retval = 0;
+        }
+    }
+    pthread_mutex_unlock(
+        &sem->mutex);
+
+    return (retval);
+}
+
+void rtdm_sem_up(
+    rtdm_sem_t *        sem) {
+
+    pthread_mutex_lock(
+        &sem->mutex);
+    sem->value++;
+    pthread_cond_signal(
+        &sem->cond);
+    pthread_mutex_unlock(
+        &sem->mutex);
+}
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        User space access
+ * @{ *//*--------------------------------------------------------------------*/
+
+int rtdm_read_user_ok(
+    rtdm_user_info_t *  user_info,
+    const void __user * ptr,
+    size_t              size) {
+
+    (void)user_info;
+    (void)size;
+
+    return ((NULL != ptr) ? 1 : 0);
+}
+
+int rtdm_rw_user_ok(
+    rtdm_user_info_t *  user_info,
+    const void __user * ptr,
+    size_t              size) {
+
+    (void)user_info;
+    (void)size;
+
+    return ((NULL != ptr) ? 1 : 0);
+}
+
+int rtdm_copy_from_user(
+    rtdm_user_info_t *  user_info,
+    void *              dst,
+    const void __user * src,
+    size_t              size) {
+
+    (void)user_info;
+    memcpy(dst, src, size);
+
+    return (0);
+}
+
+int rtdm_safe_copy_from_user(
+    rtdm_user_info_t *  user_info,
+    void *              dst,
+    const void __user * src,
+    size_t              size) {
+
+    if (NULL == src) {
+
+        return (-EFAULT);
+    }
+
+    return (rtdm_copy_from_user(user_info, dst, src, size));
+}
+
+int rtdm_copy_to_user(
+    rtdm_user_info_t *  user_info,
+    void __user *       dst,
+    const void *        src,
+    size_t              size) {
+
+    (void)user_info;
+    memcpy(dst, src, size);
+
+    return (0);
+}
+
+int rtdm_safe_copy_to_user(
+    rtdm_user_info_t *  user_info,
+    void __user *       dst,
+    const void *        src,
+    size_t              size) {
+
+    if (NULL == dst) {
+
+        return (-EFAULT);
+    }
+
+    return (rtdm_copy_to_user(user_info, dst, src, size));
+}
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Native heap
+ * @{ *//*--------------------------------------------------------------------*/
+
+int rt_heap_create(
+    RT_HEAP *           heap,
+    const char *        name,
+    size_t              heapsize,
+    int                 mode) {
+
+    (void)name;
+
+    if ((0U == heapsize) || (0 == (mode & H_SINGLE))) {
+
+        return (-EINVAL);
+    }
+    heap->size  = heapsize;
+    heap->block = NULL;
+
+    return (0);
+}
+
+int rt_heap_delete(
+    RT_HEAP *           heap) {
+
+    free(heap->block);
+    heap->block = NULL;
+
+    return (0);
+}
+
+int rt_heap_alloc(
+    RT_HEAP *           heap,
+    size_t              size,
+    long long           timeout,
+    void **             blockp) {
+
+    (void)timeout;
+
+    if (NULL != heap->block) {
+
+        return (-EBUSY);
+    }
+
+    if ((0U != size) && (heap->size < size)) {
+
+        return (-EINVAL);
+    }
+    heap->block = malloc(heap->size);
+
+    if (NULL == heap->block) {
+
+        return (-ENOMEM);
+    }
+    *blockp = heap->block;
+
+    return (0);
+}
+
+int rt_heap_free(
+    RT_HEAP *           heap,
+    void *              block) {
+
+    if (block != heap->block) {
+
+        return (-EINVAL);
+    }
+    free(block);
+    heap->block = NULL;
+
+    return (0);
+}
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        Device access
+ * @{ *//*--------------------------------------------------------------------*/
+
+int rt_dev_open(
+    const char *        path,
+    int                 oflag,
+    ...) {
+
+    struct rtdm_device * device;
+    struct rtdm_dev_context * context;
+    uint32_t            cnt;
+    int                 fd;
+    int                 retval;
+
+    if (0 == strncmp(path, DEF_DEV_PREFIX, sizeof(DEF_DEV_PREFIX) - 1U)) {
+        path += sizeof(DEF_DEV_PREFIX) - 1U;
+    }
+    device = NULL;
+    fd     = -EMFILE;
+    pthread_mutex_lock(
+        &DevLock);
+
+    for (cnt = 0U; cnt < DEF_DEV_MAX; cnt++) {
+
+        if ((NULL != DevTable[cnt]) && (0 == strcmp(DevTable[cnt]->device_name, path))) {
+            device = DevTable[cnt];
+            break;
+        }
+    }
+
+    for (cnt = 0U; (NULL != device) && (cnt < DEF_FD_MAX); cnt++) {
+
+        if (NULL == FdTable[cnt]) {
+            fd = (int)cnt;
+            break;
+        }
+    }
+    context = NULL;
+
+    if ((NULL != device) && (0 <= fd)) {
+        context = calloc(
+            1U,
+            sizeof(struct rtdm_dev_context) + device->context_size);
+
+        if (NULL != context) {
+            context->fd     = fd;
+            context->ops    = &device->ops;
+            context->device = device;
+            FdTable[fd]     = context;                                          /* Reserve the descriptor                                   */
+        }
+    }
+    pthread_mutex_unlock(
+        &DevLock);
+
+    if (NULL == device) {
+
+        return (-ENODEV);
+    }
+
+    if (0 > fd) {
+
+        return (fd);
+    }
+
+    if (NULL == context) {
+
+        return (-ENOMEM);
+    }
+
+    if (NULL != device->open_nrt) {
+        retval = device->open_nrt(
+            context,
+            NULL,
+            oflag);
+    } else {
+        retval = device->open_rt(
+            context,
+            NULL,
+            oflag);
+    }
+
+    if (0 != retval) {
+        pthread_mutex_lock(
+            &DevLock);
+        FdTable[fd] = NULL;
+        pthread_mutex_unlock(
+            &DevLock);
+        free(context);
+
+        return (retval);
+    }
+
+    return (fd);
+}
+
+int rt_dev_close(
+    int                 fd) {
+
+    struct rtdm_dev_context * context;
+    int                 retval;
+
+    context = fdGet(
+        fd);
+
+    if (NULL == context) {
+
+        return (-EBADF);
+    }
+
+    if (NULL != context->ops->close_nrt) {
+        retval = context->ops->close_nrt(
+            context,
+            NULL);
+    } else {
+        retval = context->ops->close_rt(
+            context,
+            NULL);
+    }
+
+    if (0 != retval) {
+
+        return (retval);
+    }
+    pthread_mutex_lock(
+        &DevLock);
+    FdTable[fd] = NULL;
+    pthread_mutex_unlock(
+        &DevLock);
+    free(context);
+
+    return (0);
+}
+
+int rt_dev_ioctl(
+    int                 fd,
+    int                 request,
+    ...) {
+
+    struct rtdm_dev_context * context;
+    va_list             args;
+    void *              arg;
+    int                 retval;
+
+    va_start(args, request);
+    arg = va_arg(args, void *);
+    va_end(args);
+    context = fdGet(
+        fd);
+
+    if (NULL == context) {
+
+        return (-EBADF);
+    }
+    retval = -ENOSYS;
+
+    if (NULL != context->ops->ioctl_rt) {
+        retval = context->ops->ioctl_rt(
+            context,
+            NULL,
+            (unsigned int)request,
+            arg);
+    }
+
+    if ((-ENOSYS == retval) && (NULL != context->ops->ioctl_nrt)) {
+        retval = context->ops->ioctl_nrt(
+            context,
+            NULL,
+            (unsigned int)request,
+            arg);
+    }
+
+    return (retval);
+}
+
+ssize_t rt_dev_read(
+    int                 fd,
+    void *              buf,
+    size_t              nbyte) {
+
+    struct rtdm_dev_context * context;
+    rtdm_read_handler_t handler;
+
+    context = fdGet(
+        fd);
+
+    if (NULL == context) {
+
+        return (-EBADF);
+    }
+    handler = (NULL != context->ops->read_rt) ? context->ops->read_rt : context->ops->read_nrt;
+
+    if (NULL == handler) {
+
+        return (-ENOSYS);
+    }
+
+    return (handler(context, NULL, buf, nbyte));
+}
+
+ssize_t rt_dev_write(
+    int                 fd,
+    const void *        buf,
+    size_t              nbyte) {
+
+    struct rtdm_dev_context * context;
+    rtdm_write_handler_t handler;
+
+    context = fdGet(
+        fd);
+
+    if (NULL == context) {
+
+        return (-EBADF);
+    }
+    handler = (NULL != context->ops->write_rt) ? context->ops->write_rt : context->ops->write_nrt;
+
+    if (NULL == handler) {
+
+        return (-ENOSYS);
+    }
+
+    return (handler(context, NULL, buf, nbyte));
+}
+
+ssize_t rt_dev_recvmsg(
+    int                 fd,
+    struct msghdr *     msg,
+    int                 flags) {
+
+    struct rtdm_dev_context * context;
+    rtdm_recvmsg_handler_t handler;
+
+    context = fdGet(
+        fd);
+
+    if (NULL == context) {
+
+        return (-EBADF);
+    }
+    handler = (NULL != context->ops->recvmsg_rt) ? context->ops->recvmsg_rt : context->ops->recvmsg_nrt;
+
+    if (NULL == handler) {
+
+        return (-ENOSYS);
+    }
+
+    return (handler(context, NULL, msg, flags));
+}
+
+ssize_t rt_dev_sendmsg(
+    int                 fd,
+    const struct msghdr * msg,
+    int                 flags) {
+
+    struct rtdm_dev_context * context;
+    rtdm_sendmsg_handler_t handler;
+
+    context = fdGet(
+        fd);
+
+    if (NULL == context) {
+
+        return (-EBADF);
+    }
+    handler = (NULL != context->ops->sendmsg_rt) ? context->ops->sendmsg_rt : context->ops->sendmsg_nrt;
+
+    if (NULL == handler) {
+
+        return (-ENOSYS);
+    }
+
+    return (handler(context, NULL, msg, flags));
+}
+
+/** @} *//*-------------------------------------------------------------------*/
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of sim_rtdm.c
+ ******************************************************************************/
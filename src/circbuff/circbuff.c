@@ -77,10 +77,23 @@ void circInit(
     buff->tail = 0U;
     buff->size = (uint32_t)size;
     buff->free = buff->size;
+    buff->isMirrored = FALSE;
 
     ES_DBG_API_OBLIGATION(buff->signature = CIRC_SIGNATURE);
 }
 
+void circInitMirrored(
+    circBuff_T *        buff,
+    void *              mem,
+    size_t              size) {
+
+    circInit(
+        buff,
+        mem,
+        size);
+    buff->isMirrored = TRUE;
+}
+
 size_t circRemainingFreeGet(
     const circBuff_T *   buff) {
 
@@ -88,7 +101,9 @@ size_t circRemainingFreeGet(
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, CIRC_SIGNATURE == buff->signature);
 
-    if (buff->tail > buff->head) {
+    if (TRUE == buff->isMirrored) {
+        tmp = buff->free;                                                       /* Free space continues in the mirror                       */
+    } else if (buff->tail > buff->head) {
         tmp = buff->tail - buff->head;
     } else if (buff->tail < buff->head) {
         tmp = buff->size - buff->head;
@@ -109,7 +124,9 @@ size_t circRemainingOccGet(
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, CIRC_SIGNATURE == buff->signature);
 
-    if (buff->tail < buff->head) {
+    if (TRUE == buff->isMirrored) {
+        tmp = buff->size - buff->free;
+    } else if (buff->tail < buff->head) {
         tmp = buff->head - buff->tail;
     } else if (buff->tail > buff->head) {
         tmp = buff->size - buff->tail;
@@ -123,6 +140,22 @@ size_t circRemainingOccGet(
     return ((size_t)tmp);
 }
 
+size_t circStorageOccGet(
+    const circBuff_T *  buff) {
+
+    uint32_t            occ;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, CIRC_SIGNATURE == buff->signature);
+
+    occ = buff->size - buff->free;
+
+    if (occ > (buff->size - buff->tail)) {
+        occ = buff->size - buff->tail;
+    }
+
+    return ((size_t)occ);
+}
+
 size_t circFreeGet(
     const circBuff_T *   buff) {
 
@@ -192,8 +225,25 @@ void circPosHeadSet(
     buff->free -= position;
     buff->head += position;
 
-    if (buff->size == buff->head) {
-        buff->head = 0U;
+    if (buff->size <= buff->head) {
+        buff->head -= buff->size;                                               /* Mirrored buffers are written past the end                */
+    }
+    DBG_VALIDATE(buff, buff->head);
+    DBG_VALIDATE(buff, buff->free);
+}
+
+void circPosHeadRewind(
+    circBuff_T *        buff,
+    uint32_t            size) {
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, CIRC_SIGNATURE == buff->signature);
+
+    buff->free += size;
+
+    if (size > buff->head) {
+        buff->head += buff->size - size;
+    } else {
+        buff->head -= size;
     }
     DBG_VALIDATE(buff, buff->head);
     DBG_VALIDATE(buff, buff->free);
@@ -216,8 +266,8 @@ void circPosTailSet(
     buff->free += position;
     buff->tail += position;
 
-    if (buff->size == buff->tail) {
-        buff->tail = 0U;
+    if (buff->size <= buff->tail) {
+        buff->tail -= buff->size;
     }
     DBG_VALIDATE(buff, buff->head);
     DBG_VALIDATE(buff, buff->free);
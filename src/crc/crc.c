@@ -0,0 +1,286 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Table driven CRC-16 and CRC-32 implementation
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include "crc/crc.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+#define CRC_SLICES                      8U
+
+#define CRC_TABLES                      3U
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+
+/**@brief       Algorithm parameters
+ */
+struct crcParam {
+    uint32_t            poly;                                                   /**<@brief Polynomial, bit reversed for reflected algorithms*/
+    uint32_t            init;
+    uint32_t            xorOut;
+    size_t              size;
+    bool_T              isReflected;
+};
+
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static uint32_t crcUpdateRef(
+    const uint32_t      (* table)[256],
+    uint32_t            value,
+    const uint8_t *     data,
+    size_t              size);
+
+static uint32_t crcUpdateMsb16(
+    const uint32_t      (* table)[256],
+    uint32_t            value,
+    const uint8_t *     data,
+    size_t              size);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+static const struct crcParam CrcParam[] = {
+    [CRC_NONE] = {
+        .poly           = 0x0U,
+        .init           = 0x0U,
+        .xorOut         = 0x0U,
+        .size           = 0U,
+        .isReflected    = FALSE
+    },
+    [CRC_16_CCITT] = {
+        .poly           = 0x1021U,
+        .init           = 0xFFFFU,
+        .xorOut         = 0x0U,
+        .size           = 2U,
+        .isReflected    = FALSE
+    },
+    [CRC_16_MODBUS] = {
+        .poly           = 0xA001U,
+        .init           = 0xFFFFU,
+        .xorOut         = 0x0U,
+        .size           = 2U,
+        .isReflected    = TRUE
+    },
+    [CRC_32] = {
+        .poly           = 0xEDB88320U,
+        .init           = 0xFFFFFFFFU,
+        .xorOut         = 0xFFFFFFFFU,
+        .size           = 4U,
+        .isReflected    = TRUE
+    }
+};
+
+/**@brief       Slice-by-8 tables, entry [k][b] is the CRC of byte b followed
+ *              by k zero bytes
+ */
+static uint32_t CrcTable[CRC_TABLES][CRC_SLICES][256];
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+static uint32_t crcUpdateRef(
+    const uint32_t      (* table)[256],
+    uint32_t            value,
+    const uint8_t *     data,
+    size_t              size) {
+
+    while (CRC_SLICES <= size) {
+        uint32_t        low;
+
+        low   = value ^ ((uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+        value = table[7][low & 0xFFU] ^ table[6][(low >> 8) & 0xFFU] ^
+                table[5][(low >> 16) & 0xFFU] ^ table[4][low >> 24] ^
+                table[3][data[4]] ^ table[2][data[5]] ^
+                table[1][data[6]] ^ table[0][data[7]];
+        data += CRC_SLICES;
+        size -= CRC_SLICES;
+    }
+
+    while (0U != size) {
+        value = (value >> 8) ^ table[0][(value ^ *data++) & 0xFFU];
+        size--;
+    }
+
+    return (value);
+}
+
+static uint32_t crcUpdateMsb16(
+    const uint32_t      (* table)[256],
+    uint32_t            value,
+    const uint8_t *     data,
+    size_t              size) {
+
+    while (CRC_SLICES <= size) {
+        value = table[7][data[0] ^ (value >> 8)] ^ table[6][data[1] ^ (value & 0xFFU)] ^
+                table[5][data[2]] ^ table[4][data[3]] ^
+                table[3][data[4]] ^ table[2][data[5]] ^
+                table[1][data[6]] ^ table[0][data[7]];
+        data += CRC_SLICES;
+        size -= CRC_SLICES;
+    }
+
+    while (0U != size) {
+        value = ((value << 8) & 0xFFFFU) ^ table[0][((value >> 8) ^ *data++) & 0xFFU];
+        size--;
+    }
+
+    return (value);
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+void crcModuleInit(
+    void) {
+
+    enum crcType        type;
+
+    for (type = CRC_16_CCITT; type <= CRC_32; type++) {
+        const struct crcParam * param;
+        uint32_t        (* table)[256];
+        uint32_t        item;
+
+        param = &CrcParam[type];
+        table = CrcTable[type - 1];
+
+        for (item = 0U; item < 256U; item++) {
+            uint32_t    value;
+            uint32_t    bit;
+
+            if (TRUE == param->isReflected) {
+                value = item;
+
+                for (bit = 0U; bit < 8U; bit++) {
+                    value = (0U != (value & 0x1U)) ? ((value >> 1) ^ param->poly) : (value >> 1);
+                }
+            } else {
+                value = item << 8;
+
+                for (bit = 0U; bit < 8U; bit++) {
+                    value = (0U != (value & 0x8000U)) ? ((value << 1) ^ param->poly) : (value << 1);
+                }
+                value &= 0xFFFFU;
+            }
+            table[0][item] = value;
+        }
+
+        for (item = 0U; item < 256U; item++) {
+            uint32_t    slice;
+
+            for (slice = 1U; slice < CRC_SLICES; slice++) {
+                uint32_t prev;
+
+                prev = table[slice - 1U][item];
+
+                if (TRUE == param->isReflected) {
+                    table[slice][item] = (prev >> 8) ^ table[0][prev & 0xFFU];
+                } else {
+                    table[slice][item] = ((prev << 8) & 0xFFFFU) ^ table[0][prev >> 8];
+                }
+            }
+        }
+    }
+}
+
+void crcInit(
+    struct crc *        crc,
+    enum crcType        type) {
+
+    crc->type  = type;
+    crc->value = CrcParam[type].init;
+}
+
+void crcUpdate(
+    struct crc *        crc,
+    const uint8_t *     data,
+    size_t              size) {
+
+    const uint32_t      (* table)[256];
+
+    if (CRC_NONE == crc->type) {
+
+        return;
+    }
+    table = (const uint32_t (*)[256])CrcTable[crc->type - 1];
+
+    if (TRUE == CrcParam[crc->type].isReflected) {
+        crc->value = crcUpdateRef(
+            table,
+            crc->value,
+            data,
+            size);
+    } else {
+        crc->value = crcUpdateMsb16(
+            table,
+            crc->value,
+            data,
+            size);
+    }
+}
+
+uint32_t crcValueGet(
+    const struct crc *  crc) {
+
+    return (crc->value ^ CrcParam[crc->type].xorOut);
+}
+
+size_t crcSizeGet(
+    const struct crc *  crc) {
+
+    return (CrcParam[crc->type].size);
+}
+
+size_t crcSerialize(
+    const struct crc *  crc,
+    uint8_t *           dst) {
+
+    uint32_t            value;
+    size_t              size;
+    size_t              cnt;
+
+    value = crcValueGet(
+        crc);
+    size  = crcSizeGet(
+        crc);
+
+    for (cnt = 0U; cnt < size; cnt++) {
+
+        if (TRUE == CrcParam[crc->type].isReflected) {
+            dst[cnt] = (uint8_t)(value >> (8U * cnt));
+        } else {
+            dst[cnt] = (uint8_t)(value >> (8U * (size - 1U - cnt)));
+        }
+    }
+
+    return (size);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of crc.c
+ ******************************************************************************/
@@ -32,12 +32,15 @@
 #include <linux/module.h>
 #include <linux/init.h>
 #include <linux/dma-mapping.h>
+#include <linux/vmalloc.h>
 
 #include "arch/compiler.h"
 #include "drv/x-16c750.h"
 #include "drv/x-16c750_lld.h"
 #include "drv/x-16c750_cfg.h"
 #include "drv/x-16c750_ioctl.h"
+#include "drv/x-16c750_iov.h"
+#include "drv/x-16c750_vnm.h"
 #include "dbg/dbg.h"
 #include "port/port.h"
 #include "log.h"
@@ -63,28 +66,44 @@
 #define MS_TO_NS(ms)                    (NS_PER_MS * (ms))
 #define SEC_TO_NS(sec)                  (NS_PER_S * (sec))
 
+/*
+ * Each unit (rx, tx) has its own critical section, so the reader, the writer
+ * and the ISR servicing the other direction never contend. The IER shadow is
+ * shared by both directions and is protected by a separate short lock. Lock
+ * order is: rx, tx, IER.
+ */
 #if (0 == CFG_CRITICAL_INT_ENABLE)
 #define CRITICAL_DECL(lockCtxName)                                              \
     rtdm_lockctx_t lockCtxName
 
 #define CRITICAL_INIT(uartCtx)                                                  \
-    rtdm_lock_init(&((uartCtx)->lock))
+    do {                                                                        \
+        rtdm_lock_init(&((uartCtx)->rx.lock));                                  \
+        rtdm_lock_init(&((uartCtx)->tx.lock));                                  \
+        rtdm_lock_init(&((uartCtx)->cache.lock));                               \
+    } while (0)
 
-#define CRITICAL_ENTER(uartCtx, lockCtx)                                        \
-    rtdm_lock_get_irqsave(&((uartCtx)->lock), lockCtx)
+#define CRITICAL_ENTER(uartCtx, unit, lockCtx)                                  \
+    rtdm_lock_get_irqsave(&((uartCtx)->unit.lock), lockCtx)
 
-#define CRITICAL_ENTER_ISR(uartCtx)                                             \
-    rtdm_lock_get(&(uartCtx)->lock)
+#define CRITICAL_ENTER_ISR(uartCtx, unit)                                       \
+    rtdm_lock_get(&(uartCtx)->unit.lock)
 
-#define CRITICAL_EXIT(uartCtx, lockCtx)                                         \
-    rtdm_lock_put_irqrestore(&((uartCtx)->lock), lockCtx)
+#define CRITICAL_EXIT(uartCtx, unit, lockCtx)                                   \
+    rtdm_lock_put_irqrestore(&((uartCtx)->unit.lock), lockCtx)
 
-#define CRITICAL_EXIT_ISR(uartCtx)                                              \
-    rtdm_lock_put(&(uartCtx)->lock)
+#define CRITICAL_EXIT_ISR(uartCtx, unit)                                        \
+    rtdm_lock_put(&(uartCtx)->unit.lock)
 
 #define CRITICAL_TYPE                                                           \
     rtdm_lockctx_t
 
+#define CACHE_LOCK_ENTER(uartCtx, lockCtx)                                      \
+    rtdm_lock_get_irqsave(&((uartCtx)->cache.lock), lockCtx)
+
+#define CACHE_LOCK_EXIT(uartCtx, lockCtx)                                       \
+    rtdm_lock_put_irqrestore(&((uartCtx)->cache.lock), lockCtx)
+
 #else
 #define CRITICAL_DECL(lockCtxName)                                              \
     PORT_C_UNUSED uint8_t lockCtxName
@@ -92,7 +111,7 @@
 #define CRITICAL_INIT(uartCtx)                                                  \
     (void)0
 
-#define CRITICAL_ENTER(uartCtx, lockCtx)                                        \
+#define CRITICAL_ENTER(uartCtx, unit, lockCtx)                                  \
     do {                                                                        \
         lldRegWr(                                                               \
             uartCtx->cache.io,                                                  \
@@ -100,10 +119,10 @@
             0);                                                                 \
     } while (0)
 
-#define CRITICAL_ENTER_ISR(uartCtx)                                             \
+#define CRITICAL_ENTER_ISR(uartCtx, unit)                                       \
     (void)0
 
-#define CRITICAL_EXIT(uartCtx, lockCtx)                                         \
+#define CRITICAL_EXIT(uartCtx, unit, lockCtx)                                   \
     do {                                                                        \
         lldRegWr(                                                               \
             uartCtx->cache.io,                                                  \
@@ -111,14 +130,43 @@
             uartCtx->cache.IER);                                                \
     } while (0)
 
-#define CRITICAL_EXIT_ISR(uartCtx)                                              \
+#define CRITICAL_EXIT_ISR(uartCtx, unit)                                        \
     (void)0
 
 #define CRITICAL_TYPE                                                           \
     uint8_t
 
+#define CACHE_LOCK_ENTER(uartCtx, lockCtx)                                      \
+    (void)0
+
+#define CACHE_LOCK_EXIT(uartCtx, lockCtx)                                       \
+    (void)0
+
 #endif
 
+/**@brief       Size of the stack staging area used by the framed TX path
+ */
+#define DEF_FRAME_TX_CHUNK              64U
+
+/**@brief       Bits per character used for Modbus RTU timing (start, 8 data,
+ *              parity or second stop, stop)
+ */
+#define DEF_RTU_CHAR_BITS               11U
+
+/**@brief       Baud rate above which fixed Modbus RTU timing is used
+ */
+#define DEF_RTU_FIXED_BAUD              19200U
+
+/**@brief       Number of timed THR bursts and DMA cycles averaged by the
+ *              hybrid engine calibration
+ */
+#define DEF_HYBRID_SAMPLES              8U
+
+/**@brief       Free TX FIFO space at which the UART requests the next DMA
+ *              transfer of the hardware DMA engine
+ */
+#define DEF_DMA_TX_THRESHOLD            8U
+
 /*======================================================  LOCAL DATA TYPES  ==*/
 
 enum cIntNum {
@@ -127,13 +175,50 @@ enum cIntNum {
     C_INT_RX_TIMEOUT    = IER_RHRIT
 };
 
+/**@brief       Transfer engine operations
+ * @details     Functions ending with I are called with the lock of their unit
+ *              held, attachI() and detachI() with both locks held. Whatever
+ *              signals the completion (interrupt, DMA callback or service
+ *              timer) ends in rxServiceI() and txServiceI(), so framing,
+ *              filters and wakeups behave the same with every engine.
+ */
+struct xferEngine {
+    enum xUartEngine    id;
+    const char *        name;
+    void             (* attachI)(struct uartCtx *);                             /**<@brief Engine takes over the FIFO, may be NULL          */
+    void             (* detachI)(struct uartCtx *);                             /**<@brief Engine releases the FIFO, may be NULL            */
+    void             (* rxStartI)(struct uartCtx *);
+    void             (* rxStopI)(struct uartCtx *);
+    void             (* txKickI)(struct uartCtx *);                             /**<@brief TX buffer has data to send                       */
+    void             (* txStopI)(struct uartCtx *);
+    void             (* txTransI)(struct uartCtx *, size_t);                    /**<@brief Move data from TX buffer towards the FIFO        */
+};
+
 /*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
 
-/* ===========================================================================
- * NOTE:    These functions will compile only in DMA mode 0 (disabled) and DMA
- *          mode 1 (soft DMA)
- * ===========================================================================*/
-#if (0 == CFG_DMA_MODE) || (1 == CFG_DMA_MODE)
+/**@brief       Update RX readiness state from current buffer occupancy
+ */
+static void rxRdyUpdateI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Update TX readiness state from current buffer free space
+ */
+static void txRdyUpdateI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Set RX status and keep it for the next read
+ * @details     The interrupt handler resets the status on every interrupt,
+ *              so errors found outside of a read are latched until a read
+ *              reports them.
+ */
+static void rxStatusLatchI(
+    struct uartCtx *    uartCtx,
+    enum uartStatus     status);
+
+/**@brief       Record the status of the read which is ending
+ */
+static void rxStatusTakeI(
+    struct uartCtx *    uartCtx);
 
 static void cIntEnable(
     struct uartCtx *    uartCtx,
@@ -151,9 +236,14 @@ static void cIntSetDisable(
     struct uartCtx *    uartCtx,
     enum cIntNum        cIntNum);
 
+/**@brief       Allocate a buffer and map it for streaming DMA in @c dir
+ * @details     DMA_NONE buffers are used only by the CPU and are not mapped.
+ *              The direction is ignored in DMA mode 0.
+ */
 static int32_t buffAlloc(
     struct buff *       buff,
-    size_t              size);
+    size_t              size,
+    enum dma_data_direction dir);
 
 static uint32_t buffDealloc(
     struct buff *       buff);
@@ -175,7 +265,7 @@ static int buffRxWait(
 static ssize_t buffRxCopyI(
     struct uartCtx *    uartCtx,
     CRITICAL_TYPE *     lockCtx,
-    uint8_t *           dst,
+    struct ioCursor *   dst,
     size_t              pending);
 
 static void buffRxFlush(
@@ -198,80 +288,450 @@ static int buffTxWait(
 static ssize_t buffTxCopyI(
     struct uartCtx *    uartCtx,
     CRITICAL_TYPE *     lockCtx,
-    const uint8_t *     src,
+    struct ioCursor *   src,
     size_t              bytes);
 
-static void buffTxTrans(
+static void buffTxFlushI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Append the running TX CRC to the transmit buffer
+ */
+static int buffTxCrcAppendI(
+    struct uartCtx *    uartCtx,
+    CRITICAL_TYPE *     lockCtx,
+    rtdm_toseq_t *      tmSeq);
+
+/**@brief       Make the receiver run continuously instead of only during read
+ */
+static void buffRxPersistI(
+    struct uartCtx *    uartCtx);
+
+static bool_T filterIsMatch(
+    const struct xUartFilter * cfg,
+    uint8_t             item);
+
+/**@brief       Read a FIFO burst and apply the receive address filter
+ * @return      Number of accepted bytes stored in @c burst
+ */
+static size_t buffRxFifoRd(
     struct uartCtx *    uartCtx,
+    uint8_t *           burst,
     size_t              size);
 
-static void buffTxFlushI(
+/**@brief       Decode a FIFO burst into the RX buffer when framing is enabled
+ */
+static void buffRxFrameTrans(
+    struct uartCtx *    uartCtx,
+    size_t              size);
+
+/**@brief       Receive a FIFO burst in Modbus RTU mode
+ */
+static void buffRxRtuTransI(
+    struct uartCtx *    uartCtx,
+    size_t              size,
+    bool_T              isSilent);
+
+/**@brief       Terminate the Modbus RTU frame being received
+ */
+static void buffRxRtuEndI(
     struct uartCtx *    uartCtx);
 
-#if (1 == CFG_DMA_MODE)
-static void dmaCallbackRx(
-    void *              arg);
+/**@brief       Modbus RTU t1.5 and t3.5 timer handler
+ */
+static void rtuTimerHandler(
+    rtdm_timer_t *      timer);
 
-static void dmaCallbackTx(
-    void *              arg);
-#endif /* (1 == CFG_DMA_MODE) */
+/**@brief       Wait until the line was idle for t3.5
+ */
+static int buffTxIdleWaitI(
+    struct uartCtx *    uartCtx,
+    CRITICAL_TYPE *     lockCtx,
+    rtdm_toseq_t *      tmSeq);
 
-static int handleIrq(
-    rtdm_irq_t *        arg);
+/**@brief       Arm the poll timer
+ */
+static void pollTimerArmI(
+    struct uartCtx *    uartCtx,
+    nanosecs_abs_t      expiry,
+    bool_T              isTimer);
 
-/* ===========================================================================
- * NOTE:    End of DMA mode 0 (disabled) and DMA mode 1 (soft DMA) functions
- * NOTE:    Begin of functions that will compile only in DMA mode 2 (hardware
- *          DMA)
- * ===========================================================================*/
-#elif (2 == CFG_DMA_MODE)
+/**@brief       Begin a new poll cycle
+ */
+static void pollCycleBeginI(
+    struct uartCtx *    uartCtx,
+    bool_T              isTimer);
 
-static int32_t buffAlloc(
-    struct buff *       buff,
+/**@brief       Publish cycle results and schedule the next cycle
+ */
+static void pollCycleEndI(
+    struct uartCtx *    uartCtx,
+    bool_T              isTimer);
+
+/**@brief       Send the next due request or end the cycle
+ */
+static void pollNextI(
+    struct uartCtx *    uartCtx,
+    bool_T              isTimer);
+
+/**@brief       Move the response of the current entry into its slot
+ */
+static void pollSlotFillI(
+    struct uartCtx *    uartCtx,
+    enum xUartPollStatus status);
+
+/**@brief       Check for response completion after received data
+ */
+static void pollRxI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Poll cycle and response timeout handler
+ */
+static void pollTimerHandler(
+    rtdm_timer_t *      timer);
+
+static int pollStart(
+    struct uartCtx *    uartCtx);
+
+static int pollStop(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Copy a received burst into the buffers of all taps
+ */
+static void tapFeedI(
+    struct uartCtx *    uartCtx,
+    const uint8_t *     burst,
     size_t              size);
 
-static uint32_t buffDealloc(
-    struct buff *       buff);
+/**@brief       Create the tap contexts of TapPool
+ */
+static int tapPoolInit(
+    void);
 
-static void buffTxFlushI(
+static void tapPoolTerm(
+    void);
+
+/**@brief       Take a free tap context from TapPool
+ * @details     Must be called with TapLock held.
+ * @return      Tap context or NULL when all taps are in use
+ */
+static struct uartCtx * tapClaimI(
+    void);
+
+/**@brief       Reset tap context and attach it to the hardware owner
+ */
+static int tapOpen(
+    struct uartCtx *    tap,
+    struct uartCtx *    owner);
+
+static void tapClose(
+    struct uartCtx *    tap);
+
+/**@brief       Move the received frame of a virtual channel to its tap
+ */
+static void muxDeliverI(
     struct uartCtx *    uartCtx);
 
-static ssize_t buffTxCopy(
+/**@brief       Receive core of a tap bound to a virtual channel
+ */
+static ssize_t xferRdChannel(
+    struct uartCtx *    tap,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   dst,
+    size_t              bytes);
+
+/**@brief       Orphan all taps of a closing owner
+ */
+static void tapDetachAllI(
+    struct uartCtx *    owner);
+
+/**@brief       Receive core of a tap
+ */
+static ssize_t xferRdTap(
+    struct uartCtx *    tap,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   dst,
+    size_t              bytes);
+
+/**@brief       Drop committed bytes from the RX buffer
+ */
+static void buffRxSkipI(
+    struct uartCtx *    uartCtx,
+    size_t              size);
+
+/**@brief       Wait for one complete frame and copy it into I/O vector
+ */
+static ssize_t buffRxFrameGetI(
+    struct uartCtx *    uartCtx,
+    CRITICAL_TYPE *     lockCtx,
+    struct ioCursor *   dst,
+    size_t              bytes,
+    rtdm_toseq_t *      tmSeq);
+
+/**@brief       Wait until a wake condition is met and copy received bytes
+ *              into I/O vector
+ */
+static ssize_t buffRxUntilI(
+    struct uartCtx *    uartCtx,
+    CRITICAL_TYPE *     lockCtx,
+    struct ioCursor *   dst,
+    size_t              bytes,
+    const struct rxWake * wake,
+    rtdm_toseq_t *      tmSeq);
+
+/**@brief       Transmit request and receive response in one call
+ */
+static ssize_t xferTransact(
     struct uartCtx *    uartCtx,
-    const uint8_t *     src,
+    rtdm_user_info_t *  usrInfo,
+    const struct xUartTransact * req);
+
+/**@brief       Generate self test pattern starting at stream @c offset
+ */
+static void selfTestFill(
     uint8_t *           dst,
+    size_t              size,
+    size_t              offset,
+    uint32_t            pattern,
+    uint8_t             mask);
+
+/**@brief       Pump a pattern through the UART in internal loopback
+ */
+static int xferSelfTest(
+    struct uartCtx *    uartCtx,
+    struct xUartSelfTest * test);
+
+/**@brief       Receive one frame into I/O vector
+ */
+static ssize_t xferRdFrame(
+    struct uartCtx *    uartCtx,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   dst,
     size_t              bytes);
 
+/**@brief       Transmit I/O vector as one frame
+ * @param       channel
+ *              Virtual channel number sent as the first byte of the frame,
+ *              or -1 when channels are not used
+ */
+static ssize_t xferWrFrame(
+    struct uartCtx *    uartCtx,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   src,
+    size_t              bytes,
+    int32_t             channel);
+
+/**@brief       Move received bytes from the FIFO into the RX buffer
+ * @param       transfer
+ *              Number of bytes waiting in the FIFO
+ * @param       isTimeout
+ *              The line was silent for four characters
+ */
+static void rxServiceI(
+    struct uartCtx *    uartCtx,
+    size_t              transfer,
+    bool_T              isTimeout);
+
+/**@brief       Feed the FIFO from the TX buffer and stop the engine when empty
+ */
+static void txServiceI(
+    struct uartCtx *    uartCtx);
+
+static void irqRxStartI(
+    struct uartCtx *    uartCtx);
+
+static void irqRxStopI(
+    struct uartCtx *    uartCtx);
+
+static void irqTxKickI(
+    struct uartCtx *    uartCtx);
+
+static void irqTxStopI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Copy bytes from the TX buffer to THR, used by the interrupt and
+ *              polled engines
+ */
+static void fifoTxTransI(
+    struct uartCtx *    uartCtx,
+    size_t              size);
+
+#if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
+/**@brief       Stop a running TX transfer and take its span back from DMA
+ */
+static void softDmaDetachI(
+    struct uartCtx *    uartCtx);
+
+static void softDmaTxStopI(
+    struct uartCtx *    uartCtx);
+#endif
+
+#if (1 == CFG_DMA_MODE)
+static void softDmaTxTransI(
+    struct uartCtx *    uartCtx,
+    size_t              size);
+
+/**@brief       Start timing the next THR bursts and DMA cycles of the hybrid
+ *              engine
+ */
+static void hybridCalibrateI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Derive the hybrid threshold once enough bursts were timed
+ */
+static void hybridSampleI(
+    struct uartCtx *    uartCtx);
+
+static void hybridAttachI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Stop a running TX transfer like the soft-dma engine and drop
+ *              the calibration samples of the stopped DMA cycle
+ */
+static void hybridDetachI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Write short bursts to THR and hand long ones to DMA
+ */
+static void hybridTxTransI(
+    struct uartCtx *    uartCtx,
+    size_t              size);
+#endif /* (1 == CFG_DMA_MODE) */
+
+#if (2 == CFG_DMA_MODE)
+/**@brief       Let the UART request TX DMA transfers
+ */
+static void hwDmaAttachI(
+    struct uartCtx *    uartCtx);
+
+static void hwDmaDetachI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Start the DMA transfer without waiting for the THR interrupt
+ */
+static void hwDmaTxKickI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Hand whole DMA requests worth of data to DMA and write the
+ *              shorter rest to THR
+ */
+static void hwDmaTxTransI(
+    struct uartCtx *    uartCtx,
+    size_t              size);
+#endif /* (2 == CFG_DMA_MODE) */
+
+static void polledAttachI(
+    struct uartCtx *    uartCtx);
+
+static void polledDetachI(
+    struct uartCtx *    uartCtx);
+
+static void polledRxStartI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Stop function of the polled engine, the service timer checks
+ *              the unit flags instead
+ */
+static void polledStopI(
+    struct uartCtx *    uartCtx);
+
+static void polledTxKickI(
+    struct uartCtx *    uartCtx);
+
+/**@brief       Service timer of the polled engine
+ */
+static void polledTimerHandler(
+    rtdm_timer_t *      timer);
+
+/**@brief       Look up an engine available in this build
+ * @return      Engine operations or NULL when not available
+ */
+static const struct xferEngine * engineFind(
+    uint32_t            id);
+
+/**@brief       Hand the FIFO over to another engine
+ */
+static void engineSwitchI(
+    struct uartCtx *    uartCtx,
+    const struct xferEngine * engine);
+
+/**@brief       Change the engine once pending transfers are finished
+ */
+static int engineSet(
+    struct uartCtx *    uartCtx,
+    uint32_t            id);
+
+#if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
 static void dmaCallbackRx(
     void *              arg);
 
 static void dmaCallbackTx(
     void *              arg);
+#endif /* (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE) */
 
-/* ===========================================================================
- * NOTE:    End of DMA mode 2 (hardware DMA) functions
- * ===========================================================================*/
-#endif /* (2 == CFG_DMA_MODE) */
+static int handleIrq(
+    rtdm_irq_t *        arg);
+
+#if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
+/**@brief       Hand a span of the buffer over to DMA, cached CPU writes are
+ *              cleaned to memory
+ */
+static void buffDmaGiveI(
+    struct buff *       buff,
+    size_t              pos,
+    size_t              size);
+
+/**@brief       Take a span of the buffer back from DMA, stale cache lines of
+ *              received data are invalidated
+ */
+static void buffDmaTakeI(
+    struct buff *       buff,
+    size_t              pos,
+    size_t              size);
+#endif
 
 static struct uartCtx * uartCtxFromDevCtx(
     struct rtdm_dev_context * devCtx);
 
 /**@brief       Create UART context
+ * @details     Allocates buffers, events and the IRQ once, when the module is
+ *              loaded.
  */
 static int uartCtxInit(
     struct uartCtx *    uartCtx,
     struct devData *    devData,
     volatile uint8_t *  io);
 
+/**@brief       Reset UART context for a new open
+ * @details     Does not allocate anything, so it has bounded execution time.
+ */
+static void uartCtxOpen(
+    struct uartCtx *    uartCtx);
+
 /**@brief       Destroy UART context
  */
 static void uartCtxTerm(
     struct uartCtx *    uartCtx);
 
+static void rxWakeInit(
+    struct rxWake *     wake);
+
+static void rxWakeDelimAdd(
+    struct rxWake *     wake,
+    uint8_t             item);
+
+static inline bool_T rxWakeIsDelim(
+    const struct rxWake * wake,
+    uint8_t             item);
+
+/**@brief       Check the protocol against the baud rate table of the port
+ */
 static bool_T xProtoIsValid(
     const struct xUartProto * proto);
 
-static void xProtoSet(
+/**@brief       Program the protocol, the previous one is kept when the UART
+ *              does not accept it
+ */
+static int xProtoSet(
     struct uartCtx *    uartCtx,
     const struct xUartProto * proto);
 
@@ -296,30 +756,186 @@ static int handleIOctl(
     unsigned int        req,
     void __user *       mem);
 
-/**@brief       Read device handler
+/**@brief       Select bind handler
  */
-static int handleRd(
+static int handleSelBind(
     struct rtdm_dev_context * devCtx,
-    rtdm_user_info_t *  usrInfo,
-    void *              buff,
-    size_t              bytes);
+    rtdm_selector_t *   selector,
+    enum rtdm_selecttype type,
+    unsigned int        fdIndex);
 
-/**@brief       Write device handler
+/**@brief       Receive data into I/O vector
  */
-static int handleWr(
-    struct rtdm_dev_context * devCtx,
+static ssize_t xferRd(
+    struct uartCtx *    uartCtx,
     rtdm_user_info_t *  usrInfo,
-    const void *        buff,
+    struct ioCursor *   dst,
     size_t              bytes);
 
+/**@brief       Transmit data from I/O vector
+ */
+static ssize_t xferWr(
+    struct uartCtx *    uartCtx,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   src,
+    size_t              bytes);
+
+/**@brief       Read device handler
+ */
+static ssize_t handleRd(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    void *              buff,
+    size_t              bytes);
+
+/**@brief       Write device handler
+ */
+static ssize_t handleWr(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    const void *        buff,
+    size_t              bytes);
+
+/**@brief       Scatter read device handler
+ */
+static ssize_t handleRecvMsg(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    struct msghdr *     msg,
+    int                 flags);
+
+/**@brief       Gather write device handler
+ */
+static ssize_t handleSendMsg(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    const struct msghdr * msg,
+    int                 flags);
+
 /*=======================================================  LOCAL VARIABLES  ==*/
 
 DECL_MODULE_INFO(CFG_DRV_NAME, DEF_DRV_DESCRIPTION, DEF_DRV_AUTHOR);
 
+/**@brief       Context which owns the hardware, NULL when device is closed
+ */
+static struct uartCtx * UartOwner;
+
+/**@brief       Protects UartOwner and attaching or detaching of taps
+ */
+static rtdm_lock_t      TapLock;
+
+/**@brief       Context of the hardware owner, created when the module is loaded
+ */
+static struct uartCtx   UartCtx;
+
+/**@brief       Tap contexts, created when the module is loaded
+ */
+static struct uartCtx   TapPool[CFG_TAP_MAX];
+
+/**@brief       Interrupt driven engine, the FIFO is serviced by handleIrq()
+ */
+static const struct xferEngine IrqEngine = {
+    .id                 = XUART_ENGINE_IRQ,
+    .name               = "irq",
+    .attachI            = NULL,
+    .detachI            = NULL,
+    .rxStartI           = irqRxStartI,
+    .rxStopI            = irqRxStopI,
+    .txKickI            = irqTxKickI,
+    .txStopI            = irqTxStopI,
+    .txTransI           = fifoTxTransI
+};
+
+#if (1 == CFG_DMA_MODE)
+/**@brief       Receives like the interrupt engine, TX interrupt starts a DMA
+ *              transfer of the buffered data
+ */
+static const struct xferEngine SoftDmaEngine = {
+    .id                 = XUART_ENGINE_SOFT_DMA,
+    .name               = "soft-dma",
+    .attachI            = NULL,
+    .detachI            = softDmaDetachI,
+    .rxStartI           = irqRxStartI,
+    .rxStopI            = irqRxStopI,
+    .txKickI            = irqTxKickI,
+    .txStopI            = softDmaTxStopI,
+    .txTransI           = softDmaTxTransI
+};
+
+/**@brief       Receives like the interrupt engine, TX writes bursts up to the
+ *              hybrid threshold to THR and sends longer ones by DMA
+ */
+static const struct xferEngine HybridEngine = {
+    .id                 = XUART_ENGINE_HYBRID,
+    .name               = "hybrid",
+    .attachI            = hybridAttachI,
+    .detachI            = hybridDetachI,
+    .rxStartI           = irqRxStartI,
+    .rxStopI            = irqRxStopI,
+    .txKickI            = irqTxKickI,
+    .txStopI            = softDmaTxStopI,
+    .txTransI           = hybridTxTransI
+};
+#endif /* (1 == CFG_DMA_MODE) */
+
+#if (2 == CFG_DMA_MODE)
+/**@brief       Receives like the interrupt engine, write() starts the DMA
+ *              transfer and the UART DMA requests pace it
+ */
+static const struct xferEngine HwDmaEngine = {
+    .id                 = XUART_ENGINE_DMA,
+    .name               = "dma",
+    .attachI            = hwDmaAttachI,
+    .detachI            = hwDmaDetachI,
+    .rxStartI           = irqRxStartI,
+    .rxStopI            = irqRxStopI,
+    .txKickI            = hwDmaTxKickI,
+    .txStopI            = softDmaTxStopI,
+    .txTransI           = hwDmaTxTransI
+};
+#endif /* (2 == CFG_DMA_MODE) */
+
+/**@brief       UART interrupts stay masked, the FIFO is serviced every
+ *              CFG_ENGINE_POLL_US by polledTimerHandler()
+ */
+static const struct xferEngine PolledEngine = {
+    .id                 = XUART_ENGINE_POLL,
+    .name               = "polled",
+    .attachI            = polledAttachI,
+    .detachI            = polledDetachI,
+    .rxStartI           = polledRxStartI,
+    .rxStopI            = polledStopI,
+    .txKickI            = polledTxKickI,
+    .txStopI            = polledStopI,
+    .txTransI           = fifoTxTransI
+};
+
+/**@brief       Engines indexed by enum xUartEngine, NULL when not available
+ */
+static const struct xferEngine * const Engines[] = {
+    [XUART_ENGINE_IRQ]      = &IrqEngine,
+#if (1 == CFG_DMA_MODE)
+    [XUART_ENGINE_SOFT_DMA] = &SoftDmaEngine,
+#else
+    [XUART_ENGINE_SOFT_DMA] = NULL,                                             /* Needs the software triggered channel of DMA mode 1       */
+#endif
+#if (2 == CFG_DMA_MODE)
+    [XUART_ENGINE_DMA]      = &HwDmaEngine,
+#else
+    [XUART_ENGINE_DMA]      = NULL,                                             /* Needs the UART event channel of DMA mode 2               */
+#endif
+    [XUART_ENGINE_POLL]     = &PolledEngine,
+#if (1 == CFG_DMA_MODE)
+    [XUART_ENGINE_HYBRID]   = &HybridEngine
+#else
+    [XUART_ENGINE_HYBRID]   = NULL
+#endif
+};
+
 static struct rtdm_device UartDev = {
     .struct_version     = RTDM_DEVICE_STRUCT_VER,
-    .device_flags       = RTDM_NAMED_DEVICE | RTDM_EXCLUSIVE,
-    .context_size       = sizeof(struct uartCtx),
+    .device_flags       = RTDM_NAMED_DEVICE,
+    .context_size       = sizeof(struct uartCtx *),
     .device_name        = CFG_DRV_NAME,
     .protocol_family    = 0,
     .socket_type        = 0,
@@ -332,14 +948,14 @@ static struct rtdm_device UartDev = {
         .close_nrt          = handleClose,
         .ioctl_rt           = handleIOctl,
         .ioctl_nrt          = handleIOctl,
-        .select_bind        = NULL,
+        .select_bind        = handleSelBind,
         .read_rt            = handleRd,
         .read_nrt           = NULL,
         .write_rt           = handleWr,
         .write_nrt          = NULL,
-        .recvmsg_rt         = NULL,
+        .recvmsg_rt         = handleRecvMsg,
         .recvmsg_nrt        = NULL,
-        .sendmsg_rt         = NULL,
+        .sendmsg_rt         = handleSendMsg,
         .sendmsg_nrt        = NULL
     },
     .device_class       = RTDM_CLASS_SERIAL,
@@ -363,12 +979,77 @@ MODULE_SUPPORTED_DEVICE(DEF_DRV_SUPP_DEVICE);
 
 /*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
 
+static void rxRdyUpdateI(
+    struct uartCtx *    uartCtx) {
+
+    size_t              level;
+
+    if (XUART_FRAMING_NONE != uartCtx->frame.type) {
+        level = (0U != frameQueueOccGet(&uartCtx->frame.queue)) ? uartCtx->rx.rdyLevel : 0U;
+    } else {
+        level = circOccGet(&uartCtx->rx.buff.handle);
+    }
+
+    if (uartCtx->rx.rdyLevel <= level) {
+
+        if (FALSE == uartCtx->rx.isRdy) {
+            uartCtx->rx.isRdy = TRUE;
+            rtdm_event_signal(
+                &uartCtx->rx.rdy);
+        }
+    } else if (TRUE == uartCtx->rx.isRdy) {
+        uartCtx->rx.isRdy = FALSE;
+        rtdm_event_clear(
+            &uartCtx->rx.rdy);
+    }
+}
+
+static void txRdyUpdateI(
+    struct uartCtx *    uartCtx) {
+
+    if (uartCtx->tx.rdyLevel <= circFreeGet(&uartCtx->tx.buff.handle)) {
+
+        if (FALSE == uartCtx->tx.isRdy) {
+            uartCtx->tx.isRdy = TRUE;
+            rtdm_event_signal(
+                &uartCtx->tx.rdy);
+        }
+    } else if (TRUE == uartCtx->tx.isRdy) {
+        uartCtx->tx.isRdy = FALSE;
+        rtdm_event_clear(
+            &uartCtx->tx.rdy);
+    }
+}
+
+static void rxStatusLatchI(
+    struct uartCtx *    uartCtx,
+    enum uartStatus     status) {
+
+    uartCtx->rx.status = status;
+
+    if (UART_STATUS_NORMAL == uartCtx->rx.statusLatch) {
+        uartCtx->rx.statusLatch = status;
+    }
+}
+
+static void rxStatusTakeI(
+    struct uartCtx *    uartCtx) {
+
+    if (UART_STATUS_NORMAL != uartCtx->rx.statusLatch) {
+        uartCtx->rx.statusLast = uartCtx->rx.statusLatch;
+    } else {
+        uartCtx->rx.statusLast = uartCtx->rx.status;
+    }
+    uartCtx->rx.statusLatch = UART_STATUS_NORMAL;
+    uartCtx->rx.status      = UART_STATUS_NORMAL;
+}
+
 static struct uartCtx * uartCtxFromDevCtx(
     struct rtdm_dev_context * devCtx) {
 
     struct uartCtx *    uartCtx;
 
-    uartCtx = (struct uartCtx *)rtdm_context_to_private(devCtx);
+    uartCtx = *(struct uartCtx **)rtdm_context_to_private(devCtx);
 
     return (uartCtx);
 }
@@ -387,6 +1068,7 @@ static int uartCtxInit(
     }
     /*-- STATE: init ---------------------------------------------------------*/
     LOG_INFO("init locks");
+    CRITICAL_INIT(uartCtx);
     rtdm_sem_init(
         &uartCtx->tx.acc,
         1U);
@@ -399,13 +1081,36 @@ static int uartCtxInit(
     rtdm_event_init(
         &uartCtx->rx.opr,
         0U);
-    uartCtx->state = CTX_STATE_LOCKS;
+    rtdm_event_init(
+        &uartCtx->tx.rdy,
+        0U);
+    rtdm_event_init(
+        &uartCtx->rx.rdy,
+        0U);
+    rtdm_timer_init(
+        &uartCtx->frame.rtu.timer,
+        rtuTimerHandler,
+        CFG_DRV_NAME "-rtu");
+    rtdm_timer_init(
+        &uartCtx->poll.timer,
+        pollTimerHandler,
+        CFG_DRV_NAME "-poll");
+    rtdm_timer_init(
+        &uartCtx->engine.timer,
+        polledTimerHandler,
+        CFG_DRV_NAME "-engine");
+    rtdm_event_init(
+        &uartCtx->poll.done,
+        0U);
+    uartCtx->state     = CTX_STATE_LOCKS;
+    uartCtx->signature = UART_CTX_SIGNATURE;
 
     /*-- STATE: Create TX buffer ---------------------------------------------*/
     LOG_INFO("create Tx buffer");
     retval = buffAlloc(
         &uartCtx->tx.buff,
-        CFG_DRV_BUFF_SIZE);
+        CFG_DRV_BUFF_SIZE,
+        DMA_TO_DEVICE);
 
     if (0 != retval) {
         LOG_ERR("failed to create internal TX buffer, err: %d", -retval);
@@ -417,16 +1122,18 @@ static int uartCtxInit(
     /*-- STATE: Init TX buffer -----------------------------------------------*/
 #if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
     LOG_INFO("init Tx buffer");
-    portDMATxInit(
+    retval = portDMATxInit(
         devData,
         dmaCallbackTx,
         uartCtx,
+#if (2 == CFG_DMA_MODE)
+        DEF_DMA_TX_THRESHOLD);                                                  /* UART event channel, one request per chunk                */
+#else
         0);
+#endif
 
     if (0 > retval) {
         LOG_ERR("failed to init Tx DMA, err: %d", -retval);
-        buffDealloc(
-            &uartCtx->tx.buff);
 
         return (retval);
     }
@@ -437,7 +1144,8 @@ static int uartCtxInit(
     LOG_INFO("create Rx buffer");
     retval = buffAlloc(
         &uartCtx->rx.buff,
-        CFG_DRV_BUFF_SIZE);
+        CFG_DRV_BUFF_SIZE,
+        DMA_NONE);                                                              /* Receiver is always serviced by the CPU                   */
 
     if (0 != retval) {
         LOG_ERR("failed to create internal RX buffer, err: %d", -retval);
@@ -449,26 +1157,60 @@ static int uartCtxInit(
     /*-- STATE: Init RX buffer -----------------------------------------------*/
 #if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
     LOG_INFO("init Rx buffer");
-    portDMARxInit(
+    retval = portDMARxInit(
         devData,
         dmaCallbackRx,
         uartCtx);
 
     if (0 > retval) {
         LOG_ERR("failed to init Rx DMA, err: %d", -retval);
-        buffDealloc(
-            &uartCtx->rx.buff);
 
         return (retval);
     }
 #endif
     uartCtx->state = CTX_STATE_RX_BUFF_INIT;
 
-    /*-- Prepare UART data ---------------------------------------------------*/
-    LOG_INFO("init context data");
+    /*-- STATE: Request IRQ --------------------------------------------------*/
     uartCtx->cache.io       = io;
-    uartCtx->cache.IER      = lldRegRd(io, IER);
     uartCtx->cache.devData  = devData;
+    uartCtx->tap.owner      = NULL;
+    uartCtx->tap.next       = NULL;
+    uartCtx->tap.isTap      = FALSE;
+    uartCtx->isOpen         = FALSE;
+#if (1 == CFG_DMA_MODE)
+    if (0 != CFG_HYBRID_THRESHOLD) {
+        uartCtx->engine.hybrid.threshold    = CFG_HYBRID_THRESHOLD;
+        uartCtx->engine.hybrid.isCalibrated = TRUE;
+    } else {
+        hybridCalibrateI(                                                       /* Measured by the first bursts, kept across opens          */
+            uartCtx);
+    }
+#endif
+    LOG_INFO("request IRQ");
+    retval = rtdm_irq_request(
+        &uartCtx->irqHandle,
+        PortIRQ[UartDev.device_id],
+        handleIrq,
+        RTDM_IRQTYPE_EDGE,
+        UartDev.proc_name,
+        uartCtx);                                                               /* Interrupts stay masked in IER until the device is used   */
+
+    if (0 != retval) {
+        LOG_ERR("failed to request IRQ, err: %d", -retval);
+
+        return (retval);
+    }
+    uartCtx->state = CTX_STATE_IRQ;
+
+    return (retval);
+}
+
+static void uartCtxOpen(
+    struct uartCtx *    uartCtx) {
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    uartCtx->cache.IER      = lldRegRd(uartCtx->cache.io, IER);
     uartCtx->tx.accTimeout  = MS_TO_NS(CFG_TIMEOUT_MS);
     uartCtx->tx.oprTimeout  = MS_TO_NS(CFG_TIMEOUT_MS);
     uartCtx->tx.buff.pend   = 0U;
@@ -477,12 +1219,86 @@ static int uartCtxInit(
     uartCtx->rx.oprTimeout  = MS_TO_NS(CFG_TIMEOUT_MS);
     uartCtx->rx.buff.pend   = 0U;
     uartCtx->rx.status      = UART_STATUS_NORMAL; /* not used? */
-    uartCtx->signature      = UART_CTX_SIGNATURE;
-    xProtoSet(
+    uartCtx->rx.statusLatch = UART_STATUS_NORMAL;
+    uartCtx->rx.statusLast  = UART_STATUS_NORMAL;
+    uartCtx->rx.stamp       = 0U;
+    uartCtx->tx.rdyLevel    = 1U;
+    uartCtx->tx.isRdy       = FALSE;
+    uartCtx->tx.isPersistent = FALSE;
+    uartCtx->rx.rdyLevel    = 1U;
+    uartCtx->rx.isRdy       = FALSE;
+    uartCtx->rx.isPersistent = FALSE;
+    uartCtx->tx.isCrcAppend = FALSE;
+    uartCtx->tx.crcLast     = 0U;
+    uartCtx->rx.crcLast     = 0U;
+    crcInit(
+        &uartCtx->tx.crc,
+        CRC_NONE);
+    crcInit(
+        &uartCtx->rx.crc,
+        CRC_NONE);
+    uartCtx->frame.type     = XUART_FRAMING_NONE;
+    uartCtx->frame.uncommitted = 0U;
+    uartCtx->frame.rtu.isGap = FALSE;
+    uartCtx->frame.rtu.isBad = FALSE;
+    uartCtx->tx.stamp       = 0U;
+    uartCtx->poll.isActive  = FALSE;
+    uartCtx->poll.state     = POLL_STATE_IDLE;
+    uartCtx->selfTest.isActive = FALSE;
+    uartCtx->isLoopback     = FALSE;
+    uartCtx->poll.table.count = 0U;
+    uartCtx->filter.cfg.type = XUART_FILTER_NONE;
+    uartCtx->filter.isGap   = TRUE;
+    uartCtx->filter.isMatch = FALSE;
+    uartCtx->filter.last    = 0U;
+    memset(
+        &uartCtx->wake.cfg,
+        0,
+        sizeof(struct xUartWake));
+    rxWakeInit(
+        &uartCtx->wake.cond);
+    uartCtx->wake.cur       = NULL;
+    uartCtx->wake.isEnabled = FALSE;
+    uartCtx->wake.isHit     = FALSE;
+    uartCtx->tap.channel    = 0U;
+    uartCtx->frame.mux.isEnabled   = FALSE;
+    uartCtx->frame.mux.isIdPending = TRUE;
+    frameDecInit(
+        &uartCtx->frame.dec,
+        XUART_FRAMING_NONE);
+    frameEncInit(
+        &uartCtx->frame.enc,
+        XUART_FRAMING_NONE);
+    frameQueueFlush(
+        &uartCtx->frame.queue);
+    circFlush(
+        &uartCtx->tx.buff.handle);
+    circFlush(
+        &uartCtx->rx.buff.handle);
+    rtdm_event_clear(
+        &uartCtx->tx.opr);
+    rtdm_event_clear(
+        &uartCtx->rx.opr);
+    rtdm_event_clear(
+        &uartCtx->tx.rdy);
+    rtdm_event_clear(
+        &uartCtx->rx.rdy);
+    rtdm_event_clear(
+        &uartCtx->poll.done);
+    (void)xProtoSet(
         uartCtx,
         &DefProtocol);
-
-    return (retval);
+    txRdyUpdateI(
+        uartCtx);                                                               /* Empty TX buffer: device is writable                      */
+    uartCtx->engine.isRxOn  = FALSE;
+    uartCtx->engine.isTxOn  = FALSE;
+    uartCtx->engine.ops     = engineFind(
+        CFG_ENGINE_DEFAULT);
+
+    if (NULL != uartCtx->engine.ops->attachI) {
+        uartCtx->engine.ops->attachI(
+            uartCtx);
+    }
 }
 
 static void uartCtxTerm(
@@ -493,6 +1309,15 @@ static void uartCtxTerm(
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
     switch (uartCtx->state) {
+        case CTX_STATE_IRQ : {
+            LOG_INFO("free IRQ");
+            retval = rtdm_irq_free(
+                &uartCtx->irqHandle);
+
+            if (0 != retval) {
+                LOG_ERR("failed to free irq, err: %d", -retval);
+            }
+        } /* fall through */
         case CTX_STATE_RX_BUFF_INIT :
 #if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
             LOG_INFO("term Rx buffer");
@@ -525,6 +1350,18 @@ static void uartCtxTerm(
             }
         } /* fall through */
         case CTX_STATE_LOCKS : {
+            rtdm_timer_destroy(
+                &uartCtx->engine.timer);
+            rtdm_timer_destroy(
+                &uartCtx->poll.timer);
+            rtdm_timer_destroy(
+                &uartCtx->frame.rtu.timer);
+            rtdm_event_destroy(
+                &uartCtx->poll.done);
+            rtdm_event_destroy(
+                &uartCtx->rx.rdy);
+            rtdm_event_destroy(
+                &uartCtx->tx.rdy);
             rtdm_event_destroy(
                 &uartCtx->rx.opr);
             rtdm_sem_destroy(
@@ -541,48 +1378,107 @@ static void uartCtxTerm(
             break;
         }
     }
+    uartCtx->state     = CTX_STATE_INIT;
     uartCtx->signature = ~UART_CTX_SIGNATURE;
 }
 
+static void rxWakeInit(
+    struct rxWake *     wake) {
+
+    memset(
+        wake->map,
+        0,
+        sizeof(wake->map));
+    wake->isDelim = FALSE;
+    wake->count   = 0U;
+    wake->idle    = 0;
+}
+
+static void rxWakeDelimAdd(
+    struct rxWake *     wake,
+    uint8_t             item) {
+
+    wake->map[item >> 5] |= (uint32_t)1U << (item & 0x1FU);
+    wake->isDelim = TRUE;
+}
+
+static inline bool_T rxWakeIsDelim(
+    const struct rxWake * wake,
+    uint8_t             item) {
+
+    if (0U != (wake->map[item >> 5] & ((uint32_t)1U << (item & 0x1FU)))) {
+
+        return (TRUE);
+    }
+
+    return (FALSE);
+}
+
 static bool_T xProtoIsValid(
     const struct xUartProto * proto) {
 
-    /*
-     * TODO: Check proto values here
-     */
+    if ((0U == proto->baud) || (0 > portDIVdataGet(proto->baud))) {             /* Character time below divides by the baud rate            */
+
+        return (FALSE);
+    }
+
+    if (((uint32_t)XUART_PARITY_SPACE < (uint32_t)proto->parity) ||
+        ((uint32_t)XUART_DATA_5 < (uint32_t)proto->dataBits) ||
+        ((uint32_t)XUART_STOP_2 < (uint32_t)proto->stopBits)) {
+
+        return (FALSE);
+    }
+
     return (TRUE);
 }
 
-static void xProtoSet(
+static int xProtoSet(
     struct uartCtx *    uartCtx,
     const struct xUartProto * proto) {
 
+    int                 retval;
+
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    (void)lldProtocolSet(
+    retval = (int)lldProtocolSet(
         uartCtx->cache.io,
         proto);
+
+    if (0 != retval) {
+        (void)lldProtocolSet(                                                   /* Registers were written in part, restore the old protocol */
+            uartCtx->cache.io,
+            &uartCtx->proto);
+
+        return (retval);
+    }
     memcpy(
         &uartCtx->proto,
         proto,
         sizeof(struct xUartProto));
-}
+    uartCtx->frame.rtu.tChar = US_TO_NS((nanosecs_rel_t)(DEF_RTU_CHAR_BITS * US_PER_MS * MS_PER_S) / proto->baud);
 
-/* ===========================================================================
- * NOTE:    These functions will compile only in DMA mode 0 (disabled) and DMA
- *          mode 1 (soft DMA)
- * ===========================================================================*/
-#if (0 == CFG_DMA_MODE) || (1 == CFG_DMA_MODE)
+    if (DEF_RTU_FIXED_BAUD < proto->baud) {
+        uartCtx->frame.rtu.t15 = US_TO_NS(750);
+        uartCtx->frame.rtu.t35 = US_TO_NS(1750);
+    } else {
+        uartCtx->frame.rtu.t15 = (3 * uartCtx->frame.rtu.tChar) / 2;
+        uartCtx->frame.rtu.t35 = (7 * uartCtx->frame.rtu.tChar) / 2;
+    }
+
+    return (0);
+}
 
 static void cIntEnable(
     struct uartCtx *    uartCtx,
     enum cIntNum        cIntNum) {
 
 #if (0 == CFG_CRITICAL_INT_ENABLE)
+    CRITICAL_DECL(lockCtx);
     uint32_t            tmp;
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
+    CACHE_LOCK_ENTER(uartCtx, lockCtx);
     tmp = uartCtx->cache.IER | cIntNum;
 
     if (tmp != uartCtx->cache.IER) {
@@ -592,6 +1488,7 @@ static void cIntEnable(
             wIER,
             uartCtx->cache.IER);
     }
+    CACHE_LOCK_EXIT(uartCtx, lockCtx);
 #else
     uartCtx->cache.IER |= cIntNum;
 #endif
@@ -601,13 +1498,17 @@ static void cIntSetEnable(
     struct uartCtx *    uartCtx,
     enum cIntNum        cIntNum) {
 
+    CRITICAL_DECL(lockCtx);
+
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
+    CACHE_LOCK_ENTER(uartCtx, lockCtx);
     uartCtx->cache.IER |= cIntNum;
     lldRegWr(
         uartCtx->cache.io,
         wIER,
         uartCtx->cache.IER);
+    CACHE_LOCK_EXIT(uartCtx, lockCtx);
 }
 
 static void cIntDisable(
@@ -615,10 +1516,12 @@ static void cIntDisable(
     enum cIntNum        cIntNum) {
 
 #if (0 == CFG_CRITICAL_INT_ENABLE)
+    CRITICAL_DECL(lockCtx);
     uint32_t            tmp;
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
+    CACHE_LOCK_ENTER(uartCtx, lockCtx);
     tmp = uartCtx->cache.IER & ~cIntNum;
 
     if (tmp != uartCtx->cache.IER) {
@@ -628,6 +1531,7 @@ static void cIntDisable(
             wIER,
             uartCtx->cache.IER);
     }
+    CACHE_LOCK_EXIT(uartCtx, lockCtx);
 #else
     uartCtx->cache.IER &= ~cIntNum;
 #endif
@@ -637,22 +1541,45 @@ static void cIntSetDisable(
     struct uartCtx *    uartCtx,
     enum cIntNum        cIntNum) {
 
+    CRITICAL_DECL(lockCtx);
+
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
+    CACHE_LOCK_ENTER(uartCtx, lockCtx);
     uartCtx->cache.IER &= ~cIntNum;
     lldRegWr(
         uartCtx->cache.io,
         wIER,
         uartCtx->cache.IER);
+    CACHE_LOCK_EXIT(uartCtx, lockCtx);
 }
 
 static int32_t buffAlloc(
     struct buff *       buff,
-    size_t              size) {
-#if (0 == CFG_DMA_MODE)
+    size_t              size,
+    enum dma_data_direction dir) {
+#if (0 == CFG_DMA_MODE) && (1 == CFG_BUFF_MIRROR)
+    uint8_t *           storage;
+
+    (void)dir;
+    storage = portMirrorAlloc(
+        size);
+
+    if (NULL == storage) {
+
+        return (-ENOMEM);
+    }
+    circInitMirrored(
+        &buff->handle,
+        storage,
+        size);
+
+    return (0);
+#elif (0 == CFG_DMA_MODE)
     int32_t             retval;
     uint8_t *           storage;
 
+    (void)dir;
     retval = rt_heap_create(
         &buff->storage,
         NULL,
@@ -679,34 +1606,85 @@ static int32_t buffAlloc(
         size);
 
     return (retval);
-#elif (1 == CFG_DMA_MODE)
-    uint8_t *           buffRemap;
+#elif (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
+    uint8_t *           storage;
 
-    buffRemap = dma_alloc_coherent(
-        NULL,
+#if (1 == CFG_BUFF_MIRROR)
+    storage = portMirrorAlloc(
+        size);
+#else
+    storage = kmalloc(                                                          /* Cacheable, copies to and from user run at full speed     */
         size,
-        (dma_addr_t *)&buff->phy,
-        0);
-    LOG_DBG("allocated buffer: remap: %p", buffRemap);
-    LOG_DBG("allocated buffer: phy  : %p", buff->phy);
+        GFP_KERNEL);
+#endif
 
-    if ((NULL == buffRemap) || (NULL == buff->phy)) {
+    if (NULL == storage) {
 
         return (-ENOMEM);
     }
+    buff->phy = NULL;
+    buff->dir = dir;
+
+    if (DMA_NONE != dir) {
+        dma_addr_t      phy;
+
+#if (1 == CFG_BUFF_MIRROR)
+        phy = dma_map_page(                                                     /* DMA sees only the first mapping of the pages             */
+            NULL,
+            vmalloc_to_page(storage),
+            0,
+            size,
+            dir);
+#else
+        phy = dma_map_single(
+            NULL,
+            storage,
+            size,
+            dir);
+#endif
+
+        if (0 != dma_mapping_error(NULL, phy)) {
+#if (1 == CFG_BUFF_MIRROR)
+            portMirrorFree(
+                storage,
+                size);
+#else
+            kfree(
+                storage);
+#endif
+
+            return (-ENOMEM);
+        }
+        buff->phy = (volatile uint8_t *)phy;
+    }
+    LOG_DBG("allocated buffer: virt : %p", storage);
+    LOG_DBG("allocated buffer: phy  : %p", buff->phy);
+#if (1 == CFG_BUFF_MIRROR)
+    circInitMirrored(
+        &buff->handle,
+        storage,
+        size);
+#else
     circInit(
         &buff->handle,
-        buffRemap,
+        storage,
         size);
+#endif
 
     return (0);
-#endif /* (1 == CFG_DMA_MODE) */
+#endif /* (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE) */
 }
 
 static uint32_t buffDealloc(
     struct buff *       buff) {
 
-#if (0 == CFG_DMA_MODE)
+#if (0 == CFG_DMA_MODE) && (1 == CFG_BUFF_MIRROR)
+    portMirrorFree(
+        circMemBaseGet(&buff->handle),
+        circSizeGet(&buff->handle));
+
+    return (0);
+#elif (0 == CFG_DMA_MODE)
     int32_t             retval;
 
     rt_heap_free(
@@ -716,15 +1694,33 @@ static uint32_t buffDealloc(
         &buff->storage);
 
     return (retval);
-#elif (1 == CFG_DMA_MODE)
-    dma_free_coherent(
-        NULL,
-        circSizeGet(&buff->handle),
+#elif (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
+    if (NULL != buff->phy) {
+#if (1 == CFG_BUFF_MIRROR)
+        dma_unmap_page(
+            NULL,
+            (dma_addr_t)buff->phy,
+            circSizeGet(&buff->handle),
+            buff->dir);
+#else
+        dma_unmap_single(
+            NULL,
+            (dma_addr_t)buff->phy,
+            circSizeGet(&buff->handle),
+            buff->dir);
+#endif
+    }
+#if (1 == CFG_BUFF_MIRROR)
+    portMirrorFree(
         circMemBaseGet(&buff->handle),
-        (dma_addr_t)buff->phy);
+        circSizeGet(&buff->handle));
+#else
+    kfree(
+        circMemBaseGet(&buff->handle));
+#endif
 
     return (0);
-#endif /* (1 == CFG_DMA_MODE) */
+#endif /* (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE) */
 }
 
 static void buffRxStartI(
@@ -732,9 +1728,9 @@ static void buffRxStartI(
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    cIntSetEnable(
-        uartCtx,
-        C_INT_RX | C_INT_RX_TIMEOUT);
+    uartCtx->engine.isRxOn = TRUE;
+    uartCtx->engine.ops->rxStartI(
+        uartCtx);
 }
 
 static void buffRxStopI(
@@ -742,10 +1738,10 @@ static void buffRxStopI(
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    uartCtx->rx.buff.pend = 0U;
-    cIntDisable(
-        uartCtx,
-        C_INT_RX | C_INT_RX_TIMEOUT);
+    uartCtx->rx.buff.pend  = 0U;
+    uartCtx->engine.isRxOn = FALSE;
+    uartCtx->engine.ops->rxStopI(
+        uartCtx);
 }
 
 static void buffRxPendI(
@@ -780,7 +1776,7 @@ static int buffRxWait(
 static ssize_t buffRxCopyI(
     struct uartCtx *    uartCtx,
     CRITICAL_TYPE *     lockCtx,
-    uint8_t *           dst,
+    struct ioCursor *   dst,
     size_t              pending) {
 
     size_t              transfer;
@@ -789,7 +1785,6 @@ static ssize_t buffRxCopyI(
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    transfer = 0U;
     cpd = 0U;
     occ = circRemainingOccGet(
         &uartCtx->rx.buff.handle);
@@ -800,64 +1795,206 @@ static ssize_t buffRxCopyI(
     }
 
     do {
-        uint8_t *       src;
+        const uint8_t * src;
+        int             retval;
 
-        CRITICAL_EXIT(uartCtx, *lockCtx);
-        dst += transfer;
         src = circMemTailGet(
             &uartCtx->rx.buff.handle);
         transfer = min(pending, occ);
+        CRITICAL_EXIT(uartCtx, rx, *lockCtx);
+        retval = ioCursorCopyTo(
+            dst,
+            uartCtx->rx.user,
+            src,
+            transfer);
 
-        if (NULL != uartCtx->rx.user) {
-            int         retval;
-
-            retval = rtdm_copy_from_user(
-                uartCtx->rx.user,
-                dst,
+        if (0 == retval) {
+            crcUpdate(
+                &uartCtx->rx.crc,
                 src,
-                transfer);
+                transfer);                                                      /* Data is still cache hot after the copy                   */
+        }
+        CRITICAL_ENTER(uartCtx, rx, *lockCtx);
 
-            if (0 != retval) {
-                CRITICAL_ENTER(uartCtx, *lockCtx);
+        if (0 != retval) {
 
-                return ((ssize_t)retval);
-            }
-        } else {
-            memcpy(
-                dst,
-                src,
-                transfer);
+            return ((ssize_t)retval);
         }
         pending -= transfer;
         cpd     += transfer;
-        CRITICAL_ENTER(uartCtx, *lockCtx);
         circPosTailSet(
             &uartCtx->rx.buff.handle,
             transfer);
         occ = circRemainingOccGet(
             &uartCtx->rx.buff.handle);
     } while ((0 != occ) && (0 != pending));
+    rxRdyUpdateI(
+        uartCtx);
+
+    return ((ssize_t)cpd);
+}
 
-    return (cpd);
+static bool_T filterIsMatch(
+    const struct xUartFilter * cfg,
+    uint8_t             item) {
+
+    if ((item & cfg->mask) == (cfg->addr & cfg->mask)) {
+
+        return (TRUE);
+    }
+
+    if ((0 <= cfg->broadcast) && ((int32_t)item == cfg->broadcast)) {
+
+        return (TRUE);
+    }
+
+    return (FALSE);
 }
 
-static void buffRxTrans(
+static size_t buffRxFifoRd(
     struct uartCtx *    uartCtx,
+    uint8_t *           burst,
     size_t              size) {
 
+    volatile uint8_t *  io;
+    size_t              accepted;
+    size_t              cnt;
+
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    do {
-        uint16_t        item;
+    io       = uartCtx->cache.io;
+    accepted = 0U;
 
-        size--;
-        item = lldRegRd(
-            uartCtx->cache.io,
-            RHR);
+    switch (uartCtx->filter.cfg.type) {
+        case XUART_FILTER_MARK : {
+
+            for (cnt = 0U; cnt < size; cnt++) {
+                uint16_t    status;
+                uint8_t     item;
+
+                status = lldRegRd(
+                    io,
+                    LSR);
+
+                if (0U == (status & LSR_RXFIFOSTS)) {                           /* No address byte anywhere in the FIFO: take the rest      */
+                    break;
+                }
+                item = (uint8_t)lldRegRd(
+                    io,
+                    RHR);
+
+                if (0U != (status & LSR_RXPE)) {                                /* Mark parity received while space is expected             */
+                    uartCtx->filter.isMatch = filterIsMatch(
+                        &uartCtx->filter.cfg,
+                        item);
+                }
+
+                if (TRUE == uartCtx->filter.isMatch) {
+                    burst[accepted++] = item;
+                }
+            }
+
+            if (TRUE == uartCtx->filter.isMatch) {
+
+                for (; cnt < size; cnt++) {
+                    burst[accepted++] = (uint8_t)lldRegRd(
+                        io,
+                        RHR);
+                }
+            } else {
+
+                for (; cnt < size; cnt++) {
+                    (void)lldRegRd(
+                        io,
+                        RHR);
+                }
+            }
+            break;
+        }
+        case XUART_FILTER_ADDR : {
+            nanosecs_abs_t  now;
+
+            now = rtdm_clock_read();
+
+            if ((now - size * uartCtx->frame.rtu.tChar) >= (uartCtx->filter.last + uartCtx->frame.rtu.t35)) {
+                uartCtx->filter.isGap = TRUE;                                   /* Line was silent before this burst                        */
+            }
+            uartCtx->filter.last = now;
+
+            for (cnt = 0U; cnt < size; cnt++) {
+                uint8_t     item;
+
+                item = (uint8_t)lldRegRd(
+                    io,
+                    RHR);
+
+                if (TRUE == uartCtx->filter.isGap) {
+                    uartCtx->filter.isGap   = FALSE;
+                    uartCtx->filter.isMatch = filterIsMatch(
+                        &uartCtx->filter.cfg,
+                        item);
+                }
+
+                if (TRUE == uartCtx->filter.isMatch) {
+                    burst[accepted++] = item;
+                }
+            }
+            break;
+        }
+        default : {
+
+            for (cnt = 0U; cnt < size; cnt++) {
+                burst[cnt] = (uint8_t)lldRegRd(
+                    io,
+                    RHR);
+            }
+            accepted = size;
+        }
+    }
+
+    if ((NULL != uartCtx->tap.next) && (0U != accepted) && (FALSE == uartCtx->selfTest.isActive)) {
+        tapFeedI(
+            uartCtx,
+            burst,
+            accepted);
+    }
+
+    return (accepted);
+}
+
+static size_t buffRxTrans(
+    struct uartCtx *    uartCtx,
+    size_t              size) {
+
+    uint8_t             burst[DEF_FIFO_SIZE];
+    size_t              cnt;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    size = buffRxFifoRd(
+        uartCtx,
+        burst,
+        min(size, (size_t)DEF_FIFO_SIZE));
+
+    for (cnt = 0U; cnt < size; cnt++) {
         circItemPut(
             &uartCtx->rx.buff.handle,
-            item);
-    } while (0U != size);
+            burst[cnt]);
+    }
+
+    if ((NULL != uartCtx->wake.cur) && (TRUE == uartCtx->wake.cur->isDelim)) {
+
+        for (cnt = 0U; cnt < size; cnt++) {
+
+            if (TRUE == rxWakeIsDelim(uartCtx->wake.cur, burst[cnt])) {
+                uartCtx->wake.isHit = TRUE;
+
+                break;
+            }
+        }
+    }
+
+    return (size);
 }
 
 static void buffRxFlush(
@@ -868,980 +2005,4228 @@ static void buffRxFlush(
     uartCtx->rx.buff.pend = 0U;
     circFlush(
         &uartCtx->rx.buff.handle);
+    frameQueueFlush(
+        &uartCtx->frame.queue);
+    frameDecInit(
+        &uartCtx->frame.dec,
+        uartCtx->frame.type);
+    uartCtx->frame.uncommitted = 0U;
+    uartCtx->frame.rtu.isGap = FALSE;
+    uartCtx->frame.rtu.isBad = FALSE;
+    uartCtx->frame.mux.isIdPending = TRUE;
+    rxRdyUpdateI(
+        uartCtx);
 }
 
-static void buffTxStartI(
+static void buffRxPersistI(
     struct uartCtx *    uartCtx) {
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    uartCtx->tx.buff.pend = 0U;
-    cIntEnable(
-        uartCtx,
-        C_INT_TX);
+    if (FALSE == uartCtx->rx.isPersistent) {
+        uartCtx->rx.isPersistent = TRUE;
+        buffRxFlush(
+            uartCtx);
+        lldFIFORxFlush(
+            uartCtx->cache.io);
+        buffRxStartI(
+            uartCtx);
+    }
 }
 
-static void buffTxStopI(
-    struct uartCtx *    uartCtx) {
+static void buffRxFrameTrans(
+    struct uartCtx *    uartCtx,
+    size_t              size) {
+
+    uint8_t             burst[DEF_FIFO_SIZE];
+    size_t              cnt;
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-#if (0 == CFG_DMA_MODE)
-    uartCtx->tx.buff.pend = 0U;
-    cIntSetDisable(
+    size = buffRxFifoRd(                                                        /* Drain the FIFO first, decode afterwards                  */
         uartCtx,
-        C_INT_TX);
-#elif (1 == CFG_DMA_MODE)
-    uartCtx->tx.buff.pend = 0U;
-    cIntDisable(
-        uartCtx,
-        C_INT_TX);
-    portDMATxStopI(
-        uartCtx->cache.devData);
-#endif /* (1 == CFG_DMA_MODE) */
-}
+        burst,
+        min(size, (size_t)DEF_FIFO_SIZE));
 
-static void buffTxPendI(
-    struct uartCtx *    uartCtx,
-    size_t              pending) {
+    for (cnt = 0U; cnt < size; cnt++) {
+        uint8_t         item;
 
-    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+        switch (frameDecPut(&uartCtx->frame.dec, burst[cnt], &item)) {
+            case FRAME_EV_DATA : {
 
-    if (pending > circSizeGet(&uartCtx->tx.buff.handle)) {
-        uartCtx->tx.buff.pend = circSizeGet(&uartCtx->tx.buff.handle);
-    } else {
-        uartCtx->tx.buff.pend = pending;
+                if ((TRUE == uartCtx->frame.mux.isEnabled) && (TRUE == uartCtx->frame.mux.isIdPending)) {
+                    uartCtx->frame.mux.isIdPending = FALSE;
+                    uartCtx->frame.mux.id          = item;                      /* Channel number is not stored                             */
+                    break;
+                }
+                circItemPut(
+                    &uartCtx->rx.buff.handle,
+                    item);
+                uartCtx->frame.uncommitted++;
+                break;
+            }
+            case FRAME_EV_END : {
+
+                if ((TRUE == uartCtx->frame.mux.isEnabled) && (0U != uartCtx->frame.mux.id)) {
+                    muxDeliverI(
+                        uartCtx);
+                } else if (FALSE == frameQueuePut(&uartCtx->frame.queue, uartCtx->frame.uncommitted)) {
+                    circPosHeadRewind(
+                        &uartCtx->rx.buff.handle,
+                        uartCtx->frame.uncommitted);
+                    rxStatusLatchI(
+                        uartCtx,
+                        UART_STATUS_SOFT_OVERFLOW);
+                }
+                uartCtx->frame.uncommitted     = 0U;
+                uartCtx->frame.mux.isIdPending = TRUE;
+                break;
+            }
+            case FRAME_EV_ERROR : {
+                circPosHeadRewind(
+                    &uartCtx->rx.buff.handle,
+                    uartCtx->frame.uncommitted);
+                uartCtx->frame.uncommitted     = 0U;
+                uartCtx->frame.mux.isIdPending = TRUE;
+                break;
+            }
+            default : {
+                break;
+            }
+        }
     }
-    rtdm_event_clear(
-        &uartCtx->tx.opr);
-    cIntEnable(
-        uartCtx,
-        C_INT_TX);
 }
 
-static int buffTxWait(
+static void buffRxRtuTransI(
     struct uartCtx *    uartCtx,
-    rtdm_toseq_t *      tmSeq) {
-
-    int                 retval;
+    size_t              size,
+    bool_T              isSilent) {
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    retval = rtdm_event_timedwait(
-        &uartCtx->tx.opr,
-        uartCtx->tx.oprTimeout,
-        tmSeq);
+    if (0U != size) {
 
-    return (retval);
-}
+        if (TRUE == uartCtx->frame.rtu.isGap) {                                 /* Characters after t1.5 but before t3.5: frame is broken   */
+            uartCtx->frame.rtu.isGap = FALSE;
+            uartCtx->frame.rtu.isBad = TRUE;
+            circPosHeadRewind(
+                &uartCtx->rx.buff.handle,
+                uartCtx->frame.uncommitted);
+            uartCtx->frame.uncommitted = 0U;
+        }
 
-static ssize_t buffTxCopyI(
-    struct uartCtx *    uartCtx,
-    CRITICAL_TYPE *     lockCtx,
-    const uint8_t *     src,
-    size_t              bytes) {
+        if (TRUE == uartCtx->frame.rtu.isBad) {
+            lldFIFORxFlush(
+                uartCtx->cache.io);
+        } else if (size > circFreeGet(&uartCtx->rx.buff.handle)) {
+            circPosHeadRewind(
+                &uartCtx->rx.buff.handle,
+                uartCtx->frame.uncommitted);
+            uartCtx->frame.uncommitted = 0U;
+            uartCtx->frame.rtu.isBad = TRUE;
+            lldFIFORxFlush(
+                uartCtx->cache.io);
+            rxStatusLatchI(
+                uartCtx,
+                UART_STATUS_SOFT_OVERFLOW);
+        } else {
+            buffRxFrameTrans(
+                uartCtx,
+                size);
+        }
+        uartCtx->rx.stamp = rtdm_clock_read();
+    }
 
-    size_t              transfer;
-    size_t              cpd;
-    size_t              rem;
+    if (TRUE == isSilent) {                                                     /* RX timeout: 4 characters of silence, longer than t3.5    */
+        rtdm_timer_stop(
+            &uartCtx->frame.rtu.timer);
+        buffRxRtuEndI(
+            uartCtx);
+    } else {
+        rtdm_timer_start(
+            &uartCtx->frame.rtu.timer,
+            uartCtx->rx.stamp + uartCtx->frame.rtu.t15,
+            0,
+            RTDM_TIMERMODE_ABSOLUTE);
+    }
+}
+
+static void buffRxRtuEndI(
+    struct uartCtx *    uartCtx) {
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    transfer = 0U;
-    cpd = 0U;
-    rem = circRemainingFreeGet(
-        &uartCtx->tx.buff.handle);
+    uartCtx->frame.rtu.isGap = FALSE;
 
-    if (0 == rem) {
+    if (TRUE == uartCtx->frame.rtu.isBad) {
+        uartCtx->frame.rtu.isBad = FALSE;
+    } else if (0U != uartCtx->frame.uncommitted) {
 
-        return (0);
+        if (FALSE == frameQueuePut(&uartCtx->frame.queue, uartCtx->frame.uncommitted)) {
+            circPosHeadRewind(
+                &uartCtx->rx.buff.handle,
+                uartCtx->frame.uncommitted);
+            rxStatusLatchI(
+                uartCtx,
+                UART_STATUS_SOFT_OVERFLOW);
+        }
     }
+    uartCtx->frame.uncommitted = 0U;
+    rxRdyUpdateI(
+        uartCtx);
 
-    do {
-        uint8_t *       dst;
+    if ((0U != uartCtx->rx.buff.pend) && (0U != frameQueueOccGet(&uartCtx->frame.queue))) {
+        uartCtx->rx.buff.pend = 0U;                                             /* Frame is delivered as soon as t3.5 elapses               */
+        rtdm_event_signal(
+            &uartCtx->rx.opr);
+    }
+}
 
-        CRITICAL_EXIT(uartCtx, *lockCtx);
-        src += transfer;
-        dst = circMemHeadGet(
-            &uartCtx->tx.buff.handle);
-        transfer = min(bytes, rem);
+static void rtuTimerHandler(
+    rtdm_timer_t *      timer) {
 
-        if (NULL != uartCtx->tx.user) {
-            int             retval;
+    struct uartCtx *    uartCtx;
 
-            retval = rtdm_copy_from_user(
-                uartCtx->tx.user,
-                dst,
-                src,
-                transfer);
+    uartCtx = container_of(timer, struct uartCtx, frame.rtu.timer);
 
-            if (0 != retval) {
-                CRITICAL_ENTER(uartCtx, *lockCtx);
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-                return (retval);
-            }
+    CRITICAL_ENTER_ISR(uartCtx, rx);
+
+    /*
+     * Characters still waiting in the FIFO arrived after the last burst, so
+     * the line was not silent. The RX timeout interrupt will pick them up.
+     */
+    if ((XUART_FRAMING_RTU == uartCtx->frame.type) && (0U == lldFIFORxOccupied(uartCtx->cache.io))) {
+
+        if (FALSE == uartCtx->frame.rtu.isGap) {
+            uartCtx->frame.rtu.isGap = TRUE;
+            rtdm_timer_start_in_handler(
+                timer,
+                uartCtx->rx.stamp + uartCtx->frame.rtu.t35,
+                0,
+                RTDM_TIMERMODE_ABSOLUTE);
         } else {
-            memcpy(
-                dst,
-                src,
-                transfer);
-        }
-        bytes -= transfer;
-        cpd   += transfer;
-        CRITICAL_ENTER(uartCtx, *lockCtx);
-        circPosHeadSet(
-            &uartCtx->tx.buff.handle,
-            transfer);
-        rem = circRemainingFreeGet(
-            &uartCtx->tx.buff.handle);
-    } while ((0U != bytes) && (0U != rem));
+            buffRxRtuEndI(
+                uartCtx);
 
-    return (cpd);
+            if (TRUE == uartCtx->poll.isActive) {
+                pollRxI(
+                    uartCtx);
+            }
+        }
+    }
+    CRITICAL_EXIT_ISR(uartCtx, rx);
 }
 
-static void buffTxTrans(
+static void buffRxSkipI(
     struct uartCtx *    uartCtx,
     size_t              size) {
 
-#if (0 == CFG_DMA_MODE)
-    do {
-        uint16_t        item;
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-        size--;
-        item = circItemGet(
-            &uartCtx->tx.buff.handle);
-        lldRegWr(
-            uartCtx->cache.io,
-            wTHR,
-            item);
-    } while (0U != size);
-#elif (1 == CFG_DMA_MODE)
-    size_t              rem;
+    while (0U != size) {
+        size_t          transfer;
+
+        transfer = min(size, circRemainingOccGet(&uartCtx->rx.buff.handle));
+        circPosTailSet(
+            &uartCtx->rx.buff.handle,
+            transfer);
+        size -= transfer;
+    }
+}
+
+static ssize_t buffRxFrameGetI(
+    struct uartCtx *    uartCtx,
+    CRITICAL_TYPE *     lockCtx,
+    struct ioCursor *   dst,
+    size_t              bytes,
+    rtdm_toseq_t *      tmSeq) {
+
+    ssize_t             retval;
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    rem = circOccGet(
-        &uartCtx->tx.buff.handle);
+    retval = 0;
 
-    if (size > rem) {
-        /* two DMA transfers */
-        LOG_DBG("two DMA transfers");
-        uartCtx->tx.buff.chunk = size;
+    while (0U == frameQueueOccGet(&uartCtx->frame.queue)) {
+        uartCtx->rx.buff.pend = 1U;                                             /* Wake up on the next complete frame                       */
+        rtdm_event_clear(
+            &uartCtx->rx.opr);
+        CRITICAL_EXIT(uartCtx, rx, *lockCtx);
+        retval = buffRxWait(
+            uartCtx,
+            tmSeq);
+        CRITICAL_ENTER(uartCtx, rx, *lockCtx);
 
-        if (TRUE == portDMATxIsRunning(uartCtx->cache.devData)) {
-            LOG_DBG("skipping setup transfer");
+        if (0 > retval) {
+            uartCtx->rx.status = UART_STATUS_TIMEOUT;
 
-            return;
+            break;
         }
-        portDMATxBeginI(
-            uartCtx->cache.devData,
-            circMemTailGet(&uartCtx->tx.buff.handle),
-            rem);
-        portDMATxContinueI(
-            uartCtx->cache.devData,
-            circMemBaseGet(&uartCtx->tx.buff.handle),
-            size - rem);
-        portDMATxStartI(
-            uartCtx->cache.devData);
-    } else {
-        /* single DMA transfer */
-        LOG_DBG("single DMA transfer");
-        uartCtx->tx.buff.chunk = rem;
+    }
+    uartCtx->rx.buff.pend = 0U;
+
+    if (0 == retval) {
+        size_t          len;
+        uint32_t        tail;
 
-        if (TRUE == portDMATxIsRunning(uartCtx->cache.devData)) {
-            LOG_DBG("skipping setup transfer");
+        len  = frameQueueGet(
+            &uartCtx->frame.queue);
+        tail = circPosTailGet(
+            &uartCtx->rx.buff.handle);
+        retval = buffRxCopyI(
+            uartCtx,
+            lockCtx,
+            dst,
+            min(len, bytes));
 
-            return;
+        if (0 > retval) {
+            uartCtx->rx.status = UART_STATUS_FAULT_USAGE;
         }
-        portDMATxBeginI(
-            uartCtx->cache.devData,
-            uartCtx->tx.buff.phy + circPosTailGet(&uartCtx->tx.buff.handle),
-            rem);
-        portDMATxStartI(
-            uartCtx->cache.devData);
+        tail = circPosTailGet(&uartCtx->rx.buff.handle) + circSizeGet(&uartCtx->rx.buff.handle) - tail;
+        tail = tail % circSizeGet(&uartCtx->rx.buff.handle);                    /* Bytes of this frame consumed by the copy                 */
+        buffRxSkipI(
+            uartCtx,
+            len - tail);                                                        /* Truncate frames which do not fit                         */
     }
-    cIntDisable(
-        uartCtx,
-        C_INT_TX);
-#endif /* (1 == CFG_DMA_MODE) */
+    rxRdyUpdateI(
+        uartCtx);
+
+    return (retval);
 }
 
-static void buffTxFlushI(
-    struct uartCtx *    uartCtx) {
+static ssize_t buffRxUntilI(
+    struct uartCtx *    uartCtx,
+    CRITICAL_TYPE *     lockCtx,
+    struct ioCursor *   dst,
+    size_t              bytes,
+    const struct rxWake * wake,
+    rtdm_toseq_t *      tmSeq) {
+
+    size_t              read;
+    bool_T              isDone;
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    uartCtx->tx.buff.pend = 0U;
-    circFlush(
-        &uartCtx->tx.buff.handle);
-}
+    read   = 0U;
+    isDone = FALSE;
+    uartCtx->wake.cur   = wake;                                                 /* ISR scans incoming bursts for delimiters                 */
+    uartCtx->wake.isHit = FALSE;
 
-#if (1 == CFG_DMA_MODE)
-static void dmaCallbackRx(
-    void *              arg) {
+    while ((0U != bytes) && (FALSE == isDone)) {
+        ssize_t         transfer;
+        size_t          occ;
 
-    (void)arg;
-}
+        occ = circRemainingOccGet(
+            &uartCtx->rx.buff.handle);
 
-static void dmaCallbackTx(
-    void *              arg) {
+        if (0U == occ) {
+            int         retval;
 
-    struct uartCtx *    uartCtx;
+            if (0 != wake->idle) {
+                buffRxPendI(                                                    /* Every burst restarts the idle time                       */
+                    uartCtx,
+                    1U);
+            } else {
+                buffRxPendI(
+                    uartCtx,
+                    (0U != wake->count) ? min(bytes, wake->count - read) : bytes);
+            }
 
-    LOG_DBG("DMA Tx callback");
-    uartCtx = (struct uartCtx *)arg;
+            if ((0 != wake->idle) && (0U != read)) {
+                nanosecs_rel_t  remaining;
 
-    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+                remaining = (nanosecs_rel_t)(uartCtx->rx.stamp + wake->idle - rtdm_clock_read());
 
-    LOG_DBG("circ size %d", circSizeGet(&uartCtx->tx.buff.handle));
-    LOG_DBG("circ free %d", circFreeGet(&uartCtx->tx.buff.handle));
-    circPosTailSet(
-        &uartCtx->tx.buff.handle,
-        uartCtx->tx.buff.chunk);
-    uartCtx->tx.buff.chunk = 0;
-    cIntDisable(
-        (struct uartCtx *)arg,
-        C_INT_TX);
-}
-#endif /* (1 == CFG_DMA_MODE) */
+                if (0 >= remaining) {
 
-/* Handler function in IRQ mode                                               */
-static int handleRd(
-    struct rtdm_dev_context * devCtx,
-    rtdm_user_info_t *  usrInfo,
-    void *              buff,
-    size_t              bytes) {
+                    break;                                                      /* Line is idle                                             */
+                }
+                CRITICAL_EXIT(uartCtx, rx, *lockCtx);
+                retval = rtdm_event_timedwait(
+                    &uartCtx->rx.opr,
+                    remaining,
+                    NULL);
+                CRITICAL_ENTER(uartCtx, rx, *lockCtx);
 
-    CRITICAL_DECL(lockCtx);
-    rtdm_toseq_t        tmSeq;
-    struct uartCtx *    uartCtx;
-    uint8_t *           dst;
-    size_t              read;
-    int                 retval;
+                if (-ETIMEDOUT == retval) {
 
-    uartCtx = uartCtxFromDevCtx(devCtx);
+                    continue;                                                   /* Recheck against the latest burst                         */
+                }
+            } else {
+                CRITICAL_EXIT(uartCtx, rx, *lockCtx);
+                retval = buffRxWait(
+                    uartCtx,
+                    tmSeq);
+                CRITICAL_ENTER(uartCtx, rx, *lockCtx);
+            }
 
-    if (NULL != usrInfo) {
+            if (0 > retval) {
+                uartCtx->rx.status = UART_STATUS_TIMEOUT;
 
-        if (0 == rtdm_rw_user_ok(usrInfo, buff, bytes)) {
-            uartCtx->rx.status = UART_STATUS_FAULT_USAGE;
+                break;
+            }
 
-            return (-EFAULT);
+            continue;
         }
-    }
-    uartCtx->rx.user = usrInfo;
-    retval = rtdm_sem_timeddown(
-        &uartCtx->rx.acc,
-        uartCtx->rx.accTimeout,
-        NULL);
-
-    if (0 != retval) {
-        uartCtx->rx.status = UART_STATUS_BUSY;
+        occ = min(occ, bytes);
 
-        return (-EBUSY);
-    }
-    rtdm_toseq_init(
-        &tmSeq,
-        uartCtx->rx.oprTimeout);
-    read = 0U;
-    dst = (uint8_t *)buff;
-    buffRxFlush(
-        uartCtx);
-    lldFIFORxFlush(
-        uartCtx->cache.io);
-    CRITICAL_ENTER(uartCtx, lockCtx);
-    buffRxStartI(
-        uartCtx);
+        if (TRUE == wake->isDelim) {
+            const uint8_t * src;
+            size_t      cnt;
 
-    do {
-        size_t          transfer;
-        int             retval;
+            src = circMemTailGet(
+                &uartCtx->rx.buff.handle);
 
-        buffRxPendI(
-            uartCtx,
-            bytes);
-        CRITICAL_EXIT(uartCtx, lockCtx);
-        retval = buffRxWait(
-            uartCtx,
-            &tmSeq);
+            for (cnt = 0U; cnt < occ; cnt++) {
 
-        if (0 > retval) {
+                if (TRUE == rxWakeIsDelim(wake, src[cnt])) {
+                    occ    = cnt + 1U;
+                    isDone = TRUE;
 
-             break;
+                    break;
+                }
+            }
         }
-        CRITICAL_ENTER(uartCtx, lockCtx);
         transfer = buffRxCopyI(
             uartCtx,
-            &lockCtx,
+            lockCtx,
             dst,
-            bytes);
+            occ);
 
         if (0 > transfer) {
+            uartCtx->rx.status = UART_STATUS_FAULT_USAGE;
+            uartCtx->wake.cur  = NULL;
 
-            break;
+            return (transfer);
         }
-        dst   += transfer;
-        bytes -= transfer;
-        read  += transfer;
-    } while (0 < bytes);
-
-    buffRxStopI(
-        uartCtx);
+        bytes -= (size_t)transfer;
+        read  += (size_t)transfer;
 
-    if (0 != circOccGet(&uartCtx->rx.buff.handle)) {
-        uartCtx->rx.status = UART_STATUS_SOFT_OVERFLOW;
+        if ((0U != wake->count) && (wake->count <= read)) {
+            isDone = TRUE;
+        }
     }
-    CRITICAL_EXIT(uartCtx, lockCtx);
-    rtdm_sem_up(
-        &uartCtx->rx.acc);
+    uartCtx->wake.cur     = NULL;
+    uartCtx->rx.buff.pend = 0U;
 
-    if (0 == retval) {
-        retval = read;
+    if ((0U == read) && (0U != bytes)) {
+
+        return (-ETIMEDOUT);
     }
 
-    return (retval);
+    return ((ssize_t)read);
 }
 
-/* Handler function in IRQ mode                                               */
-static int handleWr(
-    struct rtdm_dev_context * devCtx,
-    rtdm_user_info_t *  usrInfo,
-    const void *        buff,
-    size_t              bytes) {
-
-    CRITICAL_DECL(lockCtx);
-    rtdm_toseq_t        tmSeq;
-    struct uartCtx *    uartCtx;
-    const uint8_t *     src;
-    size_t              written;
-    int                 retval;
-    ssize_t             transfer;
-
-    uartCtx = uartCtxFromDevCtx(devCtx);
+static void buffTxStartI(
+    struct uartCtx *    uartCtx) {
 
-    if (NULL != usrInfo) {
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-        if (0 == rtdm_read_user_ok(usrInfo, buff, bytes)) {
-            uartCtx->tx.status = UART_STATUS_FAULT_USAGE;
+    uartCtx->tx.buff.pend  = 0U;
+    uartCtx->engine.isTxOn = TRUE;
+    uartCtx->engine.ops->txKickI(
+        uartCtx);
+}
 
-            return (-EFAULT);
-        }
-    }
-    uartCtx->rx.user = usrInfo;
-    retval = rtdm_sem_timeddown(
-        &uartCtx->tx.acc,
-        uartCtx->tx.accTimeout,
-        NULL);
+static void buffTxStopI(
+    struct uartCtx *    uartCtx) {
 
-    if (0 != retval) {
-        uartCtx->tx.status = UART_STATUS_BUSY;
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-        return (-EBUSY);
-    }
-    rtdm_toseq_init(
-        &tmSeq,
-        uartCtx->tx.oprTimeout);
+    uartCtx->tx.buff.pend  = 0U;
+    uartCtx->engine.isTxOn = FALSE;
+    uartCtx->engine.ops->txStopI(
+        uartCtx);
+}
 
-    if (TRUE == circIsEmpty(&uartCtx->tx.buff.handle)) {
-        buffTxFlushI(
-            uartCtx);
-    }
-    src = (const uint8_t *)buff;
-    CRITICAL_ENTER(uartCtx, lockCtx);
-    transfer = buffTxCopyI(
-        uartCtx,
-        &lockCtx,
-        src,
-        bytes);
+static void buffTxPendI(
+    struct uartCtx *    uartCtx,
+    size_t              pending) {
 
-    if (0 > transfer) {
-        buffTxStopI(
-            uartCtx);
-        CRITICAL_EXIT(uartCtx, lockCtx);
-        rtdm_sem_up(
-            &uartCtx->tx.acc);
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-        return (transfer);
+    if (pending > circSizeGet(&uartCtx->tx.buff.handle)) {
+        uartCtx->tx.buff.pend = circSizeGet(&uartCtx->tx.buff.handle);
+    } else {
+        uartCtx->tx.buff.pend = pending;
     }
-    buffTxStartI(
+    rtdm_event_clear(
+        &uartCtx->tx.opr);
+    uartCtx->engine.isTxOn = TRUE;
+    uartCtx->engine.ops->txKickI(
         uartCtx);
-    src     += transfer;
-    bytes   -= transfer;
-    written  = transfer;
-
-    while (0 < bytes) {
-        buffTxPendI(
-            uartCtx,
-            bytes);
-        CRITICAL_EXIT(uartCtx, lockCtx);
-        retval = buffTxWait(
-            uartCtx,
-            &tmSeq);
-
-        if (0 > retval) {
-
-            break;
-        }
-        CRITICAL_ENTER(uartCtx, lockCtx);
-        transfer = buffTxCopyI(
-            uartCtx,
-            &lockCtx,
-            src,
-            bytes);
+}
 
-        if (0 > transfer) {
+static int buffTxWait(
+    struct uartCtx *    uartCtx,
+    rtdm_toseq_t *      tmSeq) {
 
-            break;
-        }
-        src     += transfer;
-        bytes   -= transfer;
-        written += transfer;
-    }
-    CRITICAL_EXIT(uartCtx, lockCtx);
-    rtdm_sem_up(
-        &uartCtx->tx.acc);
+    int                 retval;
 
-    if (0 == retval) {
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-        return (written);
-    }
+    retval = rtdm_event_timedwait(
+        &uartCtx->tx.opr,
+        uartCtx->tx.oprTimeout,
+        tmSeq);
 
     return (retval);
 }
 
-/* Handler function in IRQ mode                                               */
-static int handleIrq(
-    rtdm_irq_t *        arg) {
-
-    struct uartCtx *    uartCtx;
-    volatile uint8_t *  io;
-    int                 retval;
-    enum lldIntNum      intNum;
+static ssize_t buffTxCopyI(
+    struct uartCtx *    uartCtx,
+    CRITICAL_TYPE *     lockCtx,
+    struct ioCursor *   src,
+    size_t              bytes) {
 
-    uartCtx = rtdm_irq_get_arg(arg, struct uartCtx);
+    size_t              transfer;
+    size_t              cpd;
+    size_t              rem;
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    LOG_DBG("UART IRQ handler");
-    io = uartCtx->cache.io;
-    retval = RTDM_IRQ_HANDLED;
-    uartCtx->rx.status = UART_STATUS_NORMAL;
-    CRITICAL_ENTER_ISR(uartCtx);
+    cpd = 0U;
+    rem = circRemainingFreeGet(
+        &uartCtx->tx.buff.handle);
 
-    while (LLD_INT_NONE != (intNum = lldIntGet(io))) {                                          /* Loop until there are interrupts to process               */
+    if (0 == rem) {
 
-        /*-- Receive interrupt -----------------------------------------------*/
-        if ((LLD_INT_RX == intNum) || (LLD_INT_RX_TIMEOUT == intNum)) {
-            size_t      transfer;
+        return (0);
+    }
 
-            transfer = lldFIFORxOccupied(
-                io);
+    do {
+        uint8_t *       dst;
+        int             retval;
 
-            if (transfer > circFreeGet(&uartCtx->rx.buff.handle)) {
-                cIntSetDisable(
-                    uartCtx,
-                    C_INT_RX | C_INT_RX_TIMEOUT);
-                lldFIFORxFlush(
-                    io);
-                uartCtx->rx.status = UART_STATUS_SOFT_OVERFLOW;
-            } else {
-                buffRxTrans(
-                    uartCtx,
-                    transfer);
+        dst = circMemHeadGet(
+            &uartCtx->tx.buff.handle);
+        transfer = min(bytes, rem);
+        CRITICAL_EXIT(uartCtx, tx, *lockCtx);
+        retval = ioCursorCopyFrom(
+            src,
+            uartCtx->tx.user,
+            dst,
+            transfer);
 
-                if (uartCtx->rx.buff.pend <= circOccGet(&uartCtx->rx.buff.handle)) {
-                    uartCtx->rx.buff.pend = 0U;
-                    rtdm_event_signal(
-                        &uartCtx->rx.opr);
-                }
-            }
+        if (0 == retval) {
+            crcUpdate(
+                &uartCtx->tx.crc,
+                dst,
+                transfer);                                                      /* Head is not moved yet, ISR does not see these bytes      */
+        }
+        CRITICAL_ENTER(uartCtx, tx, *lockCtx);
 
-        /*-- Transmit interrupt ----------------------------------------------*/
-        } else if (LLD_INT_TX == intNum) {
-            size_t      transfer;
+        if (0 != retval) {
 
-            transfer = min(lldFIFOTxFree(io), circOccGet(&uartCtx->tx.buff.handle));
+            return ((ssize_t)retval);
+        }
+        bytes -= transfer;
+        cpd   += transfer;
+        circPosHeadSet(
+            &uartCtx->tx.buff.handle,
+            transfer);
+        rem = circRemainingFreeGet(
+            &uartCtx->tx.buff.handle);
+    } while ((0U != bytes) && (0U != rem));
+    txRdyUpdateI(
+        uartCtx);
 
-            buffTxTrans(
-                uartCtx,
-                transfer);
+    return ((ssize_t)cpd);
+}
 
-            if (0 != uartCtx->tx.buff.pend) {
+static void buffTxFlushI(
+    struct uartCtx *    uartCtx) {
 
-                if (circFreeGet(&uartCtx->tx.buff.handle) >= uartCtx->tx.buff.pend) {
-                    uartCtx->tx.buff.pend = 0U;
-                    rtdm_event_signal(
-                        &uartCtx->tx.opr);
-                }
-            }
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-            if (TRUE == circIsEmpty(&uartCtx->tx.buff.handle)) {
-                buffTxStopI(
-                    uartCtx);
-            }
+    uartCtx->tx.buff.pend = 0U;
+    circFlush(
+        &uartCtx->tx.buff.handle);
+    txRdyUpdateI(
+        uartCtx);
+}
 
-        /*-- Other interrupts ------------------------------------------------*/
-        } else {
-            /*
-             * We don't know what happened here, so we disable all interrupts
-             * regardless the cache and notify all listeners. This is kind of a
-             * bug.
-             */
-            retval = RTDM_IRQ_NONE;
-            uartCtx->rx.status = UART_STATUS_UNHANDLED_INTERRUPT;
-            uartCtx->tx.status = UART_STATUS_UNHANDLED_INTERRUPT;
-            lldRegWr(
-                uartCtx->cache.io,
-                wIER,
-                0);
+static int buffTxCrcAppendI(
+    struct uartCtx *    uartCtx,
+    CRITICAL_TYPE *     lockCtx,
+    rtdm_toseq_t *      tmSeq) {
 
-            break;
+    uint8_t             crc[CRC_SIZE_MAX];
+    size_t              size;
+    size_t              cnt;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    size = crcSerialize(
+        &uartCtx->tx.crc,
+        crc);
+
+    while (size > circFreeGet(&uartCtx->tx.buff.handle)) {
+        int             retval;
+
+        buffTxPendI(
+            uartCtx,
+            size);
+        CRITICAL_EXIT(uartCtx, tx, *lockCtx);
+        retval = buffTxWait(
+            uartCtx,
+            tmSeq);
+        CRITICAL_ENTER(uartCtx, tx, *lockCtx);
+
+        if (0 > retval) {
+
+            return (retval);
         }
     }
-    CRITICAL_EXIT_ISR(uartCtx);
 
-    return (retval);
+    for (cnt = 0U; cnt < size; cnt++) {
+        circItemPut(
+            &uartCtx->tx.buff.handle,
+            crc[cnt]);
+    }
+    buffTxStartI(
+        uartCtx);
+    txRdyUpdateI(
+        uartCtx);
+
+    return (0);
 }
 
-/* ===========================================================================
- * NOTE:    End of DMA mode 0 (disabled) and DMA mode 1 (soft DMA) functions
- * NOTE:    Begin of functions that will compile only in DMA mode 2 (hardware
- *          DMA)
- * ===========================================================================*/
-#elif (2 == CFG_DMA_MODE)
+static int buffTxIdleWaitI(
+    struct uartCtx *    uartCtx,
+    CRITICAL_TYPE *     lockCtx,
+    rtdm_toseq_t *      tmSeq) {
 
-static int32_t buffAlloc(
-    struct buff *       buff,
-    size_t              size) {
+    CRITICAL_DECL(rxLockCtx);
+    nanosecs_abs_t      idle;
+    nanosecs_rel_t      t35;
+    int                 retval;
 
-    uint8_t *           buffRemap;
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    buffRemap = dma_alloc_coherent(
-        NULL,
-        size,
-        (dma_addr_t *)&buff->phy,
-        0);
-    LOG_DBG("allocated buffer: remap: %p", buffRemap);
-    LOG_DBG("allocated buffer: phy  : %p", buff->phy);
+    while (FALSE == circIsEmpty(&uartCtx->tx.buff.handle)) {                    /* Previous frame must leave the buffer first               */
+        buffTxPendI(
+            uartCtx,
+            circSizeGet(&uartCtx->tx.buff.handle));
+        CRITICAL_EXIT(uartCtx, tx, *lockCtx);
+        retval = buffTxWait(
+            uartCtx,
+            tmSeq);
+        CRITICAL_ENTER(uartCtx, tx, *lockCtx);
 
-    if ((NULL == buffRemap) || (NULL == buff->phy)) {
+        if (0 > retval) {
 
-        return (-ENOMEM);
+            return (retval);
+        }
     }
-    circInit(
-        &buff->handle,
-        buffRemap,
-        size);
+    idle = uartCtx->tx.stamp;
+    t35  = uartCtx->frame.rtu.t35;
+    CRITICAL_EXIT(uartCtx, tx, *lockCtx);                                       /* Lock order is rx, tx                                     */
+    CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
 
-    return (0);
+    if (idle < uartCtx->rx.stamp) {
+        idle = uartCtx->rx.stamp;
+    }
+    CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+    idle  += t35;
+    retval = 0;
+
+    if (rtdm_clock_read() < idle) {
+        retval = rtdm_task_sleep_abs(
+            idle,
+            RTDM_TIMERMODE_ABSOLUTE);
+    }
+    CRITICAL_ENTER(uartCtx, tx, *lockCtx);
+
+    return (retval);
 }
 
-static uint32_t buffDealloc(
-    struct buff *       buff) {
+static void pollTimerArmI(
+    struct uartCtx *    uartCtx,
+    nanosecs_abs_t      expiry,
+    bool_T              isTimer) {
+
+    if (TRUE == isTimer) {
+        rtdm_timer_start_in_handler(
+            &uartCtx->poll.timer,
+            expiry,
+            0,
+            RTDM_TIMERMODE_ABSOLUTE);
+    } else {
+        rtdm_timer_start(
+            &uartCtx->poll.timer,
+            expiry,
+            0,
+            RTDM_TIMERMODE_ABSOLUTE);
+    }
+}
 
-    dma_free_coherent(
-        NULL,
-        circSizeGet(&buff->handle),
-        circMemBaseGet(&buff->handle),
-        (dma_addr_t)buff->phy);
+static void pollCycleBeginI(
+    struct uartCtx *    uartCtx,
+    bool_T              isTimer) {
 
-    return (0);
+    struct xUartPollResult * result;
+    uint32_t            cnt;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    result = &uartCtx->poll.result[uartCtx->poll.pub ^ 1U];                     /* Work on the unpublished buffer                           */
+    result->cycle    = uartCtx->poll.cycle;
+    result->errors   = 0U;
+    result->overruns = uartCtx->poll.overruns;
+    result->count    = uartCtx->poll.table.count;
+
+    for (cnt = 0U; cnt < uartCtx->poll.table.count; cnt++) {
+        result->slot[cnt].status = XUART_POLL_SKIPPED;
+        result->slot[cnt].size   = 0U;
+    }
+    uartCtx->poll.idx = 0U;
+    pollNextI(
+        uartCtx,
+        isTimer);
 }
 
-static void buffTxFlushI(
-    struct uartCtx *    uartCtx) {
+static void pollCycleEndI(
+    struct uartCtx *    uartCtx,
+    bool_T              isTimer) {
+
+    nanosecs_abs_t      next;
+    nanosecs_abs_t      now;
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    uartCtx->tx.buff.pend = 0U;
-    circFlush(
-        &uartCtx->tx.buff.handle);
+    uartCtx->poll.pub ^= 1U;
+    uartCtx->poll.cycle++;
+    uartCtx->poll.state = POLL_STATE_CYCLE;
+    rtdm_event_signal(
+        &uartCtx->poll.done);                                                   /* The only wakeup in a cycle                               */
+    next = uartCtx->poll.start + US_TO_NS((nanosecs_rel_t)uartCtx->poll.table.period);
+    now  = rtdm_clock_read();
+
+    if (next < now) {
+        next = now;
+        uartCtx->poll.overruns++;
+    }
+    uartCtx->poll.start = next;
+    pollTimerArmI(
+        uartCtx,
+        next,
+        isTimer);
 }
 
-static ssize_t buffTxCopy(
+static void pollNextI(
     struct uartCtx *    uartCtx,
-    const uint8_t *     src,
-    uint8_t *           dst,
-    size_t              bytes) {
+    bool_T              isTimer) {
+
+    const struct xUartPollEntry * entry;
+    uint32_t            cnt;
 
     ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-    if (NULL != uartCtx->tx.user) {
-        int             retval;
+    while (uartCtx->poll.idx < uartCtx->poll.table.count) {
+        uint32_t        every;
 
-        retval = rtdm_copy_from_user(
-            uartCtx->tx.user,
-            dst,
-            src,
-            bytes);
+        every = uartCtx->poll.table.entry[uartCtx->poll.idx].every;
 
-        if (0 != retval) {
+        if ((0U == every) || (0U == (uartCtx->poll.cycle % every))) {
 
-            return (retval);
+            break;
         }
-    } else {
-        memcpy(
-            dst,
-            src,
-            bytes);
+        uartCtx->poll.idx++;
     }
 
-    return (0);
+    if (uartCtx->poll.idx == uartCtx->poll.table.count) {
+        pollCycleEndI(
+            uartCtx,
+            isTimer);
+
+        return;
+    }
+    entry = &uartCtx->poll.table.entry[uartCtx->poll.idx];
+    buffRxFlush(
+        uartCtx);
+    lldFIFORxFlush(
+        uartCtx->cache.io);
+    buffRxStartI(
+        uartCtx);                                                               /* Also re-enables receiver after an overflow               */
+
+    for (cnt = 0U; cnt < entry->reqSize; cnt++) {
+        circItemPut(
+            &uartCtx->tx.buff.handle,
+            entry->req[cnt]);
+    }
+    buffTxStartI(
+        uartCtx);
+    uartCtx->poll.state = POLL_STATE_RSP;
+    pollTimerArmI(
+        uartCtx,
+        rtdm_clock_read() + entry->reqSize * uartCtx->frame.rtu.tChar + US_TO_NS((nanosecs_rel_t)entry->timeout),
+        isTimer);
 }
 
-static volatile uint8_t * buffRemapToPhy(
-    struct buff *       buff,
-    uint8_t *           remap) {
+static void pollSlotFillI(
+    struct uartCtx *    uartCtx,
+    enum xUartPollStatus status) {
 
-    size_t              pos;
+    struct xUartPollResult * result;
+    struct xUartPollSlot * slot;
+    size_t              size;
+    size_t              cnt;
 
-    pos = remap - circMemBaseGet(&buff->handle);
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    result = &uartCtx->poll.result[uartCtx->poll.pub ^ 1U];
+    slot   = &result->slot[uartCtx->poll.idx];
+
+    if (0U != frameQueueOccGet(&uartCtx->frame.queue)) {
+        size = frameQueueGet(
+            &uartCtx->frame.queue);
+    } else {
+        size = circOccGet(
+            &uartCtx->rx.buff.handle);
+    }
+    size = min(size, (size_t)uartCtx->poll.table.entry[uartCtx->poll.idx].rspSize);
+
+    for (cnt = 0U; cnt < size; cnt++) {
+        slot->rsp[cnt] = circItemGet(
+            &uartCtx->rx.buff.handle);
+    }
+    slot->size      = (uint32_t)size;
+    slot->status    = status;
+    slot->timestamp = uartCtx->rx.stamp;
 
-    return (buff->phy + pos);
+    if (XUART_POLL_OK != status) {
+        result->errors++;
+    }
+    uartCtx->poll.idx++;
 }
 
-/* Handler function in DMA mode                                               */
-static int handleRd(
-    struct rtdm_dev_context * devCtx,
-    rtdm_user_info_t *  usrInfo,
-    void *              buff,
-    size_t              bytes) {
+static void pollRxI(
+    struct uartCtx *    uartCtx) {
 
-    struct uartCtx *    uartCtx;
-    int                 retval;
+    bool_T              isDone;
 
-    if (NULL != usrInfo) {
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-        if (0 == rtdm_rw_user_ok(usrInfo, buff, bytes)) {
-            uartCtx = uartCtxFromDevCtx(devCtx);
-            uartCtx->rx.status = UART_STATUS_FAULT_USAGE;
+    if (POLL_STATE_RSP != uartCtx->poll.state) {
 
-            return (-EFAULT);
-        }
+        return;
     }
-    uartCtx = uartCtxFromDevCtx(devCtx);
-    uartCtx->rx.user = usrInfo;
-#if 0
-    portDMARxBeginI(uartCtx->cache.devData, buffRemapToPhy(&uartCtx->rx.buff, circMemHeadGet(&uartCtx->rx.buff.handle)), bytes);
-    portDMARxStartI(uartCtx->cache.devData);
-#endif
-    retval = rtdm_event_timedwait(
-        &uartCtx->rx.opr,
-        uartCtx->rx.oprTimeout,
-        NULL);
 
-    if (0 != retval) {
-        uartCtx->rx.status = UART_STATUS_BUSY;
+    if (UART_STATUS_SOFT_OVERFLOW == uartCtx->rx.status) {                      /* Babbling device: abort the cycle and report it           */
+        pollSlotFillI(
+            uartCtx,
+            XUART_POLL_OVERFLOW);
+        CRITICAL_ENTER_ISR(uartCtx, tx);
+        pollCycleEndI(
+            uartCtx,
+            FALSE);
+        CRITICAL_EXIT_ISR(uartCtx, tx);
 
-        return (-EBUSY);
+        return;
     }
 
-    return (retval);
+    if (XUART_FRAMING_RTU == uartCtx->frame.type) {
+        isDone = (0U != frameQueueOccGet(&uartCtx->frame.queue)) ? TRUE : FALSE;
+    } else {
+        isDone = (uartCtx->poll.table.entry[uartCtx->poll.idx].rspSize <= circOccGet(&uartCtx->rx.buff.handle)) ? TRUE : FALSE;
+    }
+
+    if (TRUE == isDone) {
+        pollSlotFillI(
+            uartCtx,
+            XUART_POLL_OK);
+        CRITICAL_ENTER_ISR(uartCtx, tx);
+        pollNextI(
+            uartCtx,
+            FALSE);                                                             /* Next request goes out without a task wakeup              */
+        CRITICAL_EXIT_ISR(uartCtx, tx);
+    }
 }
 
-/* Handler function in DMA mode                                               */
-static int handleWr(
-    struct rtdm_dev_context * devCtx,
-    rtdm_user_info_t *  usrInfo,
-    const void *        buff,
-    size_t              bytes) {
+static void pollTimerHandler(
+    rtdm_timer_t *      timer) {
 
-    CRITICAL_DECL(lockCtx);
-    rtdm_toseq_t        tmSeq;
     struct uartCtx *    uartCtx;
-    const uint8_t *     src;
-    size_t              transfer;
-    size_t              written;
-    uint8_t *           head;
-    int                 retval;
 
-    uartCtx = uartCtxFromDevCtx(devCtx);
+    uartCtx = container_of(timer, struct uartCtx, poll.timer);
 
-    if (NULL != usrInfo) {
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
 
-        if (0 == rtdm_read_user_ok(usrInfo, buff, bytes)) {
-            uartCtx->tx.status = UART_STATUS_FAULT_USAGE;
+    CRITICAL_ENTER_ISR(uartCtx, rx);
+    CRITICAL_ENTER_ISR(uartCtx, tx);
 
-            return (-EFAULT);
+    if (TRUE == uartCtx->poll.isActive) {
+
+        if (POLL_STATE_CYCLE == uartCtx->poll.state) {
+            pollCycleBeginI(
+                uartCtx,
+                TRUE);
+        } else if (POLL_STATE_RSP == uartCtx->poll.state) {
+            pollSlotFillI(
+                uartCtx,
+                XUART_POLL_TIMEOUT);
+            pollNextI(
+                uartCtx,
+                TRUE);
         }
     }
-    uartCtx->rx.user = usrInfo;
+    CRITICAL_EXIT_ISR(uartCtx, tx);
+    CRITICAL_EXIT_ISR(uartCtx, rx);
+}
+
+static int pollStart(
+    struct uartCtx *    uartCtx) {
+
+    CRITICAL_DECL(rxLockCtx);
+    CRITICAL_DECL(txLockCtx);
+    int                 retval;
+
+#if (1 == CFG_CRITICAL_INT_ENABLE)
+    return (-ENOTSUPP);                                                         /* Poll timer is not covered by IER masking                 */
+#endif
+
+    if ((XUART_FRAMING_NONE != uartCtx->frame.type) && (XUART_FRAMING_RTU != uartCtx->frame.type)) {
+
+        return (-EINVAL);
+    }
+
+    if ((TRUE == uartCtx->poll.isActive) || (0U == uartCtx->poll.table.count)) {
+
+        return (-EINVAL);
+    }
+    retval = rtdm_sem_timeddown(                                                /* Keep read() and write() out while polling                */
+        &uartCtx->rx.acc,
+        uartCtx->rx.accTimeout,
+        NULL);
+
+    if (0 != retval) {
+
+        return (-EBUSY);
+    }
     retval = rtdm_sem_timeddown(
         &uartCtx->tx.acc,
         uartCtx->tx.accTimeout,
         NULL);
 
     if (0 != retval) {
-        uartCtx->tx.status = UART_STATUS_BUSY;
+        rtdm_sem_up(
+            &uartCtx->rx.acc);
 
         return (-EBUSY);
     }
-    rtdm_toseq_init(
-        &tmSeq,
-        uartCtx->tx.oprTimeout);
+    CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+    CRITICAL_ENTER(uartCtx, tx, txLockCtx);
+    buffTxFlushI(
+        uartCtx);
+    rtdm_event_clear(
+        &uartCtx->poll.done);
+    uartCtx->poll.isActive = TRUE;
+    uartCtx->poll.state    = POLL_STATE_CYCLE;
+    uartCtx->poll.cycle    = 0U;
+    uartCtx->poll.overruns = 0U;
+    uartCtx->poll.pub      = 0U;
+    uartCtx->poll.start    = rtdm_clock_read();
+    pollTimerArmI(
+        uartCtx,
+        uartCtx->poll.start,
+        FALSE);
+    CRITICAL_EXIT(uartCtx, tx, txLockCtx);
+    CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
 
-    if (TRUE == circIsEmpty(&uartCtx->tx.buff.handle)) {
-        buffTxFlushI(
-            uartCtx);
+    return (0);
+}
+
+static int pollStop(
+    struct uartCtx *    uartCtx) {
+
+    CRITICAL_DECL(rxLockCtx);
+    CRITICAL_DECL(txLockCtx);
+
+    if (FALSE == uartCtx->poll.isActive) {
+
+        return (-EINVAL);
     }
-    src = (const uint8_t *)buff;
-    CRITICAL_ENTER(uartCtx, lockCtx);
-    written  = 0u;
-    lldRegWr(uartCtx->cache.io, wTHR, 0x11);
-    lldRegWr(uartCtx->cache.io, wTHR, 0x11);
-    lldRegWr(uartCtx->cache.io, wTHR, 0x11);
-    lldRegWr(uartCtx->cache.io, wTHR, 0x11);
-    lldRegWr(uartCtx->cache.io, wTHR, 0x11);
-    lldRegWr(uartCtx->cache.io, wTHR, 0x11);
-    lldRegWr(uartCtx->cache.io, wTHR, 0x11);
-    lldRegWr(uartCtx->cache.io, wTHR, 0x11);
-    lldRegWr(uartCtx->cache.io, wTHR, 0x11);
-    transfer = min(bytes, circRemainingFreeGet(&uartCtx->tx.buff.handle));
-
-    if (0u != transfer) {
-        head = circMemHeadGet(&uartCtx->tx.buff.handle);
-        CRITICAL_EXIT(uartCtx, lockCtx);
-        retval = buffTxCopy(
-            uartCtx,
-            src,
-            head,
-            transfer);
-        CRITICAL_ENTER(uartCtx, lockCtx);
-        circPosHeadSet(
-            &uartCtx->tx.buff.handle,
-            transfer);
+    CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+    CRITICAL_ENTER(uartCtx, tx, txLockCtx);
+    rtdm_timer_stop(
+        &uartCtx->poll.timer);
+    uartCtx->poll.isActive = FALSE;
+    uartCtx->poll.state    = POLL_STATE_IDLE;
+    buffRxFlush(
+        uartCtx);
 
-        if (FALSE == portDMATxIsRunning(uartCtx->cache.devData)) {
-            uartCtx->tx.buff.chunk = transfer;
-            portDMATxBeginI(
-                uartCtx->cache.devData,
-                buffRemapToPhy(&uartCtx->tx.buff, head),
-                transfer);
-            portDMATxStartI(
-                uartCtx->cache.devData);
+    if (FALSE == uartCtx->rx.isPersistent) {
+        buffRxStopI(
+            uartCtx);
+    }
+    CRITICAL_EXIT(uartCtx, tx, txLockCtx);
+    CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+    rtdm_event_signal(
+        &uartCtx->poll.done);                                                   /* Release a task blocked in XUART_POLL_WAIT                */
+    rtdm_sem_up(
+        &uartCtx->tx.acc);
+    rtdm_sem_up(
+        &uartCtx->rx.acc);
+
+    return (0);
+}
+
+static void tapFeedI(
+    struct uartCtx *    uartCtx,
+    const uint8_t *     burst,
+    size_t              size) {
+
+    struct uartCtx *    tap;
+    nanosecs_abs_t      now;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    now = rtdm_clock_read();
+
+    for (tap = uartCtx->tap.next; NULL != tap; tap = tap->tap.next) {
+        size_t          free;
+        size_t          put;
+        size_t          cnt;
+
+        if (0U != tap->tap.channel) {                                           /* Channel taps get demultiplexed frames only               */
+            continue;
+        }
+        CRITICAL_ENTER_ISR(tap, rx);
+        free = circFreeGet(
+            &tap->rx.buff.handle);
+        put  = size;
+
+        if (put > free) {
+
+            if ((XUART_TAP_DROP_OLD == tap->tap.policy) && (FALSE == tap->tap.isCopying)) {
+                size_t  drop;
+
+                drop = put - free;                                              /* Burst is never bigger than the buffer                    */
+
+                while (0U != drop) {
+                    size_t  chunk;
+
+                    chunk = min(drop, circRemainingOccGet(&tap->rx.buff.handle));
+                    circPosTailSet(
+                        &tap->rx.buff.handle,
+                        (int32_t)chunk);
+                    drop -= chunk;
+                }
+                tap->tap.lost += put - free;
+            } else {
+                put = free;                                                     /* Reader owns the tail, so drop the new bytes instead      */
+                tap->tap.lost += size - put;
+            }
+        }
+
+        for (cnt = 0U; cnt < put; cnt++) {
+            circItemPut(
+                &tap->rx.buff.handle,
+                burst[cnt]);
+        }
+        tap->rx.stamp = now;
+        rxRdyUpdateI(
+            tap);
+
+        if ((0U != tap->rx.buff.pend) && (tap->rx.buff.pend <= circOccGet(&tap->rx.buff.handle))) {
+            tap->rx.buff.pend = 0U;
+            rtdm_event_signal(
+                &tap->rx.opr);
         }
-        src    += transfer;
-        bytes  -= transfer;
-        written = transfer;
+        CRITICAL_EXIT_ISR(tap, rx);
     }
+}
 
-    while (0 < bytes) {
-        uartCtx->tx.buff.pend = bytes;
-        CRITICAL_EXIT(uartCtx, lockCtx);
-        retval = rtdm_event_timedwait(
-            &uartCtx->tx.opr,
-            uartCtx->tx.oprTimeout,
-            &tmSeq);
+static int tapPoolInit(
+    void) {
+
+    uint32_t            cnt;
+    int                 retval;
+
+    for (cnt = 0U; cnt < CFG_TAP_MAX; cnt++) {
+        struct uartCtx * tap;
+
+        tap = &TapPool[cnt];
+        retval = buffAlloc(
+            &tap->rx.buff,
+            CFG_DRV_BUFF_SIZE,
+            DMA_NONE);
 
         if (0 != retval) {
-            retval = 0;
+            LOG_ERR("failed to create tap buffer, err: %d", -retval);
+
+            return (retval);
+        }
+        CRITICAL_INIT(tap);
+        rtdm_sem_init(
+            &tap->rx.acc,
+            1U);
+        rtdm_event_init(
+            &tap->rx.opr,
+            0U);
+        rtdm_event_init(
+            &tap->rx.rdy,
+            0U);
+        tap->tap.owner = NULL;
+        tap->tap.next  = NULL;
+        tap->tap.isTap = TRUE;
+        tap->isOpen    = FALSE;
+        tap->state     = CTX_STATE_RX_BUFF;
+        tap->signature = UART_CTX_SIGNATURE;
+    }
+
+    return (0);
+}
+
+static void tapPoolTerm(
+    void) {
+
+    uint32_t            cnt;
+
+    for (cnt = 0U; cnt < CFG_TAP_MAX; cnt++) {
+        struct uartCtx * tap;
+
+        tap = &TapPool[cnt];
+
+        if (CTX_STATE_RX_BUFF == tap->state) {
+            rtdm_event_destroy(
+                &tap->rx.rdy);
+            rtdm_event_destroy(
+                &tap->rx.opr);
+            rtdm_sem_destroy(
+                &tap->rx.acc);
+            buffDealloc(
+                &tap->rx.buff);
+            tap->state     = CTX_STATE_INIT;
+            tap->signature = ~UART_CTX_SIGNATURE;
+        }
+    }
+}
+
+static struct uartCtx * tapClaimI(
+    void) {
+
+    uint32_t            cnt;
+
+    for (cnt = 0U; cnt < CFG_TAP_MAX; cnt++) {
+
+        if ((CTX_STATE_RX_BUFF == TapPool[cnt].state) && (FALSE == TapPool[cnt].isOpen)) {
+            TapPool[cnt].isOpen = TRUE;
+
+            return (&TapPool[cnt]);
+        }
+    }
+
+    return (NULL);
+}
+
+static int tapOpen(
+    struct uartCtx *    tap,
+    struct uartCtx *    owner) {
+
+    rtdm_lockctx_t      tapLockCtx;
+    CRITICAL_DECL(rxLockCtx);
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == tap->signature);
+
+    circFlush(
+        &tap->rx.buff.handle);
+    rtdm_event_clear(
+        &tap->rx.opr);
+    rtdm_event_clear(
+        &tap->rx.rdy);
+    crcInit(
+        &tap->rx.crc,
+        CRC_NONE);
+    tap->cache.io         = owner->cache.io;
+    tap->cache.devData    = owner->cache.devData;
+    tap->rx.accTimeout    = MS_TO_NS(CFG_TIMEOUT_MS);
+    tap->rx.oprTimeout    = MS_TO_NS(CFG_TIMEOUT_MS);
+    tap->rx.buff.pend     = 0U;
+    tap->rx.status        = UART_STATUS_NORMAL;
+    tap->rx.statusLatch   = UART_STATUS_NORMAL;
+    tap->rx.statusLast    = UART_STATUS_NORMAL;
+    tap->rx.stamp         = 0U;
+    tap->rx.rdyLevel      = 1U;
+    tap->rx.isRdy         = FALSE;
+    tap->rx.isPersistent  = TRUE;
+    tap->frame.type       = XUART_FRAMING_NONE;
+    tap->tap.owner        = owner;
+    tap->tap.next         = NULL;
+    tap->tap.policy       = XUART_TAP_DROP_NEW;
+    tap->tap.lost         = 0U;
+    tap->tap.isCopying    = FALSE;
+    tap->tap.channel      = 0U;
+    frameQueueFlush(
+        &tap->frame.queue);
+    rtdm_lock_get_irqsave(&TapLock, tapLockCtx);
+
+    if (owner != UartOwner) {                                                   /* Owner was closed in the meantime                         */
+        rtdm_lock_put_irqrestore(&TapLock, tapLockCtx);
+        tap->tap.owner = NULL;
+        tapClose(
+            tap);
+
+        return (-EBUSY);
+    }
+    CRITICAL_ENTER(owner, rx, rxLockCtx);
+    tap->tap.next   = owner->tap.next;
+    owner->tap.next = tap;
+
+    if (FALSE == owner->rx.isPersistent) {                                      /* Keep the receiver running, but do not flush owner data   */
+        owner->rx.isPersistent = TRUE;
+        buffRxStartI(
+            owner);
+    }
+    CRITICAL_EXIT(owner, rx, rxLockCtx);
+    rtdm_lock_put_irqrestore(&TapLock, tapLockCtx);
+
+    return (0);
+}
+
+static void tapClose(
+    struct uartCtx *    tap) {
+
+    rtdm_lockctx_t      tapLockCtx;
+    struct uartCtx *    owner;
+
+    rtdm_lock_get_irqsave(&TapLock, tapLockCtx);
+    owner = tap->tap.owner;
+
+    if (NULL != owner) {
+        CRITICAL_DECL(rxLockCtx);
+        struct uartCtx ** link;
+
+        CRITICAL_ENTER(owner, rx, rxLockCtx);
+
+        link = &owner->tap.next;
+
+        while (tap != *link) {
+            link = &(*link)->tap.next;
+        }
+        *link = tap->tap.next;
+        CRITICAL_EXIT(owner, rx, rxLockCtx);
+    }
+    tap->tap.owner = NULL;
+    tap->tap.next  = NULL;
+    tap->isOpen    = FALSE;                                                     /* Return the context to TapPool                            */
+    rtdm_lock_put_irqrestore(&TapLock, tapLockCtx);
+}
+
+static void tapDetachAllI(
+    struct uartCtx *    owner) {
+
+    struct uartCtx *    tap;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == owner->signature);
+
+    tap = owner->tap.next;
+
+    while (NULL != tap) {
+        struct uartCtx * next;
+
+        CRITICAL_ENTER_ISR(tap, rx);
+        next           = tap->tap.next;
+        tap->tap.owner = NULL;
+        tap->tap.next  = NULL;
+        rtdm_event_signal(
+            &tap->rx.opr);                                                      /* Blocked reader returns -EBADF                            */
+        CRITICAL_EXIT_ISR(tap, rx);
+        tap = next;
+    }
+    owner->tap.next = NULL;
+}
+
+static ssize_t xferRdTap(
+    struct uartCtx *    tap,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   dst,
+    size_t              bytes) {
+
+    CRITICAL_DECL(lockCtx);
+    rtdm_toseq_t        tmSeq;
+    ssize_t             retval;
+
+    retval = rtdm_sem_timeddown(
+        &tap->rx.acc,
+        tap->rx.accTimeout,
+        NULL);
+
+    if (0 != retval) {
+        tap->rx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+    tap->rx.user = usrInfo;
+    rtdm_toseq_init(
+        &tmSeq,
+        tap->rx.oprTimeout);
+    CRITICAL_ENTER(tap, rx, lockCtx);
+
+    while (0U == circOccGet(&tap->rx.buff.handle)) {
+
+        if (NULL == tap->tap.owner) {
+            retval = -EBADF;
 
             break;
         }
-        CRITICAL_ENTER(uartCtx, lockCtx);
-        transfer = min(bytes, circRemainingFreeGet(&uartCtx->tx.buff.handle));
-        head = circMemTailGet(
-            &uartCtx->tx.buff.handle);
-        CRITICAL_EXIT(uartCtx, lockCtx);
-        retval = buffTxCopy(
+        buffRxPendI(
+            tap,
+            1U);
+        CRITICAL_EXIT(tap, rx, lockCtx);
+        retval = buffRxWait(
+            tap,
+            &tmSeq);
+        CRITICAL_ENTER(tap, rx, lockCtx);
+
+        if (0 > retval) {
+            retval = 0;                                                         /* Timeout: nothing was read                                */
+
+            break;
+        }
+    }
+
+    if (0U != circOccGet(&tap->rx.buff.handle)) {
+        tap->tap.isCopying = TRUE;
+        retval = buffRxCopyI(
+            tap,
+            &lockCtx,
+            dst,
+            bytes);
+        tap->tap.isCopying = FALSE;
+
+        if (0 > retval) {
+            tap->rx.status = UART_STATUS_FAULT_USAGE;
+        }
+    }
+    tap->rx.buff.pend = 0U;
+    rxStatusTakeI(
+        tap);
+    CRITICAL_EXIT(tap, rx, lockCtx);
+    rtdm_sem_up(
+        &tap->rx.acc);
+
+    return (retval);
+}
+
+static void muxDeliverI(
+    struct uartCtx *    uartCtx) {
+
+    struct uartCtx *    tap;
+    const uint8_t *     base;
+    size_t              size;
+    size_t              len;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    len = uartCtx->frame.uncommitted;
+    tap = uartCtx->tap.next;
+
+    while ((NULL != tap) && (uartCtx->frame.mux.id != tap->tap.channel)) {
+        tap = tap->tap.next;
+    }
+
+    if (NULL != tap) {
+        CRITICAL_ENTER_ISR(tap, rx);
+
+        if ((len <= circFreeGet(&tap->rx.buff.handle)) && (CFG_FRAME_QUEUE_SIZE > frameQueueOccGet(&tap->frame.queue))) {
+            uint32_t    pos;
+            size_t      cnt;
+
+            base = circMemBaseGet(
+                &uartCtx->rx.buff.handle);
+            size = circSizeGet(
+                &uartCtx->rx.buff.handle);
+            pos  = (uint32_t)((circPosHeadGet(&uartCtx->rx.buff.handle) + size - len) % size);
+
+            for (cnt = 0U; cnt < len; cnt++) {
+                circItemPut(
+                    &tap->rx.buff.handle,
+                    base[pos]);
+
+                if (size == ++pos) {
+                    pos = 0U;
+                }
+            }
+            (void)frameQueuePut(
+                &tap->frame.queue,
+                len);
+            tap->rx.stamp = uartCtx->rx.stamp;
+            rxRdyUpdateI(
+                tap);
+
+            if (0U != tap->rx.buff.pend) {
+                tap->rx.buff.pend = 0U;
+                rtdm_event_signal(
+                    &tap->rx.opr);
+            }
+        } else {
+            tap->tap.lost += len;                                               /* Slow channel reader loses only its own frames            */
+        }
+        CRITICAL_EXIT_ISR(tap, rx);
+    }
+    circPosHeadRewind(
+        &uartCtx->rx.buff.handle,
+        len);
+}
+
+static ssize_t xferRdChannel(
+    struct uartCtx *    tap,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   dst,
+    size_t              bytes) {
+
+    CRITICAL_DECL(lockCtx);
+    rtdm_toseq_t        tmSeq;
+    ssize_t             retval;
+
+    retval = rtdm_sem_timeddown(
+        &tap->rx.acc,
+        tap->rx.accTimeout,
+        NULL);
+
+    if (0 != retval) {
+        tap->rx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+    tap->rx.user = usrInfo;
+    rtdm_toseq_init(
+        &tmSeq,
+        tap->rx.oprTimeout);
+    CRITICAL_ENTER(tap, rx, lockCtx);
+
+    if ((NULL == tap->tap.owner) && (0U == frameQueueOccGet(&tap->frame.queue))) {
+        retval = -EBADF;
+    } else {
+        tap->tap.isCopying = TRUE;
+        retval = buffRxFrameGetI(
+            tap,
+            &lockCtx,
+            dst,
+            bytes,
+            &tmSeq);
+        tap->tap.isCopying = FALSE;
+    }
+    rxStatusTakeI(
+        tap);
+    CRITICAL_EXIT(tap, rx, lockCtx);
+    rtdm_sem_up(
+        &tap->rx.acc);
+
+    return (retval);
+}
+
+static void rxServiceI(
+    struct uartCtx *    uartCtx,
+    size_t              transfer,
+    bool_T              isTimeout) {
+
+    volatile uint8_t *  io;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    io = uartCtx->cache.io;
+
+    if (XUART_FRAMING_RTU == uartCtx->frame.type) {
+        buffRxRtuTransI(
+            uartCtx,
+            transfer,
+            isTimeout);
+    } else if (0U == transfer) {
+        /* Silence reported by the polled engine, nothing to move           */
+    } else if (XUART_FRAMING_NONE != uartCtx->frame.type) {
+
+        if (transfer > circFreeGet(&uartCtx->rx.buff.handle)) {                /* Drop the frame in progress, keep receiving            */
+            circPosHeadRewind(
+                &uartCtx->rx.buff.handle,
+                uartCtx->frame.uncommitted);
+            uartCtx->frame.uncommitted = 0U;
+            uartCtx->frame.mux.isIdPending = TRUE;
+            frameDecDiscard(
+                &uartCtx->frame.dec);
+            lldFIFORxFlush(
+                io);
+            rxStatusLatchI(
+                uartCtx,
+                UART_STATUS_SOFT_OVERFLOW);
+        } else {
+            buffRxFrameTrans(
+                uartCtx,
+                transfer);
+            uartCtx->rx.stamp = rtdm_clock_read();
+            rxRdyUpdateI(
+                uartCtx);
+
+            if ((0U != uartCtx->rx.buff.pend) && (0U != frameQueueOccGet(&uartCtx->frame.queue))) {
+                uartCtx->rx.buff.pend = 0U;                                     /* One wakeup per complete frame                            */
+                rtdm_event_signal(
+                    &uartCtx->rx.opr);
+            }
+        }
+    } else if (transfer > circFreeGet(&uartCtx->rx.buff.handle)) {
+        uartCtx->engine.isRxOn = FALSE;                                         /* Reader starts the receiver again                         */
+        uartCtx->engine.ops->rxStopI(
+            uartCtx);
+        lldFIFORxFlush(
+            io);
+        rxStatusLatchI(
+            uartCtx,
+            UART_STATUS_SOFT_OVERFLOW);
+    } else if (0U != buffRxTrans(uartCtx, transfer)) {                          /* Nothing to do when all bytes were filtered out           */
+        uartCtx->rx.stamp = rtdm_clock_read();
+        rxRdyUpdateI(
+            uartCtx);
+
+        if ((uartCtx->rx.buff.pend <= circOccGet(&uartCtx->rx.buff.handle)) || (TRUE == uartCtx->wake.isHit)) {
+            uartCtx->rx.buff.pend = 0U;
+            uartCtx->wake.isHit   = FALSE;
+            rtdm_event_signal(
+                &uartCtx->rx.opr);
+        }
+    }
+
+    if (TRUE == isTimeout) {
+        uartCtx->filter.isGap = TRUE;                                           /* Four characters of silence end the frame                 */
+    }
+
+    if (TRUE == uartCtx->poll.isActive) {
+        pollRxI(
+            uartCtx);
+    }
+}
+
+static void txServiceI(
+    struct uartCtx *    uartCtx) {
+
+    volatile uint8_t *  io;
+    size_t              transfer;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    io       = uartCtx->cache.io;
+    transfer = min(lldFIFOTxFree(io), circOccGet(&uartCtx->tx.buff.handle));
+
+    if (0U != transfer) {
+        uartCtx->engine.ops->txTransI(
             uartCtx,
-            src,
-            head,
-            transfer);
-        CRITICAL_ENTER(uartCtx, lockCtx);
-        circPosHeadSet(
-            &uartCtx->tx.buff.handle,
-            transfer);
-        uartCtx->tx.buff.chunk = transfer;
-        portDMATxBeginI(
-            uartCtx->cache.devData,
-            buffRemapToPhy(&uartCtx->tx.buff, head),
             transfer);
-        portDMARxStartI(
-            uartCtx->cache.devData);
-        src     += transfer;
-        bytes   -= transfer;
-        written += transfer;
     }
-    uartCtx->tx.buff.pend = 0u;
-    CRITICAL_EXIT(uartCtx, lockCtx);
-    rtdm_sem_up(
-        &uartCtx->tx.acc);
+    txRdyUpdateI(
+        uartCtx);
+
+    if (0 != uartCtx->tx.buff.pend) {
+
+        if (circFreeGet(&uartCtx->tx.buff.handle) >= uartCtx->tx.buff.pend) {
+            uartCtx->tx.buff.pend = 0U;
+            rtdm_event_signal(
+                &uartCtx->tx.opr);
+        }
+    }
+
+    if (TRUE == circIsEmpty(&uartCtx->tx.buff.handle)) {
+        uartCtx->tx.stamp  = (DEF_FIFO_SIZE - lldFIFOTxFree(io)) * uartCtx->frame.rtu.tChar;
+        uartCtx->tx.stamp += rtdm_clock_read();                                 /* Estimated end of transmission                            */
+        buffTxStopI(
+            uartCtx);
+    }
+}
+
+static void irqRxStartI(
+    struct uartCtx *    uartCtx) {
+
+    cIntSetEnable(
+        uartCtx,
+        C_INT_RX | C_INT_RX_TIMEOUT);
+}
+
+static void irqRxStopI(
+    struct uartCtx *    uartCtx) {
+
+    cIntDisable(
+        uartCtx,
+        C_INT_RX | C_INT_RX_TIMEOUT);
+}
+
+static void irqTxKickI(
+    struct uartCtx *    uartCtx) {
+
+    cIntEnable(
+        uartCtx,
+        C_INT_TX);
+}
+
+static void irqTxStopI(
+    struct uartCtx *    uartCtx) {
+
+    cIntSetDisable(
+        uartCtx,
+        C_INT_TX);
+}
+
+static void fifoTxTransI(
+    struct uartCtx *    uartCtx,
+    size_t              size) {
+
+    do {
+        uint16_t        item;
+
+        size--;
+        item = circItemGet(
+            &uartCtx->tx.buff.handle);
+        lldRegWr(
+            uartCtx->cache.io,
+            wTHR,
+            item);
+    } while (0U != size);
+}
+
+#if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
+static void softDmaDetachI(
+    struct uartCtx *    uartCtx) {
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    softDmaTxStopI(
+        uartCtx);
+
+    if (0U != uartCtx->tx.buff.chunk) {
+        buffDmaTakeI(                                                           /* Tail stays, the stopped chunk never completed            */
+            &uartCtx->tx.buff,
+            circPosTailGet(&uartCtx->tx.buff.handle),
+            uartCtx->tx.buff.chunk);
+        uartCtx->tx.buff.chunk = 0U;
+    }
+    uartCtx->engine.isTxOn = FALSE;
+}
+
+static void softDmaTxStopI(
+    struct uartCtx *    uartCtx) {
+
+    cIntDisable(
+        uartCtx,
+        C_INT_TX);
+    portDMATxStopI(
+        uartCtx->cache.devData);
+}
+#endif
+
+#if (1 == CFG_DMA_MODE)
+static void softDmaTxTransI(
+    struct uartCtx *    uartCtx,
+    size_t              size) {
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    (void)size;                                                                 /* DMA requests of the UART pace the transfer               */
+
+    if (FALSE == portDMATxIsRunning(uartCtx->cache.devData)) {
+        uartCtx->tx.buff.chunk = circStorageOccGet(                             /* Up to the buffer end, the rest goes with the next chunk  */
+            &uartCtx->tx.buff.handle);
+        LOG_DBG("DMA transfer of %d bytes", uartCtx->tx.buff.chunk);
+        buffDmaGiveI(
+            &uartCtx->tx.buff,
+            circPosTailGet(&uartCtx->tx.buff.handle),
+            uartCtx->tx.buff.chunk);
+        portDMATxBeginI(
+            uartCtx->cache.devData,
+            uartCtx->tx.buff.phy + circPosTailGet(&uartCtx->tx.buff.handle),
+            uartCtx->tx.buff.chunk);
+        portDMATxStartI(
+            uartCtx->cache.devData);
+    }
+    cIntDisable(
+        uartCtx,
+        C_INT_TX);                                                              /* dmaCallbackTx() signals the completion                   */
+}
+
+static void hybridCalibrateI(
+    struct uartCtx *    uartCtx) {
+
+    struct hybrid *     hybrid;
+
+    hybrid = &uartCtx->engine.hybrid;
+    hybrid->threshold    = DEF_FIFO_SIZE;                                       /* Longer bursts go by DMA and get timed as well            */
+    hybrid->pioTime      = 0U;
+    hybrid->pioBytes     = 0U;
+    hybrid->pioSamples   = 0U;
+    hybrid->dmaTime      = 0U;
+    hybrid->dmaSamples   = 0U;
+    hybrid->isCalibrated = FALSE;
+}
+
+static void hybridSampleI(
+    struct uartCtx *    uartCtx) {
+
+    struct hybrid *     hybrid;
+    size_t              threshold;
+
+    hybrid = &uartCtx->engine.hybrid;
+
+    if ((DEF_HYBRID_SAMPLES > hybrid->pioSamples) || (DEF_HYBRID_SAMPLES > hybrid->dmaSamples)) {
+
+        return;
+    }
+    hybrid->pioByte      = hybrid->pioTime / max(hybrid->pioBytes, (size_t)1U);
+    hybrid->dmaSetup     = hybrid->dmaTime / hybrid->dmaSamples;
+    threshold            = hybrid->dmaSetup / max(hybrid->pioByte, 1U);
+    hybrid->threshold    = min(max(threshold, (size_t)DEF_FIFO_SIZE), (size_t)CFG_DRV_BUFF_SIZE);
+    hybrid->isCalibrated = TRUE;
+    LOG_INFO("hybrid engine: DMA cycle %uns, THR write %uns per byte, threshold %u bytes",
+        hybrid->dmaSetup,
+        hybrid->pioByte,
+        (uint32_t)hybrid->threshold);
+}
+
+static void hybridAttachI(
+    struct uartCtx *    uartCtx) {
+
+    uartCtx->engine.hybrid.dmaBursts = 0U;                                      /* Threshold is kept, see uartCtxInit()                     */
+    uartCtx->engine.hybrid.pioBursts = 0U;
+}
+
+static void hybridDetachI(
+    struct uartCtx *    uartCtx) {
+
+    bool_T              isStopped;
+
+    isStopped = (0U != uartCtx->tx.buff.chunk) ? TRUE : FALSE;
+    softDmaDetachI(
+        uartCtx);
+
+    if ((TRUE == isStopped) && (FALSE == uartCtx->engine.hybrid.isCalibrated)) {
+        hybridCalibrateI(                                                       /* Start of the stopped cycle is already in dmaTime         */
+            uartCtx);
+    }
+}
+
+static void hybridTxTransI(
+    struct uartCtx *    uartCtx,
+    size_t              size) {
+
+    nanosecs_abs_t      begin;
+    size_t              occ;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    if (TRUE == portDMATxIsRunning(uartCtx->cache.devData)) {
+        cIntDisable(
+            uartCtx,
+            C_INT_TX);                                                          /* Tail moves only in dmaCallbackTx()                       */
+
+        return;
+    }
+    occ = circOccGet(
+        &uartCtx->tx.buff.handle);
+
+    begin = rtdm_clock_read();
+
+    if ((occ <= max(size, uartCtx->engine.hybrid.threshold)) ||
+        (circStorageOccGet(&uartCtx->tx.buff.handle) <= size)) {                /* Short run before the buffer end is not worth a DMA       */
+        uartCtx->engine.hybrid.pioBursts++;
+        fifoTxTransI(
+            uartCtx,
+            size);
+
+        if (FALSE == uartCtx->engine.hybrid.isCalibrated) {
+            uartCtx->engine.hybrid.pioTime  += (uint32_t)(rtdm_clock_read() - begin);
+            uartCtx->engine.hybrid.pioBytes += size;
+            uartCtx->engine.hybrid.pioSamples++;
+            hybridSampleI(
+                uartCtx);
+        }
+        cIntEnable(
+            uartCtx,
+            C_INT_TX);                                                          /* Was disabled by the last DMA burst                       */
+    } else {
+        uartCtx->engine.hybrid.dmaBursts++;
+        softDmaTxTransI(
+            uartCtx,
+            size);
+
+        if (FALSE == uartCtx->engine.hybrid.isCalibrated) {                     /* Start of the cycle, dmaCallbackTx() times the end        */
+            uartCtx->engine.hybrid.dmaTime += (uint32_t)(rtdm_clock_read() - begin);
+        }
+    }
+}
+#endif /* (1 == CFG_DMA_MODE) */
+
+#if (2 == CFG_DMA_MODE)
+static void hwDmaAttachI(
+    struct uartCtx *    uartCtx) {
+
+    lldUARTTxDMAThresholdCtrl(
+        uartCtx->cache.io,
+        LLD_DMA_TX_THRESHOLD_REG);
+    lldUARTDMATxThresholdVal(
+        uartCtx->cache.io,
+        DEF_DMA_TX_THRESHOLD);
+    lldUARTDMAStateSet(                                                         /* Receiver stays interrupt driven                          */
+        uartCtx->cache.io,
+        LLD_DMA_MODE_TX);
+}
+
+static void hwDmaDetachI(
+    struct uartCtx *    uartCtx) {
+
+    softDmaDetachI(
+        uartCtx);
+    lldUARTDMAStateSet(
+        uartCtx->cache.io,
+        LLD_DMA_MODE_DISABLED);
+}
+
+static void hwDmaTxKickI(
+    struct uartCtx *    uartCtx) {
+
+    txServiceI(
+        uartCtx);                                                               /* First chunk goes out without waiting for an interrupt    */
+
+    if ((TRUE == uartCtx->engine.isTxOn) &&
+        (FALSE == portDMATxIsRunning(uartCtx->cache.devData))) {
+        cIntEnable(
+            uartCtx,
+            C_INT_TX);                                                          /* FIFO was full, THR interrupt asks for the rest           */
+    }
+}
+
+static void hwDmaTxTransI(
+    struct uartCtx *    uartCtx,
+    size_t              size) {
+
+    size_t              span;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    if (TRUE == portDMATxIsRunning(uartCtx->cache.devData)) {
+        cIntDisable(
+            uartCtx,
+            C_INT_TX);                                                          /* Tail moves only in dmaCallbackTx()                       */
+
+        return;
+    }
+    span  = circStorageOccGet(                                                  /* Up to the buffer end, the rest goes with the next chunk  */
+        &uartCtx->tx.buff.handle);
+    span -= span % DEF_DMA_TX_THRESHOLD;                                        /* Every DMA request moves DEF_DMA_TX_THRESHOLD bytes       */
+
+    if (0U == span) {
+        fifoTxTransI(
+            uartCtx,
+            size);
+        cIntEnable(
+            uartCtx,
+            C_INT_TX);                                                          /* Shorter than one DMA request                             */
+
+        return;
+    }
+    uartCtx->tx.buff.chunk = span;
+    buffDmaGiveI(
+        &uartCtx->tx.buff,
+        circPosTailGet(&uartCtx->tx.buff.handle),
+        span);
+    portDMATxBeginI(
+        uartCtx->cache.devData,
+        uartCtx->tx.buff.phy + circPosTailGet(&uartCtx->tx.buff.handle),
+        span);
+    portDMATxStartI(
+        uartCtx->cache.devData);
+    cIntDisable(
+        uartCtx,
+        C_INT_TX);                                                              /* dmaCallbackTx() signals the completion                   */
+}
+#endif /* (2 == CFG_DMA_MODE) */
+
+static void polledAttachI(
+    struct uartCtx *    uartCtx) {
+
+    cIntSetDisable(
+        uartCtx,
+        C_INT_TX | C_INT_RX | C_INT_RX_TIMEOUT);
+    rtdm_timer_start(
+        &uartCtx->engine.timer,
+        US_TO_NS(CFG_ENGINE_POLL_US),
+        US_TO_NS(CFG_ENGINE_POLL_US),
+        RTDM_TIMERMODE_RELATIVE);
+}
+
+static void polledDetachI(
+    struct uartCtx *    uartCtx) {
+
+    rtdm_timer_stop(
+        &uartCtx->engine.timer);
+}
+
+static void polledRxStartI(
+    struct uartCtx *    uartCtx) {
+
+    uartCtx->engine.isRxIdle = TRUE;                                            /* Silence is reported only after data                      */
+}
+
+static void polledStopI(
+    struct uartCtx *    uartCtx) {
+
+    (void)uartCtx;
+}
+
+static void polledTxKickI(
+    struct uartCtx *    uartCtx) {
+
+    txServiceI(
+        uartCtx);                                                               /* First burst goes out without waiting for the timer       */
+}
+
+static void polledTimerHandler(
+    rtdm_timer_t *      timer) {
+
+    struct uartCtx *    uartCtx;
+    nanosecs_abs_t      entry;
+
+    uartCtx = container_of(timer, struct uartCtx, engine.timer);
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    entry = rtdm_clock_read();
+    CRITICAL_ENTER_ISR(uartCtx, rx);
+
+    if (TRUE == uartCtx->engine.isRxOn) {
+        size_t          transfer;
+
+        transfer = lldFIFORxOccupied(
+            uartCtx->cache.io);
+
+        if (0U != transfer) {
+            uartCtx->rx.status       = UART_STATUS_NORMAL;
+            uartCtx->engine.rxLast   = entry;
+            uartCtx->engine.isRxIdle = FALSE;
+            rxServiceI(
+                uartCtx,
+                transfer,
+                FALSE);
+        } else if ((FALSE == uartCtx->engine.isRxIdle) &&
+                   ((nanosecs_rel_t)(entry - uartCtx->engine.rxLast) >= (4 * uartCtx->frame.rtu.tChar))) {
+            uartCtx->engine.isRxIdle = TRUE;                                    /* Same silence as the RX timeout interrupt                 */
+            rxServiceI(
+                uartCtx,
+                0U,
+                TRUE);
+        }
+    }
+    CRITICAL_EXIT_ISR(uartCtx, rx);
+    CRITICAL_ENTER_ISR(uartCtx, tx);
+
+    if (TRUE == uartCtx->engine.isTxOn) {
+        txServiceI(
+            uartCtx);
+    }
+    CRITICAL_EXIT_ISR(uartCtx, tx);
+
+    if (TRUE == uartCtx->selfTest.isActive) {
+        uartCtx->selfTest.isrTime += (nanosecs_rel_t)(rtdm_clock_read() - entry);
+        uartCtx->selfTest.irqs++;
+    }
+}
+
+static const struct xferEngine * engineFind(
+    uint32_t            id) {
+
+    if (XUART_ENGINE_HYBRID < id) {
+
+        return (NULL);
+    }
+#if (1 == CFG_CRITICAL_INT_ENABLE)
+    if (XUART_ENGINE_POLL == id) {
+
+        return (NULL);                                                          /* Service timer is not covered by IER masking              */
+    }
+#endif
+
+    return (Engines[id]);
+}
+
+static void engineSwitchI(
+    struct uartCtx *    uartCtx,
+    const struct xferEngine * engine) {
+
+    bool_T              isRxOn;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    isRxOn = uartCtx->engine.isRxOn;
+
+    if (TRUE == isRxOn) {
+        buffRxStopI(
+            uartCtx);
+    }
+
+    if (NULL != uartCtx->engine.ops->detachI) {
+        uartCtx->engine.ops->detachI(
+            uartCtx);
+    }
+    LOG_INFO("transfer engine: %s -> %s", uartCtx->engine.ops->name, engine->name);
+    uartCtx->engine.ops = engine;
+
+    if (NULL != engine->attachI) {
+        engine->attachI(
+            uartCtx);
+    }
+
+    if (TRUE == isRxOn) {                                                       /* Persistent receiver keeps running                        */
+        buffRxStartI(
+            uartCtx);
+    }
+}
+
+static int engineSet(
+    struct uartCtx *    uartCtx,
+    uint32_t            id) {
+
+    CRITICAL_DECL(rxLockCtx);
+    CRITICAL_DECL(txLockCtx);
+    const struct xferEngine * engine;
+    int                 retval;
+
+    if (XUART_ENGINE_HYBRID < id) {
+
+        return (-EINVAL);
+    }
+    engine = engineFind(
+        id);
+
+    if (NULL == engine) {
+
+        return (-ENOTSUPP);
+    }
+
+    if (engine == uartCtx->engine.ops) {
+
+        return (0);
+    }
+
+    if ((TRUE == uartCtx->poll.isActive) || (TRUE == uartCtx->selfTest.isActive) ||
+        (XUART_FRAMING_NONE != uartCtx->frame.type)) {                          /* Frame in progress would be split between two engines     */
+
+        return (-EBUSY);
+    }
+    retval = rtdm_sem_timeddown(                                                /* Wait for read() and write() in progress                  */
+        &uartCtx->rx.acc,
+        uartCtx->rx.accTimeout,
+        NULL);
+
+    if (0 != retval) {
+
+        return (-EBUSY);
+    }
+    retval = rtdm_sem_timeddown(
+        &uartCtx->tx.acc,
+        uartCtx->tx.accTimeout,
+        NULL);
+
+    if (0 != retval) {
+        rtdm_sem_up(
+            &uartCtx->rx.acc);
+
+        return (-EBUSY);
+    }
+    CRITICAL_ENTER(uartCtx, tx, txLockCtx);
+    retval = buffTxIdleWaitI(                                                   /* Written data leaves with the old engine                  */
+        uartCtx,
+        &txLockCtx,
+        NULL);
+    CRITICAL_EXIT(uartCtx, tx, txLockCtx);
+
+    if (0 == retval) {
+        CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+        CRITICAL_ENTER(uartCtx, tx, txLockCtx);
+        engineSwitchI(
+            uartCtx,
+            engine);
+        CRITICAL_EXIT(uartCtx, tx, txLockCtx);
+        CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+    } else {
+        retval = -EBUSY;
+    }
+    rtdm_sem_up(
+        &uartCtx->tx.acc);
+    rtdm_sem_up(
+        &uartCtx->rx.acc);
+
+    return (retval);
+}
+
+#if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
+static void dmaCallbackRx(
+    void *              arg) {
+
+    (void)arg;
+}
+
+static void dmaCallbackTx(
+    void *              arg) {
+
+    struct uartCtx *    uartCtx;
+    nanosecs_abs_t      entry;
+
+    LOG_DBG("DMA Tx callback");
+    uartCtx = (struct uartCtx *)arg;
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    LOG_DBG("circ size %d", circSizeGet(&uartCtx->tx.buff.handle));
+    LOG_DBG("circ free %d", circFreeGet(&uartCtx->tx.buff.handle));
+    entry = rtdm_clock_read();
+    CRITICAL_ENTER_ISR(uartCtx, tx);
+
+    if (0U == uartCtx->tx.buff.chunk) {                                         /* Completion of a chunk softDmaDetachI() already took back */
+        CRITICAL_EXIT_ISR(uartCtx, tx);
+
+        return;
+    }
+    buffDmaTakeI(
+        &uartCtx->tx.buff,
+        circPosTailGet(&uartCtx->tx.buff.handle),
+        uartCtx->tx.buff.chunk);
+    circPosTailSet(
+        &uartCtx->tx.buff.handle,
+        uartCtx->tx.buff.chunk);
+    uartCtx->tx.buff.chunk = 0;
+#if (1 == CFG_DMA_MODE)
+    if ((&HybridEngine == uartCtx->engine.ops) && (FALSE == uartCtx->engine.hybrid.isCalibrated)) {
+        uartCtx->engine.hybrid.dmaTime += (uint32_t)(rtdm_clock_read() - entry);
+        uartCtx->engine.hybrid.dmaSamples++;
+        hybridSampleI(
+            uartCtx);
+    }
+#else
+    (void)entry;
+#endif
+    txServiceI(
+        uartCtx);                                                               /* Wake the writer, start the next chunk or stop            */
+
+    if ((TRUE == uartCtx->engine.isTxOn) &&
+        (FALSE == portDMATxIsRunning(uartCtx->cache.devData))) {
+        cIntEnable(
+            uartCtx,
+            C_INT_TX);                                                          /* FIFO was full, THR interrupt asks for the rest           */
+    }
+    CRITICAL_EXIT_ISR(uartCtx, tx);
+}
+#endif /* (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE) */
+
+/* Receive core in IRQ mode                                                   */
+static ssize_t xferRd(
+    struct uartCtx *    uartCtx,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   dst,
+    size_t              bytes) {
+
+    CRITICAL_DECL(lockCtx);
+    rtdm_toseq_t        tmSeq;
+    size_t              read;
+    int                 retval;
+
+    if (TRUE == uartCtx->tap.isTap) {
+
+        if (0U != uartCtx->tap.channel) {
+
+            return (xferRdChannel(uartCtx, usrInfo, dst, bytes));
+        }
+
+        return (xferRdTap(uartCtx, usrInfo, dst, bytes));
+    }
+
+    if (TRUE == uartCtx->poll.isActive) {
+        uartCtx->rx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+
+    if (XUART_FRAMING_NONE != uartCtx->frame.type) {
+
+        return (xferRdFrame(uartCtx, usrInfo, dst, bytes));
+    }
+    retval = rtdm_sem_timeddown(
+        &uartCtx->rx.acc,
+        uartCtx->rx.accTimeout,
+        NULL);
+
+    if (0 != retval) {
+        uartCtx->rx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+    uartCtx->rx.user = usrInfo;
+    rtdm_toseq_init(
+        &tmSeq,
+        uartCtx->rx.oprTimeout);
+    read = 0U;
+    crcInit(
+        &uartCtx->rx.crc,
+        uartCtx->rx.crc.type);
+
+    if (FALSE == uartCtx->rx.isPersistent) {
+        buffRxFlush(
+            uartCtx);
+        lldFIFORxFlush(
+            uartCtx->cache.io);
+    }
+    CRITICAL_ENTER(uartCtx, rx, lockCtx);
+    buffRxStartI(
+        uartCtx);
+
+    if (TRUE == uartCtx->wake.isEnabled) {
+        ssize_t         transfer;
+
+        transfer = buffRxUntilI(
+            uartCtx,
+            &lockCtx,
+            dst,
+            bytes,
+            &uartCtx->wake.cond,
+            &tmSeq);
+
+        if (0 <= transfer) {
+            read = (size_t)transfer;
+        } else if (-ETIMEDOUT != transfer) {
+            retval = (int)transfer;
+        }
+    } else {
+        bool_T          isTimeout;
+        bool_T          isDone;
+
+        isTimeout = FALSE;
+        isDone    = FALSE;
+
+        while ((0U != bytes) && (FALSE == isDone)) {
+            ssize_t     transfer;
+
+            transfer = buffRxCopyI(                                             /* Persistent receiver may already hold the data            */
+                uartCtx,
+                &lockCtx,
+                dst,
+                bytes);
+
+            if (0 > transfer) {
+                uartCtx->rx.status = UART_STATUS_FAULT_USAGE;
+                retval = (int)transfer;
+
+                break;
+            }
+            bytes -= (size_t)transfer;
+            read  += (size_t)transfer;
+
+            if (TRUE == isTimeout) {
+                isDone = TRUE;                                                  /* Return what has been read so far                         */
+            } else if (0U != bytes) {
+                buffRxPendI(
+                    uartCtx,
+                    bytes);
+                CRITICAL_EXIT(uartCtx, rx, lockCtx);
+
+                if (0 > buffRxWait(uartCtx, &tmSeq)) {
+                    isTimeout = TRUE;                                           /* Copy the bytes which did arrive                          */
+                }
+                CRITICAL_ENTER(uartCtx, rx, lockCtx);
+            }
+        }
+    }
+
+    if (FALSE == uartCtx->rx.isPersistent) {
+        buffRxStopI(
+            uartCtx);
+
+        if (0 != circOccGet(&uartCtx->rx.buff.handle)) {
+            uartCtx->rx.status = UART_STATUS_SOFT_OVERFLOW;
+        }
+    } else {
+        uartCtx->rx.buff.pend = 0U;                                             /* Receiver keeps running, see buffRxPersistI()             */
+    }
+    rxStatusTakeI(
+        uartCtx);
+    uartCtx->rx.crcLast = crcValueGet(
+        &uartCtx->rx.crc);
+    CRITICAL_EXIT(uartCtx, rx, lockCtx);
+    rtdm_sem_up(
+        &uartCtx->rx.acc);
+
+    if (0 == retval) {
+
+        return ((ssize_t)read);
+    }
+
+    return (retval);
+}
+
+/* Transmit core in IRQ mode                                                  */
+static ssize_t xferWr(
+    struct uartCtx *    uartCtx,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   src,
+    size_t              bytes) {
+
+    CRITICAL_DECL(lockCtx);
+    rtdm_toseq_t        tmSeq;
+    size_t              written;
+    int                 retval;
+    ssize_t             transfer;
+
+    if (TRUE == uartCtx->tap.isTap) {
+        struct uartCtx * owner;
+
+        owner = uartCtx->tap.owner;
+
+        if (0U == uartCtx->tap.channel) {
+
+            return (-EPERM);                                                    /* Plain taps are read only                                 */
+        }
+
+        if (NULL == owner) {
+
+            return (-EBADF);
+        }
+
+        if ((FALSE == owner->frame.mux.isEnabled) || (TRUE == owner->poll.isActive)) {
+            uartCtx->tx.status = UART_STATUS_BUSY;
+
+            return (-EBUSY);
+        }
+
+        return (xferWrFrame(owner, usrInfo, src, bytes, (int32_t)uartCtx->tap.channel));
+    }
+
+    if (TRUE == uartCtx->poll.isActive) {
+        uartCtx->tx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+
+    if (XUART_FRAMING_NONE != uartCtx->frame.type) {
+
+        return (xferWrFrame(uartCtx, usrInfo, src, bytes, (TRUE == uartCtx->frame.mux.isEnabled) ? 0 : -1));
+    }
+    retval = rtdm_sem_timeddown(
+        &uartCtx->tx.acc,
+        uartCtx->tx.accTimeout,
+        NULL);
+
+    if (0 != retval) {
+        uartCtx->tx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+    uartCtx->tx.user = usrInfo;
+    rtdm_toseq_init(
+        &tmSeq,
+        uartCtx->tx.oprTimeout);
+    crcInit(
+        &uartCtx->tx.crc,
+        uartCtx->tx.crc.type);
+
+    if (TRUE == circIsEmpty(&uartCtx->tx.buff.handle)) {
+        buffTxFlushI(
+            uartCtx);
+    }
+    CRITICAL_ENTER(uartCtx, tx, lockCtx);
+    transfer = buffTxCopyI(
+        uartCtx,
+        &lockCtx,
+        src,
+        bytes);
+
+    if (0 > transfer) {
+        uartCtx->tx.status = UART_STATUS_FAULT_USAGE;
+        buffTxStopI(
+            uartCtx);
+        CRITICAL_EXIT(uartCtx, tx, lockCtx);
+        rtdm_sem_up(
+            &uartCtx->tx.acc);
+
+        return (transfer);
+    }
+    buffTxStartI(
+        uartCtx);
+    bytes   -= (size_t)transfer;
+    written  = (size_t)transfer;
+
+    while (0 < bytes) {
+        buffTxPendI(
+            uartCtx,
+            bytes);
+        CRITICAL_EXIT(uartCtx, tx, lockCtx);
+        retval = buffTxWait(
+            uartCtx,
+            &tmSeq);
+        CRITICAL_ENTER(uartCtx, tx, lockCtx);
+
+        if (0 > retval) {
+
+            break;
+        }
+        transfer = buffTxCopyI(
+            uartCtx,
+            &lockCtx,
+            src,
+            bytes);
+
+        if (0 > transfer) {
+            uartCtx->tx.status = UART_STATUS_FAULT_USAGE;
+            retval = (int)transfer;
+
+            break;
+        }
+        bytes   -= (size_t)transfer;
+        written += (size_t)transfer;
+    }
+
+    if ((0 == retval) && (TRUE == uartCtx->tx.isCrcAppend)) {
+        retval = buffTxCrcAppendI(
+            uartCtx,
+            &lockCtx,
+            &tmSeq);
+    }
+    uartCtx->tx.crcLast = crcValueGet(
+        &uartCtx->tx.crc);
+    CRITICAL_EXIT(uartCtx, tx, lockCtx);
+    rtdm_sem_up(
+        &uartCtx->tx.acc);
+
+    if (0 == retval) {
+
+        return ((ssize_t)written);
+    }
+
+    return (retval);
+}
+
+/* Transaction core in IRQ mode                                               */
+static ssize_t xferTransact(
+    struct uartCtx *    uartCtx,
+    rtdm_user_info_t *  usrInfo,
+    const struct xUartTransact * req) {
+
+    CRITICAL_DECL(lockCtx);
+    rtdm_toseq_t        tmSeq;
+    struct ioCursor     src;
+    struct ioCursor     dst;
+    struct iovec        srcIov;
+    struct iovec        dstIov;
+    struct rxWake       wake;
+    ssize_t             retval;
+
+    if (TRUE == uartCtx->poll.isActive) {
+        uartCtx->rx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+
+    if ((0U == req->rxSize) || (0xFF < req->term) || (-1 > req->term)) {
+
+        return (-EINVAL);
+    }
+
+    if (NULL != usrInfo) {
+
+        if ((0 == rtdm_read_user_ok(usrInfo, req->tx, req->txSize)) ||
+            (0 == rtdm_rw_user_ok(usrInfo, req->rx, req->rxSize))) {
+            uartCtx->rx.status = UART_STATUS_FAULT_USAGE;
+
+            return (-EFAULT);
+        }
+    }
+    srcIov.iov_base = (void *)req->tx;
+    srcIov.iov_len  = req->txSize;
+    dstIov.iov_base = req->rx;
+    dstIov.iov_len  = req->rxSize;
+    ioCursorInit(
+        &src,
+        &srcIov,
+        1U);
+    ioCursorInit(
+        &dst,
+        &dstIov,
+        1U);
+    rxWakeInit(
+        &wake);
+
+    if (0 <= req->term) {
+        rxWakeDelimAdd(
+            &wake,
+            (uint8_t)req->term);
+    }
+    retval = rtdm_sem_timeddown(
+        &uartCtx->rx.acc,
+        uartCtx->rx.accTimeout,
+        NULL);
+
+    if (0 != retval) {
+        uartCtx->rx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+    uartCtx->rx.user = usrInfo;
+    crcInit(
+        &uartCtx->rx.crc,
+        uartCtx->rx.crc.type);
+
+    /*
+     * Arm the receiver before the request is queued, so a fast responder can
+     * not race with the flush of stale data.
+     */
+    CRITICAL_ENTER(uartCtx, rx, lockCtx);
+    buffRxFlush(
+        uartCtx);
+    lldFIFORxFlush(
+        uartCtx->cache.io);
+    buffRxStartI(
+        uartCtx);
+    CRITICAL_EXIT(uartCtx, rx, lockCtx);
+    retval = xferWr(
+        uartCtx,
+        usrInfo,
+        &src,
+        req->txSize);
+
+    if (0 <= retval) {
+        rtdm_toseq_init(
+            &tmSeq,
+            (0U != req->timeout) ? US_TO_NS((nanosecs_rel_t)req->timeout) : uartCtx->rx.oprTimeout);
+        CRITICAL_ENTER(uartCtx, rx, lockCtx);
+
+        if (XUART_FRAMING_NONE != uartCtx->frame.type) {
+            retval = buffRxFrameGetI(
+                uartCtx,
+                &lockCtx,
+                &dst,
+                req->rxSize,
+                &tmSeq);
+        } else {
+            retval = buffRxUntilI(
+                uartCtx,
+                &lockCtx,
+                &dst,
+                req->rxSize,
+                &wake,
+                &tmSeq);
+        }
+        CRITICAL_EXIT(uartCtx, rx, lockCtx);
+    }
+    CRITICAL_ENTER(uartCtx, rx, lockCtx);
+
+    if (FALSE == uartCtx->rx.isPersistent) {
+        buffRxStopI(
+            uartCtx);
+    }
+    uartCtx->rx.crcLast = crcValueGet(
+        &uartCtx->rx.crc);
+    CRITICAL_EXIT(uartCtx, rx, lockCtx);
+    rtdm_sem_up(
+        &uartCtx->rx.acc);
+
+    return (retval);
+}
+
+static void selfTestFill(
+    uint8_t *           dst,
+    size_t              size,
+    size_t              offset,
+    uint32_t            pattern,
+    uint8_t             mask) {
+
+    size_t              cnt;
+
+    for (cnt = 0U; cnt < size; cnt++) {
+        uint32_t        item;
+
+        switch (pattern) {
+            case XUART_SELFTEST_ZERO : {
+                item = 0x00U;
+                break;
+            }
+            case XUART_SELFTEST_ONE : {
+                item = 0xffU;
+                break;
+            }
+            case XUART_SELFTEST_RANDOM : {
+                item  = (uint32_t)(offset + cnt) * 2654435761U;                 /* Multiplicative hash, reproducible from the offset alone  */
+                item ^= item >> 16;
+                item >>= 8;
+                break;
+            }
+            default : {
+                item = (uint32_t)(offset + cnt);
+                break;
+            }
+        }
+        dst[cnt] = (uint8_t)item & mask;
+    }
+}
+
+/* Self test core in IRQ mode                                                 */
+static int xferSelfTest(
+    struct uartCtx *    uartCtx,
+    struct xUartSelfTest * test) {
+
+    CRITICAL_DECL(lockCtx);
+    CRITICAL_DECL(txLockCtx);
+    rtdm_toseq_t        tmSeq;
+    struct ioCursor     cur;
+    struct iovec        iov;
+    struct rxWake       wake;
+    uint8_t             txBuff[CFG_SELFTEST_CHUNK];
+    uint8_t             rxBuff[CFG_SELFTEST_CHUNK];
+    nanosecs_abs_t      start;
+    nanosecs_rel_t      duration;
+    size_t              size;
+    size_t              written;
+    size_t              read;
+    size_t              chunk;
+    size_t              cnt;
+    uint32_t            errors;
+    uint8_t             mask;
+    ssize_t             retval;
+
+    if ((TRUE == uartCtx->poll.isActive) || (XUART_FRAMING_NONE != uartCtx->frame.type)) {
+        uartCtx->rx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+
+    if (XUART_SELFTEST_RANDOM < test->pattern) {
+
+        return (-EINVAL);
+    }
+    size = (0U != test->size) ? test->size : CFG_SELFTEST_SIZE;
+    mask = (XUART_DATA_5 == uartCtx->proto.dataBits) ? 0x1fU : 0xffU;
+    rxWakeInit(
+        &wake);
+    retval = rtdm_sem_timeddown(
+        &uartCtx->rx.acc,
+        uartCtx->rx.accTimeout,
+        NULL);
+
+    if (0 != retval) {
+        uartCtx->rx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+    uartCtx->rx.user = NULL;                                                    /* Chunk buffers live in kernel space                       */
+    CRITICAL_ENTER(uartCtx, rx, lockCtx);
+    buffRxFlush(
+        uartCtx);
+    lldFIFORxFlush(
+        uartCtx->cache.io);
+    uartCtx->selfTest.isrTime  = 0;
+    uartCtx->selfTest.irqs     = 0U;
+    uartCtx->selfTest.isActive = TRUE;
+    lldLoopbackSet(
+        uartCtx->cache.io,
+        LLD_ENABLE);
+    buffRxStartI(
+        uartCtx);
+    CRITICAL_EXIT(uartCtx, rx, lockCtx);
+    start   = rtdm_clock_read();
+    written = 0U;
+    read    = 0U;
+    errors  = 0U;
+    retval  = 0;
+
+    while (read < size) {
+
+        /*
+         * Keep the transmitter ahead of the reader, but never by more than
+         * half of the RX buffer so the receiver can not overflow.
+         */
+        while ((written < size) && ((written - read) < (CFG_DRV_BUFF_SIZE / 2U))) {
+            chunk = min(size - written, (size_t)CFG_SELFTEST_CHUNK);
+            selfTestFill(
+                txBuff,
+                chunk,
+                written,
+                test->pattern,
+                mask);
+            iov.iov_base = txBuff;
+            iov.iov_len  = chunk;
+            ioCursorInit(
+                &cur,
+                &iov,
+                1U);
+            retval = xferWr(
+                uartCtx,
+                NULL,
+                &cur,
+                chunk);
+
+            if (0 > retval) {
+
+                break;
+            }
+            written += chunk;
+        }
+
+        if (0 > retval) {
+
+            break;
+        }
+        chunk = min(size - read, (size_t)CFG_SELFTEST_CHUNK);
+        iov.iov_base = rxBuff;
+        iov.iov_len  = chunk;
+        ioCursorInit(
+            &cur,
+            &iov,
+            1U);
+        rtdm_toseq_init(
+            &tmSeq,
+            uartCtx->rx.oprTimeout);
+        CRITICAL_ENTER(uartCtx, rx, lockCtx);
+        retval = buffRxUntilI(
+            uartCtx,
+            &lockCtx,
+            &cur,
+            chunk,
+            &wake,
+            &tmSeq);
+        CRITICAL_EXIT(uartCtx, rx, lockCtx);
+
+        if (0 > retval) {
+
+            if (-ETIMEDOUT == retval) {
+                retval = 0;                                                     /* Lost bytes are reported as errors                        */
+            }
+
+            break;
+        }
+        selfTestFill(
+            txBuff,
+            (size_t)retval,
+            read,
+            test->pattern,
+            mask);
+
+        for (cnt = 0U; cnt < (size_t)retval; cnt++) {
+
+            if (txBuff[cnt] != rxBuff[cnt]) {
+                errors++;
+            }
+        }
+        read += (size_t)retval;
+    }
+    duration = (nanosecs_rel_t)(rtdm_clock_read() - start);
+    CRITICAL_ENTER(uartCtx, rx, lockCtx);
+    CRITICAL_ENTER(uartCtx, tx, txLockCtx);
+    buffTxFlushI(                                                               /* Nothing may reach the line after loopback is disabled    */
+        uartCtx);
+    lldFIFOTxFlush(
+        uartCtx->cache.io);
+    CRITICAL_EXIT(uartCtx, tx, txLockCtx);
+    lldLoopbackSet(
+        uartCtx->cache.io,
+        (TRUE == uartCtx->isLoopback) ? LLD_ENABLE : LLD_DISABLE);
+    uartCtx->selfTest.isActive = FALSE;
+
+    if (FALSE == uartCtx->rx.isPersistent) {
+        buffRxStopI(
+            uartCtx);
+    }
+    buffRxFlush(
+        uartCtx);
+    lldFIFORxFlush(
+        uartCtx->cache.io);
+    CRITICAL_EXIT(uartCtx, rx, lockCtx);
+    rtdm_sem_up(
+        &uartCtx->rx.acc);
+
+    if (0 > retval) {
+
+        return ((int)retval);
+    }
+    test->size        = (uint32_t)size;
+    test->duration    = (uint64_t)duration;
+    test->isrTime     = (uint64_t)uartCtx->selfTest.isrTime;
+    test->irqs        = uartCtx->selfTest.irqs;
+    test->errors      = errors + (uint32_t)(size - read);
+    test->bytesPerSec = (0 < duration) ? (uint32_t)(((uint64_t)read * NS_PER_S) / (uint64_t)duration) : 0U;
+    test->irqsPerKiB  = (0U != read) ? (uint32_t)(((uint64_t)test->irqs * 1024U) / read) : 0U;
+
+    return (0);
+}
+
+/* Frame receive core in IRQ mode                                             */
+static ssize_t xferRdFrame(
+    struct uartCtx *    uartCtx,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   dst,
+    size_t              bytes) {
+
+    CRITICAL_DECL(lockCtx);
+    rtdm_toseq_t        tmSeq;
+    ssize_t             retval;
+
+    retval = rtdm_sem_timeddown(
+        &uartCtx->rx.acc,
+        uartCtx->rx.accTimeout,
+        NULL);
+
+    if (0 != retval) {
+        uartCtx->rx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+    uartCtx->rx.user = usrInfo;
+    rtdm_toseq_init(
+        &tmSeq,
+        uartCtx->rx.oprTimeout);
+    crcInit(
+        &uartCtx->rx.crc,
+        uartCtx->rx.crc.type);
+    CRITICAL_ENTER(uartCtx, rx, lockCtx);
+    buffRxStartI(
+        uartCtx);                                                               /* Re-enable receiver after an overflow                     */
+    retval = buffRxFrameGetI(
+        uartCtx,
+        &lockCtx,
+        dst,
+        bytes,
+        &tmSeq);
+    rxStatusTakeI(
+        uartCtx);
+    uartCtx->rx.crcLast = crcValueGet(
+        &uartCtx->rx.crc);
+    CRITICAL_EXIT(uartCtx, rx, lockCtx);
+    rtdm_sem_up(
+        &uartCtx->rx.acc);
+
+    return (retval);
+}
+
+/* Frame transmit core in IRQ mode                                            */
+static ssize_t xferWrFrame(
+    struct uartCtx *    uartCtx,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   src,
+    size_t              bytes,
+    int32_t             channel) {
+
+    CRITICAL_DECL(lockCtx);
+    rtdm_toseq_t        tmSeq;
+    uint8_t             chunk[DEF_FRAME_TX_CHUNK];
+    size_t              written;
+    bool_T              isBegin;
+    int                 retval;
+
+    retval = rtdm_sem_timeddown(
+        &uartCtx->tx.acc,
+        uartCtx->tx.accTimeout,
+        NULL);
+
+    if (0 != retval) {
+        uartCtx->tx.status = UART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+    uartCtx->tx.user = usrInfo;
+    rtdm_toseq_init(
+        &tmSeq,
+        uartCtx->tx.oprTimeout);
+    crcInit(
+        &uartCtx->tx.crc,
+        uartCtx->tx.crc.type);
+    written = 0U;
+    isBegin = TRUE;
+    CRITICAL_ENTER(uartCtx, tx, lockCtx);
+
+    do {
+        size_t          transfer;
+        size_t          bound;
+
+        transfer = min(bytes, sizeof(chunk));
+        CRITICAL_EXIT(uartCtx, tx, lockCtx);
+        retval = ioCursorCopyFrom(
+            src,
+            uartCtx->tx.user,
+            chunk,
+            transfer);
+        CRITICAL_ENTER(uartCtx, tx, lockCtx);
+
+        if (0 != retval) {
+            uartCtx->tx.status = UART_STATUS_FAULT_USAGE;
+
+            break;
+        }
+        crcUpdate(
+            &uartCtx->tx.crc,
+            chunk,
+            transfer);
+        bound = frameEncBound(
+            &uartCtx->frame.enc,
+            transfer + ((TRUE == uartCtx->tx.isCrcAppend) ? crcSizeGet(&uartCtx->tx.crc) : 0U) +
+            (((TRUE == isBegin) && (0 <= channel)) ? 1U : 0U));
+        bound += FRAME_ABORT_SIZE;                                              /* Room to abort the frame when a later chunk fails         */
+
+        while (bound > circFreeGet(&uartCtx->tx.buff.handle)) {
+            buffTxPendI(
+                uartCtx,
+                bound);
+            CRITICAL_EXIT(uartCtx, tx, lockCtx);
+            retval = buffTxWait(
+                uartCtx,
+                &tmSeq);
+            CRITICAL_ENTER(uartCtx, tx, lockCtx);
+
+            if (0 > retval) {
+
+                break;
+            }
+        }
+
+        if (0 > retval) {
+
+            break;
+        }
+
+        if (TRUE == isBegin) {
+
+            if (XUART_FRAMING_RTU == uartCtx->frame.type) {
+                retval = buffTxIdleWaitI(
+                    uartCtx,
+                    &lockCtx,
+                    &tmSeq);
+
+                if (0 > retval) {
+
+                    break;
+                }
+            }
+            isBegin = FALSE;
+            frameEncBegin(
+                &uartCtx->frame.enc,
+                &uartCtx->tx.buff.handle);
+
+            if (0 <= channel) {
+                uint8_t id;
+
+                id = (uint8_t)channel;
+                frameEncPut(
+                    &uartCtx->frame.enc,
+                    &uartCtx->tx.buff.handle,
+                    &id,
+                    1U);
+            }
+        }
+        frameEncPut(
+            &uartCtx->frame.enc,
+            &uartCtx->tx.buff.handle,
+            chunk,
+            transfer);
+        buffTxStartI(
+            uartCtx);
+        bytes   -= transfer;
+        written += transfer;
+    } while (0U != bytes);
+
+    if (FALSE == isBegin) {
+
+        if (0 != retval) {
+            frameEncAbort(                                                      /* Partial payload must not look like a complete frame      */
+                &uartCtx->frame.enc,
+                &uartCtx->tx.buff.handle);
+        } else {
+
+            if (TRUE == uartCtx->tx.isCrcAppend) {
+                size_t  size;
+
+                size = crcSerialize(
+                    &uartCtx->tx.crc,
+                    chunk);
+                frameEncPut(
+                    &uartCtx->frame.enc,
+                    &uartCtx->tx.buff.handle,
+                    chunk,
+                    size);                                                      /* CRC is sent inside the frame                             */
+            }
+            frameEncEnd(
+                &uartCtx->frame.enc,
+                &uartCtx->tx.buff.handle);                                      /* Space was reserved by frameEncBound()                    */
+        }
+        buffTxStartI(
+            uartCtx);
+    }
+    txRdyUpdateI(
+        uartCtx);
+    uartCtx->tx.crcLast = crcValueGet(
+        &uartCtx->tx.crc);
+    CRITICAL_EXIT(uartCtx, tx, lockCtx);
+    rtdm_sem_up(
+        &uartCtx->tx.acc);
 
     if (0 == retval) {
 
-        return (written);
-    }
+        return ((ssize_t)written);
+    }
+
+    return (retval);
+}
+
+/* Handler function in IRQ mode                                               */
+static int handleIrq(
+    rtdm_irq_t *        arg) {
+
+    struct uartCtx *    uartCtx;
+    volatile uint8_t *  io;
+    int                 retval;
+    enum lldIntNum      intNum;
+    nanosecs_abs_t      entry;
+
+    uartCtx = rtdm_irq_get_arg(arg, struct uartCtx);
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, UART_CTX_SIGNATURE == uartCtx->signature);
+
+    if (FALSE == uartCtx->isOpen) {
+
+        return (RTDM_IRQ_NONE);                                                 /* IER is masked while the device is closed                 */
+    }
+    entry = 0U;
+
+    if (TRUE == uartCtx->selfTest.isActive) {
+        entry = rtdm_clock_read();
+    }
+    LOG_DBG("UART IRQ handler");
+    io = uartCtx->cache.io;
+    retval = RTDM_IRQ_HANDLED;
+    uartCtx->rx.status = UART_STATUS_NORMAL;
+
+    while (LLD_INT_NONE != (intNum = lldIntGet(io))) {                                          /* Loop until there are interrupts to process               */
+
+        /*-- Receive interrupt -----------------------------------------------*/
+        if ((LLD_INT_RX == intNum) || (LLD_INT_RX_TIMEOUT == intNum)) {
+            CRITICAL_ENTER_ISR(uartCtx, rx);
+            rxServiceI(
+                uartCtx,
+                lldFIFORxOccupied(io),
+                (LLD_INT_RX_TIMEOUT == intNum) ? TRUE : FALSE);
+            CRITICAL_EXIT_ISR(uartCtx, rx);
+
+        /*-- Transmit interrupt ----------------------------------------------*/
+        } else if (LLD_INT_TX == intNum) {
+            CRITICAL_ENTER_ISR(uartCtx, tx);
+            txServiceI(
+                uartCtx);
+            CRITICAL_EXIT_ISR(uartCtx, tx);
+
+        /*-- Other interrupts ------------------------------------------------*/
+        } else {
+            /*
+             * We don't know what happened here, so we disable all interrupts
+             * regardless the cache and notify all listeners. This is kind of a
+             * bug.
+             */
+            retval = RTDM_IRQ_NONE;
+            uartCtx->rx.status = UART_STATUS_UNHANDLED_INTERRUPT;
+            uartCtx->tx.status = UART_STATUS_UNHANDLED_INTERRUPT;
+            lldRegWr(
+                uartCtx->cache.io,
+                wIER,
+                0);
+
+            break;
+        }
+    }
+
+    if (TRUE == uartCtx->selfTest.isActive) {
+        uartCtx->selfTest.isrTime += (nanosecs_rel_t)(rtdm_clock_read() - entry);
+        uartCtx->selfTest.irqs++;
+    }
+
+    return (retval);
+}
+
+#if (1 == CFG_DMA_MODE) || (2 == CFG_DMA_MODE)
+static void buffDmaGiveI(
+    struct buff *       buff,
+    size_t              pos,
+    size_t              size) {
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, NULL != buff->phy);
+
+    dma_sync_single_for_device(
+        NULL,
+        (dma_addr_t)(buff->phy + pos),
+        size,
+        buff->dir);
+}
+
+static void buffDmaTakeI(
+    struct buff *       buff,
+    size_t              pos,
+    size_t              size) {
+
+    ES_DBG_API_REQUIRE(ES_DBG_OBJECT_NOT_VALID, NULL != buff->phy);
+
+    dma_sync_single_for_cpu(
+        NULL,
+        (dma_addr_t)(buff->phy + pos),
+        size,
+        buff->dir);
+}
+#endif
+
+static ssize_t handleRd(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    void *              buff,
+    size_t              bytes) {
+
+    struct uartCtx *    uartCtx;
+    struct ioCursor     dst;
+    struct iovec        iov;
+
+    uartCtx = uartCtxFromDevCtx(devCtx);
+
+    if (NULL != usrInfo) {
+
+        if (0 == rtdm_rw_user_ok(usrInfo, buff, bytes)) {
+            uartCtx->rx.status = UART_STATUS_FAULT_USAGE;
+
+            return (-EFAULT);
+        }
+    }
+    iov.iov_base = buff;
+    iov.iov_len  = bytes;
+    ioCursorInit(
+        &dst,
+        &iov,
+        1U);
+
+    return (xferRd(uartCtx, usrInfo, &dst, bytes));
+}
+
+static ssize_t handleWr(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    const void *        buff,
+    size_t              bytes) {
+
+    struct uartCtx *    uartCtx;
+    struct ioCursor     src;
+    struct iovec        iov;
+
+    uartCtx = uartCtxFromDevCtx(devCtx);
+
+    if (NULL != usrInfo) {
+
+        if (0 == rtdm_read_user_ok(usrInfo, buff, bytes)) {
+            uartCtx->tx.status = UART_STATUS_FAULT_USAGE;
+
+            return (-EFAULT);
+        }
+    }
+    iov.iov_base = (void *)buff;
+    iov.iov_len  = bytes;
+    ioCursorInit(
+        &src,
+        &iov,
+        1U);
+
+    return (xferWr(uartCtx, usrInfo, &src, bytes));
+}
+
+static ssize_t handleRecvMsg(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    struct msghdr *     msg,
+    int                 flags) {
+
+    struct uartCtx *    uartCtx;
+    struct ioCursor     dst;
+    struct iovec        iov[CFG_DRV_IOV_MAX];
+    ssize_t             retval;
+
+    (void)flags;
+    uartCtx = uartCtxFromDevCtx(devCtx);
+    retval  = ioCursorFromMsg(
+        &dst,
+        iov,
+        usrInfo,
+        msg,
+        IO_DIR_RX);
+
+    if (0 > retval) {
+        uartCtx->rx.status = UART_STATUS_FAULT_USAGE;
+
+        return (retval);
+    }
+    retval = xferRd(
+        uartCtx,
+        usrInfo,
+        &dst,
+        (size_t)retval);
+
+    if (0 > retval) {
+
+        return (retval);
+    }
+
+    if ((NULL != msg->msg_control) && (sizeof(struct xUartRxInfo) <= msg->msg_controllen)) {
+        struct xUartRxInfo  info;
+        int                 status;
+
+        info.timestamp = uartCtx->rx.stamp;
+        info.status    = uartCtx->rx.statusLast;
+        info.size      = (uint32_t)retval;
+        info.crc       = uartCtx->rx.crcLast;
+
+        if (NULL != usrInfo) {
+            status = rtdm_safe_copy_to_user(
+                usrInfo,
+                msg->msg_control,
+                &info,
+                sizeof(info));
+
+            if (0 != status) {
+
+                return (status);
+            }
+        } else {
+            memcpy(
+                msg->msg_control,
+                &info,
+                sizeof(info));
+        }
+        msg->msg_controllen = sizeof(info);
+    } else {
+        msg->msg_controllen = 0U;
+    }
+    msg->msg_flags = 0;
+
+    return (retval);
+}
+
+static ssize_t handleSendMsg(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    const struct msghdr * msg,
+    int                 flags) {
+
+    struct uartCtx *    uartCtx;
+    struct ioCursor     src;
+    struct iovec        iov[CFG_DRV_IOV_MAX];
+    ssize_t             retval;
+
+    (void)flags;
+    uartCtx = uartCtxFromDevCtx(devCtx);
+    retval  = ioCursorFromMsg(
+        &src,
+        iov,
+        usrInfo,
+        msg,
+        IO_DIR_TX);
+
+    if (0 > retval) {
+        uartCtx->tx.status = UART_STATUS_FAULT_USAGE;
+
+        return (retval);
+    }
+
+    return (xferWr(uartCtx, usrInfo, &src, (size_t)retval));
+}
+
+static int handleOpen(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    int                 oflag) {
+
+    struct uartCtx *    uartCtx;
+    struct uartCtx *    owner;
+    rtdm_lockctx_t      tapLockCtx;
+
+    uartCtx = NULL;
+    rtdm_lock_get_irqsave(&TapLock, tapLockCtx);
+    owner = UartOwner;
+
+    if (FALSE == UartCtx.isOpen) {
+        uartCtx = &UartCtx;
+        uartCtx->isOpen = TRUE;
+    } else if (NULL != owner) {                                                 /* Hardware is taken, open a passive tap instead            */
+#if (0 == CFG_CRITICAL_INT_ENABLE)
+        uartCtx = tapClaimI();
+#endif
+    }
+    rtdm_lock_put_irqrestore(&TapLock, tapLockCtx);
+
+    if (NULL == uartCtx) {
+
+        return (-EBUSY);
+    }
+    *(struct uartCtx **)rtdm_context_to_private(devCtx) = uartCtx;
+
+#if (0 == CFG_CRITICAL_INT_ENABLE)
+    if (TRUE == uartCtx->tap.isTap) {
+
+        return (tapOpen(uartCtx, owner));
+    }
+#endif
+    uartCtxOpen(
+        uartCtx);
+    lldFIFORxFlush(
+        uartCtx->cache.io);
+    lldFIFOTxFlush(
+        uartCtx->cache.io);
+    rtdm_lock_get_irqsave(&TapLock, tapLockCtx);
+    UartOwner = uartCtx;                                                        /* Taps may attach from now on                              */
+    rtdm_lock_put_irqrestore(&TapLock, tapLockCtx);
+
+    return (0);
+}
+
+static int handleClose(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo) {
+
+    struct uartCtx *    uartCtx;
+
+    uartCtx = uartCtxFromDevCtx(devCtx);
+
+    if ((NULL == uartCtx) || (FALSE == uartCtx->isOpen)) {                      /* Driver must be ready to accept close callbacks for       */
+                                                                                /* already closed devices.                                  */
+        return (0);
+    }
+    if (TRUE == uartCtx->tap.isTap) {
+        tapClose(
+            uartCtx);
+
+        return (0);
+    }
+
+    if (TRUE == uartCtx->poll.isActive) {
+        pollStop(                                                               /* Give back read() and write(), wake XUART_POLL_WAIT       */
+            uartCtx);
+    }
+    {
+        CRITICAL_DECL(rxLockCtx);
+        CRITICAL_DECL(txLockCtx);
+        rtdm_lockctx_t  tapLockCtx;
+
+        /*
+         * TODO: Here should be some sync mechanism to wait for driver shutdown
+         */
+        rtdm_lock_get_irqsave(&TapLock, tapLockCtx);
+        UartOwner = NULL;
+        CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+        CRITICAL_ENTER(uartCtx, tx, txLockCtx);
+        uartCtx->frame.type    = XUART_FRAMING_NONE;
+
+        if (TRUE == uartCtx->isLoopback) {
+            uartCtx->isLoopback = FALSE;
+            lldLoopbackSet(
+                uartCtx->cache.io,
+                LLD_DISABLE);
+        }
+        tapDetachAllI(
+            uartCtx);
+        cIntSetDisable(
+            uartCtx,
+            C_INT_TX | C_INT_RX | C_INT_RX_TIMEOUT);                            /* Mask all interrupts, the IRQ stays requested             */
+
+        if (NULL != uartCtx->engine.ops->detachI) {
+            uartCtx->engine.ops->detachI(
+                uartCtx);
+        }
+        rtdm_timer_stop(
+            &uartCtx->poll.timer);
+        rtdm_timer_stop(
+            &uartCtx->frame.rtu.timer);
+        uartCtx->isOpen = FALSE;
+        CRITICAL_EXIT(uartCtx, tx, txLockCtx);
+        CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+        rtdm_lock_put_irqrestore(&TapLock, tapLockCtx);
+    }
+
+    return (0);
+}
+
+static int handleIOctl(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    unsigned int        req,
+    void __user *       mem) {
+
+    struct uartCtx *    uartCtx;
+    int                 retval;
+
+    uartCtx = uartCtxFromDevCtx(devCtx);
+    retval = 0;
+
+    if ((TRUE == uartCtx->tap.isTap) && (XUART_TAP_GET != req) && (XUART_TAP_SET != req) && (XUART_CHANNEL_SET != req)) {
+
+        return (-EPERM);                                                        /* Taps can not change the hardware owner settings          */
+    }
+
+    switch (req) {
+        case XUART_PROTOCOL_GET : {
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_to_user(
+                    usrInfo,
+                    mem,
+                    &uartCtx->proto,
+                    sizeof(struct xUartProto));
+            } else {
+                memcpy(
+                    mem,
+                    &uartCtx->proto,
+                    sizeof(struct xUartProto));
+            }
+            break;
+        }
+        case XUART_PROTOCOL_SET : {
+            struct xUartProto proto;
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &proto,
+                    mem,
+                    sizeof(struct xUartProto));
+
+                if (0 != retval) {
+
+                    break;
+                }
+            } else {
+                memcpy(
+                    &proto,
+                    mem,
+                    sizeof(struct xUartProto));
+            }
+
+            if (FALSE == xProtoIsValid(&proto)) {
+                retval = -EINVAL;
+            } else {
+                CRITICAL_DECL(rxLockCtx);
+                CRITICAL_DECL(txLockCtx);
+
+                CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+                CRITICAL_ENTER(uartCtx, tx, txLockCtx);
+                retval = xProtoSet(
+                    uartCtx,
+                    &proto);
+                CRITICAL_EXIT(uartCtx, tx, txLockCtx);
+                CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+            }
+            break;
+        }
+        case XUART_RDY_LEVEL_SET : {
+            struct xUartRdyLevel level;
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &level,
+                    mem,
+                    sizeof(struct xUartRdyLevel));
+
+                if (0 != retval) {
+
+                    break;
+                }
+            } else {
+                memcpy(
+                    &level,
+                    mem,
+                    sizeof(struct xUartRdyLevel));
+            }
+
+            if ((0U == level.rx) || (circSizeGet(&uartCtx->rx.buff.handle) < level.rx) ||
+                (0U == level.tx) || (circSizeGet(&uartCtx->tx.buff.handle) < level.tx)) {
+                retval = -EINVAL;
+            } else {
+                CRITICAL_DECL(lockCtx);
+
+                CRITICAL_ENTER(uartCtx, rx, lockCtx);
+                uartCtx->rx.rdyLevel = level.rx;
+                rxRdyUpdateI(
+                    uartCtx);
+                CRITICAL_EXIT(uartCtx, rx, lockCtx);
+                CRITICAL_ENTER(uartCtx, tx, lockCtx);
+                uartCtx->tx.rdyLevel = level.tx;
+                txRdyUpdateI(
+                    uartCtx);
+                CRITICAL_EXIT(uartCtx, tx, lockCtx);
+            }
+            break;
+        }
+        case XUART_RX_PERSIST : {
+            CRITICAL_DECL(lockCtx);
+
+            CRITICAL_ENTER(uartCtx, rx, lockCtx);
+            buffRxPersistI(
+                uartCtx);
+            CRITICAL_EXIT(uartCtx, rx, lockCtx);
+            break;
+        }
+        case XUART_FRAMING_GET : {
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_to_user(
+                    usrInfo,
+                    mem,
+                    &uartCtx->frame.type,
+                    sizeof(enum xUartFraming));
+            } else {
+                memcpy(
+                    mem,
+                    &uartCtx->frame.type,
+                    sizeof(enum xUartFraming));
+            }
+            break;
+        }
+        case XUART_CRC_GET : {
+            struct xUartCrcState state;
+
+            state.rx = uartCtx->rx.crcLast;
+            state.tx = uartCtx->tx.crcLast;
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_to_user(
+                    usrInfo,
+                    mem,
+                    &state,
+                    sizeof(struct xUartCrcState));
+            } else {
+                memcpy(
+                    mem,
+                    &state,
+                    sizeof(struct xUartCrcState));
+            }
+            break;
+        }
+        case XUART_FRAMING_SET : {
+            enum xUartFraming type;
+            CRITICAL_DECL(rxLockCtx);
+            CRITICAL_DECL(txLockCtx);
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &type,
+                    mem,
+                    sizeof(enum xUartFraming));
+
+                if (0 != retval) {
+
+                    break;
+                }
+            } else {
+                memcpy(
+                    &type,
+                    mem,
+                    sizeof(enum xUartFraming));
+            }
+
+            if (XUART_FRAMING_RTU < (unsigned int)type) {
+                retval = -EINVAL;
+
+                break;
+            }
+
+            if (TRUE == uartCtx->poll.isActive) {
+                retval = -EBUSY;
+
+                break;
+            }
+
+            if ((XUART_FILTER_NONE != uartCtx->filter.cfg.type) &&
+                (XUART_FRAMING_NONE != type) && (XUART_FRAMING_RTU != type)) {
+                retval = -EBUSY;                                                /* Address filter works on raw bytes only                   */
+
+                break;
+            }
+
+            if ((TRUE == uartCtx->frame.mux.isEnabled) &&
+                ((XUART_FRAMING_NONE == type) || (XUART_FRAMING_RTU == type))) {
+                retval = -EBUSY;                                                /* Channels need delimited frames                           */
+
+                break;
+            }
+#if (1 == CFG_CRITICAL_INT_ENABLE)
+            if (XUART_FRAMING_RTU == type) {                                    /* RTU timer is not covered by IER masking                  */
+                retval = -ENOTSUPP;
+
+                break;
+            }
+#endif
+            CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+            CRITICAL_ENTER(uartCtx, tx, txLockCtx);
+
+            if (XUART_FRAMING_RTU == uartCtx->frame.type) {
+                rtdm_timer_stop(
+                    &uartCtx->frame.rtu.timer);
+            }
+            uartCtx->frame.type = type;
+            frameEncInit(
+                &uartCtx->frame.enc,
+                type);
+            buffRxFlush(
+                uartCtx);                                                       /* Also resets the decoder and the frame queue              */
+
+            if (XUART_FRAMING_NONE != type) {
+                buffRxPersistI(
+                    uartCtx);                                                   /* Frames arriving between reads must not be lost           */
+            }
+            CRITICAL_EXIT(uartCtx, tx, txLockCtx);
+            CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+            break;
+        }
+        case XUART_CRC_SET : {
+            struct xUartCrcCfg cfg;
+            CRITICAL_DECL(rxLockCtx);
+            CRITICAL_DECL(txLockCtx);
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &cfg,
+                    mem,
+                    sizeof(struct xUartCrcCfg));
+
+                if (0 != retval) {
+
+                    break;
+                }
+            } else {
+                memcpy(
+                    &cfg,
+                    mem,
+                    sizeof(struct xUartCrcCfg));
+            }
+
+            if ((XUART_CRC_32 < cfg.type) || (1U < cfg.isAppend)) {
+                retval = -EINVAL;
+
+                break;
+            }
+            CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+            CRITICAL_ENTER(uartCtx, tx, txLockCtx);
+            crcInit(
+                &uartCtx->rx.crc,
+                (enum crcType)cfg.type);                                        /* enum xUartCrc mirrors enum crcType                       */
+            crcInit(
+                &uartCtx->tx.crc,
+                (enum crcType)cfg.type);
+            uartCtx->tx.isCrcAppend = (0U != cfg.isAppend) ? TRUE : FALSE;
+            CRITICAL_EXIT(uartCtx, tx, txLockCtx);
+            CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+            break;
+        }
+        case XUART_TRANSACT : {
+            struct xUartTransact req;
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &req,
+                    mem,
+                    sizeof(struct xUartTransact));
+
+                if (0 != retval) {
+
+                    break;
+                }
+            } else {
+                memcpy(
+                    &req,
+                    mem,
+                    sizeof(struct xUartTransact));
+            }
+            retval = (int)xferTransact(
+                uartCtx,
+                usrInfo,
+                &req);
+            break;
+        }
+        case XUART_POLL_SET : {
+            struct xUartPollTable * table;
+            uint32_t    cnt;
+
+            if (TRUE == uartCtx->poll.isActive) {
+                retval = -EBUSY;
+
+                break;
+            }
+            table = &uartCtx->poll.table;                                       /* Too big for the stack, copy in place                     */
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    table,
+                    mem,
+                    sizeof(struct xUartPollTable));
+            } else {
+                memcpy(
+                    table,
+                    mem,
+                    sizeof(struct xUartPollTable));
+            }
+
+            if ((0 == retval) && ((0U == table->period) || (XUART_POLL_ENTRIES_MAX < table->count))) {
+                retval = -EINVAL;
+            }
+
+            for (cnt = 0U; (0 == retval) && (cnt < table->count); cnt++) {
+
+                if ((0U == table->entry[cnt].reqSize) || (XUART_POLL_REQ_MAX < table->entry[cnt].reqSize) ||
+                    (0U == table->entry[cnt].rspSize) || (XUART_POLL_RSP_MAX < table->entry[cnt].rspSize)) {
+                    retval = -EINVAL;
+                }
+            }
+
+            if (0 != retval) {
+                table->count = 0U;
+            }
+            break;
+        }
+        case XUART_POLL_START : {
+            retval = pollStart(
+                uartCtx);
+            break;
+        }
+        case XUART_POLL_STOP : {
+            retval = pollStop(
+                uartCtx);
+            break;
+        }
+        case XUART_POLL_WAIT : {
+            CRITICAL_DECL(rxLockCtx);
+            uint32_t    pub;
+
+            if (FALSE == uartCtx->poll.isActive) {
+                retval = -EINVAL;
+
+                break;
+            }
+            retval = rtdm_event_wait(
+                &uartCtx->poll.done);
+
+            if (0 != retval) {
+
+                break;
+            }
+
+            if (FALSE == uartCtx->poll.isActive) {
+                retval = -EIDRM;                                                /* Stopped while waiting                                    */
+
+                break;
+            }
+            CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+            pub = uartCtx->poll.pub;
+            CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_to_user(
+                    usrInfo,
+                    mem,
+                    &uartCtx->poll.result[pub],
+                    sizeof(struct xUartPollResult));
+            } else {
+                memcpy(
+                    mem,
+                    &uartCtx->poll.result[pub],
+                    sizeof(struct xUartPollResult));
+            }
+            break;
+        }
+        case XUART_FILTER_GET : {
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_to_user(
+                    usrInfo,
+                    mem,
+                    &uartCtx->filter.cfg,
+                    sizeof(struct xUartFilter));
+            } else {
+                memcpy(
+                    mem,
+                    &uartCtx->filter.cfg,
+                    sizeof(struct xUartFilter));
+            }
+            break;
+        }
+        case XUART_FILTER_SET : {
+            struct xUartFilter cfg;
+            CRITICAL_DECL(rxLockCtx);
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &cfg,
+                    mem,
+                    sizeof(struct xUartFilter));
+
+                if (0 != retval) {
+
+                    break;
+                }
+            } else {
+                memcpy(
+                    &cfg,
+                    mem,
+                    sizeof(struct xUartFilter));
+            }
+
+            if ((XUART_FILTER_ADDR < cfg.type) || (0xFFU < cfg.addr) || (0xFF < cfg.broadcast)) {
+                retval = -EINVAL;
+
+                break;
+            }
+
+            if ((XUART_FILTER_MARK == cfg.type) && (XUART_PARITY_SPACE != uartCtx->proto.parity)) {
+                retval = -EINVAL;
+
+                break;
+            }
+
+            if ((XUART_FILTER_NONE != cfg.type) &&
+                (XUART_FRAMING_NONE != uartCtx->frame.type) && (XUART_FRAMING_RTU != uartCtx->frame.type)) {
+                retval = -EBUSY;
+
+                break;
+            }
+            CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+            memcpy(
+                &uartCtx->filter.cfg,
+                &cfg,
+                sizeof(struct xUartFilter));
+            uartCtx->filter.isGap   = TRUE;                                     /* Wait for the next address byte                           */
+            uartCtx->filter.isMatch = FALSE;
+            uartCtx->filter.last    = 0U;
+            CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+            break;
+        }
+        case XUART_WAKE_GET : {
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_to_user(
+                    usrInfo,
+                    mem,
+                    &uartCtx->wake.cfg,
+                    sizeof(struct xUartWake));
+            } else {
+                memcpy(
+                    mem,
+                    &uartCtx->wake.cfg,
+                    sizeof(struct xUartWake));
+            }
+            break;
+        }
+        case XUART_WAKE_SET : {
+            struct xUartWake cfg;
+            uint32_t    cnt;
+            CRITICAL_DECL(rxLockCtx);
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &cfg,
+                    mem,
+                    sizeof(struct xUartWake));
+
+                if (0 != retval) {
+
+                    break;
+                }
+            } else {
+                memcpy(
+                    &cfg,
+                    mem,
+                    sizeof(struct xUartWake));
+            }
+
+            if (XUART_WAKE_DELIM_MAX < cfg.delimCount) {
+                retval = -EINVAL;
+
+                break;
+            }
+            CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+
+            if (&uartCtx->wake.cond == uartCtx->wake.cur) {                     /* Do not change conditions under a running read()          */
+                CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+                retval = -EBUSY;
+
+                break;
+            }
+            memcpy(
+                &uartCtx->wake.cfg,
+                &cfg,
+                sizeof(struct xUartWake));
+            rxWakeInit(
+                &uartCtx->wake.cond);
+
+            for (cnt = 0U; cnt < cfg.delimCount; cnt++) {
+                rxWakeDelimAdd(
+                    &uartCtx->wake.cond,
+                    cfg.delim[cnt]);
+            }
+            uartCtx->wake.cond.count = cfg.count;
+            uartCtx->wake.cond.idle  = US_TO_NS((nanosecs_rel_t)cfg.idle);
+            uartCtx->wake.isEnabled  = ((0U != cfg.count) || (0U != cfg.idle) || (0U != cfg.delimCount)) ? TRUE : FALSE;
+            CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+            break;
+        }
+        case XUART_TAP_GET : {
+            struct xUartTap tap;
+
+            if (FALSE == uartCtx->tap.isTap) {
+                retval = -EINVAL;
+
+                break;
+            }
+            tap.policy = uartCtx->tap.policy;
+            tap.lost   = uartCtx->tap.lost;
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_to_user(
+                    usrInfo,
+                    mem,
+                    &tap,
+                    sizeof(struct xUartTap));
+            } else {
+                memcpy(
+                    mem,
+                    &tap,
+                    sizeof(struct xUartTap));
+            }
+            break;
+        }
+        case XUART_TAP_SET : {
+            struct xUartTap tap;
+
+            if (FALSE == uartCtx->tap.isTap) {
+                retval = -EINVAL;
+
+                break;
+            }
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &tap,
+                    mem,
+                    sizeof(struct xUartTap));
+
+                if (0 != retval) {
+
+                    break;
+                }
+            } else {
+                memcpy(
+                    &tap,
+                    mem,
+                    sizeof(struct xUartTap));
+            }
+
+            if (XUART_TAP_DROP_OLD < tap.policy) {
+                retval = -EINVAL;
 
-    return (retval);
-}
+                break;
+            }
+            uartCtx->tap.policy = (enum xUartTapPolicy)tap.policy;
+            break;
+        }
+        case XUART_MUX_SET : {
+            uint32_t    isEnabled;
+            CRITICAL_DECL(rxLockCtx);
+            CRITICAL_DECL(txLockCtx);
 
-static void dmaCallbackRx(
-    void *              arg) {
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &isEnabled,
+                    mem,
+                    sizeof(uint32_t));
 
-    /*
-     * TODO: Napisati
-     */
-}
+                if (0 != retval) {
 
-static void dmaCallbackTx(
-    void *              arg) {
+                    break;
+                }
+            } else {
+                memcpy(
+                    &isEnabled,
+                    mem,
+                    sizeof(uint32_t));
+            }
 
-    struct uartCtx *    uartCtx;
+            if ((0U != isEnabled) &&
+                ((XUART_FRAMING_NONE == uartCtx->frame.type) || (XUART_FRAMING_RTU == uartCtx->frame.type))) {
+                retval = -EINVAL;
 
-    uartCtx = (struct uartCtx *)arg;
+                break;
+            }
+            CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+            CRITICAL_ENTER(uartCtx, tx, txLockCtx);
+            uartCtx->frame.mux.isEnabled = (0U != isEnabled) ? TRUE : FALSE;
+            buffRxFlush(
+                uartCtx);                                                       /* Also waits for the channel number of the next frame      */
+            CRITICAL_EXIT(uartCtx, tx, txLockCtx);
+            CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+            break;
+        }
+        case XUART_CHANNEL_SET : {
+            struct uartCtx * owner;
+            struct uartCtx * tap;
+            uint32_t    channel;
+            rtdm_lockctx_t tapLockCtx;
+            CRITICAL_DECL(rxLockCtx);
+            CRITICAL_DECL(lockCtx);
+
+            if (FALSE == uartCtx->tap.isTap) {
+                retval = -EINVAL;
+
+                break;
+            }
 
-    LOG_DBG("DMA Tx callback");
-    circPosTailSet(
-        &uartCtx->tx.buff.handle,
-        uartCtx->tx.buff.chunk);
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &channel,
+                    mem,
+                    sizeof(uint32_t));
 
-    if (0u != uartCtx->tx.buff.pend) {
-        rtdm_event_signal(
-            &uartCtx->tx.opr);
-    }
+                if (0 != retval) {
 
-    if (0u == circFreeGet(&uartCtx->tx.buff.handle)) {
-        portDMARxStopI(uartCtx->cache.devData);
+                    break;
+                }
+            } else {
+                memcpy(
+                    &channel,
+                    mem,
+                    sizeof(uint32_t));
+            }
 
-    }
-}
+            if (XUART_CHANNEL_MAX < channel) {
+                retval = -EINVAL;
 
+                break;
+            }
+            rtdm_lock_get_irqsave(&TapLock, tapLockCtx);
+            owner = uartCtx->tap.owner;
 
+            if (NULL == owner) {
+                rtdm_lock_put_irqrestore(&TapLock, tapLockCtx);
+                retval = -EBADF;
 
-/* ===========================================================================
- * NOTE:    End of DMA mode 2 (hardware DMA) functions
- * ===========================================================================*/
-#endif /* (2 == CFG_DMA_MODE) */
+                break;
+            }
+            CRITICAL_ENTER(owner, rx, rxLockCtx);
 
-static int handleOpen(
-    struct rtdm_dev_context * devCtx,
-    rtdm_user_info_t *  usrInfo,
-    int                 oflag) {
+            for (tap = owner->tap.next; NULL != tap; tap = tap->tap.next) {
 
-    int                 retval;
-    struct uartCtx *    uartCtx;
+                if ((uartCtx != tap) && (0U != channel) && (channel == tap->tap.channel)) {
+                    retval = -EBUSY;                                            /* Channel is already bound to another tap                  */
+                }
+            }
 
-    uartCtx = uartCtxFromDevCtx(
-        devCtx);
-    CRITICAL_INIT(uartCtx);
-    retval = uartCtxInit(
-        uartCtx,
-        devCtx->device->device_data,
-        portIORemapGet(devCtx->device->device_data));
+            if (0 == retval) {
+                CRITICAL_ENTER(uartCtx, rx, lockCtx);
+                uartCtx->tap.channel = channel;
+                uartCtx->frame.type  = (0U != channel) ? owner->frame.type : XUART_FRAMING_NONE;
+                circFlush(
+                    &uartCtx->rx.buff.handle);
+                frameQueueFlush(
+                    &uartCtx->frame.queue);
+                rxRdyUpdateI(
+                    uartCtx);
+                CRITICAL_EXIT(uartCtx, rx, lockCtx);
+            }
+            CRITICAL_EXIT(owner, rx, rxLockCtx);
+            rtdm_lock_put_irqrestore(&TapLock, tapLockCtx);
+            break;
+        }
+        case XUART_LOOPBACK_SET : {
+            uint32_t    isEnabled;
+            CRITICAL_DECL(rxLockCtx);
+            CRITICAL_DECL(txLockCtx);
 
-    if (0 != retval) {
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &isEnabled,
+                    mem,
+                    sizeof(uint32_t));
 
-        return (retval);
-    }
-    lldFIFORxFlush(
-        uartCtx->cache.io);
-    lldFIFOTxFlush(
-        uartCtx->cache.io);
-#if (0 == CFG_DMA_MODE) || (1 == CFG_DMA_MODE)
-    retval = rtdm_irq_request(
-        &uartCtx->irqHandle,
-        PortIRQ[devCtx->device->device_id],
-        handleIrq,
-        RTDM_IRQTYPE_EDGE,
-        devCtx->device->proc_name,
-        uartCtx);
-#endif
+                if (0 != retval) {
 
-    return (retval);
-}
+                    break;
+                }
+            } else {
+                memcpy(
+                    &isEnabled,
+                    mem,
+                    sizeof(uint32_t));
+            }
+            CRITICAL_ENTER(uartCtx, rx, rxLockCtx);
+            CRITICAL_ENTER(uartCtx, tx, txLockCtx);
+            uartCtx->isLoopback = (0U != isEnabled) ? TRUE : FALSE;
+            lldLoopbackSet(
+                uartCtx->cache.io,
+                (TRUE == uartCtx->isLoopback) ? LLD_ENABLE : LLD_DISABLE);
+            CRITICAL_EXIT(uartCtx, tx, txLockCtx);
+            CRITICAL_EXIT(uartCtx, rx, rxLockCtx);
+            break;
+        }
+        case XUART_SELFTEST : {
+            struct xUartSelfTest test;
 
-static int handleClose(
-    struct rtdm_dev_context * devCtx,
-    rtdm_user_info_t *  usrInfo) {
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &test,
+                    mem,
+                    sizeof(struct xUartSelfTest));
 
-    struct uartCtx *    uartCtx;
-    int                 retval;
+                if (0 != retval) {
 
-    uartCtx = uartCtxFromDevCtx(devCtx);
-    retval = 0;
+                    break;
+                }
+            } else {
+                memcpy(
+                    &test,
+                    mem,
+                    sizeof(struct xUartSelfTest));
+            }
+            retval = xferSelfTest(
+                uartCtx,
+                &test);
 
-    if (UART_CTX_SIGNATURE == uartCtx->signature) {                             /* Driver must be ready to accept close callbacks for       */
-                                                                                /* already closed devices.                                  */
-        CRITICAL_DECL(lockCtx);
+            if (0 != retval) {
 
-        /*
-         * TODO: Here should be some sync mechanism to wait for driver shutdown
-         */
-        CRITICAL_ENTER(uartCtx, lockCtx);
-#if (0 == CFG_DMA_MODE) || (1 == CFG_DMA_MODE)
-        cIntSetDisable(
-            uartCtx,
-            C_INT_TX | C_INT_RX | C_INT_RX_TIMEOUT);                            /* Turn off all interrupts                                  */
-        retval = rtdm_irq_free(
-            &uartCtx->irqHandle);
+                break;
+            }
 
-        if (0 != retval) {
-            LOG_ERR("failed to free irq, err: %d", -retval);
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_to_user(
+                    usrInfo,
+                    mem,
+                    &test,
+                    sizeof(struct xUartSelfTest));
+            } else {
+                memcpy(
+                    mem,
+                    &test,
+                    sizeof(struct xUartSelfTest));
+            }
+            break;
         }
-#endif
-        uartCtxTerm(
-            uartCtx);
-        CRITICAL_EXIT(uartCtx, lockCtx);
-    }
+        case XUART_ENGINE_GET : {
+            uint32_t    id;
 
-    return (retval);
-}
+            id = uartCtx->engine.ops->id;
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_to_user(
+                    usrInfo,
+                    mem,
+                    &id,
+                    sizeof(uint32_t));
+            } else {
+                memcpy(
+                    mem,
+                    &id,
+                    sizeof(uint32_t));
+            }
+            break;
+        }
+        case XUART_ENGINE_SET : {
+            uint32_t    id;
 
-static int handleIOctl(
-    struct rtdm_dev_context * devCtx,
-    rtdm_user_info_t *  usrInfo,
-    unsigned int        req,
-    void __user *       mem) {
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &id,
+                    mem,
+                    sizeof(uint32_t));
 
-    struct uartCtx *    uartCtx;
-    int                 retval;
+                if (0 != retval) {
 
-    uartCtx = uartCtxFromDevCtx(devCtx);
-    retval = 0;
+                    break;
+                }
+            } else {
+                memcpy(
+                    &id,
+                    mem,
+                    sizeof(uint32_t));
+            }
+            retval = engineSet(
+                uartCtx,
+                id);
+            break;
+        }
+        case XUART_HYBRID_GET : {
+#if (1 == CFG_DMA_MODE)
+            CRITICAL_DECL(lockCtx);
+            struct xUartHybrid hybrid;
 
-    switch (req) {
-        case XUART_PROTOCOL_GET : {
+            CRITICAL_ENTER(uartCtx, tx, lockCtx);
+            hybrid.threshold = (uint32_t)uartCtx->engine.hybrid.threshold;
+            hybrid.dmaSetup  = uartCtx->engine.hybrid.dmaSetup;
+            hybrid.pioByte   = uartCtx->engine.hybrid.pioByte;
+            hybrid.dmaBursts = uartCtx->engine.hybrid.dmaBursts;
+            hybrid.pioBursts = uartCtx->engine.hybrid.pioBursts;
+            CRITICAL_EXIT(uartCtx, tx, lockCtx);
 
             if (NULL != usrInfo) {
                 retval = rtdm_safe_copy_to_user(
                     usrInfo,
                     mem,
-                    &uartCtx->proto,
-                    sizeof(struct xUartProto));
+                    &hybrid,
+                    sizeof(struct xUartHybrid));
             } else {
                 memcpy(
                     mem,
-                    &uartCtx->proto,
-                    sizeof(struct xUartProto));
+                    &hybrid,
+                    sizeof(struct xUartHybrid));
             }
+#else
+            retval = -ENOTSUPP;                                                 /* Hybrid engine needs DMA mode 1                           */
+#endif
             break;
         }
-        case XUART_PROTOCOL_SET : {
-            struct xUartProto proto;
+        case XUART_HYBRID_SET : {
+#if (1 == CFG_DMA_MODE)
+            CRITICAL_DECL(lockCtx);
+            struct xUartHybrid hybrid;
 
             if (NULL != usrInfo) {
                 retval = rtdm_safe_copy_from_user(
                     usrInfo,
-                    &proto,
+                    &hybrid,
                     mem,
-                    sizeof(struct xUartProto));
+                    sizeof(struct xUartHybrid));
+
+                if (0 != retval) {
+
+                    break;
+                }
             } else {
                 memcpy(
-                    &proto,
+                    &hybrid,
                     mem,
-                    sizeof(struct xUartProto));
+                    sizeof(struct xUartHybrid));
             }
+            CRITICAL_ENTER(uartCtx, tx, lockCtx);
 
-            if (TRUE == xProtoIsValid(&proto)) {
-                CRITICAL_DECL(lockCtx);
-
-                CRITICAL_ENTER(uartCtx, lockCtx);
-                xProtoSet(
-                    uartCtx,
-                    &proto);
-                CRITICAL_EXIT(uartCtx, lockCtx);
+            if (0U != hybrid.threshold) {
+                uartCtx->engine.hybrid.threshold    = hybrid.threshold;
+                uartCtx->engine.hybrid.isCalibrated = TRUE;
+            } else if (TRUE == portDMATxIsRunning(uartCtx->cache.devData)) {
+                retval = -EBUSY;                                                /* Running DMA cycle would be timed only in part            */
+            } else {
+                hybridCalibrateI(
+                    uartCtx);
             }
+            CRITICAL_EXIT(uartCtx, tx, lockCtx);
+#else
+            retval = -ENOTSUPP;
+#endif
             break;
         }
         default : {
@@ -1852,6 +6237,62 @@ static int handleIOctl(
     return (retval);
 }
 
+static int handleSelBind(
+    struct rtdm_dev_context * devCtx,
+    rtdm_selector_t *   selector,
+    enum rtdm_selecttype type,
+    unsigned int        fdIndex) {
+
+    struct uartCtx *    uartCtx;
+    int                 retval;
+
+    uartCtx = uartCtxFromDevCtx(devCtx);
+
+    switch (type) {
+        case RTDM_SELECTTYPE_READ : {
+            CRITICAL_DECL(lockCtx);
+
+            retval = rtdm_event_select_bind(
+                &uartCtx->rx.rdy,
+                selector,
+                type,
+                fdIndex);
+
+            if (0 != retval) {
+
+                break;
+            }
+            CRITICAL_ENTER(uartCtx, rx, lockCtx);
+
+            if (FALSE == uartCtx->tap.isTap) {
+                buffRxPersistI(
+                    uartCtx);                                                   /* Readiness needs a running receiver, so keep it enabled   */
+            }
+            CRITICAL_EXIT(uartCtx, rx, lockCtx);
+            break;
+        }
+        case RTDM_SELECTTYPE_WRITE : {
+
+            if (TRUE == uartCtx->tap.isTap) {
+                retval = -EBADF;
+
+                break;
+            }
+            retval = rtdm_event_select_bind(
+                &uartCtx->tx.rdy,
+                selector,
+                type,
+                fdIndex);
+            break;
+        }
+        default : {
+            retval = -EBADF;
+        }
+    }
+
+    return (retval);
+}
+
 /*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
 /*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
 
@@ -1862,6 +6303,9 @@ int __init moduleInit(
 
     LOG(DEF_DRV_DESCRIPTION);
     LOG("version: %d.%d.%d", DEF_DRV_VERSION_MAJOR, DEF_DRV_VERSION_MINOR, DEF_DRV_VERSION_PATCH);
+    crcModuleInit();
+    rtdm_lock_init(
+        &TapLock);
 
     UartDev.device_id = CFG_UART_ID;
     memcpy(&UartDev.device_name, CFG_DRV_NAME, sizeof(CFG_DRV_NAME));
@@ -1890,6 +6334,30 @@ int __init moduleInit(
         return (retval);
     }
 
+    /*-- STATE: UART context creation ----------------------------------------*/
+    LOG_INFO("create UART context");
+    retval = uartCtxInit(
+        &UartCtx,
+        UartDev.device_data,
+        portIORemapGet(UartDev.device_data));
+
+    if (0 == retval) {
+        retval = tapPoolInit();
+    }
+
+    if (0 != retval) {
+        LOG_ERR("failed to create UART context, err: %d", -retval);
+        tapPoolTerm();
+        uartCtxTerm(
+            &UartCtx);
+        lldTerm(
+            portIORemapGet(UartDev.device_data));
+        portTerm(
+            UartDev.device_data);
+
+        return (retval);
+    }
+
     /*-- STATE: Xenomai device registration ----------------------------------*/
     LOG_INFO("registering device: %s, id: %d", (char *)&UartDev.device_name, UartDev.device_id);
     retval = rtdm_dev_register(
@@ -1897,11 +6365,36 @@ int __init moduleInit(
 
     if (0 != retval) {
         LOG_ERR("failed to register to Real-Time DM, err: %d", -retval);
+        tapPoolTerm();
+        uartCtxTerm(
+            &UartCtx);
         lldTerm(
             UartDev.device_data);
         portTerm(
             UartDev.device_data);
+
+        return (retval);
+    }
+#if (0 != CFG_VNM_PAIRS)
+
+    /*-- STATE: Virtual null-modem devices -----------------------------------*/
+    LOG_INFO("registering %d virtual null-modem pairs", CFG_VNM_PAIRS);
+    retval = vnmInit();
+
+    if (0 != retval) {
+        LOG_ERR("failed to create virtual null-modem devices, err: %d", -retval);
+        rtdm_dev_unregister(
+            &UartDev,
+            CFG_TIMEOUT_MS);
+        tapPoolTerm();
+        uartCtxTerm(
+            &UartCtx);
+        lldTerm(
+            portIORemapGet(UartDev.device_data));
+        portTerm(
+            UartDev.device_data);
     }
+#endif
 
     return (retval);
 }
@@ -1910,6 +6403,10 @@ void __exit moduleTerm(
     void) {
     int             retval;
 
+#if (0 != CFG_VNM_PAIRS)
+    LOG_INFO("removing virtual null-modem devices");
+    vnmTerm();
+#endif
     LOG("removing driver for UART: %d", UartDev.device_id);
     retval = rtdm_dev_unregister(
         &UartDev,
@@ -1918,6 +6415,10 @@ void __exit moduleTerm(
     if (0 != retval) {
         LOG_ERR("failed to unregister device, err: %d", -retval);
     }
+    LOG_INFO("destroying UART context");
+    tapPoolTerm();
+    uartCtxTerm(
+        &UartCtx);
     LOG_INFO("terminating low-level device");
     retval = lldTerm(
         portIORemapGet(UartDev.device_data));
@@ -1957,6 +6458,26 @@ module_init(moduleInit);
 module_exit(moduleTerm);
 
 /*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+
+#if (1 == CFG_VNM_STANDALONE)
+# error "x-16c750: build the standalone virtual null-modem module with: make vnm"
+#endif
+
+#if (4 < CFG_ENGINE_DEFAULT) ||                                                  \
+    ((1 == CFG_ENGINE_DEFAULT) && (1 != CFG_DMA_MODE)) ||                       \
+    ((2 == CFG_ENGINE_DEFAULT) && (2 != CFG_DMA_MODE)) ||                       \
+    ((4 == CFG_ENGINE_DEFAULT) && (1 != CFG_DMA_MODE))
+# error "x-16c750: CFG_ENGINE_DEFAULT selects an engine which is not available with this CFG_DMA_MODE"
+#endif
+
+#if (1 == CFG_BUFF_MIRROR) && (0 != (CFG_DRV_BUFF_SIZE % 4096U))
+# error "x-16c750: CFG_BUFF_MIRROR needs CFG_DRV_BUFF_SIZE to be a multiple of the page size"
+#endif
+
+#if (3 == CFG_ENGINE_DEFAULT) && (1 == CFG_CRITICAL_INT_ENABLE)
+# error "x-16c750: the polled engine needs CFG_CRITICAL_INT_ENABLE set to 0"
+#endif
+
 /** @endcond *//** @} *//******************************************************
  * END of x-16c750.c
  ******************************************************************************/
@@ -0,0 +1,534 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Frame encoder and decoder (SLIP, COBS, HDLC-like)
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include "drv/x-16c750_frame.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+#define SLIP_END                        0xC0U
+#define SLIP_ESC                        0xDBU
+#define SLIP_ESC_END                    0xDCU
+#define SLIP_ESC_ESC                    0xDDU
+
+#define HDLC_FLAG                       0x7EU
+#define HDLC_ESC                        0x7DU
+#define HDLC_XOR                        0x20U
+
+#define COBS_DELIM                      0x00U
+#define COBS_CODE_MAX                   0xFFU
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static void decReset(
+    struct frameDec *   dec);
+
+static enum frameEvent decDelim(
+    struct frameDec *   dec);
+
+static enum frameEvent decSlip(
+    struct frameDec *   dec,
+    uint8_t             item,
+    uint8_t *           out);
+
+static enum frameEvent decHdlc(
+    struct frameDec *   dec,
+    uint8_t             item,
+    uint8_t *           out);
+
+static enum frameEvent decCobs(
+    struct frameDec *   dec,
+    uint8_t             item,
+    uint8_t *           out);
+
+static void encCobsBlock(
+    struct frameEnc *   enc,
+    circBuff_T *        dst);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+static void decReset(
+    struct frameDec *   dec) {
+
+    dec->len   = 0U;
+    dec->code  = 0U;
+    dec->rem   = 0U;
+    dec->isEsc = FALSE;
+    dec->isBad = FALSE;
+}
+
+static enum frameEvent decDelim(
+    struct frameDec *   dec) {
+
+    enum frameEvent     event;
+
+    if (TRUE == dec->isBad) {
+        event = FRAME_EV_NONE;                                                  /* Error was already reported                               */
+    } else if ((TRUE == dec->isEsc) || (0U != dec->rem)) {
+        event = FRAME_EV_ERROR;                                                 /* Aborted or truncated frame                               */
+    } else if (0U == dec->len) {
+        event = FRAME_EV_NONE;                                                  /* Empty frame or leading delimiter                         */
+    } else {
+        event = FRAME_EV_END;
+    }
+    decReset(
+        dec);
+
+    return (event);
+}
+
+static enum frameEvent decSlip(
+    struct frameDec *   dec,
+    uint8_t             item,
+    uint8_t *           out) {
+
+    if (SLIP_END == item) {
+
+        return (decDelim(dec));
+    }
+
+    if (TRUE == dec->isBad) {
+
+        return (FRAME_EV_NONE);
+    }
+
+    if (TRUE == dec->isEsc) {
+        dec->isEsc = FALSE;
+
+        if (SLIP_ESC_END == item) {
+            *out = SLIP_END;
+        } else if (SLIP_ESC_ESC == item) {
+            *out = SLIP_ESC;
+        } else {
+            dec->isBad = TRUE;
+
+            return (FRAME_EV_ERROR);
+        }
+    } else if (SLIP_ESC == item) {
+        dec->isEsc = TRUE;
+
+        return (FRAME_EV_NONE);
+    } else {
+        *out = item;
+    }
+    dec->len++;
+
+    return (FRAME_EV_DATA);
+}
+
+static enum frameEvent decHdlc(
+    struct frameDec *   dec,
+    uint8_t             item,
+    uint8_t *           out) {
+
+    if (HDLC_FLAG == item) {
+
+        return (decDelim(dec));                                                 /* ESC followed by FLAG is an abort sequence                */
+    }
+
+    if (TRUE == dec->isBad) {
+
+        return (FRAME_EV_NONE);
+    }
+
+    if (TRUE == dec->isEsc) {
+        dec->isEsc = FALSE;
+        *out = item ^ HDLC_XOR;
+    } else if (HDLC_ESC == item) {
+        dec->isEsc = TRUE;
+
+        return (FRAME_EV_NONE);
+    } else {
+        *out = item;
+    }
+    dec->len++;
+
+    return (FRAME_EV_DATA);
+}
+
+static enum frameEvent decCobs(
+    struct frameDec *   dec,
+    uint8_t             item,
+    uint8_t *           out) {
+
+    if (COBS_DELIM == item) {
+
+        return (decDelim(dec));
+    }
+
+    if (TRUE == dec->isBad) {
+
+        return (FRAME_EV_NONE);
+    }
+
+    if (0U != dec->rem) {
+        dec->rem--;
+        dec->len++;
+        *out = item;
+
+        return (FRAME_EV_DATA);
+    }
+    /*
+     * This is a code byte. The zero which terminated the previous block is
+     * emitted only now, so the implicit zero after the last block of a frame
+     * is never stored.
+     */
+    if ((0U != dec->code) && (COBS_CODE_MAX != dec->code)) {
+        dec->code = item;
+        dec->rem  = item - 1U;
+        dec->len++;
+        *out = 0U;
+
+        return (FRAME_EV_DATA);
+    }
+    dec->code = item;
+    dec->rem  = item - 1U;
+
+    return (FRAME_EV_NONE);
+}
+
+static void encCobsBlock(
+    struct frameEnc *   enc,
+    circBuff_T *        dst) {
+
+    size_t              cnt;
+
+    circItemPut(
+        dst,
+        (uint8_t)(enc->blockLen + 1U));
+
+    for (cnt = 0U; cnt < enc->blockLen; cnt++) {
+        circItemPut(
+            dst,
+            enc->block[cnt]);
+    }
+    enc->blockLen = 0U;
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+void frameDecInit(
+    struct frameDec *   dec,
+    enum xUartFraming   type) {
+
+    dec->type = type;
+    decReset(
+        dec);
+}
+
+enum frameEvent frameDecPut(
+    struct frameDec *   dec,
+    uint8_t             item,
+    uint8_t *           out) {
+
+    enum frameEvent     event;
+
+    switch (dec->type) {
+        case XUART_FRAMING_SLIP : {
+            event = decSlip(
+                dec,
+                item,
+                out);
+            break;
+        }
+        case XUART_FRAMING_HDLC : {
+            event = decHdlc(
+                dec,
+                item,
+                out);
+            break;
+        }
+        case XUART_FRAMING_COBS : {
+            event = decCobs(
+                dec,
+                item,
+                out);
+            break;
+        }
+        default : {
+            *out  = item;
+            event = FRAME_EV_DATA;
+        }
+    }
+
+    return (event);
+}
+
+void frameDecDiscard(
+    struct frameDec *   dec) {
+
+    decReset(
+        dec);
+    dec->isBad = TRUE;
+}
+
+void frameEncInit(
+    struct frameEnc *   enc,
+    enum xUartFraming   type) {
+
+    enc->type     = type;
+    enc->blockLen = 0U;
+}
+
+size_t frameEncBound(
+    const struct frameEnc * enc,
+    size_t              size) {
+
+    size_t              bound;
+
+    switch (enc->type) {
+        case XUART_FRAMING_SLIP :
+        case XUART_FRAMING_HDLC : {
+            bound = (2U * size) + 2U;                                           /* Every byte escaped, leading and trailing delimiter       */
+            break;
+        }
+        case XUART_FRAMING_COBS : {
+            size += enc->blockLen;
+            bound = size + (size / FRAME_COBS_BLOCK_SIZE) + 2U;                 /* Code bytes and trailing delimiter                        */
+            break;
+        }
+        default : {
+            bound = size;
+        }
+    }
+
+    return (bound);
+}
+
+void frameEncBegin(
+    struct frameEnc *   enc,
+    circBuff_T *        dst) {
+
+    switch (enc->type) {
+        case XUART_FRAMING_SLIP : {
+            circItemPut(
+                dst,
+                SLIP_END);                                                      /* Flush any line noise at the receiver                     */
+            break;
+        }
+        case XUART_FRAMING_HDLC : {
+            circItemPut(
+                dst,
+                HDLC_FLAG);
+            break;
+        }
+        case XUART_FRAMING_COBS : {
+            enc->blockLen = 0U;
+            break;
+        }
+        default : {
+            break;
+        }
+    }
+}
+
+void frameEncPut(
+    struct frameEnc *   enc,
+    circBuff_T *        dst,
+    const uint8_t *     src,
+    size_t              size) {
+
+    while (0U != size) {
+        uint8_t         item;
+
+        item = *src++;
+        size--;
+
+        switch (enc->type) {
+            case XUART_FRAMING_SLIP : {
+
+                if (SLIP_END == item) {
+                    circItemPut(dst, SLIP_ESC);
+                    circItemPut(dst, SLIP_ESC_END);
+                } else if (SLIP_ESC == item) {
+                    circItemPut(dst, SLIP_ESC);
+                    circItemPut(dst, SLIP_ESC_ESC);
+                } else {
+                    circItemPut(dst, item);
+                }
+                break;
+            }
+            case XUART_FRAMING_HDLC : {
+
+                if ((HDLC_FLAG == item) || (HDLC_ESC == item)) {
+                    circItemPut(dst, HDLC_ESC);
+                    circItemPut(dst, item ^ HDLC_XOR);
+                } else {
+                    circItemPut(dst, item);
+                }
+                break;
+            }
+            case XUART_FRAMING_COBS : {
+
+                if (COBS_DELIM == item) {
+                    encCobsBlock(
+                        enc,
+                        dst);
+                } else {
+                    enc->block[enc->blockLen++] = item;
+
+                    if (FRAME_COBS_BLOCK_SIZE == enc->blockLen) {
+                        encCobsBlock(
+                            enc,
+                            dst);
+                    }
+                }
+                break;
+            }
+            default : {
+                circItemPut(dst, item);
+            }
+        }
+    }
+}
+
+void frameEncEnd(
+    struct frameEnc *   enc,
+    circBuff_T *        dst) {
+
+    switch (enc->type) {
+        case XUART_FRAMING_SLIP : {
+            circItemPut(
+                dst,
+                SLIP_END);
+            break;
+        }
+        case XUART_FRAMING_HDLC : {
+            circItemPut(
+                dst,
+                HDLC_FLAG);
+            break;
+        }
+        case XUART_FRAMING_COBS : {
+            encCobsBlock(
+                enc,
+                dst);
+            circItemPut(
+                dst,
+                COBS_DELIM);
+            break;
+        }
+        default : {
+            break;
+        }
+    }
+}
+
+void frameEncAbort(
+    struct frameEnc *   enc,
+    circBuff_T *        dst) {
+
+    switch (enc->type) {
+        case XUART_FRAMING_SLIP : {
+            circItemPut(
+                dst,
+                SLIP_ESC);
+            circItemPut(
+                dst,
+                SLIP_END);                                                      /* Invalid escape sequence                                  */
+            break;
+        }
+        case XUART_FRAMING_HDLC : {
+            circItemPut(
+                dst,
+                HDLC_ESC);
+            circItemPut(
+                dst,
+                HDLC_FLAG);                                                     /* Abort sequence                                           */
+            break;
+        }
+        case XUART_FRAMING_COBS : {
+            enc->blockLen = 0U;
+            circItemPut(
+                dst,
+                COBS_CODE_MAX);
+            circItemPut(
+                dst,
+                COBS_DELIM);                                                    /* Truncated block                                          */
+            break;
+        }
+        default : {
+            break;
+        }
+    }
+}
+
+void frameQueueFlush(
+    struct frameQueue * queue) {
+
+    queue->head = 0U;
+    queue->tail = 0U;
+    queue->occ  = 0U;
+}
+
+bool_T frameQueuePut(
+    struct frameQueue * queue,
+    size_t              len) {
+
+    if (CFG_FRAME_QUEUE_SIZE == queue->occ) {
+
+        return (FALSE);
+    }
+    queue->len[queue->head++] = len;
+
+    if (CFG_FRAME_QUEUE_SIZE == queue->head) {
+        queue->head = 0U;
+    }
+    queue->occ++;
+
+    return (TRUE);
+}
+
+size_t frameQueueGet(
+    struct frameQueue * queue) {
+
+    size_t              len;
+
+    if (0U == queue->occ) {
+
+        return (0U);
+    }
+    len = queue->len[queue->tail++];
+
+    if (CFG_FRAME_QUEUE_SIZE == queue->tail) {
+        queue->tail = 0U;
+    }
+    queue->occ--;
+
+    return (len);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x-16c750_frame.c
+ ******************************************************************************/
@@ -0,0 +1,214 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Scatter/gather copy between I/O vectors and driver buffers
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <linux/kernel.h>
+
+#include "drv/x-16c750_iov.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+/*======================================================  LOCAL DATA TYPES  ==*/
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+/*=======================================================  LOCAL VARIABLES  ==*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+void ioCursorInit(
+    struct ioCursor *   cur,
+    struct iovec *      iov,
+    size_t              iovlen) {
+
+    cur->iov    = iov;
+    cur->iovlen = iovlen;
+}
+
+ssize_t ioCursorFromMsg(
+    struct ioCursor *   cur,
+    struct iovec *      iov,
+    rtdm_user_info_t *  user,
+    const struct msghdr * msg,
+    enum ioDir          dir) {
+
+    size_t              cnt;
+    size_t              total;
+
+    if ((0U == msg->msg_iovlen) || (CFG_DRV_IOV_MAX < msg->msg_iovlen)) {
+
+        return (-EINVAL);
+    }
+
+    if (NULL != user) {
+        int             retval;
+
+        retval = rtdm_safe_copy_from_user(
+            user,
+            iov,
+            msg->msg_iov,
+            msg->msg_iovlen * sizeof(struct iovec));
+
+        if (0 != retval) {
+
+            return (retval);
+        }
+    } else {
+        memcpy(
+            iov,
+            msg->msg_iov,
+            msg->msg_iovlen * sizeof(struct iovec));
+    }
+    total = 0U;
+
+    for (cnt = 0U; cnt < msg->msg_iovlen; cnt++) {
+
+        if (NULL != user) {
+            int         isOk;
+
+            if (IO_DIR_RX == dir) {
+                isOk = rtdm_rw_user_ok(user, iov[cnt].iov_base, iov[cnt].iov_len);
+            } else {
+                isOk = rtdm_read_user_ok(user, iov[cnt].iov_base, iov[cnt].iov_len);
+            }
+
+            if (0 == isOk) {
+
+                return (-EFAULT);
+            }
+        }
+        total += iov[cnt].iov_len;
+    }
+    ioCursorInit(
+        cur,
+        iov,
+        msg->msg_iovlen);
+
+    return ((ssize_t)total);
+}
+
+int ioCursorCopyTo(
+    struct ioCursor *   cur,
+    rtdm_user_info_t *  user,
+    const uint8_t *     src,
+    size_t              size) {
+
+    while (0U != size) {
+        size_t          transfer;
+
+        while ((0U != cur->iovlen) && (0U == cur->iov->iov_len)) {
+            cur->iov++;
+            cur->iovlen--;
+        }
+
+        if (0U == cur->iovlen) {
+
+            return (-EINVAL);
+        }
+        transfer = min(size, cur->iov->iov_len);
+
+        if (NULL != user) {
+            int         retval;
+
+            retval = rtdm_copy_to_user(
+                user,
+                cur->iov->iov_base,
+                src,
+                transfer);
+
+            if (0 != retval) {
+
+                return (retval);
+            }
+        } else {
+            memcpy(
+                cur->iov->iov_base,
+                src,
+                transfer);
+        }
+        cur->iov->iov_base = (uint8_t *)cur->iov->iov_base + transfer;
+        cur->iov->iov_len -= transfer;
+        src  += transfer;
+        size -= transfer;
+    }
+
+    return (0);
+}
+
+int ioCursorCopyFrom(
+    struct ioCursor *   cur,
+    rtdm_user_info_t *  user,
+    uint8_t *           dst,
+    size_t              size) {
+
+    while (0U != size) {
+        size_t          transfer;
+
+        while ((0U != cur->iovlen) && (0U == cur->iov->iov_len)) {
+            cur->iov++;
+            cur->iovlen--;
+        }
+
+        if (0U == cur->iovlen) {
+
+            return (-EINVAL);
+        }
+        transfer = min(size, cur->iov->iov_len);
+
+        if (NULL != user) {
+            int         retval;
+
+            retval = rtdm_copy_from_user(
+                user,
+                dst,
+                cur->iov->iov_base,
+                transfer);
+
+            if (0 != retval) {
+
+                return (retval);
+            }
+        } else {
+            memcpy(
+                dst,
+                cur->iov->iov_base,
+                transfer);
+        }
+        cur->iov->iov_base = (uint8_t *)cur->iov->iov_base + transfer;
+        cur->iov->iov_len -= transfer;
+        dst  += transfer;
+        size -= transfer;
+    }
+
+    return (0);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x-16c750_iov.c
+ ******************************************************************************/
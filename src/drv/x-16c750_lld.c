@@ -53,8 +53,6 @@
 # define FIFO_TX_LVL                    TLR_TX_FIFO_TRIG_DMA_56
 #endif
 
-#define DEF_FIFO_SIZE                   64U
-
 /*======================================================  LOCAL DATA TYPES  ==*/
 
 const struct xUartProto DefProtocol = {
@@ -129,13 +127,6 @@ static void lldInit_(
         io,                                                                     /* (1/2)                                                    */
         waFCR,
         FCR_FIFO_EN);                                                           /* BUG NOTE: HW does not listen these FIFO granularity      */
-#if (2u == CFG_DMA_MODE)
-    lldUARTDMAStateSet(
-        io,
-        LLD_DMA_MODE_TX_AND_RX);
-    lldRegWr(io, wMDR3, MDR3_SET_DMA_TX_THRESHOLD);
-    lldRegWr(io, wTXDMA, 0x08);
-#endif
     lldRegWr(
         io,
         waFCR,
@@ -339,6 +330,31 @@ void lldEnhanced(
         regLCR);
 }
 
+void lldLoopbackSet(
+    volatile uint8_t *  io,
+    enum lldState       state) {
+
+    switch (state) {
+        case LLD_ENABLE : {
+            lldRegSetBits(                                                      /* Route TX output to RX input, the line stays idle         */
+                io,
+                MCR,
+                MCR_LOOPBACKEN);
+            break;
+        }
+        case LLD_DISABLE : {
+            lldRegResetBits(
+                io,
+                MCR,
+                MCR_LOOPBACKEN);
+            break;
+        }
+        default : {
+            break;
+        }
+    }
+}
+
 int32_t lldSoftReset(
     volatile uint8_t *  io) {
 
@@ -540,6 +556,14 @@ void lldProtocolPrint(
             parity = "odd";
             break;
         }
+        case XUART_PARITY_MARK : {
+            parity = "mark";
+            break;
+        }
+        case XUART_PARITY_SPACE : {
+            parity = "space";
+            break;
+        }
         default : {
             parity = "unknown";
             break;
@@ -593,9 +617,9 @@ int32_t lldProtocolSet(
     volatile uint8_t *  io,
     const struct xUartProto * protocol) {
 
-    uint16_t            tmp;
+    int32_t             tmp;
     uint16_t            arg;
-    uint16_t            retval;
+    int32_t             retval;
     uint16_t            regEFR;
 
     retval = 0;
@@ -667,6 +691,14 @@ int32_t lldProtocolSet(
             arg = LCR_PARITY_EN;
             break;
         }
+        case XUART_PARITY_MARK : {
+            arg = LCR_PARITY_EN | LCR_PARITY_TYPE2;
+            break;
+        }
+        case XUART_PARITY_SPACE : {
+            arg = LCR_PARITY_EN | LCR_PARITY_TYPE1 | LCR_PARITY_TYPE2;
+            break;
+        }
         default : {                                                             /* Use default value and report warning                     */
             LOG_INFO("protocol: invalid parity");
             arg = 0;
@@ -738,9 +770,9 @@ int32_t lldProtocolSet(
     }
     lldModeSet(
         io,
-        tmp);
+        (enum lldMode)tmp);
 
-    return (0);
+    return (retval);
 }
 
 /*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
@@ -0,0 +1,1350 @@
+/*
+ * This file is part of x-16c750
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Virtual null-modem device pairs
+ * @details     Two devices of a pair are connected back to back. Bytes written
+ *              to one end are queued in its transmit buffer and moved to the
+ *              receive buffer of the other end by a timer, one character time
+ *              of the configured protocol after the previous byte. Reads and
+ *              writes follow the semantics of the hardware device.
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/init.h>
+#include <rtdm/rtdm_driver.h>
+
+#include "arch/compiler.h"
+#include "drv/x-16c750_vnm.h"
+#include "drv/x-16c750_cfg.h"
+#include "drv/x-16c750_ioctl.h"
+#include "drv/x-16c750_iov.h"
+#include "circbuff/circbuff.h"
+#include "dbg/dbg.h"
+#include "log.h"
+
+#if (0 != CFG_VNM_PAIRS)
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+#define DEF_VNM_VERSION_MAJOR           1
+#define DEF_VNM_VERSION_MINOR           0
+#define DEF_VNM_VERSION_PATCH           0
+#define DEF_VNM_AUTHOR                  "Nenad Radulovic <nenad.radulovic@netico-group.com>"
+#define DEF_VNM_DESCRIPTION             "Virtual null-modem device pairs"
+#define DEF_VNM_SUPP_DEVICE             "Virtual 16C750 null-modem pair"
+
+#define NS_PER_US                       1000
+#define NS_PER_MS                       1000000
+#define NS_PER_S                        1000000000U
+
+#define US_TO_NS(us)                    (NS_PER_US * (us))
+#define MS_TO_NS(ms)                    (NS_PER_MS * (ms))
+
+/**@brief       Number of registered devices, two per pair
+ */
+#define DEF_PORT_COUNT                  (2U * CFG_VNM_PAIRS)
+
+/**@brief       Highest accepted baud rate, keeps the character time above 0
+ */
+#define DEF_BAUD_MAX                    12000000U
+
+/**@brief       Error injection rates are given in parts per million
+ */
+#define DEF_PPM                         1000000U
+
+#define DEF_JITTER_MAX                  NS_PER_S
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+
+/**@brief       Receive or transmit buffer of a device
+ */
+struct vnmBuff {
+    circBuff_T          handle;
+    rtdm_sem_t          acc;                                                    /**<@brief Serializes readers or writers                    */
+    rtdm_event_t        opr;                                                    /**<@brief Signalled when @c pend bytes can be moved        */
+    size_t              pend;                                                   /**<@brief Bytes the waiting task needs, 0 when nobody waits*/
+    uint8_t             mem[CFG_DRV_BUFF_SIZE];
+};
+
+struct vnmPair;
+
+/**@brief       One end of a virtual null-modem cable
+ */
+struct vnmPort {
+    struct rtdm_device  dev;
+    struct vnmPair *    pair;
+    struct vnmPort *    peer;
+    struct vnmBuff      rx;
+    struct vnmBuff      tx;
+    rtdm_timer_t        timer;                                                  /**<@brief Delivers transmitted bytes to the receiver       */
+    nanosecs_abs_t      due;                                                    /**<@brief Time when the byte on the line is completely sent*/
+    nanosecs_abs_t      stamp;                                                  /**<@brief Time of the last received byte                   */
+    nanosecs_rel_t      charTime;
+    struct xUartProto   proto;
+    struct xUartVnm     line;
+    uint32_t            seed;                                                   /**<@brief State of the error injection generator           */
+    enum xUartStatus    status;
+    bool_T              isOpen;
+    bool_T              isPersistent;
+    bool_T              isLoopback;
+    bool_T              isRunning;                                              /**<@brief Delivery timer is armed                          */
+};
+
+struct vnmPair {
+    rtdm_lock_t         lock;                                                   /**<@brief Protects both ends of the pair                   */
+    struct vnmPort      port[2];
+};
+
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static uint32_t vnmRand(
+    struct vnmPort *    port);
+
+static bool_T vnmChance(
+    struct vnmPort *    port,
+    uint32_t            ppm);
+
+static bool_T vnmProtoIsValid(
+    const struct xUartProto * proto);
+
+static bool_T vnmProtoIsEqual(
+    const struct xUartProto * proto,
+    const struct xUartProto * other);
+
+/**@brief       Time needed to send one character, including start, parity and
+ *              stop bits
+ */
+static nanosecs_rel_t vnmCharTimeGet(
+    const struct xUartProto * proto);
+
+static void vnmProtoSetI(
+    struct vnmPort *    port,
+    const struct xUartProto * proto);
+
+static void vnmPortResetI(
+    struct vnmPort *    port);
+
+static struct vnmPort * vnmPortGet(
+    uint32_t            id);
+
+static struct vnmPort * vnmPortFromDevCtx(
+    struct rtdm_dev_context * devCtx);
+
+static int vnmPortInit(
+    uint32_t            id);
+
+static void vnmPortTerm(
+    uint32_t            id);
+
+/**@brief       Wake the task waiting on the buffer when @c avail bytes cover
+ *              its request
+ */
+static void vnmWakeI(
+    struct vnmBuff *    buff,
+    size_t              avail);
+
+static nanosecs_abs_t vnmExpiryGet(
+    struct vnmPort *    port,
+    nanosecs_abs_t      now);
+
+/**@brief       Start delivering the transmit buffer when the line is idle
+ */
+static void vnmTxStartI(
+    struct vnmPort *    port);
+
+/**@brief       Put one byte on the line
+ * @details     Applies error injection and stores the byte in the receive
+ *              buffer of the other end, or of the same end in loopback.
+ */
+static void vnmLineXferI(
+    struct vnmPort *    port,
+    uint8_t             item,
+    nanosecs_abs_t      now);
+
+static void vnmTimerHandler(
+    rtdm_timer_t *      timer);
+
+static ssize_t vnmXferRd(
+    struct vnmPort *    port,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   dst,
+    size_t              bytes);
+
+static ssize_t vnmXferWr(
+    struct vnmPort *    port,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   src,
+    size_t              bytes);
+
+static int vnmHandleOpen(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    int                 oflag);
+
+static int vnmHandleClose(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo);
+
+static int vnmHandleIOctl(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    unsigned int        req,
+    void __user *       mem);
+
+static ssize_t vnmHandleRd(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    void *              buff,
+    size_t              bytes);
+
+static ssize_t vnmHandleWr(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    const void *        buff,
+    size_t              bytes);
+
+static ssize_t vnmHandleRecvMsg(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    struct msghdr *     msg,
+    int                 flags);
+
+static ssize_t vnmHandleSendMsg(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    const struct msghdr * msg,
+    int                 flags);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+DECL_MODULE_INFO(CFG_DRV_NAME "-vnm", DEF_VNM_DESCRIPTION, DEF_VNM_AUTHOR);
+
+static const struct xUartProto VnmProtoDefault = {
+    .baud               = CFG_DEFAULT_BAUD_RATE,
+    .parity             = XUART_PARITY_NONE,
+    .dataBits           = XUART_DATA_8,
+    .stopBits           = XUART_STOP_1
+};
+
+/**@brief       Device template, name and id are set for every end
+ */
+static const struct rtdm_device VnmDev = {
+    .struct_version     = RTDM_DEVICE_STRUCT_VER,
+    .device_flags       = RTDM_NAMED_DEVICE,
+    .context_size       = sizeof(struct vnmPort *),
+    .device_name        = "",
+    .protocol_family    = 0,
+    .socket_type        = 0,
+    .open_rt            = NULL,
+    .open_nrt           = vnmHandleOpen,
+    .socket_rt          = NULL,
+    .socket_nrt         = NULL,
+    .ops                = {
+        .close_rt           = NULL,
+        .close_nrt          = vnmHandleClose,
+        .ioctl_rt           = vnmHandleIOctl,
+        .ioctl_nrt          = vnmHandleIOctl,
+        .select_bind        = NULL,
+        .read_rt            = vnmHandleRd,
+        .read_nrt           = NULL,
+        .write_rt           = vnmHandleWr,
+        .write_nrt          = NULL,
+        .recvmsg_rt         = vnmHandleRecvMsg,
+        .recvmsg_nrt        = NULL,
+        .sendmsg_rt         = vnmHandleSendMsg,
+        .sendmsg_nrt        = NULL
+    },
+    .device_class       = RTDM_CLASS_SERIAL,
+    .device_sub_class   = 0,
+    .profile_version    = 0,
+    .driver_name        = CFG_DRV_NAME "-vnm",
+    .driver_version     = RTDM_DRIVER_VER(DEF_VNM_VERSION_MAJOR, DEF_VNM_VERSION_MINOR, DEF_VNM_VERSION_PATCH),
+    .peripheral_name    = DEF_VNM_SUPP_DEVICE,
+    .provider_name      = DEF_VNM_AUTHOR,
+    .proc_name          = NULL,
+    .device_id          = 0,
+    .device_data        = NULL
+};
+
+static struct vnmPair   VnmPair[CFG_VNM_PAIRS];
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+
+#if (1 == CFG_VNM_STANDALONE)
+MODULE_LICENSE("GPL");
+MODULE_AUTHOR(DEF_VNM_AUTHOR);
+MODULE_DESCRIPTION(DEF_VNM_DESCRIPTION);
+MODULE_SUPPORTED_DEVICE(DEF_VNM_SUPP_DEVICE);
+#endif
+
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+/* Xorshift generator, every end has its own fixed seed so injected errors
+ * are reproducible from open to open                                         */
+static uint32_t vnmRand(
+    struct vnmPort *    port) {
+
+    uint32_t            tmp;
+
+    tmp  = port->seed;
+    tmp ^= tmp << 13;
+    tmp ^= tmp >> 17;
+    tmp ^= tmp << 5;
+    port->seed = tmp;
+
+    return (tmp);
+}
+
+static bool_T vnmChance(
+    struct vnmPort *    port,
+    uint32_t            ppm) {
+
+    if (0U == ppm) {
+
+        return (FALSE);
+    }
+
+    if ((vnmRand(port) % DEF_PPM) < ppm) {
+
+        return (TRUE);
+    } else {
+
+        return (FALSE);
+    }
+}
+
+static bool_T vnmProtoIsValid(
+    const struct xUartProto * proto) {
+
+    if ((0U == proto->baud) || (DEF_BAUD_MAX < proto->baud)) {
+
+        return (FALSE);
+    }
+
+    if (((uint32_t)XUART_PARITY_SPACE < (uint32_t)proto->parity) ||
+        ((uint32_t)XUART_DATA_5 < (uint32_t)proto->dataBits) ||
+        ((uint32_t)XUART_STOP_2 < (uint32_t)proto->stopBits)) {
+
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+static bool_T vnmProtoIsEqual(
+    const struct xUartProto * proto,
+    const struct xUartProto * other) {
+
+    if ((proto->baud     == other->baud)     &&
+        (proto->parity   == other->parity)   &&
+        (proto->dataBits == other->dataBits) &&
+        (proto->stopBits == other->stopBits)) {
+
+        return (TRUE);
+    } else {
+
+        return (FALSE);
+    }
+}
+
+static nanosecs_rel_t vnmCharTimeGet(
+    const struct xUartProto * proto) {
+
+    uint32_t            halfBits;
+
+    halfBits = 2U * (1U + ((XUART_DATA_5 == proto->dataBits) ? 5U : 8U));      /* Start and data bits                                      */
+
+    if (XUART_PARITY_NONE != proto->parity) {
+        halfBits += 2U;
+    }
+
+    switch (proto->stopBits) {
+        case XUART_STOP_1n5 : {
+            halfBits += 3U;
+            break;
+        }
+        case XUART_STOP_2 : {
+            halfBits += 4U;
+            break;
+        }
+        default : {
+            halfBits += 2U;
+        }
+    }
+
+    return ((nanosecs_rel_t)(((halfBits * (NS_PER_S / 20U)) / proto->baud) * 10U)); /* Stays within 32 bits, rounded to 10ns                */
+}
+
+static void vnmProtoSetI(
+    struct vnmPort *    port,
+    const struct xUartProto * proto) {
+
+    port->proto    = *proto;
+    port->charTime = vnmCharTimeGet(
+        proto);
+}
+
+static void vnmPortResetI(
+    struct vnmPort *    port) {
+
+    circFlush(
+        &port->rx.handle);
+    circFlush(
+        &port->tx.handle);
+    vnmProtoSetI(
+        port,
+        &VnmProtoDefault);
+    memset(
+        &port->line,
+        0,
+        sizeof(port->line));
+    port->due          = 0U;
+    port->stamp        = 0U;
+    port->seed         = (0x2545f491U + (uint32_t)port->dev.device_id * 0x9e3779b9U) | 1U;
+    port->status       = XUART_STATUS_NORMAL;
+    port->isPersistent = FALSE;
+    port->isLoopback   = FALSE;
+}
+
+static struct vnmPort * vnmPortGet(
+    uint32_t            id) {
+
+    ES_DBG_API_REQUIRE(ES_DBG_OUT_OF_RANGE, DEF_PORT_COUNT > id);
+
+    return (&VnmPair[id / 2U].port[id % 2U]);
+}
+
+static struct vnmPort * vnmPortFromDevCtx(
+    struct rtdm_dev_context * devCtx) {
+
+    return (*(struct vnmPort **)rtdm_context_to_private(devCtx));
+}
+
+static int vnmPortInit(
+    uint32_t            id) {
+
+    struct vnmPort *    port;
+    struct vnmPair *    pair;
+
+    pair = &VnmPair[id / 2U];
+    port = vnmPortGet(
+        id);
+
+    if (0U == (id % 2U)) {
+        rtdm_lock_init(
+            &pair->lock);
+    }
+    port->dev = VnmDev;
+    snprintf(
+        port->dev.device_name,
+        sizeof(port->dev.device_name),
+        CFG_DRV_NAME "-vnm%u%c",
+        (unsigned int)(id / 2U),
+        (0U == (id % 2U)) ? 'a' : 'b');
+    port->dev.proc_name   = port->dev.device_name;
+    port->dev.device_id   = (int)id;
+    port->dev.device_data = port;
+    port->pair = pair;
+    port->peer = &pair->port[(id % 2U) ^ 1U];
+    circInit(
+        &port->rx.handle,
+        port->rx.mem,
+        sizeof(port->rx.mem));
+    circInit(
+        &port->tx.handle,
+        port->tx.mem,
+        sizeof(port->tx.mem));
+    rtdm_sem_init(
+        &port->rx.acc,
+        1);
+    rtdm_sem_init(
+        &port->tx.acc,
+        1);
+    rtdm_event_init(
+        &port->rx.opr,
+        0);
+    rtdm_event_init(
+        &port->tx.opr,
+        0);
+    port->isOpen    = FALSE;
+    port->isRunning = FALSE;
+    vnmPortResetI(
+        port);
+
+    return (rtdm_timer_init(&port->timer, vnmTimerHandler, port->dev.device_name));
+}
+
+static void vnmPortTerm(
+    uint32_t            id) {
+
+    struct vnmPort *    port;
+
+    port = vnmPortGet(
+        id);
+    rtdm_timer_destroy(
+        &port->timer);
+    rtdm_event_destroy(
+        &port->tx.opr);
+    rtdm_event_destroy(
+        &port->rx.opr);
+    rtdm_sem_destroy(
+        &port->tx.acc);
+    rtdm_sem_destroy(
+        &port->rx.acc);
+}
+
+static void vnmWakeI(
+    struct vnmBuff *    buff,
+    size_t              avail) {
+
+    if ((0U != buff->pend) && (buff->pend <= avail)) {
+        buff->pend = 0U;
+        rtdm_event_signal(
+            &buff->opr);
+    }
+}
+
+/* Expire when the next byte is due, but not sooner than one tick from now so
+ * fast lines are served in batches. Jitter only delays delivery, the average
+ * rate is kept by the due time.                                              */
+static nanosecs_abs_t vnmExpiryGet(
+    struct vnmPort *    port,
+    nanosecs_abs_t      now) {
+
+    nanosecs_abs_t      expiry;
+
+    expiry = now + US_TO_NS(CFG_VNM_TICK_US);
+
+    if (expiry < port->due) {
+        expiry = port->due;
+    }
+
+    if (0U != port->line.jitter) {
+        expiry += vnmRand(port) % (port->line.jitter + 1U);
+    }
+
+    return (expiry);
+}
+
+static void vnmTxStartI(
+    struct vnmPort *    port) {
+
+    nanosecs_abs_t      now;
+
+    if (TRUE == port->isRunning) {
+
+        return;
+    }
+    now = rtdm_clock_read();
+
+    if (port->due < now) {                                                      /* Line was idle, the first byte starts now                 */
+        port->due = now;
+    }
+    port->due      += port->charTime;
+    port->isRunning = TRUE;
+    rtdm_timer_start(
+        &port->timer,
+        vnmExpiryGet(port, now),
+        0,
+        RTDM_TIMERMODE_ABSOLUTE);
+}
+
+static void vnmLineXferI(
+    struct vnmPort *    port,
+    uint8_t             item,
+    nanosecs_abs_t      now) {
+
+    struct vnmPort *    dst;
+
+    port->line.sent++;
+
+    if (TRUE == vnmChance(port, port->line.dropRate)) {
+        port->line.dropped++;
+
+        return;
+    }
+
+    if (TRUE == vnmChance(port, port->line.corruptRate)) {
+        item ^= (uint8_t)(1U << (vnmRand(port) % ((XUART_DATA_5 == port->proto.dataBits) ? 5U : 8U)));
+        port->line.corrupted++;
+    }
+    dst = (TRUE == port->isLoopback) ? port : port->peer;
+
+    if (FALSE == dst->isOpen) {                                                 /* Nobody is listening on the other end                     */
+
+        return;
+    }
+
+    if (FALSE == vnmProtoIsEqual(&port->proto, &dst->proto)) {
+        dst->line.mismatched++;
+
+        return;
+    }
+
+    if (0U == circFreeGet(&dst->rx.handle)) {
+        dst->line.overflows++;
+        dst->status = XUART_STATUS_SOFT_OVERFLOW;
+
+        return;
+    }
+
+    if (XUART_DATA_5 == port->proto.dataBits) {
+        item &= 0x1fU;
+    }
+    circItemPut(
+        &dst->rx.handle,
+        item);
+    dst->line.received++;
+    dst->stamp = now;
+    vnmWakeI(
+        &dst->rx,
+        circOccGet(&dst->rx.handle));
+}
+
+static void vnmTimerHandler(
+    rtdm_timer_t *      timer) {
+
+    struct vnmPort *    port;
+    nanosecs_abs_t      now;
+
+    port = container_of(timer, struct vnmPort, timer);
+    rtdm_lock_get(
+        &port->pair->lock);
+    now = rtdm_clock_read();
+
+    while ((FALSE == circIsEmpty(&port->tx.handle)) && (port->due <= now)) {
+        vnmLineXferI(
+            port,
+            circItemGet(&port->tx.handle),
+            now);
+
+        if (FALSE == circIsEmpty(&port->tx.handle)) {
+            port->due += port->charTime;
+        }
+    }
+    vnmWakeI(
+        &port->tx,
+        circFreeGet(&port->tx.handle));
+
+    if (TRUE == circIsEmpty(&port->tx.handle)) {
+        port->isRunning = FALSE;
+    } else {
+        rtdm_timer_start_in_handler(
+            timer,
+            vnmExpiryGet(port, now),
+            0,
+            RTDM_TIMERMODE_ABSOLUTE);
+    }
+    rtdm_lock_put(
+        &port->pair->lock);
+}
+
+static ssize_t vnmXferRd(
+    struct vnmPort *    port,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   dst,
+    size_t              bytes) {
+
+    rtdm_lockctx_t      lockCtx;
+    rtdm_toseq_t        tmSeq;
+    size_t              transfer;
+    size_t              read;
+    uint8_t *           tail;
+    bool_T              isExpired;
+    int                 retval;
+
+    retval = rtdm_sem_timeddown(
+        &port->rx.acc,
+        MS_TO_NS(CFG_TIMEOUT_MS),
+        NULL);
+
+    if (0 != retval) {
+        port->status = XUART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+    rtdm_toseq_init(
+        &tmSeq,
+        MS_TO_NS(CFG_TIMEOUT_MS));
+    read      = 0U;
+    isExpired = FALSE;
+    rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+
+    if (FALSE == port->isPersistent) {
+        circFlush(
+            &port->rx.handle);
+    }
+
+    while ((read < bytes) && (0 == retval)) {
+        transfer = min(bytes - read, circRemainingOccGet(&port->rx.handle));
+
+        if (0U != transfer) {
+            tail = circMemTailGet(
+                &port->rx.handle);
+            rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+            retval = ioCursorCopyTo(
+                dst,
+                usrInfo,
+                tail,
+                transfer);
+            rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+
+            if (0 == retval) {
+                circPosTailSet(
+                    &port->rx.handle,
+                    transfer);
+                read += transfer;
+            }
+        } else if (TRUE == isExpired) {                                         /* Return what was received so far                          */
+
+            break;
+        } else {
+            port->rx.pend = min(bytes - read, (size_t)(CFG_DRV_BUFF_SIZE - CFG_BUFF_BACKOFF));
+            rtdm_event_clear(
+                &port->rx.opr);
+            rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+            retval = rtdm_event_timedwait(
+                &port->rx.opr,
+                MS_TO_NS(CFG_TIMEOUT_MS),
+                &tmSeq);
+            rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+            port->rx.pend = 0U;
+
+            if (-ETIMEDOUT == retval) {
+                port->status = XUART_STATUS_TIMEOUT;
+                isExpired    = TRUE;
+                retval       = 0;
+            }
+        }
+    }
+    rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+    rtdm_sem_up(
+        &port->rx.acc);
+
+    if (0 != retval) {
+
+        return (retval);
+    }
+
+    return ((ssize_t)read);
+}
+
+static ssize_t vnmXferWr(
+    struct vnmPort *    port,
+    rtdm_user_info_t *  usrInfo,
+    struct ioCursor *   src,
+    size_t              bytes) {
+
+    rtdm_lockctx_t      lockCtx;
+    rtdm_toseq_t        tmSeq;
+    size_t              transfer;
+    size_t              written;
+    uint8_t *           head;
+    bool_T              isExpired;
+    int                 retval;
+
+    retval = rtdm_sem_timeddown(
+        &port->tx.acc,
+        MS_TO_NS(CFG_TIMEOUT_MS),
+        NULL);
+
+    if (0 != retval) {
+        port->status = XUART_STATUS_BUSY;
+
+        return (-EBUSY);
+    }
+    rtdm_toseq_init(
+        &tmSeq,
+        MS_TO_NS(CFG_TIMEOUT_MS));
+    written   = 0U;
+    isExpired = FALSE;
+    rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+
+    while ((written < bytes) && (0 == retval)) {
+        transfer = min(bytes - written, circRemainingFreeGet(&port->tx.handle));
+
+        if (0U != transfer) {
+            head = circMemHeadGet(
+                &port->tx.handle);
+            rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+            retval = ioCursorCopyFrom(
+                src,
+                usrInfo,
+                head,
+                transfer);
+            rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+
+            if (0 == retval) {
+                circPosHeadSet(
+                    &port->tx.handle,
+                    transfer);
+                written += transfer;
+                vnmTxStartI(
+                    port);
+            }
+        } else if (TRUE == isExpired) {
+
+            break;
+        } else {
+            port->tx.pend = min(bytes - written, (size_t)(CFG_DRV_BUFF_SIZE / 2U)); /* Refill in large chunks                                   */
+            rtdm_event_clear(
+                &port->tx.opr);
+            rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+            retval = rtdm_event_timedwait(
+                &port->tx.opr,
+                MS_TO_NS(CFG_TIMEOUT_MS),
+                &tmSeq);
+            rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+            port->tx.pend = 0U;
+
+            if (-ETIMEDOUT == retval) {
+                port->status = XUART_STATUS_TIMEOUT;
+                isExpired    = TRUE;
+                retval       = 0;
+            }
+        }
+    }
+    rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+    rtdm_sem_up(
+        &port->tx.acc);
+
+    if (0 != retval) {
+
+        return (retval);
+    }
+
+    return ((ssize_t)written);
+}
+
+static int vnmHandleOpen(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    int                 oflag) {
+
+    struct vnmPort *    port;
+    rtdm_lockctx_t      lockCtx;
+    int                 retval;
+
+    port   = (struct vnmPort *)devCtx->device->device_data;
+    retval = 0;
+    rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+
+    if (TRUE == port->isOpen) {
+        retval = -EBUSY;
+    } else {
+        port->isOpen = TRUE;
+        vnmPortResetI(
+            port);
+    }
+    rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+
+    if (0 == retval) {
+        *(struct vnmPort **)rtdm_context_to_private(devCtx) = port;
+    }
+
+    return (retval);
+}
+
+/* Bytes still waiting in the transmit buffer are discarded                   */
+static int vnmHandleClose(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo) {
+
+    struct vnmPort *    port;
+    rtdm_lockctx_t      lockCtx;
+
+    port = vnmPortFromDevCtx(
+        devCtx);
+    rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+    port->isOpen = FALSE;
+
+    if (TRUE == port->isRunning) {
+        rtdm_timer_stop(
+            &port->timer);
+        port->isRunning = FALSE;
+    }
+    circFlush(
+        &port->tx.handle);
+    circFlush(
+        &port->rx.handle);
+    rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+
+    return (0);
+}
+
+static int vnmHandleIOctl(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    unsigned int        req,
+    void __user *       mem) {
+
+    struct vnmPort *    port;
+    rtdm_lockctx_t      lockCtx;
+    int                 retval;
+
+    port   = vnmPortFromDevCtx(
+        devCtx);
+    retval = 0;
+
+    switch (req) {
+        case XUART_PROTOCOL_GET : {
+            struct xUartProto proto;
+
+            rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+            proto = port->proto;
+            rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_to_user(
+                    usrInfo,
+                    mem,
+                    &proto,
+                    sizeof(struct xUartProto));
+            } else {
+                memcpy(
+                    mem,
+                    &proto,
+                    sizeof(struct xUartProto));
+            }
+            break;
+        }
+        case XUART_PROTOCOL_SET : {
+            struct xUartProto proto;
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &proto,
+                    mem,
+                    sizeof(struct xUartProto));
+
+                if (0 != retval) {
+
+                    break;
+                }
+            } else {
+                memcpy(
+                    &proto,
+                    mem,
+                    sizeof(struct xUartProto));
+            }
+
+            if (FALSE == vnmProtoIsValid(&proto)) {
+                retval = -EINVAL;
+
+                break;
+            }
+            rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+            vnmProtoSetI(
+                port,
+                &proto);
+            rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+            break;
+        }
+        case XUART_RX_PERSIST : {
+            rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+            port->isPersistent = TRUE;
+            rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+            break;
+        }
+        case XUART_LOOPBACK_SET : {
+            uint32_t    isEnabled;
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &isEnabled,
+                    mem,
+                    sizeof(uint32_t));
+
+                if (0 != retval) {
+
+                    break;
+                }
+            } else {
+                memcpy(
+                    &isEnabled,
+                    mem,
+                    sizeof(uint32_t));
+            }
+            rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+            port->isLoopback = (0U != isEnabled) ? TRUE : FALSE;
+            rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+            break;
+        }
+        case XUART_VNM_GET : {
+            struct xUartVnm line;
+
+            rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+            line = port->line;
+            rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_to_user(
+                    usrInfo,
+                    mem,
+                    &line,
+                    sizeof(struct xUartVnm));
+            } else {
+                memcpy(
+                    mem,
+                    &line,
+                    sizeof(struct xUartVnm));
+            }
+            break;
+        }
+        case XUART_VNM_SET : {
+            struct xUartVnm line;
+
+            if (NULL != usrInfo) {
+                retval = rtdm_safe_copy_from_user(
+                    usrInfo,
+                    &line,
+                    mem,
+                    sizeof(struct xUartVnm));
+
+                if (0 != retval) {
+
+                    break;
+                }
+            } else {
+                memcpy(
+                    &line,
+                    mem,
+                    sizeof(struct xUartVnm));
+            }
+
+            if ((DEF_JITTER_MAX < line.jitter) || (DEF_PPM < line.corruptRate) || (DEF_PPM < line.dropRate)) {
+                retval = -EINVAL;
+
+                break;
+            }
+            rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+            port->line.jitter      = line.jitter;
+            port->line.corruptRate = line.corruptRate;
+            port->line.dropRate    = line.dropRate;
+            rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+            break;
+        }
+        default : {
+            retval = -ENOTSUPP;
+        }
+    }
+
+    return (retval);
+}
+
+static ssize_t vnmHandleRd(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    void *              buff,
+    size_t              bytes) {
+
+    struct vnmPort *    port;
+    struct ioCursor     dst;
+    struct iovec        iov;
+
+    port = vnmPortFromDevCtx(
+        devCtx);
+
+    if (NULL != usrInfo) {
+
+        if (0 == rtdm_rw_user_ok(usrInfo, buff, bytes)) {
+            port->status = XUART_STATUS_FAULT_USAGE;
+
+            return (-EFAULT);
+        }
+    }
+    iov.iov_base = buff;
+    iov.iov_len  = bytes;
+    ioCursorInit(
+        &dst,
+        &iov,
+        1U);
+
+    return (vnmXferRd(port, usrInfo, &dst, bytes));
+}
+
+static ssize_t vnmHandleWr(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    const void *        buff,
+    size_t              bytes) {
+
+    struct vnmPort *    port;
+    struct ioCursor     src;
+    struct iovec        iov;
+
+    port = vnmPortFromDevCtx(
+        devCtx);
+
+    if (NULL != usrInfo) {
+
+        if (0 == rtdm_read_user_ok(usrInfo, buff, bytes)) {
+            port->status = XUART_STATUS_FAULT_USAGE;
+
+            return (-EFAULT);
+        }
+    }
+    iov.iov_base = (void *)buff;
+    iov.iov_len  = bytes;
+    ioCursorInit(
+        &src,
+        &iov,
+        1U);
+
+    return (vnmXferWr(port, usrInfo, &src, bytes));
+}
+
+/* The receiver status reported in the sideband data covers everything since
+ * the previous recvmsg() call, it is cleared once reported                   */
+static ssize_t vnmHandleRecvMsg(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    struct msghdr *     msg,
+    int                 flags) {
+
+    struct vnmPort *    port;
+    struct ioCursor     dst;
+    struct iovec        iov[CFG_DRV_IOV_MAX];
+    ssize_t             retval;
+
+    (void)flags;
+    port   = vnmPortFromDevCtx(
+        devCtx);
+    retval = ioCursorFromMsg(
+        &dst,
+        iov,
+        usrInfo,
+        msg,
+        IO_DIR_RX);
+
+    if (0 > retval) {
+        port->status = XUART_STATUS_FAULT_USAGE;
+
+        return (retval);
+    }
+    retval = vnmXferRd(
+        port,
+        usrInfo,
+        &dst,
+        (size_t)retval);
+
+    if (0 > retval) {
+
+        return (retval);
+    }
+
+    if ((NULL != msg->msg_control) && (sizeof(struct xUartRxInfo) <= msg->msg_controllen)) {
+        struct xUartRxInfo  info;
+        rtdm_lockctx_t      lockCtx;
+        int                 status;
+
+        rtdm_lock_get_irqsave(&port->pair->lock, lockCtx);
+        info.timestamp = port->stamp;
+        info.status    = port->status;
+        port->status   = XUART_STATUS_NORMAL;
+        rtdm_lock_put_irqrestore(&port->pair->lock, lockCtx);
+        info.size      = (uint32_t)retval;
+        info.crc       = 0U;
+
+        if (NULL != usrInfo) {
+            status = rtdm_safe_copy_to_user(
+                usrInfo,
+                msg->msg_control,
+                &info,
+                sizeof(info));
+
+            if (0 != status) {
+
+                return (status);
+            }
+        } else {
+            memcpy(
+                msg->msg_control,
+                &info,
+                sizeof(info));
+        }
+        msg->msg_controllen = sizeof(info);
+    } else {
+        msg->msg_controllen = 0U;
+    }
+    msg->msg_flags = 0;
+
+    return (retval);
+}
+
+static ssize_t vnmHandleSendMsg(
+    struct rtdm_dev_context * devCtx,
+    rtdm_user_info_t *  usrInfo,
+    const struct msghdr * msg,
+    int                 flags) {
+
+    struct vnmPort *    port;
+    struct ioCursor     src;
+    struct iovec        iov[CFG_DRV_IOV_MAX];
+    ssize_t             retval;
+
+    (void)flags;
+    port   = vnmPortFromDevCtx(
+        devCtx);
+    retval = ioCursorFromMsg(
+        &src,
+        iov,
+        usrInfo,
+        msg,
+        IO_DIR_TX);
+
+    if (0 > retval) {
+        port->status = XUART_STATUS_FAULT_USAGE;
+
+        return (retval);
+    }
+
+    return (vnmXferWr(port, usrInfo, &src, (size_t)retval));
+}
+
+#if (1 == CFG_VNM_STANDALONE)
+static int __init vnmModuleInit(
+    void) {
+
+    LOG(DEF_VNM_DESCRIPTION);
+    LOG("version: %d.%d.%d", DEF_VNM_VERSION_MAJOR, DEF_VNM_VERSION_MINOR, DEF_VNM_VERSION_PATCH);
+
+    return (vnmInit());
+}
+
+static void __exit vnmModuleTerm(
+    void) {
+
+    LOG("removing virtual null-modem devices");
+    vnmTerm();
+}
+#endif
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+int vnmInit(
+    void) {
+
+    uint32_t            cnt;
+    int                 retval;
+
+    retval = 0;
+
+    for (cnt = 0U; cnt < DEF_PORT_COUNT; cnt++) {
+        struct vnmPort * port;
+
+        retval = vnmPortInit(
+            cnt);
+
+        if (0 != retval) {
+            LOG_ERR("failed to create virtual device %u, err: %d", (unsigned int)cnt, -retval);
+
+            break;
+        }
+        port = vnmPortGet(
+            cnt);
+        LOG_INFO("registering device: %s, id: %d", (char *)&port->dev.device_name, port->dev.device_id);
+        retval = rtdm_dev_register(
+            &port->dev);
+
+        if (0 != retval) {
+            LOG_ERR("failed to register to Real-Time DM, err: %d", -retval);
+            vnmPortTerm(
+                cnt);
+
+            break;
+        }
+    }
+
+    if (0 != retval) {
+
+        while (0U != cnt) {
+            cnt--;
+            rtdm_dev_unregister(
+                &vnmPortGet(cnt)->dev,
+                CFG_TIMEOUT_MS);
+            vnmPortTerm(
+                cnt);
+        }
+    }
+
+    return (retval);
+}
+
+void vnmTerm(
+    void) {
+
+    uint32_t            cnt;
+
+    for (cnt = 0U; cnt < DEF_PORT_COUNT; cnt++) {
+        int             retval;
+
+        retval = rtdm_dev_unregister(
+            &vnmPortGet(cnt)->dev,
+            CFG_TIMEOUT_MS);
+
+        if (0 != retval) {
+            LOG_ERR("failed to unregister device, err: %d", -retval);
+        }
+        vnmPortTerm(
+            cnt);
+    }
+}
+
+#if (1 == CFG_VNM_STANDALONE)
+void userAssert(
+    const struct esDbgReport * dbgReport) {
+
+    printk(KERN_ERR "\n ----\n");
+    printk(KERN_ERR DEF_VNM_DESCRIPTION " ASSERTION FAILED\n");
+    printk(KERN_ERR " Module name: %s\n", dbgReport->modName);
+    printk(KERN_ERR " Module file: %s\n", dbgReport->modFile);
+    printk(KERN_ERR " Function   : %s\n", dbgReport->fnName);
+    printk(KERN_ERR " Line       : %d\n", dbgReport->line);
+    printk(KERN_ERR " Expression : %s\n", dbgReport->expr);
+    printk(KERN_ERR " ----\n");
+}
+
+module_init(vnmModuleInit);
+module_exit(vnmModuleTerm);
+#endif
+
+#endif /* (0 != CFG_VNM_PAIRS) */
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+
+#if (1 == CFG_VNM_STANDALONE) && (0 == CFG_VNM_PAIRS)
+# error "x-16c750: CFG_VNM_STANDALONE requires CFG_VNM_PAIRS of at least 1"
+#endif
+
+/** @endcond *//** @} *//******************************************************
+ * END of x-16c750_vnm.c
+ ******************************************************************************/
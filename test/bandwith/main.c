@@ -28,6 +28,7 @@
 /*=========================================================  INCLUDE FILES  ==*/
 
 #include <time.h>
+#include <errno.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -45,6 +46,8 @@
 #include <native/heap.h>
 #include <rtdm/rtdm.h>
 
+#include "drv/x-16c750_ioctl.h"
+
 /*=========================================================  LOCAL MACRO's  ==*/
 
 #define CFG_DEVICE_DRIVER_NAME          "xuart"
@@ -53,10 +56,12 @@
 #define CFG_NUM_OF_TESTS                0UL
 #define CFG_LINES_PER_HEADER            20UL
 #define CFG_ALGORITHM                   0
+#define CFG_SWEEP_NUM_OF_TESTS          100UL
+#define CFG_SOAK_INTERVAL_S             60U
 
 #define APP_VER_MAJOR                   1U
-#define APP_VER_MINOR                   0U
-#define APP_VER_PATCH                   2U
+#define APP_VER_MINOR                   2U
+#define APP_VER_PATCH                   0U
 #define APP_NAME                        "RTDEV_bandwith"
 #define APP_DESC                        "Real-Time RTDEV driver latency tester"
 #define APP_MAINTAINER                  "Nenad Radulovic <nenad.b.radulovic@gmail.com>"
@@ -84,6 +89,11 @@
 #define RECV_PERIODIC                   1U
 #define DEF_RECV_RETRY_CNT              10U
 #define DEF_MAX_TEST_DATA_SIZE          HEAP_SIZE
+#define DEF_SWEEP_LIST_MAX              16U
+#define DEF_MAX_TX_PERIOD_MS            10000U
+#define DEF_SOAK_HDR_SIZE               8U                                      /* Sequence number and frame size                    */
+#define DEF_SOAK_CRC_SIZE               4U
+#define DEF_SOAK_MIN_FRAME              (DEF_SOAK_HDR_SIZE + DEF_SOAK_CRC_SIZE)
 
 /*-- FIXME: UART protocol defaults should go into driver configuration -------*/
 #define BAUD_RATE                       921600ULL
@@ -103,8 +113,23 @@
 #define NS_PER_S                        (MS_PER_S * NS_PER_MS)
 
 
-#define TRANSMISION_TIME(size)                                                  \
-    ((1000000000ULL * (uint64_t)(STOP_BITS + DATA_BITS + PARITY_BITS + 1ULL) * (uint64_t)(size)) / BAUD_RATE)
+#define CHAR_BITS                       (STOP_BITS + DATA_BITS + PARITY_BITS + 1ULL)
+
+#define TRANSMISION_TIME(baud, size)                                            \
+    ((1000000000ULL * CHAR_BITS * (uint64_t)(size)) / (uint64_t)(baud))
+
+#define SWEEP_CSV_HEADER                                                        \
+    "size,baud,period_ms,pattern,runs,errors,throughput,efficiency,"            \
+    "lat_min_us,lat_p50_us,lat_p90_us,lat_p99_us,lat_max_us,cpu_send,cpu_recv\n"
+
+#define SOAK_CSV_HEADER                                                         \
+    "elapsed_s,frames,bytes,throughput,lat_p50_us,lat_p99_us,lat_max_us,"      \
+    "drift_pct,overflow,short,sequence,crc,io\n"
+
+#define SOAK_TABLE_HEADER                                                                                   \
+    "-----------------------------------------------------------------------------------------------------------\n" \
+    "  Elapsed   |   Frames   | Rate B/s |   p50   |   p99   |   max   | Drift |  Ovf  | Short |  Seq  |  CRC  |  IO  |\n" \
+    "-----------------------------------------------------------------------------------------------------------\n"
 
 #define BEFORE_DECIMAL(val)                                                     \
     ((val) / 1000ULL)
@@ -188,6 +213,57 @@ struct meas {
     RTIME               max;
 };
 
+enum outFormat {
+    OUT_TABLE,
+    OUT_CSV,
+    OUT_JSON
+};
+
+struct sweepList {
+    uint32_t            item[DEF_SWEEP_LIST_MAX];
+    uint32_t            count;
+};
+
+/* One output row of the sweep mode, ratios are in per mille                 */
+struct sweepRow {
+    uint32_t            runs;
+    uint32_t            errors;
+    uint64_t            throughput;
+    uint64_t            efficiency;
+    RTIME               min;
+    RTIME               p50;
+    RTIME               p90;
+    RTIME               p99;
+    RTIME               max;
+    uint64_t            cpuSend;
+    uint64_t            cpuRecv;
+};
+
+/* Frame counters of the soak mode, each failed frame is counted once        */
+struct soakCount {
+    uint64_t            frames;
+    uint64_t            bytes;
+    uint32_t            overflow;                                               /* Soft overflow reported by the driver              */
+    uint32_t            shortFrame;                                             /* Fewer bytes received than sent                    */
+    uint32_t            sequence;                                               /* Valid CRC, wrong sequence number or size          */
+    uint32_t            crc;
+    uint32_t            io;                                                     /* Read call failed                                  */
+};
+
+struct soakState {
+    struct soakCount    count;
+    uint64_t            windowBytes;
+    size_t              windowSamples;
+    RTIME               begin;
+    RTIME               windowBegin;
+    RTIME               latMax;
+    RTIME               refP99;                                                 /* p99 of the first snapshot, reference for drift    */
+    int64_t             driftWorst;
+    uint32_t            seed;
+    uint32_t            snapshots;
+    volatile bool       isDone;
+};
+
 struct appConfig {
     size_t              testDataSize;
     RTIME               txPeriod;
@@ -195,7 +271,25 @@ struct appConfig {
     uint32_t            linesPerHeader;
     uint32_t            taskStats;
     uint32_t            algo;
+    uint32_t            baud;
     bool                dumpBuff;
+    enum outFormat      format;
+    const char *        outFile;
+    struct sweepConfig {
+        struct sweepList    size;
+        struct sweepList    baud;
+        struct sweepList    period;                                             /* Transmission periods in ms                        */
+        struct sweepList    algo;
+    }                   sweep;
+    struct soakConfig {
+        size_t              maxSize;
+        uint32_t            duration;                                           /* Seconds, 0 runs until stopped                     */
+        uint32_t            interval;                                           /* Seconds between snapshots                         */
+        uint32_t            maxErrors;
+        uint32_t            maxDrift;                                           /* Percent of p99, 0 disables the check              */
+        uint32_t            seed;
+        bool                isEnabled;
+    }                   soak;
 };
 
 enum appBootState {
@@ -229,6 +323,55 @@ static void taskRecv(
 static void taskPrint(
     void *              arg);
 
+static void taskSweep(
+    void *              arg);
+
+static int sweepPoint(
+    struct sweepRow *   row);
+
+static void sweepRowPrint(
+    const struct sweepRow * row);
+
+static int sweepListParse(
+    struct sweepList *  list,
+    const char *        str,
+    uint32_t            min,
+    uint32_t            max);
+
+static void sweepListDefault(
+    struct sweepList *  list,
+    uint32_t            value);
+
+static void taskSoak(
+    void *              arg);
+
+static int soakFrameRecv(
+    uint32_t            seq);
+
+static void soakFrameBuild(
+    uint8_t *           buff,
+    size_t              size,
+    uint32_t            seq);
+
+static void soakSnapshot(
+    RTIME               now);
+
+static uint32_t soakErrors(
+    void);
+
+static bool soakIsPassed(
+    void);
+
+static void soakReport(
+    void);
+
+static int measCmp(
+    const void *        a,
+    const void *        b);
+
+static int protocolSet(
+    uint32_t            baud);
+
 static void measInit(
     struct meas *       meas);
 
@@ -246,6 +389,17 @@ static uint32_t dataIsValid(
     const void *        dst,
     size_t              size);
 
+static uint32_t crc32Calc(
+    const uint8_t *     src,
+    size_t              size);
+
+static void put32(
+    uint8_t *           dst,
+    uint32_t            value);
+
+static uint32_t get32(
+    const uint8_t *     src);
+
 static int appInit(
     void);
 
@@ -276,6 +430,19 @@ static void *           RxBuff;
 
 static volatile struct timeMeas Time;
 
+static FILE *           Out;
+static RTIME *          Lat;
+static size_t           LatSize;
+
+static struct soakState Soak;
+
+static const char * const DataTypeName[] = {
+    "linear",
+    "zero",
+    "one",
+    "random"
+};
+
 static enum appBootState AppBootState;
 
 static struct appConfig AppConfig = {
@@ -285,7 +452,13 @@ static struct appConfig AppConfig = {
     .linesPerHeader     = CFG_LINES_PER_HEADER,
     .taskStats          = 0,
     .algo               = CFG_ALGORITHM,
-    .dumpBuff           = false
+    .baud               = BAUD_RATE,
+    .dumpBuff           = false,
+    .format             = OUT_TABLE,
+    .outFile            = NULL,
+    .soak               = {
+        .interval       = CFG_SOAK_INTERVAL_S
+    }
 };
 
 /*======================================================  GLOBAL VARIABLES  ==*/
@@ -323,10 +496,12 @@ static void taskSend(
 
     (void)arg;
 
-    dataGen(
-        AppConfig.algo,
-        TxBuff,
-        AppConfig.testDataSize);
+    if ((OUT_TABLE == AppConfig.format) && (false == AppConfig.soak.isEnabled)) {  /* Sweep and soak tasks generate their own data   */
+        dataGen(
+            AppConfig.algo,
+            TxBuff,
+            AppConfig.testDataSize);
+    }
 
     while (true) {
         ssize_t len;
@@ -595,6 +770,590 @@ static void taskPrint(
     }
 }
 
+static void taskSweep(
+    void *              arg) {
+
+    uint32_t            baud;
+    uint32_t            size;
+    uint32_t            period;
+    uint32_t            algo;
+
+    (void)arg;
+
+    if (OUT_CSV == AppConfig.format) {
+        fprintf(Out, SWEEP_CSV_HEADER);
+    }
+
+    for (baud = 0U; baud < AppConfig.sweep.baud.count; baud++) {
+        int             retval;
+
+        AppConfig.baud = AppConfig.sweep.baud.item[baud];
+        retval = protocolSet(
+            AppConfig.baud);
+
+        if (0 != retval) {
+            LOG_ERR("protocol set, baud %u, err: %s", AppConfig.baud, strerror(-retval));
+
+            break;
+        }
+
+        for (size = 0U; size < AppConfig.sweep.size.count; size++) {
+
+            for (period = 0U; period < AppConfig.sweep.period.count; period++) {
+
+                for (algo = 0U; algo < AppConfig.sweep.algo.count; algo++) {
+                    struct sweepRow row;
+
+                    AppConfig.testDataSize = AppConfig.sweep.size.item[size];
+                    AppConfig.txPeriod     = MS_TO_NS((RTIME)AppConfig.sweep.period.item[period]);
+                    AppConfig.algo         = AppConfig.sweep.algo.item[algo];
+                    retval = sweepPoint(
+                        &row);
+
+                    if (0 != retval) {
+
+                        return;                                                 /* Device was closed, application is exiting         */
+                    }
+                    sweepRowPrint(
+                        &row);
+                }
+            }
+        }
+    }
+    fflush(
+        Out);
+    kill(
+        getpid(),
+        SIGTERM);
+}
+
+static int sweepPoint(
+    struct sweepRow *   row) {
+
+    RT_TASK_INFO        sendBegin;
+    RT_TASK_INFO        recvBegin;
+    RT_TASK_INFO        sendEnd;
+    RT_TASK_INFO        recvEnd;
+    RTIME               begin;
+    RTIME               next;
+    RTIME               busy;
+    RTIME               elapsed;
+    uint64_t            bytes;
+    uint32_t            run;
+
+    dataGen(
+        AppConfig.algo,
+        TxBuff,
+        AppConfig.testDataSize);
+    memset(
+        row,
+        0,
+        sizeof(*row));
+    rt_task_inquire(
+        &TaskSend,
+        &sendBegin);
+    rt_task_inquire(
+        &TaskRecv,
+        &recvBegin);
+    busy  = 0U;
+    bytes = 0U;
+    begin = rt_timer_read();
+    next  = begin;
+
+    for (run = 0U; run < AppConfig.numOfTests; run++) {
+        ssize_t         len;
+        RTIME           rxEnd;
+
+        rt_task_sleep_until(                                                    /* Returns at once when the previous run overran     */
+            next);
+        next += AppConfig.txPeriod;
+        rt_sem_v(
+            &SemSend);
+        len = rt_dev_read(
+            UARTDevice,
+            RxBuff,
+            AppConfig.testDataSize);
+        rxEnd = rt_timer_read();
+
+        if (-EIDRM == len) {
+
+            return ((int)len);
+        }
+        Lat[run] = (RTIME)ABS64((int64_t)rxEnd - (int64_t)Time.txBegin);
+        busy    += Lat[run];
+
+        if (0 < len) {
+            bytes += (uint64_t)len;
+        }
+
+        if ((len != (ssize_t)AppConfig.testDataSize) ||
+            (0U != dataIsValid(TxBuff, RxBuff, AppConfig.testDataSize))) {
+            row->errors++;
+        }
+        memset(
+            RxBuff,
+            0,
+            AppConfig.testDataSize);
+    }
+    elapsed = rt_timer_read() - begin;
+    rt_task_inquire(
+        &TaskSend,
+        &sendEnd);
+    rt_task_inquire(
+        &TaskRecv,
+        &recvEnd);
+    qsort(
+        Lat,
+        run,
+        sizeof(RTIME),
+        measCmp);
+    row->runs       = run;
+    row->throughput = (0U != busy) ? (bytes * NS_PER_S) / busy : 0U;
+    row->efficiency = (row->throughput * CHAR_BITS * 1000ULL) / AppConfig.baud;
+    row->min        = Lat[0];
+    row->p50        = Lat[((run - 1U) * 500U) / 1000U];
+    row->p90        = Lat[((run - 1U) * 900U) / 1000U];
+    row->p99        = Lat[((run - 1U) * 990U) / 1000U];
+    row->max        = Lat[run - 1U];
+    row->cpuSend    = ((sendEnd.exectime - sendBegin.exectime) * 1000ULL) / elapsed;
+    row->cpuRecv    = ((recvEnd.exectime - recvBegin.exectime) * 1000ULL) / elapsed;
+
+    return (0);
+}
+
+static void sweepRowPrint(
+    const struct sweepRow * row) {
+
+    const char *        format;
+
+    if (OUT_CSV == AppConfig.format) {
+        format = "%zu,%u,%llu,%s,%u,%u,%llu,%llu.%llu,"
+            "%llu.%llu,%llu.%llu,%llu.%llu,%llu.%llu,%llu.%llu,"
+            "%llu.%llu,%llu.%llu\n";
+    } else {
+        format = "{\"size\":%zu,\"baud\":%u,\"period_ms\":%llu,\"pattern\":\"%s\",\"runs\":%u,\"errors\":%u,"
+            "\"throughput\":%llu,\"efficiency\":%llu.%llu,"
+            "\"lat_us\":{\"min\":%llu.%llu,\"p50\":%llu.%llu,\"p90\":%llu.%llu,\"p99\":%llu.%llu,\"max\":%llu.%llu},"
+            "\"cpu_send\":%llu.%llu,\"cpu_recv\":%llu.%llu}\n";
+    }
+    fprintf(Out, format,
+        AppConfig.testDataSize,
+        AppConfig.baud,
+        NS_TO_MS(AppConfig.txPeriod),
+        DataTypeName[AppConfig.algo],
+        row->runs,
+        row->errors,
+        row->throughput,
+        row->efficiency / 10ULL,
+        row->efficiency % 10ULL,
+        BEFORE_DECIMAL(row->min),
+        AFTER_DECIMAL(row->min),
+        BEFORE_DECIMAL(row->p50),
+        AFTER_DECIMAL(row->p50),
+        BEFORE_DECIMAL(row->p90),
+        AFTER_DECIMAL(row->p90),
+        BEFORE_DECIMAL(row->p99),
+        AFTER_DECIMAL(row->p99),
+        BEFORE_DECIMAL(row->max),
+        AFTER_DECIMAL(row->max),
+        row->cpuSend / 10ULL,
+        row->cpuSend % 10ULL,
+        row->cpuRecv / 10ULL,
+        row->cpuRecv % 10ULL);
+    fflush(
+        Out);
+}
+
+static int sweepListParse(
+    struct sweepList *  list,
+    const char *        str,
+    uint32_t            min,
+    uint32_t            max) {
+
+    list->count = 0U;
+
+    while ('\0' != *str) {
+        char *          end;
+        unsigned long   value;
+
+        if (DEF_SWEEP_LIST_MAX == list->count) {
+
+            return (-1);
+        }
+        value = strtoul(str, &end, 0);
+
+        if ((end == str) || (min > value) || (max < value) || ((',' != *end) && ('\0' != *end))) {
+
+            return (-1);
+        }
+        list->item[list->count++] = (uint32_t)value;
+        str = (',' == *end) ? end + 1 : end;
+    }
+
+    return ((0U == list->count) ? -1 : 0);
+}
+
+static void sweepListDefault(
+    struct sweepList *  list,
+    uint32_t            value) {
+
+    if (0U == list->count) {
+        list->item[0] = value;
+        list->count   = 1U;
+    }
+}
+
+static void taskSoak(
+    void *              arg) {
+
+    RTIME               next;
+    RTIME               end;
+    RTIME               snapshot;
+    uint32_t            seq;
+
+    (void)arg;
+
+    if (OUT_CSV == AppConfig.format) {
+        fprintf(Out, SOAK_CSV_HEADER);
+    }
+    Soak.seed        = AppConfig.soak.seed;
+    Soak.begin       = rt_timer_read();
+    Soak.windowBegin = Soak.begin;
+    end              = Soak.begin + SEC_TO_NS((RTIME)AppConfig.soak.duration);
+    snapshot         = Soak.begin + SEC_TO_NS((RTIME)AppConfig.soak.interval);
+    next             = Soak.begin;
+
+    for (seq = 0U; (0U == AppConfig.soak.duration) || (next < end); seq++) {
+        RTIME           now;
+
+        rt_task_sleep_until(
+            next);
+        AppConfig.testDataSize = DEF_SOAK_MIN_FRAME +
+            (size_t)rand_r(&Soak.seed) % (AppConfig.soak.maxSize - DEF_SOAK_MIN_FRAME + 1U);
+        soakFrameBuild(
+            TxBuff,
+            AppConfig.testDataSize,
+            seq);
+
+        if (0 != soakFrameRecv(seq)) {
+
+            return;                                                             /* Device was closed, application is exiting         */
+        }
+        now  = rt_timer_read();
+        next = now + US_TO_NS((RTIME)((uint32_t)rand_r(&Soak.seed) % (uint32_t)(NS_TO_US(AppConfig.txPeriod) + 1U)));
+
+        if (now >= snapshot) {
+            soakSnapshot(
+                now);
+            snapshot = now + SEC_TO_NS((RTIME)AppConfig.soak.interval);
+        }
+    }
+
+    if (0U != Soak.count.frames) {
+        soakSnapshot(
+            rt_timer_read());
+    }
+    soakReport();
+    kill(
+        getpid(),
+        SIGTERM);
+}
+
+/*
+ * Transmits the frame prepared in TxBuff and classifies the response. Each
+ * read starts with flushed receive buffers, so a failed frame does not spill
+ * over into the next one.
+ */
+static int soakFrameRecv(
+    uint32_t            seq) {
+
+    struct xUartRxInfo  info;
+    struct iovec        iov;
+    struct msghdr       msg;
+    ssize_t             len;
+    RTIME               rxEnd;
+    size_t              size;
+
+    size = AppConfig.testDataSize;
+    memset(
+        &msg,
+        0,
+        sizeof(msg));
+    iov.iov_base       = RxBuff;
+    iov.iov_len        = size;
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = &info;
+    msg.msg_controllen = sizeof(info);
+    info.status        = XUART_STATUS_NORMAL;
+    rt_sem_v(
+        &SemSend);
+    len = rt_dev_recvmsg(
+        UARTDevice,
+        &msg,
+        0);
+    rxEnd = rt_timer_read();
+
+    if ((-EIDRM == len) || (-EBADF == len)) {
+
+        return ((int)len);
+    }
+    Soak.count.frames++;
+
+    if (0 > len) {
+        Soak.count.io++;
+
+        return (0);
+    }
+    Soak.count.bytes += (uint64_t)len;
+    Soak.windowBytes += (uint64_t)len;
+
+    if ((0U != msg.msg_controllen) && (XUART_STATUS_SOFT_OVERFLOW == info.status)) {
+        Soak.count.overflow++;
+    } else if (len != (ssize_t)size) {
+        Soak.count.shortFrame++;
+    } else if (crc32Calc(RxBuff, size - DEF_SOAK_CRC_SIZE) != get32((uint8_t *)RxBuff + size - DEF_SOAK_CRC_SIZE)) {
+        Soak.count.crc++;
+    } else if ((seq != get32(RxBuff)) || ((uint32_t)size != get32((uint8_t *)RxBuff + 4))) {
+        Soak.count.sequence++;
+    } else {
+        RTIME           lat;
+
+        lat = (RTIME)ABS64((int64_t)rxEnd - (int64_t)Time.txBegin);
+
+        if (Soak.windowSamples < LatSize) {
+            Lat[Soak.windowSamples++] = lat;
+        }
+
+        if (Soak.latMax < lat) {
+            Soak.latMax = lat;
+        }
+    }
+
+    return (0);
+}
+
+/* Frame: sequence number, frame size, random payload, CRC-32 of the rest     */
+static void soakFrameBuild(
+    uint8_t *           buff,
+    size_t              size,
+    uint32_t            seq) {
+
+    size_t              cnt;
+
+    put32(
+        &buff[0],
+        seq);
+    put32(
+        &buff[4],
+        (uint32_t)size);
+
+    for (cnt = DEF_SOAK_HDR_SIZE; cnt < (size - DEF_SOAK_CRC_SIZE); cnt++) {
+        buff[cnt] = (uint8_t)rand_r(&Soak.seed);
+    }
+    put32(
+        &buff[size - DEF_SOAK_CRC_SIZE],
+        crc32Calc(buff, size - DEF_SOAK_CRC_SIZE));
+}
+
+static void soakSnapshot(
+    RTIME               now) {
+
+    const char *        format;
+    RTIME               elapsed;
+    RTIME               window;
+    RTIME               p50;
+    RTIME               p99;
+    RTIME               max;
+    uint64_t            rate;
+    int64_t             drift;
+    size_t              samples;
+
+    samples = Soak.windowSamples;
+    p50     = 0U;
+    p99     = 0U;
+    max     = 0U;
+    drift   = 0;
+
+    if (0U != samples) {
+        qsort(
+            Lat,
+            samples,
+            sizeof(RTIME),
+            measCmp);
+        p50 = Lat[((samples - 1U) * 500U) / 1000U];
+        p99 = Lat[((samples - 1U) * 990U) / 1000U];
+        max = Lat[samples - 1U];
+
+        if (0U == Soak.refP99) {
+            Soak.refP99 = p99;
+        }
+        drift = (((int64_t)p99 - (int64_t)Soak.refP99) * 100) / (int64_t)Soak.refP99;
+
+        if (ABS64(drift) > ABS64(Soak.driftWorst)) {
+            Soak.driftWorst = drift;
+        }
+    }
+    elapsed = NS_TO_MS(now - Soak.begin) / MS_PER_S;
+    window  = now - Soak.windowBegin;
+    rate    = (0U != window) ? (Soak.windowBytes * NS_PER_S) / window : 0U;
+
+    if (OUT_TABLE == AppConfig.format) {
+
+        if ((0U != AppConfig.linesPerHeader) && (0U == (Soak.snapshots % AppConfig.linesPerHeader))) {
+            fprintf(Out, SOAK_TABLE_HEADER);
+        }
+        fprintf(Out, " %4llu:%02llu:%02llu | %10llu | %8llu | %5llu.%llu | %5llu.%llu | %5llu.%llu | %+4lld%% | %5u | %5u | %5u | %5u | %4u |\n",
+            elapsed / 3600U,
+            (elapsed / 60U) % 60U,
+            elapsed % 60U,
+            (unsigned long long)Soak.count.frames,
+            (unsigned long long)rate,
+            BEFORE_DECIMAL(p50),
+            AFTER_DECIMAL(p50),
+            BEFORE_DECIMAL(p99),
+            AFTER_DECIMAL(p99),
+            BEFORE_DECIMAL(max),
+            AFTER_DECIMAL(max),
+            (long long)drift,
+            Soak.count.overflow,
+            Soak.count.shortFrame,
+            Soak.count.sequence,
+            Soak.count.crc,
+            Soak.count.io);
+    } else {
+
+        if (OUT_CSV == AppConfig.format) {
+            format = "%llu,%llu,%llu,%llu,%llu.%llu,%llu.%llu,%llu.%llu,%lld,%u,%u,%u,%u,%u\n";
+        } else {
+            format = "{\"elapsed_s\":%llu,\"frames\":%llu,\"bytes\":%llu,\"throughput\":%llu,"
+                "\"lat_us\":{\"p50\":%llu.%llu,\"p99\":%llu.%llu,\"max\":%llu.%llu},\"drift_pct\":%lld,"
+                "\"errors\":{\"overflow\":%u,\"short\":%u,\"sequence\":%u,\"crc\":%u,\"io\":%u}}\n";
+        }
+        fprintf(Out, format,
+            elapsed,
+            (unsigned long long)Soak.count.frames,
+            (unsigned long long)Soak.count.bytes,
+            (unsigned long long)rate,
+            BEFORE_DECIMAL(p50),
+            AFTER_DECIMAL(p50),
+            BEFORE_DECIMAL(p99),
+            AFTER_DECIMAL(p99),
+            BEFORE_DECIMAL(max),
+            AFTER_DECIMAL(max),
+            (long long)drift,
+            Soak.count.overflow,
+            Soak.count.shortFrame,
+            Soak.count.sequence,
+            Soak.count.crc,
+            Soak.count.io);
+    }
+    fflush(
+        Out);
+    Soak.snapshots++;
+    Soak.windowBytes   = 0U;
+    Soak.windowSamples = 0U;
+    Soak.windowBegin   = now;
+}
+
+static uint32_t soakErrors(
+    void) {
+
+    return (Soak.count.overflow + Soak.count.shortFrame + Soak.count.sequence + Soak.count.crc + Soak.count.io);
+}
+
+static bool soakIsPassed(
+    void) {
+
+    if ((0U == Soak.count.frames) || (AppConfig.soak.maxErrors < soakErrors())) {
+
+        return (false);
+    }
+
+    if ((0U != AppConfig.soak.maxDrift) && ((int64_t)AppConfig.soak.maxDrift < ABS64(Soak.driftWorst))) {
+
+        return (false);
+    }
+
+    return (true);
+}
+
+static void soakReport(
+    void) {
+
+    bool                isPassed;
+
+    if (true == Soak.isDone) {
+
+        return;
+    }
+    Soak.isDone = true;
+    isPassed    = soakIsPassed();
+    printf("\n### Soak summary\n");
+    printf(" - duration            : %llu s\n", NS_TO_MS(rt_timer_read() - Soak.begin) / MS_PER_S);
+    printf(" - frames              : %llu, %llu bytes\n", (unsigned long long)Soak.count.frames, (unsigned long long)Soak.count.bytes);
+    printf(" - errors              : %u, allowed %u\n", soakErrors(), AppConfig.soak.maxErrors);
+    printf("   overflow            : %u\n", Soak.count.overflow);
+    printf("   short               : %u\n", Soak.count.shortFrame);
+    printf("   sequence            : %u\n", Soak.count.sequence);
+    printf("   crc                 : %u\n", Soak.count.crc);
+    printf("   io                  : %u\n", Soak.count.io);
+    printf(" - max latency         : %llu.%llu us\n", BEFORE_DECIMAL(Soak.latMax), AFTER_DECIMAL(Soak.latMax));
+    printf(" - worst p99 drift     : %+lld%%, allowed %u%%\n", (long long)Soak.driftWorst, AppConfig.soak.maxDrift);
+    printf(" Verdict: %s\n\n", (true == isPassed) ? COLOR_GREEN "PASS" COLOR_WHITE : COLOR_RED "FAIL" COLOR_WHITE);
+
+    if (OUT_JSON == AppConfig.format) {
+        fprintf(Out, "{\"verdict\":\"%s\",\"frames\":%llu,\"errors\":%u,\"lat_max_us\":%llu.%llu,\"drift_worst_pct\":%lld}\n",
+            (true == isPassed) ? "pass" : "fail",
+            (unsigned long long)Soak.count.frames,
+            soakErrors(),
+            BEFORE_DECIMAL(Soak.latMax),
+            AFTER_DECIMAL(Soak.latMax),
+            (long long)Soak.driftWorst);
+    }
+    fflush(
+        Out);
+    fflush(
+        stdout);
+}
+
+static int measCmp(
+    const void *        a,
+    const void *        b) {
+
+    RTIME               left;
+    RTIME               right;
+
+    left  = *(const RTIME *)a;
+    right = *(const RTIME *)b;
+
+    return ((left > right) - (left < right));
+}
+
+static int protocolSet(
+    uint32_t            baud) {
+
+    struct xUartProto   proto;
+    int                 retval;
+
+    retval = rt_dev_ioctl(
+        UARTDevice,
+        XUART_PROTOCOL_GET,
+        &proto);
+
+    if (0 != retval) {
+
+        return (retval);
+    }
+    proto.baud = baud;
+    retval = rt_dev_ioctl(
+        UARTDevice,
+        XUART_PROTOCOL_SET,
+        &proto);
+
+    return (retval);
+}
+
 static void measInit(
     struct meas *       meas) {
     meas->cnt  = 0UL;
@@ -702,6 +1461,44 @@ static uint32_t dataIsValid(
     return (cnt);
 }
 
+/* CRC-32 (IEEE 802.3), bitwise: frames are short and the line is slow       */
+static uint32_t crc32Calc(
+    const uint8_t *     src,
+    size_t              size) {
+
+    uint32_t            crc;
+
+    crc = 0xffffffffU;
+
+    while (0U != size--) {
+        uint32_t        bit;
+
+        crc ^= *src++;
+
+        for (bit = 0U; bit < 8U; bit++) {
+            crc = (crc >> 1) ^ (0xedb88320U & (0U - (crc & 1U)));
+        }
+    }
+
+    return (~crc);
+}
+
+static void put32(
+    uint8_t *           dst,
+    uint32_t            value) {
+
+    dst[0] = (uint8_t)(value >>  0);
+    dst[1] = (uint8_t)(value >>  8);
+    dst[2] = (uint8_t)(value >> 16);
+    dst[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get32(
+    const uint8_t *     src) {
+
+    return ((uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24));
+}
+
 static int appInit(
     void) {
 
@@ -719,6 +1516,14 @@ static int appInit(
 
         return (UARTDevice);
     }
+    retval = protocolSet(
+        AppConfig.baud);
+
+    if (0 != retval) {
+        LOG_ERR("failed to set baud rate %u, err: %s", AppConfig.baud, strerror(-retval));
+
+        return (retval);
+    }
 
     /*-- BOOT_CREATE_TX ------------------------------------------------------*/
     AppBootState = BOOT_CREATE_TX;
@@ -860,7 +1665,7 @@ static int appInit(
     LOG_INFO("start task : %s", TASK_RECV_NAME);
     retval = rt_task_start(
         &TaskRecv,
-        taskRecv,
+        (true == AppConfig.soak.isEnabled) ? taskSoak : ((OUT_TABLE == AppConfig.format) ? taskRecv : taskSweep),
         NULL);
 
     if (0 != retval) {
@@ -976,7 +1781,26 @@ static void appPrintConfig(
     printf(" - lines per header    : %u\n", AppConfig.linesPerHeader);
     printf(" - num of tests        : %u\n", AppConfig.numOfTests);
     printf(" - tasks statistics    : %u\n", AppConfig.taskStats);
-    printf(" - algorithm           : %u\n\n", AppConfig.algo);
+    printf(" - algorithm           : %u\n", AppConfig.algo);
+    printf(" - baud rate           : %u\n\n", AppConfig.baud);
+
+    if (true == AppConfig.soak.isEnabled) {
+        printf(" - soak duration       : %u s%s\n",
+            AppConfig.soak.duration,
+            (0U == AppConfig.soak.duration) ? ", until stopped" : "");
+        printf(" - snapshot interval   : %u s\n", AppConfig.soak.interval);
+        printf(" - frame size          : %u - %zu bytes\n", DEF_SOAK_MIN_FRAME, AppConfig.soak.maxSize);
+        printf(" - gap between frames  : 0 - %llu ms\n", NS_TO_MS(AppConfig.txPeriod));
+        printf(" - allowed errors      : %u\n", AppConfig.soak.maxErrors);
+        printf(" - allowed p99 drift   : %u%%\n", AppConfig.soak.maxDrift);
+        printf(" - random seed         : %u\n\n", AppConfig.soak.seed);
+    } else if (OUT_TABLE != AppConfig.format) {
+        printf(" - sweep points        : %u\n",
+            AppConfig.sweep.size.count * AppConfig.sweep.baud.count * AppConfig.sweep.period.count * AppConfig.sweep.algo.count);
+        printf(" - sweep output        : %s, %s\n\n",
+            (OUT_CSV == AppConfig.format) ? "csv" : "json",
+            (NULL != AppConfig.outFile) ? AppConfig.outFile : "stdout");
+    }
 }
 
 /*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
@@ -993,7 +1817,7 @@ int main(
 
     printf("\n" APP_DESC "\n");
 
-    while (EOF != (cmd = getopt(argc, argv, "a:s:p:l:n:t:vd"))) {
+    while (EOF != (cmd = getopt(argc, argv, "a:s:p:l:n:t:b:f:o:S:B:P:A:k:i:E:r:vd"))) {
 
         switch (cmd) {
             case 'a' :
@@ -1019,7 +1843,7 @@ int main(
             case 'p' :
                 AppConfig.txPeriod = MS_TO_NS((RTIME)atoi(optarg));
 
-                if ((0U == AppConfig.txPeriod) || (TRANSMISION_TIME(DEF_MAX_TEST_DATA_SIZE) < AppConfig.txPeriod)) {
+                if ((0U == AppConfig.txPeriod) || (TRANSMISION_TIME(BAUD_RATE, DEF_MAX_TEST_DATA_SIZE) < AppConfig.txPeriod)) {
                     printf(" Invalid -p option value: %llu\n", AppConfig.txPeriod);
                     exit(2);
                 }
@@ -1038,6 +1862,74 @@ int main(
             case 't' :
                 AppConfig.taskStats = (uint32_t)atoi(optarg);
                 break;
+            case 'b' :
+                AppConfig.baud = (uint32_t)atoi(optarg);
+
+                if (0U == AppConfig.baud) {
+                    printf(" Invalid -b option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'f' :
+
+                if (0 == strcmp(optarg, "csv")) {
+                    AppConfig.format = OUT_CSV;
+                } else if (0 == strcmp(optarg, "json")) {
+                    AppConfig.format = OUT_JSON;
+                } else {
+                    printf(" Invalid -f option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'o' :
+                AppConfig.outFile = optarg;
+                break;
+            case 'S' :
+
+                if (0 != sweepListParse(&AppConfig.sweep.size, optarg, 1U, DEF_MAX_TEST_DATA_SIZE)) {
+                    printf(" Invalid -S option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'B' :
+
+                if (0 != sweepListParse(&AppConfig.sweep.baud, optarg, 1U, UINT32_MAX)) {
+                    printf(" Invalid -B option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'P' :
+
+                if (0 != sweepListParse(&AppConfig.sweep.period, optarg, 1U, DEF_MAX_TX_PERIOD_MS)) {
+                    printf(" Invalid -P option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'A' :
+
+                if (0 != sweepListParse(&AppConfig.sweep.algo, optarg, 0U, DATA_LAST_ALGO - 1U)) {
+                    printf(" Invalid -A option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'k' :
+                AppConfig.soak.duration  = (uint32_t)strtoul(optarg, NULL, 0);
+                AppConfig.soak.isEnabled = true;
+                break;
+            case 'i' :
+                AppConfig.soak.interval = (uint32_t)atoi(optarg);
+
+                if (0U == AppConfig.soak.interval) {
+                    printf(" Invalid -i option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'E' :
+                AppConfig.soak.maxErrors = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'r' :
+                AppConfig.soak.maxDrift = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
             case 'v' :
                 printf(" Version: %u.%u.%u\n", APP_VER_MAJOR, APP_VER_MINOR, APP_VER_PATCH);
                 printf(" Maintainer: %s\n", APP_MAINTAINER);
@@ -1052,17 +1944,94 @@ int main(
                     "  -n <num_of_tests>        - default infinite                              \n"
                     "  -t <lines_per_info>      - default %u, 0 to supress task statistics      \n"
                     "  -a <algorithm>           - default lin, available const and lin          \n"
+                    "  -b <baud_rate>           - default %u                                    \n"
                     "  -d                       - dump received buffer in case it is not valid  \n"
                     "  -v                       - show version information                      \n"
+                    "                                                                           \n"
+                    "Sweep mode, runs every combination of the lists below:                     \n"
+                    "  -f <csv|json>            - enable sweep mode, one row per point          \n"
+                    "  -o <file>                - rows go to file, default stdout               \n"
+                    "  -S <size,...>            - transfer sizes, default -s                    \n"
+                    "  -B <baud,...>            - baud rates, default -b                        \n"
+                    "  -P <period_ms,...>       - transmission periods, default -p              \n"
+                    "  -A <algorithm,...>       - data patterns 0-%u, default -a                \n"
+                    "  -n <num_of_tests>        - runs per point, default %lu                   \n"
+                    "                                                                           \n"
+                    "Soak mode, sequence numbered frames protected by CRC-32:                   \n"
+                    "  -k <seconds>             - enable soak mode, 0 runs until stopped        \n"
+                    "  -i <seconds>             - snapshot interval, default %u                 \n"
+                    "  -E <errors>              - errors allowed for a pass, default 0          \n"
+                    "  -r <percent>             - allowed p99 latency drift, default 0 (off)    \n"
+                    "  -s, -p                   - maximum frame size and gap, random below      \n"
+                    "  -f, -o                   - snapshot format and file, default table       \n"
                     "                                                                           \n",
                     AppConfig.testDataSize,
                     DEF_MAX_TEST_DATA_SIZE,
                     NS_TO_MS(AppConfig.txPeriod),
                     AppConfig.linesPerHeader,
-                    AppConfig.taskStats);
+                    AppConfig.taskStats,
+                    AppConfig.baud,
+                    DATA_LAST_ALGO - 1U,
+                    CFG_SWEEP_NUM_OF_TESTS,
+                    CFG_SOAK_INTERVAL_S);
                 exit(2);
         }
     }
+
+    if (true == AppConfig.soak.isEnabled) {
+
+        if (DEF_SOAK_MIN_FRAME > AppConfig.testDataSize) {
+            printf(" Soak mode needs -s of at least %u bytes\n", DEF_SOAK_MIN_FRAME);
+            exit(2);
+        }
+        AppConfig.soak.maxSize = AppConfig.testDataSize;
+        AppConfig.soak.seed    = (uint32_t)time(NULL);
+        LatSize = ((size_t)AppConfig.soak.interval * (AppConfig.baud / CHAR_BITS)) / DEF_SOAK_MIN_FRAME + 1U;
+    } else if (OUT_TABLE != AppConfig.format) {
+        sweepListDefault(
+            &AppConfig.sweep.size,
+            (uint32_t)AppConfig.testDataSize);
+        sweepListDefault(
+            &AppConfig.sweep.baud,
+            AppConfig.baud);
+        sweepListDefault(
+            &AppConfig.sweep.period,
+            (uint32_t)NS_TO_MS(AppConfig.txPeriod));
+        sweepListDefault(
+            &AppConfig.sweep.algo,
+            AppConfig.algo);
+        AppConfig.baud = AppConfig.sweep.baud.item[0];
+
+        if (0U == AppConfig.numOfTests) {
+            AppConfig.numOfTests = CFG_SWEEP_NUM_OF_TESTS;
+        }
+        LatSize = AppConfig.numOfTests;
+    }
+
+    if (0U != LatSize) {
+        Lat = malloc(sizeof(RTIME) * LatSize);
+
+        if (NULL == Lat) {
+            LOG_ERR("unable to allocate %zu latency samples", LatSize);
+
+            return (ENOMEM);
+        }
+
+        if (NULL != AppConfig.outFile) {
+            Out = fopen(AppConfig.outFile, "w");
+
+            if (NULL == Out) {
+                LOG_ERR("open %s, err: %s", AppConfig.outFile, strerror(errno));
+
+                return (errno);
+            }
+        } else {
+            Out = fdopen(dup(STDOUT_FILENO), "w");                              /* Keep stdout for the rows, send the log to stderr  */
+            dup2(
+                STDERR_FILENO,
+                STDOUT_FILENO);
+        }
+    }
     appPrintConfig();
     sigemptyset(
         &sigset);
@@ -1125,6 +2094,18 @@ int main(
     rt_sem_delete(
         &SemExit);
 
+    if (true == AppConfig.soak.isEnabled) {
+        soakReport();                                                           /* Only reports when stopped before the end          */
+        retval = (true == soakIsPassed()) ? 0 : 1;
+    }
+
+    if (NULL != Out) {
+        fclose(
+            Out);
+    }
+    free(
+        Lat);
+
     return (retval);
 }
 
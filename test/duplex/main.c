@@ -0,0 +1,729 @@
+/*
+ * This file is part of x-16c750-app
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750-app is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750-app is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750-app; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ *********************************************************************//** @{ */
+
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <time.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+
+#include <native/task.h>
+#include <native/timer.h>
+#include <rtdm/rtdm.h>
+
+#include "drv/x-16c750_ioctl.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+#define CFG_DEVICE_DRIVER_NAME          "xuart"
+#define CFG_CHUNK_SIZE                  256U
+#define CFG_DURATION_S                  10U
+#define CFG_BAUD_RATE                   921600U
+
+#define APP_VER_MAJOR                   1U
+#define APP_VER_MINOR                   0U
+#define APP_VER_PATCH                   0U
+#define APP_NAME                        "RTDEV_duplex"
+#define APP_DESC                        "Real-Time RTDEV driver full-duplex multi-port benchmark"
+#define APP_MAINTAINER                  "Nenad Radulovic <nenad.b.radulovic@gmail.com>"
+
+#define TASK_SEND_STKSZ                 0
+#define TASK_SEND_MODE                  T_JOINABLE
+#define TASK_SEND_PRIO                  T_HIPRIO-2
+
+#define TASK_RECV_STKSZ                 0
+#define TASK_RECV_MODE                  T_JOINABLE
+#define TASK_RECV_PRIO                  T_HIPRIO-1
+
+#define TASK_MAN_PRIO                   T_HIPRIO
+
+#define DEF_PORT_MAX                    6U
+#define DEF_MAX_CHUNK_SIZE              4096U
+#define DEF_STAT_FILE                   "/proc/xenomai/stat"
+#define DEF_POLL_NS                     MS_TO_NS(100ULL)
+
+#define NS_PER_US                       1000ULL
+#define US_PER_MS                       1000ULL
+#define MS_PER_S                        1000ULL
+#define NS_PER_MS                       (US_PER_MS * NS_PER_US)
+#define NS_PER_S                        (MS_PER_S * NS_PER_MS)
+
+#define MS_TO_NS(ms)                    (NS_PER_MS * (ms))
+#define SEC_TO_NS(sec)                  (NS_PER_S * (sec))
+
+/* Start, data and stop bits of the 8N1 format                                */
+#define CHAR_BITS                       10ULL
+
+#define LOG_INFO(msg, ...)                                                      \
+    printf(APP_NAME " " msg "\n", ##__VA_ARGS__)
+
+#define LOG_ERR(msg, ...)                                                       \
+    fprintf(stderr, APP_NAME " <ERR> : line %d:\t" msg "\n", __LINE__, ##__VA_ARGS__)
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+
+enum appMode {
+    MODE_LOOP,                                                                  /* Each port in internal loopback                    */
+    MODE_PAIR                                                                   /* Ports 0-1, 2-3, ... are cross-wired               */
+};
+
+struct port {
+    char                name[32];
+    int                 dev;
+    uint32_t            id;
+    uint32_t            peer;                                                   /* Port whose stream this port receives              */
+    RT_TASK             send;
+    RT_TASK             recv;
+    uint8_t *           txBuff;
+    uint8_t *           rxBuff;
+    uint8_t *           expBuff;
+    volatile uint64_t   txBytes;
+    volatile uint64_t   rxBytes;
+    volatile uint64_t   corrupt;
+};
+
+struct appConfig {
+    size_t              chunkSize;
+    uint32_t            duration;
+    uint32_t            baud;
+    enum appMode        mode;
+    bool                isRamp;
+};
+
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static void taskSend(
+    void *              arg);
+
+static void taskRecv(
+    void *              arg);
+
+static void streamFill(
+    uint8_t *           dst,
+    size_t              size,
+    uint64_t            offset,
+    uint32_t            seed);
+
+static uint64_t dataIsValid(
+    const void *        src,
+    const void *        dst,
+    size_t              size);
+
+static int portOpen(
+    struct port *       port);
+
+static void portClose(
+    struct port *       port);
+
+static int runPorts(
+    uint32_t            active);
+
+static int isrShareGet(
+    uint32_t            active,
+    uint32_t *          share);
+
+static void catch(
+    int                 sig);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+static struct port      Port[DEF_PORT_MAX];
+static uint32_t         PortNum;
+static volatile bool    IsRunning;
+static volatile bool    IsAborted;
+static RT_TASK          TaskMan;
+
+static struct appConfig AppConfig = {
+    .chunkSize          = CFG_CHUNK_SIZE,
+    .duration           = CFG_DURATION_S,
+    .baud               = CFG_BAUD_RATE,
+    .mode               = MODE_LOOP,
+    .isRamp             = false
+};
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+static void taskSend(
+    void *              arg) {
+
+    struct port *       port;
+
+    port = (struct port *)arg;
+
+    while (true == IsRunning) {
+        ssize_t         len;
+
+        streamFill(
+            port->txBuff,
+            AppConfig.chunkSize,
+            port->txBytes,
+            port->id);
+        len = rt_dev_write(
+            port->dev,
+            port->txBuff,
+            AppConfig.chunkSize);
+
+        if (0 > len) {
+            LOG_ERR("%s: failed transmission, err: %s", port->name, strerror((int)-len));
+
+            return;
+        }
+        port->txBytes += (uint64_t)len;
+    }
+}
+
+static void taskRecv(
+    void *              arg) {
+
+    struct port *       port;
+
+    port = (struct port *)arg;
+
+    while (true) {
+        ssize_t         len;
+
+        len = rt_dev_read(
+            port->dev,
+            port->rxBuff,
+            AppConfig.chunkSize);
+
+        if (0 >= len) {
+
+            if (((0 == len) || (-ETIMEDOUT == len)) && (false == IsRunning)) {
+
+                return;                                                         /* Stream is drained                                 */
+            }
+
+            if ((0 != len) && (-ETIMEDOUT != len)) {
+                LOG_ERR("%s: failed reception, err: %s", port->name, strerror((int)-len));
+
+                return;
+            }
+
+            continue;                                                           /* Timeout without data, stream paused               */
+        }
+        streamFill(
+            port->expBuff,
+            (size_t)len,
+            port->rxBytes,
+            Port[port->peer].id);
+        port->corrupt += dataIsValid(
+            port->expBuff,
+            port->rxBuff,
+            (size_t)len);
+        port->rxBytes += (uint64_t)len;
+    }
+}
+
+/* Every port sends its own stream, so crossed wires show up as corruption    */
+static void streamFill(
+    uint8_t *           dst,
+    size_t              size,
+    uint64_t            offset,
+    uint32_t            seed) {
+
+    size_t              cnt;
+
+    for (cnt = 0U; cnt < size; cnt++) {
+        uint32_t        item;
+
+        item  = (uint32_t)(offset + cnt) * 2654435761U + seed * 40503U;
+        item ^= item >> 16;
+        dst[cnt] = (uint8_t)(item >> 8);
+    }
+}
+
+static uint64_t dataIsValid(
+    const void *        src,
+    const void *        dst,
+    size_t              size) {
+
+    size_t              i;
+    uint64_t            cnt;
+    const uint8_t *     pSrc;
+    const uint8_t *     pDst;
+
+    cnt  = 0U;
+    pSrc = (const uint8_t *)src;
+    pDst = (const uint8_t *)dst;
+
+    for (i = 0U; i < size; i++) {
+
+        if (*pSrc != *pDst) {
+            cnt++;
+        }
+        pSrc++;
+        pDst++;
+    }
+
+    return (cnt);
+}
+
+static int portOpen(
+    struct port *       port) {
+
+    struct xUartProto   proto;
+    uint32_t            isLoopback;
+    int                 retval;
+
+    port->dev = rt_dev_open(
+        port->name,
+        0);
+
+    if (0 > port->dev) {
+        LOG_ERR("%s: failed to open device, err: %s", port->name, strerror(-port->dev));
+
+        return (port->dev);
+    }
+    retval = rt_dev_ioctl(
+        port->dev,
+        XUART_PROTOCOL_GET,
+        &proto);
+
+    if (0 == retval) {
+        proto.baud = AppConfig.baud;
+        retval = rt_dev_ioctl(
+            port->dev,
+            XUART_PROTOCOL_SET,
+            &proto);
+    }
+
+    if (0 != retval) {
+        LOG_ERR("%s: failed to set baud rate, err: %s", port->name, strerror(-retval));
+
+        return (retval);
+    }
+    isLoopback = (MODE_LOOP == AppConfig.mode) ? 1U : 0U;
+    retval = rt_dev_ioctl(
+        port->dev,
+        XUART_LOOPBACK_SET,
+        &isLoopback);
+
+    if (0 != retval) {
+        LOG_ERR("%s: failed to set loopback, err: %s", port->name, strerror(-retval));
+
+        return (retval);
+    }
+    retval = rt_dev_ioctl(                                                      /* Keep bytes arriving between reads                 */
+        port->dev,
+        XUART_RX_PERSIST);
+
+    if (0 != retval) {
+        LOG_ERR("%s: failed to keep the receiver running, err: %s", port->name, strerror(-retval));
+
+        return (retval);
+    }
+    port->txBuff  = malloc(AppConfig.chunkSize);
+    port->rxBuff  = malloc(AppConfig.chunkSize);
+    port->expBuff = malloc(AppConfig.chunkSize);
+
+    if ((NULL == port->txBuff) || (NULL == port->rxBuff) || (NULL == port->expBuff)) {
+        LOG_ERR("%s: unable to allocate buffers", port->name);
+
+        return (-ENOMEM);
+    }
+
+    return (0);
+}
+
+static void portClose(
+    struct port *       port) {
+
+    if (0 <= port->dev) {
+        rt_dev_close(
+            port->dev);
+        port->dev = -1;
+    }
+    free(
+        port->txBuff);
+    free(
+        port->rxBuff);
+    free(
+        port->expBuff);
+    port->txBuff  = NULL;
+    port->rxBuff  = NULL;
+    port->expBuff = NULL;
+}
+
+/*
+ * Reads the %CPU of the IRQ handlers of the active ports. Xenomai computes the
+ * column over the interval since the previous read of the file, so the first
+ * call of a run only sets the reference point.
+ */
+static int isrShareGet(
+    uint32_t            active,
+    uint32_t *          share) {
+
+    FILE *              stat;
+    char                line[256];
+
+    stat = fopen(DEF_STAT_FILE, "r");
+
+    if (NULL == stat) {
+
+        return (-errno);
+    }
+    *share = 0U;
+
+    while (NULL != fgets(line, sizeof(line), stat)) {
+        const char *    irq;
+        const char *    cpu;
+        uint32_t        whole;
+        uint32_t        tenth;
+        uint32_t        cnt;
+
+        irq = strstr(line, "IRQ");
+
+        if (NULL == irq) {
+
+            continue;
+        }
+
+        for (cnt = 0U; cnt < active; cnt++) {
+
+            if (NULL != strstr(irq, Port[cnt].name)) {
+                break;
+            }
+        }
+
+        if (active == cnt) {
+
+            continue;
+        }
+
+        for (cpu = irq; (cpu > line) && (' ' == cpu[-1]); cpu--);              /* %CPU is the column just before the name           */
+        for (; (cpu > line) && (' ' != cpu[-1]); cpu--);
+
+        if (2 == sscanf(cpu, "%u.%u", &whole, &tenth)) {
+            *share += whole * 10U + tenth;                                      /* Per mille                                         */
+        }
+    }
+    fclose(
+        stat);
+
+    return (0);
+}
+
+static int runPorts(
+    uint32_t            active) {
+
+    RTIME               begin;
+    RTIME               elapsed;
+    uint64_t            rxWindow[DEF_PORT_MAX];
+    uint64_t            aggregate;
+    uint64_t            lost;
+    uint64_t            corrupt;
+    uint32_t            share;
+    uint32_t            cnt;
+    int                 retval;
+
+    for (cnt = 0U; cnt < active; cnt++) {
+        Port[cnt].txBytes = 0U;
+        Port[cnt].rxBytes = 0U;
+        Port[cnt].corrupt = 0U;
+    }
+    isrShareGet(
+        active,
+        &share);
+    IsRunning = true;
+
+    for (cnt = 0U; cnt < active; cnt++) {
+        char            name[XNOBJECT_NAME_LEN];
+
+        snprintf(name, sizeof(name), "duplex_rx%u", cnt);
+        retval = rt_task_spawn(
+            &Port[cnt].recv,
+            name,
+            TASK_RECV_STKSZ,
+            TASK_RECV_PRIO,
+            TASK_RECV_MODE,
+            taskRecv,
+            &Port[cnt]);
+
+        if (0 == retval) {
+            snprintf(name, sizeof(name), "duplex_tx%u", cnt);
+            retval = rt_task_spawn(
+                &Port[cnt].send,
+                name,
+                TASK_SEND_STKSZ,
+                TASK_SEND_PRIO,
+                TASK_SEND_MODE,
+                taskSend,
+                &Port[cnt]);
+        }
+
+        if (0 != retval) {
+            LOG_ERR("%s: failed to spawn tasks, err: %s", Port[cnt].name, strerror(-retval));
+            IsAborted = true;
+
+            break;
+        }
+    }
+    begin = rt_timer_read();
+
+    while ((false == IsAborted) && ((rt_timer_read() - begin) < SEC_TO_NS((RTIME)AppConfig.duration))) {
+        rt_task_sleep(
+            DEF_POLL_NS);
+    }
+    elapsed = rt_timer_read() - begin;
+
+    for (cnt = 0U; cnt < active; cnt++) {
+        rxWindow[cnt] = Port[cnt].rxBytes;
+    }
+    isrShareGet(
+        active,
+        &share);
+    IsRunning = false;
+
+    for (cnt = 0U; cnt < active; cnt++) {                                       /* Senders stop first, receivers drain the line      */
+        rt_task_join(
+            &Port[cnt].send);
+    }
+
+    for (cnt = 0U; cnt < active; cnt++) {
+        rt_task_join(
+            &Port[cnt].recv);
+    }
+    aggregate = 0U;
+    lost      = 0U;
+    corrupt   = 0U;
+    printf("\n ports: %u, %s, %u baud, chunk %zu bytes, %llu ms\n",
+        active,
+        (MODE_LOOP == AppConfig.mode) ? "internal loopback" : "cross-wired pairs",
+        AppConfig.baud,
+        AppConfig.chunkSize,
+        (unsigned long long)(elapsed / NS_PER_MS));
+
+    for (cnt = 0U; cnt < active; cnt++) {
+        uint64_t        rate;
+        uint64_t        sent;
+
+        rate  = (rxWindow[cnt] * NS_PER_S) / elapsed;
+        sent  = Port[Port[cnt].peer].txBytes;
+        aggregate += rate;
+        lost      += (sent > Port[cnt].rxBytes) ? (sent - Port[cnt].rxBytes) : 0U;
+        corrupt   += Port[cnt].corrupt;
+        printf("  %-12s rx %8llu B/s (%3llu%% of line), sent by peer %llu, received %llu, corrupt %llu\n",
+            Port[cnt].name,
+            (unsigned long long)rate,
+            (unsigned long long)((rate * CHAR_BITS * 100ULL) / AppConfig.baud),
+            (unsigned long long)sent,
+            (unsigned long long)Port[cnt].rxBytes,
+            (unsigned long long)Port[cnt].corrupt);
+    }
+    printf("  aggregate    rx %8llu B/s, lost %llu bytes, corrupt %llu bytes, ISR CPU %u.%u%%\n",
+        (unsigned long long)aggregate,
+        (unsigned long long)lost,
+        (unsigned long long)corrupt,
+        share / 10U,
+        share % 10U);
+
+    return ((0U == (lost + corrupt)) ? 0 : 1);
+}
+
+static void catch(
+    int                 sig) {
+
+    (void)sig;
+    IsAborted = true;
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+int main(
+    int                 argc,
+    char **             argv) {
+
+    int                 retval;
+    int                 cmd;
+    uint32_t            cnt;
+    uint32_t            step;
+    uint32_t            active;
+
+    printf("\n" APP_DESC "\n");
+
+    while (EOF != (cmd = getopt(argc, argv, "D:m:b:s:d:rv"))) {
+
+        switch (cmd) {
+            case 'D' : {
+                char *  name;
+
+                PortNum = 0U;
+
+                for (name = strtok(optarg, ","); NULL != name; name = strtok(NULL, ",")) {
+
+                    if (DEF_PORT_MAX == PortNum) {
+                        printf(" Too many devices, at most %u\n", DEF_PORT_MAX);
+                        exit(2);
+                    }
+                    snprintf(Port[PortNum].name, sizeof(Port[PortNum].name), "%s", name);
+                    PortNum++;
+                }
+                break;
+            }
+            case 'm' :
+
+                if (0 == strcmp(optarg, "loop")) {
+                    AppConfig.mode = MODE_LOOP;
+                } else if (0 == strcmp(optarg, "pair")) {
+                    AppConfig.mode = MODE_PAIR;
+                } else {
+                    printf(" Invalid -m option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'b' :
+                AppConfig.baud = (uint32_t)atoi(optarg);
+
+                if (0U == AppConfig.baud) {
+                    printf(" Invalid -b option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 's' :
+                AppConfig.chunkSize = (size_t)atoi(optarg);
+
+                if ((0U == AppConfig.chunkSize) || (DEF_MAX_CHUNK_SIZE < AppConfig.chunkSize)) {
+                    printf(" Invalid -s option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'd' :
+                AppConfig.duration = (uint32_t)atoi(optarg);
+
+                if (0U == AppConfig.duration) {
+                    printf(" Invalid -d option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'r' :
+                AppConfig.isRamp = true;
+                break;
+            case 'v' :
+                printf(" Version: %u.%u.%u\n", APP_VER_MAJOR, APP_VER_MINOR, APP_VER_PATCH);
+                printf(" Maintainer: %s\n", APP_MAINTAINER);
+                exit(0);
+            default :
+                fprintf(stderr,
+                    "usage: duplex [options]                                                    \n"
+                    "                                                                           \n"
+                    "  -D <dev,...>             - default %s, at most %u devices                \n"
+                    "  -m <loop|pair>           - default loop: internal loopback on each port, \n"
+                    "                             pair: ports 1-2, 3-4, ... are cross-wired     \n"
+                    "  -b <baud_rate>           - default %u                                    \n"
+                    "  -s <size>                - default %u bytes, [1-%u] read/write chunk     \n"
+                    "  -d <seconds>             - default %u, duration of one run               \n"
+                    "  -r                       - ramp the number of active ports up to all     \n"
+                    "  -v                       - show version information                      \n"
+                    "                                                                           \n",
+                    CFG_DEVICE_DRIVER_NAME,
+                    DEF_PORT_MAX,
+                    CFG_BAUD_RATE,
+                    CFG_CHUNK_SIZE,
+                    DEF_MAX_CHUNK_SIZE,
+                    CFG_DURATION_S);
+                exit(2);
+        }
+    }
+
+    if (0U == PortNum) {
+        snprintf(Port[0].name, sizeof(Port[0].name), "%s", CFG_DEVICE_DRIVER_NAME);
+        PortNum = 1U;
+    }
+    step = (MODE_PAIR == AppConfig.mode) ? 2U : 1U;
+
+    if (0U != (PortNum % step)) {
+        printf(" Cross-wired mode needs an even number of devices\n");
+        exit(2);
+    }
+    signal(
+        SIGINT,
+        catch);
+    signal(
+        SIGTERM,
+        catch);
+    mlockall(
+        MCL_CURRENT | MCL_FUTURE);
+    retval = rt_task_shadow(
+        &TaskMan,
+        "duplex_man",
+        TASK_MAN_PRIO,
+        0);
+
+    if (0 != retval) {
+        LOG_ERR("failed to shadow main task, err: %s", strerror(-retval));
+
+        return (1);
+    }
+
+    for (cnt = 0U; cnt < PortNum; cnt++) {
+        Port[cnt].dev  = -1;
+        Port[cnt].id   = cnt;
+        Port[cnt].peer = (MODE_PAIR == AppConfig.mode) ? (cnt ^ 1U) : cnt;
+    }
+
+    for (cnt = 0U; cnt < PortNum; cnt++) {
+        retval = portOpen(
+            &Port[cnt]);
+
+        if (0 != retval) {
+            break;
+        }
+    }
+
+    if (0 == retval) {
+        active = (true == AppConfig.isRamp) ? step : PortNum;
+
+        for (; (active <= PortNum) && (false == IsAborted); active += step) {
+            retval |= runPorts(
+                active);
+        }
+    }
+
+    for (cnt = 0U; cnt < PortNum; cnt++) {
+        portClose(
+            &Port[cnt]);
+    }
+
+    return ((0 == retval) ? 0 : 1);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of main.c
+ ******************************************************************************/
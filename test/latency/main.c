@@ -27,9 +27,13 @@
 
 /*=========================================================  INCLUDE FILES  ==*/
 
+#include <time.h>
+#include <errno.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include <signal.h>
 #include <unistd.h>
 #include <stdbool.h>
@@ -65,6 +69,22 @@
 
 #define DEF_RECV_RETRY_CNT                  10U
 
+#define CFG_PERIOD_US                   10000U
+#define CFG_WORST_NUM                   10U
+
+/*
+ * Log-linear histogram: values below 2 * HIST_SUB_COUNT ns have their own
+ * bucket, above that every power of two is split into HIST_SUB_COUNT buckets,
+ * which keeps the relative error under 1 / HIST_SUB_COUNT. Values above
+ * HIST_MAX_BITS bits (about 68 s) are counted in the last bucket.
+ */
+#define HIST_SUB_BITS                   5U
+#define HIST_SUB_COUNT                  (1U << HIST_SUB_BITS)
+#define HIST_MAX_BITS                   36U
+#define HIST_BUCKETS                    ((HIST_MAX_BITS - HIST_SUB_BITS + 1U) * HIST_SUB_COUNT)
+
+#define DEF_WORST_MAX                   64U
+
 #define TABLE_HEADER                                                                                \
     "---------------------------------------------------------------------------------------\n"     \
     " Nr.  |   min   |  TURN   |   max   |   avg   |   min   |    TX   |   max   |   avg   |\n"     \
@@ -126,6 +146,21 @@ struct meas {
     RTIME               max;
 };
 
+struct hist {
+    uint64_t            bucket[HIST_BUCKETS];
+    uint64_t            cnt;
+    RTIME               sum;
+    RTIME               min;
+    RTIME               max;
+};
+
+struct worst {
+    uint64_t            seq;                                                    /* Sample number since start                         */
+    RTIME               stamp;                                                  /* Time of reception                                 */
+    RTIME               turn;
+    RTIME               tx;
+};
+
 /*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
 
 static void taskSend(
@@ -144,6 +179,34 @@ static void calcMeas(
     struct meas *       meas,
     RTIME               new);
 
+static void initHist(
+    struct hist *       hist);
+
+static void addHist(
+    struct hist *       hist,
+    RTIME               new);
+
+static RTIME quantileHist(
+    const struct hist * hist,
+    uint32_t            ppm);
+
+static void printHist(
+    const char *        name,
+    const struct hist * hist);
+
+static void addWorst(
+    uint64_t            seq,
+    RTIME               stamp,
+    RTIME               turn,
+    RTIME               tx);
+
+static int cmpWorst(
+    const void *        a,
+    const void *        b);
+
+static void printWorst(
+    void);
+
 static void catch(
     int                 sig);
 
@@ -159,6 +222,16 @@ static const char       gTestData[] = TEST_DATA;
 
 static volatile struct timeMeas gTime;
 
+static RTIME            gPeriod = US_TO_NS((RTIME)CFG_PERIOD_US);
+static bool             gIsQuiet;
+static struct hist      gTurnHist;
+static struct hist      gTxHist;
+static struct worst     gWorst[DEF_WORST_MAX];
+static uint32_t         gWorstNum = CFG_WORST_NUM;
+static uint32_t         gWorstUsed;
+static RTIME            gStartRt;                                               /* rt_timer_read() at start                          */
+static struct timespec  gStartWall;                                             /* Wall clock at start                               */
+
 /*======================================================  GLOBAL VARIABLES  ==*/
 /*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
 
@@ -176,7 +249,7 @@ static void taskSend(
     retval = rt_task_set_periodic(
         NULL,
         TM_NOW,
-        MS_TO_NS(10));
+        gPeriod);
     LOG_ERR_IF(0 != retval, "failed to set period (err: %d)", retval);
 
     while (true) {
@@ -194,10 +267,12 @@ static void taskRecv(
     void *              arg) {
 
     uint32_t            retry;
+    uint64_t            seq;
 
     (void)arg;
 
     retry = DEF_RECV_RETRY_CNT;
+    seq   = 0U;
 
     while (true) {
         int             retval;
@@ -227,7 +302,23 @@ static void taskRecv(
                 continue;
             }
         } else {
+            RTIME       turn;
+            RTIME       tx;
+
             retry = DEF_RECV_RETRY_CNT;
+            turn  = gTime.rxEnd - gTime.txBegin;                                /* Every sample is recorded here, the print task may */
+            tx    = gTime.txEnd - gTime.txBegin;                                /* skip samples when it falls behind                 */
+            addHist(
+                &gTurnHist,
+                turn);
+            addHist(
+                &gTxHist,
+                tx);
+            addWorst(
+                seq++,
+                gTime.rxEnd,
+                turn,
+                tx);
         }
 
         retval = rt_event_signal(
@@ -306,6 +397,11 @@ static void taskPrint(
             &tx,
             txCurr);
 
+        if (true == gIsQuiet) {
+
+            continue;
+        }
+
         if (0U == (cntr % 40U)) {
             printf(TABLE_HEADER);
         }
@@ -364,6 +460,200 @@ static void calcMeas(
     }
 }
 
+static void initHist(
+    struct hist *       hist) {
+
+    memset(
+        hist,
+        0,
+        sizeof(*hist));
+    hist->min = (RTIME)-1;
+}
+
+static void addHist(
+    struct hist *       hist,
+    RTIME               new) {
+
+    uint32_t            idx;
+
+    if (new < (2U * HIST_SUB_COUNT)) {
+        idx = (uint32_t)new;
+    } else {
+        uint32_t        exp;
+
+        exp = (uint32_t)(63 - __builtin_clzll(new)) - HIST_SUB_BITS;           /* new >> exp is in [HIST_SUB_COUNT, 2 * HIST_SUB_COUNT)*/
+        idx = exp * HIST_SUB_COUNT + (uint32_t)(new >> exp);
+
+        if (HIST_BUCKETS <= idx) {
+            idx = HIST_BUCKETS - 1U;
+        }
+    }
+    hist->bucket[idx]++;
+    hist->cnt++;
+    hist->sum += new;
+
+    if (hist->min > new) {
+        hist->min = new;
+    }
+
+    if (hist->max < new) {
+        hist->max = new;
+    }
+}
+
+/* Returns the upper edge of the bucket holding the requested quantile        */
+static RTIME quantileHist(
+    const struct hist * hist,
+    uint32_t            ppm) {
+
+    uint64_t            rank;
+    uint64_t            seen;
+    uint32_t            idx;
+
+    rank = (hist->cnt * ppm + 999999U) / 1000000U;
+    seen = 0U;
+
+    for (idx = 0U; idx < HIST_BUCKETS; idx++) {
+        seen += hist->bucket[idx];
+
+        if (seen >= rank) {
+            break;
+        }
+    }
+
+    if ((HIST_BUCKETS - 1U) <= idx) {                                          /* Last bucket also holds the clamped values         */
+
+        return (hist->max);
+    }
+
+    if (idx < (2U * HIST_SUB_COUNT)) {
+
+        return ((RTIME)idx);
+    } else {
+        uint32_t        exp;
+        RTIME           edge;
+
+        exp  = idx / HIST_SUB_COUNT - 1U;
+        edge = ((RTIME)(idx - exp * HIST_SUB_COUNT + 1U) << exp) - 1U;
+
+        return ((edge < hist->max) ? edge : hist->max);
+    }
+}
+
+static void printHist(
+    const char *        name,
+    const struct hist * hist) {
+
+    if (0U == hist->cnt) {
+        printf(" %-5s: no samples\n", name);
+
+        return;
+    }
+    printf(" %-5s: samples %llu, min %llu.%llu, avg %llu.%llu, p50 %llu.%llu, p99 %llu.%llu, p99.9 %llu.%llu, p99.99 %llu.%llu, max %llu.%llu us\n",
+        name,
+        (unsigned long long)hist->cnt,
+        hist->min / 1000U,
+        (hist->min % 1000U) / 100U,
+        (hist->sum / hist->cnt) / 1000U,
+        ((hist->sum / hist->cnt) % 1000U) / 100U,
+        quantileHist(hist, 500000U) / 1000U,
+        (quantileHist(hist, 500000U) % 1000U) / 100U,
+        quantileHist(hist, 990000U) / 1000U,
+        (quantileHist(hist, 990000U) % 1000U) / 100U,
+        quantileHist(hist, 999000U) / 1000U,
+        (quantileHist(hist, 999000U) % 1000U) / 100U,
+        quantileHist(hist, 999900U) / 1000U,
+        (quantileHist(hist, 999900U) % 1000U) / 100U,
+        hist->max / 1000U,
+        (hist->max % 1000U) / 100U);
+}
+
+/* Keeps the gWorstNum largest turnaround samples, replacing the smallest one */
+static void addWorst(
+    uint64_t            seq,
+    RTIME               stamp,
+    RTIME               turn,
+    RTIME               tx) {
+
+    uint32_t            idx;
+    uint32_t            cnt;
+
+    if (gWorstUsed < gWorstNum) {
+        idx = gWorstUsed++;
+    } else {
+        idx = 0U;
+
+        for (cnt = 1U; cnt < gWorstUsed; cnt++) {
+
+            if (gWorst[idx].turn > gWorst[cnt].turn) {
+                idx = cnt;
+            }
+        }
+
+        if (gWorst[idx].turn >= turn) {
+
+            return;
+        }
+    }
+    gWorst[idx].seq   = seq;
+    gWorst[idx].stamp = stamp;
+    gWorst[idx].turn  = turn;
+    gWorst[idx].tx    = tx;
+}
+
+static int cmpWorst(
+    const void *        a,
+    const void *        b) {
+
+    const struct worst * left;
+    const struct worst * right;
+
+    left  = (const struct worst *)a;
+    right = (const struct worst *)b;
+
+    return ((left->turn < right->turn) - (left->turn > right->turn));
+}
+
+static void printWorst(
+    void) {
+
+    uint32_t            cnt;
+
+    qsort(
+        gWorst,
+        gWorstUsed,
+        sizeof(struct worst),
+        cmpWorst);
+    printf(" worst %u turnaround samples:\n", gWorstUsed);
+
+    for (cnt = 0U; cnt < gWorstUsed; cnt++) {
+        struct tm       tm;
+        time_t          sec;
+        RTIME           wall;
+        char            date[32];
+
+        wall = (RTIME)gStartWall.tv_sec * NS_PER_S + (RTIME)gStartWall.tv_nsec + (gWorst[cnt].stamp - gStartRt);
+        sec  = (time_t)(wall / NS_PER_S);
+        localtime_r(
+            &sec,
+            &tm);
+        strftime(
+            date,
+            sizeof(date),
+            "%Y-%m-%d %H:%M:%S",
+            &tm);
+        printf("  %2u: %s.%06llu  sample %llu, turn %llu.%llu us, tx %llu.%llu us\n",
+            cnt + 1U,
+            date,
+            (wall % NS_PER_S) / NS_PER_US,
+            (unsigned long long)gWorst[cnt].seq,
+            gWorst[cnt].turn / 1000U,
+            (gWorst[cnt].turn % 1000U) / 100U,
+            gWorst[cnt].tx / 1000U,
+            (gWorst[cnt].tx % 1000U) / 100U);
+    }
+}
+
 static void catch(
     int                 sig) {
 
@@ -375,17 +665,66 @@ int main(
     char **             argv) {
 
     int                 retval;
+    int                 cmd;
+    uint32_t            duration;
 
-    (void)argc;
-    (void)argv;
+    duration = 0U;
 
     printf("\nReal-Time UART driver latency tester\n");
+
+    while (EOF != (cmd = getopt(argc, argv, "p:d:w:q"))) {
+
+        switch (cmd) {
+            case 'p' :
+                gPeriod = US_TO_NS((RTIME)atoi(optarg));
+
+                if (0U == gPeriod) {
+                    printf(" Invalid -p option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'd' :
+                duration = (uint32_t)atoi(optarg);
+                break;
+            case 'w' :
+                gWorstNum = (uint32_t)atoi(optarg);
+
+                if (DEF_WORST_MAX < gWorstNum) {
+                    printf(" Invalid -w option value: %s\n", optarg);
+                    exit(2);
+                }
+                break;
+            case 'q' :
+                gIsQuiet = true;
+                break;
+            default :
+                fprintf(stderr,
+                    "usage: latency [options]                                                   \n"
+                    "                                                                           \n"
+                    "  -p <period_us>           - default %u us, transmission period            \n"
+                    "  -d <seconds>             - default 0, run until interrupted              \n"
+                    "  -w <num>                 - default %u, [0-%u] worst samples to keep      \n"
+                    "  -q                       - do not print a table row per sample           \n"
+                    "                                                                           \n",
+                    CFG_PERIOD_US,
+                    CFG_WORST_NUM,
+                    DEF_WORST_MAX);
+                exit(2);
+        }
+    }
+    initHist(
+        &gTurnHist);
+    initHist(
+        &gTxHist);
     signal(
         SIGTERM,
         catch);
     signal(
         SIGINT,
         catch);
+    signal(
+        SIGALRM,
+        catch);
     mlockall(
         MCL_CURRENT | MCL_FUTURE);
 
@@ -451,6 +790,10 @@ int main(
         return (retval);
     }
 
+    gStartRt = rt_timer_read();
+    clock_gettime(
+        CLOCK_REALTIME,
+        &gStartWall);
     LOG_INFO("start task : %s", TASK_RECV_NAME);
     retval = rt_task_start(
         &taskRecvDesc,
@@ -472,6 +815,11 @@ int main(
     printf("\n-----------------------------------------------------------------\n");
     printf("  Message length: %d\n", sizeof(gTestData));
     printf("-----------------------------------------------------------------\n\n");
+
+    if (0U != duration) {
+        alarm(
+            duration);
+    }
     pause();
     LOG_INFO("terminating");
     rt_task_delete(
@@ -482,6 +830,14 @@ int main(
         &taskRecvDesc);
     rt_dev_close(
         gDev);
+    printf("\n-----------------------------------------------------------------\n");
+    printHist(
+        "TURN",
+        &gTurnHist);
+    printHist(
+        "TX",
+        &gTxHist);
+    printWorst();
 
     return (retval);
 }
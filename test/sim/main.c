@@ -0,0 +1,620 @@
+/*
+ * This file is part of x-16c750-app
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x-16c750-app is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x-16c750-app is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x-16c750-app; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ *********************************************************************//** @{ */
+
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <time.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include <rtdm/rtdm.h>
+
+#include "drv/x-16c750_cfg.h"
+#include "drv/x-16c750_ioctl.h"
+#include "plat_sim.h"
+#include "sim_core.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+#define CFG_DEVICE_DRIVER_NAME          CFG_DRV_NAME
+#define CFG_VNM_RX_NAME                 CFG_DRV_NAME "-vnm0b"
+#define CFG_VNM_TX_NAME                 CFG_DRV_NAME "-vnm0a"
+#define CFG_TEST_DATA_SIZE              1024U
+#define CFG_NUM_OF_TESTS                20UL
+#define CFG_BAUD_RATE                   921600UL
+
+#define APP_VER_MAJOR                   1U
+#define APP_VER_MINOR                   0U
+#define APP_VER_PATCH                   0U
+#define APP_NAME                        "RTDEV_sim"
+#define APP_DESC                        "Host simulation loopback benchmark"
+#define APP_MAINTAINER                  "Nenad Radulovic <nenad.b.radulovic@gmail.com>"
+
+#define DEF_MAX_TEST_DATA_SIZE          (64U * 1024U)
+#define DEF_ARM_DELAY_NS                US_TO_NS(200ULL)                        /* Time given to the reader to start its receiver    */
+#define DEF_IDLE_TEST_SIZE              3U                                      /* Bytes sent by the far end before it goes silent   */
+
+#define NS_PER_US                       1000ULL
+#define US_PER_MS                       1000ULL
+#define MS_PER_S                        1000ULL
+#define NS_PER_MS                       (US_PER_MS * NS_PER_US)
+#define NS_PER_S                        (MS_PER_S * NS_PER_MS)
+
+#define US_TO_NS(us)                    (NS_PER_US * (us))
+#define NS_TO_US(ns)                    ((ns) / NS_PER_US)
+
+/* Start, data and stop bits of the 8N1 format used by the benchmark          */
+#define TRANSMISION_TIME(baud, size)                                            \
+    ((NS_PER_S * 10ULL * (uint64_t)(size)) / (uint64_t)(baud))
+
+#define LOG_INFO(msg, ...)                                                      \
+    printf(APP_NAME " " msg "\n", ##__VA_ARGS__)
+
+#define LOG_ERR(msg, ...)                                                       \
+    fprintf(stderr, APP_NAME " <ERR> : line %d:\t" msg "\n", __LINE__, ##__VA_ARGS__)
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+
+struct meas {
+    uint64_t            cnt;
+    uint64_t            avg;
+    uint64_t            min;
+    uint64_t            max;
+};
+
+struct appConfig {
+    size_t              testDataSize;
+    uint32_t            numOfTests;
+    uint32_t            baud;
+    uint32_t            uart;
+    int32_t             engine;
+    uint32_t            idle;
+    bool                isSelfTest;
+    bool                isVnm;
+};
+
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static void * taskSend(
+    void *              arg);
+
+static int selfTestRun(
+    void);
+
+static void * taskFeed(
+    void *              arg);
+
+static int idleWakeRun(
+    void);
+
+static void measInit(
+    struct meas *       meas);
+
+static void measCalc(
+    struct meas *       meas,
+    uint64_t            new);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+static sem_t            SemSend;
+static volatile bool    IsRunning;
+static int              UARTDevice;
+static int              TxDevice;
+static uint8_t *        TxBuff;
+static uint8_t *        RxBuff;
+static volatile uint64_t TxBegin;
+
+static struct appConfig AppConfig = {
+    .testDataSize       = CFG_TEST_DATA_SIZE,
+    .numOfTests         = CFG_NUM_OF_TESTS,
+    .baud               = CFG_BAUD_RATE,
+    .uart               = CFG_UART_ID,
+    .engine             = -1,
+    .idle               = 0U,
+    .isSelfTest         = false,
+    .isVnm              = false
+};
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+static void * taskSend(
+    void *              arg) {
+
+    (void)arg;
+
+    for (;;) {
+        struct timespec delay;
+        ssize_t         len;
+
+        sem_wait(
+            &SemSend);
+
+        if (false == IsRunning) {
+            break;
+        }
+        delay.tv_sec  = 0;
+        delay.tv_nsec = (long)DEF_ARM_DELAY_NS;
+        nanosleep(
+            &delay,
+            NULL);
+        TxBegin = simClockRead();
+        len = rt_dev_write(
+            TxDevice,
+            TxBuff,
+            AppConfig.testDataSize);
+
+        if (len != (ssize_t)AppConfig.testDataSize) {
+            LOG_ERR("failed transmission, err: %s", strerror((int)-len));
+        }
+    }
+
+    return (NULL);
+}
+
+static int selfTestRun(
+    void) {
+
+    struct xUartSelfTest test;
+    int                 retval;
+
+    memset(&test, 0, sizeof(test));
+    test.size    = (uint32_t)(AppConfig.testDataSize * AppConfig.numOfTests);
+    test.pattern = XUART_SELFTEST_RANDOM;
+    retval = rt_dev_ioctl(
+        UARTDevice,
+        XUART_SELFTEST,
+        &test);
+
+    if (0 != retval) {
+        LOG_ERR("self test, err: %s", strerror(-retval));
+
+        return (retval);
+    }
+    LOG_INFO("UART%u, %u baud, self test of %u bytes in internal loopback", AppConfig.uart, AppConfig.baud, test.size);
+    LOG_INFO("throughput    : %u bytes/s", test.bytesPerSec);
+    LOG_INFO("interrupts    : %u, %u per KiB, ISR time %llu us",
+        test.irqs,
+        test.irqsPerKiB,
+        (unsigned long long)NS_TO_US(test.isrTime));
+    LOG_INFO("duration      : %llu us",
+        (unsigned long long)NS_TO_US(test.duration));
+    LOG_INFO("errors        : %u", test.errors);
+
+    return ((0U == test.errors) ? 0 : -EIO);
+}
+
+static void * taskFeed(
+    void *              arg) {
+
+    static const uint8_t data[DEF_IDLE_TEST_SIZE] = {
+        0x31U, 0x32U, 0x33U
+    };
+    struct timespec     delay;
+
+    (void)arg;
+    delay.tv_sec  = 0;
+    delay.tv_nsec = (long)DEF_ARM_DELAY_NS;
+    nanosleep(
+        &delay,
+        NULL);
+    portSimRemoteWr(
+        AppConfig.uart,
+        data,
+        sizeof(data));
+
+    return (NULL);
+}
+
+static int idleWakeRun(
+    void) {
+
+    struct xUartWake    wake;
+    uint8_t             buff[64];
+    pthread_t           feed;
+    uint64_t            begin;
+    uint64_t            elapsed;
+    ssize_t             len;
+    uint32_t            errors;
+    int                 retval;
+
+    memset(&wake, 0, sizeof(wake));
+    wake.idle = AppConfig.idle;
+    retval = rt_dev_ioctl(
+        UARTDevice,
+        XUART_WAKE_SET,
+        &wake);
+
+    if (0 != retval) {
+        LOG_ERR("wake conditions, err: %s", strerror(-retval));
+
+        return (retval);
+    }
+    pthread_create(
+        &feed,
+        NULL,
+        taskFeed,
+        NULL);
+    begin   = simClockRead();
+    len     = rt_dev_read(
+        UARTDevice,
+        buff,
+        sizeof(buff));
+    elapsed = simClockRead() - begin;
+    pthread_join(
+        feed,
+        NULL);
+    errors = 0U;
+
+    /*
+     * The read must end on the idle time, well before the operation timeout
+     * of the driver, and return the bytes which were sent.
+     */
+    if ((DEF_IDLE_TEST_SIZE != len) ||
+        (US_TO_NS((uint64_t)AppConfig.idle) > elapsed) ||
+        ((NS_PER_MS * CFG_TIMEOUT_MS) <= elapsed)) {
+        errors++;
+    }
+    LOG_INFO("UART%u, %u baud, %u bytes then silence, idle time %u us", AppConfig.uart, AppConfig.baud, DEF_IDLE_TEST_SIZE, AppConfig.idle);
+    LOG_INFO("read          : %zd bytes in %llu us", len, (unsigned long long)NS_TO_US(elapsed));
+    LOG_INFO("errors        : %u", errors);
+
+    return ((0U == errors) ? 0 : -EIO);
+}
+
+static void measInit(
+    struct meas *       meas) {
+
+    meas->cnt = 0U;
+    meas->avg = 0U;
+    meas->min = UINT64_MAX;
+    meas->max = 0U;
+}
+
+static void measCalc(
+    struct meas *       meas,
+    uint64_t            new) {
+
+    meas->cnt++;
+    meas->avg += (int64_t)(new - meas->avg) / (int64_t)meas->cnt;
+
+    if (new < meas->min) {
+        meas->min = new;
+    }
+
+    if (new > meas->max) {
+        meas->max = new;
+    }
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+int main(
+    int                 argc,
+    char **             argv) {
+
+    int                 retval;
+    int                 cmd;
+    uint32_t            test;
+    uint32_t            errors;
+    uint64_t            lineTime;
+    uint64_t            begin;
+    uint64_t            elapsed;
+    struct meas         latency;
+    struct xUartProto   proto;
+    struct portSimStats stats;
+    pthread_t           send;
+
+    printf("\n" APP_DESC "\n");
+
+    while (EOF != (cmd = getopt(argc, argv, "s:n:b:e:w:tmv"))) {
+
+        switch (cmd) {
+            case 's' :
+                AppConfig.testDataSize = (size_t)atoi(optarg);
+
+                if ((0U == AppConfig.testDataSize) || (DEF_MAX_TEST_DATA_SIZE < AppConfig.testDataSize)) {
+                    printf(" Invalid -s option value: %zu\n", AppConfig.testDataSize);
+                    exit(2);
+                }
+                break;
+            case 'n' :
+                AppConfig.numOfTests = (uint32_t)atoi(optarg);
+
+                if (0U == AppConfig.numOfTests) {
+                    printf(" Invalid -n option value: %u\n", AppConfig.numOfTests);
+                    exit(2);
+                }
+                break;
+            case 'b' :
+                AppConfig.baud = (uint32_t)atoi(optarg);
+                break;
+            case 'e' :
+                AppConfig.engine = (int32_t)atoi(optarg);
+                break;
+            case 'w' :
+                AppConfig.idle = (uint32_t)atoi(optarg);
+
+                if (0U == AppConfig.idle) {
+                    printf(" Invalid -w option value: %u\n", AppConfig.idle);
+                    exit(2);
+                }
+                break;
+            case 't' :
+                AppConfig.isSelfTest = true;
+                break;
+            case 'm' :
+                AppConfig.isVnm = true;
+                break;
+            case 'v' :
+                printf(" Version: %u.%u.%u\n", APP_VER_MAJOR, APP_VER_MINOR, APP_VER_PATCH);
+                printf(" Maintainer: %s\n", APP_MAINTAINER);
+                exit(0);
+            default :
+                fprintf(stderr,
+                    "usage: sim [options]                                                       \n"
+                    "                                                                           \n"
+                    "  -s <size>                - default %u bytes, [1-%u] test data size       \n"
+                    "  -n <num_of_tests>        - default %lu                                   \n"
+                    "  -b <baud_rate>           - default %lu                                   \n"
+                    "  -e <engine>              - transfer engine, see enum xUartEngine         \n"
+                    "  -w <idle_us>             - far end sends %u bytes, read() must end after \n"
+                    "                             the idle time, see XUART_WAKE_SET             \n"
+                    "  -t                       - run XUART_SELFTEST with size x num_of_tests   \n"
+                    "  -m                       - send over the virtual null-modem pair " CFG_DRV_NAME "-vnm0\n"
+                    "  -v                       - show version information                      \n"
+                    "                                                                           \n",
+                    CFG_TEST_DATA_SIZE,
+                    DEF_MAX_TEST_DATA_SIZE,
+                    CFG_NUM_OF_TESTS,
+                    CFG_BAUD_RATE,
+                    DEF_IDLE_TEST_SIZE);
+                exit(2);
+        }
+    }
+    proto.baud     = AppConfig.baud;
+    proto.parity   = XUART_PARITY_NONE;
+    proto.dataBits = XUART_DATA_8;
+    proto.stopBits = XUART_STOP_1;
+    retval = moduleInit();
+
+    if (0 != retval) {
+        LOG_ERR("module init, err: %s", strerror(-retval));
+
+        return (1);
+    }
+    if (true == AppConfig.isVnm) {
+        UARTDevice = rt_dev_open(
+            CFG_VNM_RX_NAME,
+            0);
+    } else {
+        if ((false == AppConfig.isSelfTest) && (0U == AppConfig.idle)) {        /* Self test loops back inside the UART, line unwired*/
+            portSimConnect(
+                AppConfig.uart,
+                AppConfig.uart);                                                /* TX wired back to RX                               */
+        }
+        UARTDevice = rt_dev_open(
+            CFG_DEVICE_DRIVER_NAME,
+            0);
+    }
+
+    if (0 > UARTDevice) {
+        LOG_ERR("open device, err: %s", strerror(-UARTDevice));
+        moduleTerm();
+
+        return (1);
+    }
+    TxDevice = UARTDevice;
+
+    if (true == AppConfig.isVnm) {
+        TxDevice = rt_dev_open(
+            CFG_VNM_TX_NAME,
+            0);
+
+        if (0 > TxDevice) {
+            LOG_ERR("open device, err: %s", strerror(-TxDevice));
+            rt_dev_close(
+                UARTDevice);
+            moduleTerm();
+
+            return (1);
+        }
+        retval = rt_dev_ioctl(
+            TxDevice,
+            XUART_PROTOCOL_SET,
+            &proto);
+    }
+    if (0 == retval) {
+        retval = rt_dev_ioctl(
+            UARTDevice,
+            XUART_PROTOCOL_SET,
+            &proto);
+    }
+
+    if ((0 == retval) && (0 <= AppConfig.engine)) {
+        uint32_t        engine;
+
+        engine = (uint32_t)AppConfig.engine;
+        retval = rt_dev_ioctl(
+            UARTDevice,
+            XUART_ENGINE_SET,
+            &engine);
+    }
+
+    if (0 != retval) {
+        LOG_ERR("device setup, err: %s", strerror(-retval));
+
+        if (TxDevice != UARTDevice) {
+            rt_dev_close(
+                TxDevice);
+        }
+        rt_dev_close(
+            UARTDevice);
+        moduleTerm();
+
+        return (1);
+    }
+    if (true == AppConfig.isSelfTest) {
+        retval = selfTestRun();
+        rt_dev_close(
+            UARTDevice);
+        moduleTerm();
+        simCoreStop();
+
+        return ((0 == retval) ? 0 : 1);
+    }
+    if (0U != AppConfig.idle) {                                                 /* Far end of the unwired UART feeds the reader      */
+        retval = idleWakeRun();
+        rt_dev_close(
+            UARTDevice);
+        moduleTerm();
+        simCoreStop();
+
+        return ((0 == retval) ? 0 : 1);
+    }
+    TxBuff = malloc(AppConfig.testDataSize);
+    RxBuff = malloc(AppConfig.testDataSize);
+
+    for (test = 0U; test < AppConfig.testDataSize; test++) {
+        TxBuff[test] = (uint8_t)(test * 7U);
+    }
+    sem_init(
+        &SemSend,
+        0,
+        0);
+    IsRunning = true;
+    pthread_create(
+        &send,
+        NULL,
+        taskSend,
+        NULL);
+    lineTime = TRANSMISION_TIME(AppConfig.baud, AppConfig.testDataSize);
+    errors   = 0U;
+    measInit(
+        &latency);
+    begin = simClockRead();
+
+    for (test = 0U; test < AppConfig.numOfTests; test++) {
+        ssize_t         len;
+        uint64_t        rxEnd;
+
+        memset(RxBuff, 0, AppConfig.testDataSize);
+        sem_post(
+            &SemSend);
+        len = rt_dev_read(
+            UARTDevice,
+            RxBuff,
+            AppConfig.testDataSize);
+        rxEnd = simClockRead();
+
+        if ((len != (ssize_t)AppConfig.testDataSize) ||
+            (0 != memcmp(TxBuff, RxBuff, AppConfig.testDataSize))) {
+            errors++;
+        }
+        measCalc(
+            &latency,
+            (rxEnd - TxBegin > lineTime) ? (rxEnd - TxBegin - lineTime) : 0U);
+    }
+    elapsed   = simClockRead() - begin;
+    IsRunning = false;
+    sem_post(
+        &SemSend);
+    pthread_join(
+        send,
+        NULL);
+    portSimStatsGet(
+        AppConfig.uart,
+        &stats);
+
+    if (TxDevice != UARTDevice) {
+        struct xUartVnm line;
+
+        memset(&line, 0, sizeof(line));
+        rt_dev_ioctl(
+            TxDevice,
+            XUART_VNM_GET,
+            &line);
+        stats.txBytes  = line.sent;
+        stats.overruns = line.overflows;
+        rt_dev_close(
+            TxDevice);
+        memset(&line, 0, sizeof(line));
+        rt_dev_ioctl(
+            UARTDevice,
+            XUART_VNM_GET,
+            &line);
+        stats.rxBytes   = line.received;
+        stats.overruns += line.overflows;
+    }
+    rt_dev_close(
+        UARTDevice);
+    moduleTerm();
+    simCoreStop();
+
+    if (true == AppConfig.isVnm) {
+        LOG_INFO("%s, %u baud, %u x %zu bytes", CFG_VNM_TX_NAME, AppConfig.baud, AppConfig.numOfTests, AppConfig.testDataSize);
+    } else {
+        LOG_INFO("UART%u, %u baud, %u x %zu bytes", AppConfig.uart, AppConfig.baud, AppConfig.numOfTests, AppConfig.testDataSize);
+    }
+    LOG_INFO("throughput    : %llu bytes/s",
+        (unsigned long long)(((uint64_t)AppConfig.numOfTests * AppConfig.testDataSize * NS_PER_S) / elapsed));
+    LOG_INFO("latency [us]  : min %llu, avg %llu, max %llu (after line time of %llu)",
+        (unsigned long long)NS_TO_US(latency.min),
+        (unsigned long long)NS_TO_US(latency.avg),
+        (unsigned long long)NS_TO_US(latency.max),
+        (unsigned long long)NS_TO_US(lineTime));
+    LOG_INFO("interrupts    : %llu, %llu per KiB, ISR time %llu us",
+        (unsigned long long)stats.irqs,
+        (unsigned long long)((0U != stats.rxBytes) ? (stats.irqs * 1024U) / stats.rxBytes : 0U),
+        (unsigned long long)NS_TO_US((uint64_t)stats.isrTime));
+    LOG_INFO("line          : tx %llu, rx %llu, overruns %llu",
+        (unsigned long long)stats.txBytes,
+        (unsigned long long)stats.rxBytes,
+        (unsigned long long)stats.overruns);
+    LOG_INFO("host stalls   : %llu us, not charged to the simulated clock",
+        (unsigned long long)NS_TO_US((uint64_t)simClockStallGet()));
+    LOG_INFO("errors        : %u", errors);
+    free(TxBuff);
+    free(RxBuff);
+
+    return ((0U == errors) ? 0 : 1);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of main.c
+ ******************************************************************************/